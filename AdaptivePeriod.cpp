@@ -0,0 +1,51 @@
+#include "AdaptivePeriod.h"
+
+AdaptivePeriod::AdaptivePeriod(uint32_t minPeriod, uint32_t maxPeriod, uint32_t period)
+{
+  this->minPeriod = minPeriod;
+  this->maxPeriod = maxPeriod;
+  this->period = constrain(period, minPeriod, maxPeriod);
+}
+
+void AdaptivePeriod::observe(float change, float noise, float resolution, uint16_t window)
+{
+  float threshold = ADAPTIVE_NOISE_SIGMAS * noise;
+  if (threshold < resolution)
+    threshold = resolution;
+
+  // A channel without a reading yet (NAN) does not count
+  float moved = fabs(change) / threshold;
+  if (moved > activity)
+    activity = moved;
+
+  if (moved >= 1 && window > hold)
+    hold = window;
+}
+
+uint32_t AdaptivePeriod::next()
+{
+  float target;
+
+  if (activity >= 1)
+  {
+    // Period that would have kept the most active channel to one threshold per sample
+    target = period / activity;
+  }
+  else if (hold > 0)
+  {
+    // A jump still in a window: the noise measured there is too high to trust
+    target = period;
+    hold--;
+  }
+  else
+    target = period * ADAPTIVE_BACKOFF;
+
+  period = constrain(target, (float) minPeriod, (float) maxPeriod);
+  activity = 0;
+  return period;
+}
+
+uint32_t AdaptivePeriod::getPeriod()
+{
+  return period;
+}
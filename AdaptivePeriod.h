@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Arduino.h"
+
+#define ADAPTIVE_BACKOFF 1.5          // period growth per sample while the signal is flat
+#define ADAPTIVE_NOISE_SIGMAS 3       // change beyond this many standard deviations of the noise is movement
+
+// -------------------------------------------------------
+// Adaptive sampling period
+// -------------------------------------------------------
+//
+// Each sample, the sensor process shows every channel it read: how far
+// it moved since the previous sample and the noise of the channel, the
+// standard deviation of the changes between the samples of its averaging
+// window (RollingStats::jitter, blind to a steady drift). The change counts
+// against ADAPTIVE_NOISE_SIGMAS times the noise, or against the resolution
+// of the channel (the smallest change worth seeing) if larger. The most
+// active channel sets the period:
+//  - moving beyond its threshold: the period shrinks right away, so the
+//    next samples again move about one threshold each
+//  - flat against its own noise: the period grows by ADAPTIVE_BACKOFF per
+//    sample
+// always within the bounds given. Noise only raises the threshold, so a
+// noisy channel is sampled as slowly as a quiet one instead of being held
+// at the fastest rate by its own scatter.
+//
+// Once a channel has jumped, the jump stays in its window for as many
+// samples as the window is long and the noise reads high meanwhile: the
+// period does not grow until the jump has left the window, so the tail of
+// a transient is followed as closely as its onset.
+
+class AdaptivePeriod
+{
+  public:
+    AdaptivePeriod(uint32_t minPeriod, uint32_t maxPeriod, uint32_t period);
+
+    // One channel of the sample just taken, window the number of samples its noise comes from
+    void observe(float change, float noise, float resolution, uint16_t window = 0);
+
+    // Period until the next sample, from the channels observed since the last call
+    uint32_t next();
+
+    uint32_t getPeriod();
+
+  private:
+    uint32_t minPeriod, maxPeriod;
+    uint32_t period;
+    float activity = 0;               // thresholds moved in the sample, most active channel
+    uint16_t hold = 0;                // flat samples left before backing off, a transient is still in a window
+};
@@ -24,18 +24,26 @@
 */
 
 #include "AdsbExchangeClient.h"
+#include "HttpResponse.h"
+#include "JsonKeys.h"
 #include <ESP8266WiFi.h>
 #include <WiFiClient.h>
 
-// Extern variables
-extern WiFiClient wifiClient;
-
 // Prototypes
 void errLog(String msg);
 
+// Same order as AdsbExchangeClient::Key
+static constexpr const char *keyNames[] = {
+  "Id", "From", "To", "OpIcao", "Dst", "Mdl", "Trak", "Alt",
+  "Lat", "Long", "Spd", "Icao", "Call", "PosStale", "Cos", "Trt"
+};
+static constexpr JsonKeyTable<sizeof(keyNames) / sizeof(keyNames[0]), 5> keys(keyNames);
+static_assert(keys.isPerfect(), "ADS-B key table has collisions, give it more bits");
+static_assert(sizeof(keyNames) / sizeof(keyNames[0]) == AdsbExchangeClient::KEY_TRT, "ADS-B key names and ids differ");
+
 AdsbExchangeClient::AdsbExchangeClient() {}
 
-void AdsbExchangeClient::updateVisibleAircraft(String searchQuery)
+bool AdsbExchangeClient::updateVisibleAircraft(String searchQuery)
 {
 
   JsonStreamingParser parser;
@@ -45,53 +53,35 @@ void AdsbExchangeClient::updateVisibleAircraft(String searchQuery)
 
   const char host[] = "global.adsbexchange.com";
 
+  // Own connection, the global client belongs to MQTT
+  WiFiClient client;
   const int httpPort = 80;
-  if (!wifiClient.connect(host, httpPort))
+  if (!client.connect(host, httpPort))
   {
     errLog(F("Can't connect to adsbexchange.com"));
-    return;
+    return false;
   }
 
   // Get Aircrafts list
-  wifiClient.print(F("GET "));
-  wifiClient.print(F("/VirtualRadar/AircraftList.json?"));
-  wifiClient.print(searchQuery);
-  wifiClient.print(F(" HTTP/1.1\r\nHost: "));
-  wifiClient.print(host);
-  wifiClient.print(F("\r\nConnection: close\r\n\r\n"));
-
-  int retryCounter = 0;
-  while (!wifiClient.available())
+  client.print(F("GET "));
+  client.print(F("/VirtualRadar/AircraftList.json?"));
+  client.print(searchQuery);
+  client.print(F(" HTTP/1.1\r\nHost: "));
+  client.print(host);
+  client.print(F("\r\nConnection: close\r\n\r\n"));
+
+  HttpResponse response(client);
+  if (!response.begin() || response.getStatus() != 200)
   {
-    delay(1000);
-    retryCounter++;
-    if (retryCounter > 10)
-    {
-      return;
-    }
+    errLog(F("No valid response from adsbexchange.com"));
+    client.stop();
+    return false;
   }
 
-  int pos = 0;
-  bool isBody = false;
-  char c;
-
-  int size = 0;
-  wifiClient.setNoDelay(false);
-  while (wifiClient.connected())
-  {
-    while ((size = wifiClient.available()) > 0)
-    {
-      c = wifiClient.read();
-      if (c == '{' || c == '[')
-      {
-        isBody = true;
-      }
-      if (isBody) {
-        parser.parse(c);
-      }
-    }
-  }
+  bool complete = response.parse(parser);
+  client.stop();
   endDocument();
+  return complete;
 }
 
 
@@ -101,12 +91,12 @@ void AdsbExchangeClient::whitespace(char c)
 }
 
 void AdsbExchangeClient::startDocument() {
-  counter = 0;
-  index = -1;
+  updateMillis = millis();
+  isIncoming = false;
 }
 
 void AdsbExchangeClient::key(String key) {
-  currentKey = key;
+  currentKey = (Key) keys.lookup(key.c_str());
 }
 
 void AdsbExchangeClient::value(String value) {
@@ -128,91 +118,223 @@ void AdsbExchangeClient::value(String value) {
     "Dst": 6.23,
     "Year": "1996"
   */
-  if (counter >= MAX_AIRCRAFTS - 1) {
-    //-#ifdef DEBUG_SERIAL Serial.println(F("Max Aircrafts reached...."));
+  const char *text = value.c_str();
+
+  // Each aircraft starts with its Id
+  if (currentKey == KEY_ID)
+  {
+    merge();
+    incoming = {};
+    incoming.icao = atol(text);     // the Icao key follows, Id is only a fallback
+    isIncoming = true;
+    trailIndex = 0;
     return;
   }
-  if (currentKey == F("Id")) {
 
-    counter++;
-    index = counter - 1;
-    aircrafts[index] = {};
-    histories[index] = {};
+  if (!isIncoming)
+    return;
 
-    trailIndex = 0;
-    for (int i = 0; i < MAX_HISTORY_TEMP; i++)
-    {
-      positionTemp[i] = {};
-    }
+  switch (currentKey)
+  {
+    // "LSZH Zurich, Switzerland": keep the name between the code and the first comma
+    case KEY_FROM:
+    case KEY_TO:
+      {
+        char *place = currentKey == KEY_FROM ? incoming.fromShort : incoming.toShort;
+        if (value.length() > 4)
+        {
+          const char *comma = strchr(text + 4, ',');
+          copyJsonValue(place, AIRCRAFT_PLACE_SIZE, text + 4, comma ? comma - (text + 4) : (size_t) -1);
+        }
+        else
+          place[0] = 0;
+      }
+      break;
+
+    case KEY_DST:
+      incoming.distance = atof(text);
+      break;
+
+    case KEY_MDL:
+      copyJsonValue(incoming.aircraftType, AIRCRAFT_TYPE_SIZE, text);
+      break;
+
+    case KEY_TRAK:
+      incoming.heading = atof(text);
+      break;
+
+    case KEY_ALT:
+      incoming.altitude = atoi(text);
+      break;
+
+    case KEY_LAT:
+      incoming.lat = atof(text);
+      break;
+
+    case KEY_LONG:
+      incoming.lon = atof(text);
+      break;
+
+    case KEY_SPD:
+      incoming.speed = atof(text);
+      break;
 
-  } else if (currentKey == F("From")) {
-    // aircrafts[index].from = value;
-    // aircrafts[index].fromCode = value.substring(0, 4);
-    int indexOfFirstComma = value.indexOf(F(","));
-    aircrafts[index].fromShort = value.substring(4, indexOfFirstComma);
-  } else if (currentKey == F("To")) {
-    // aircrafts[index].to = value;
-    // aircrafts[index].toCode = value.substring(0, 4);
-    int indexOfFirstComma = value.indexOf(F(","));
-    aircrafts[index].toShort = value.substring(4, indexOfFirstComma);
-  } else if (currentKey == F("OpIcao")) {
-    // aircrafts[index].operatorCode = value;
-  } else if (currentKey == F("Dst")) {
-    aircrafts[index].distance = value.toFloat();
-  } else if (currentKey == F("Mdl")) {
-    aircrafts[index].aircraftType = value;
-  } else if (currentKey == F("Trak")) {
-    aircrafts[index].heading = value.toFloat();
-  } else if (currentKey == F("Alt")) {
-    aircrafts[index].altitude = value.toInt();;
-  } else if (currentKey == F("Lat")) {
-    aircrafts[index].lat = value.toFloat();
-  } else if (currentKey == F("Long")) {
-    aircrafts[index].lon = value.toFloat();
-  } else if (currentKey == F("Spd")) {
-    aircrafts[index].speed = value.toFloat();
-  } else if (currentKey == F("Icao")) {
-    // aircrafts[index].icao = value;
-  } else if (currentKey == F("Call")) {
-    //-#ifdef DEBUG_SERIAL Serial.println("Saw " + value);
-    aircrafts[index].call = value;
-  } else if (currentKey == F("PosStale")) {
-    aircrafts[index].posStall = (value == F("true"));
-  } else if (currentKey == F("Cos")) {
-    int tempIndex = trailIndex / 4;
-    if (tempIndex < MAX_HISTORY_TEMP) {
-      AircraftPosition position = positionTemp[tempIndex];
-      Coordinates coordinates = position.coordinates;
-      if (trailIndex % 4 == 0) {
-        coordinates.lat = value.toFloat();
-      } else if (trailIndex % 4 == 1) {
-        coordinates.lon = value.toFloat();
-      } else if (trailIndex % 4 == 3) {
-        position.altitude = value.toInt();
+    case KEY_ICAO:
+      incoming.icao = strtoul(text, nullptr, 16);
+      break;
+
+    case KEY_CALL:
+      copyJsonValue(incoming.call, AIRCRAFT_CALL_SIZE, text);
+      break;
+
+    case KEY_POS_STALE:
+      incoming.posStall = strcmp(text, "true") == 0;
+      break;
+
+    // Short trail: lat, lon, time, altitude for each point, oldest first
+    case KEY_COS:
+      {
+        int tempIndex = trailIndex / 4;
+        if (tempIndex < MAX_HISTORY_TEMP) {
+          AircraftPosition &position = positionTemp[tempIndex];
+          if (trailIndex % 4 == 0) {
+            position.coordinates.lat = atof(text);
+          } else if (trailIndex % 4 == 1) {
+            position.coordinates.lon = atof(text);
+          } else if (trailIndex % 4 == 3) {
+            position.altitude = atoi(text);
+          }
+          trailIndex++;
+        }
       }
-      position.coordinates = coordinates;
-      positionTemp[tempIndex] = position;
-      trailIndex++;
+      break;
+
+    default:
+      break;
+  }
+
+}
+
+int AdsbExchangeClient::find(uint32_t icao)
+{
+  for (int i = 0; i < counter; i++)
+  {
+    if (aircrafts[i].icao == icao)
+      return i;
+  }
+  return -1;
+}
+
+// Update the tracked aircraft with the one just parsed, or start tracking it
+void AdsbExchangeClient::merge()
+{
+  if (!isIncoming)
+    return;
+  isIncoming = false;
+
+  // Nothing to place on the map
+  if (incoming.posStall || (incoming.lat == 0 && incoming.lon == 0))
+    return;
+
+  incoming.fix.lat = incoming.lat;
+  incoming.fix.lon = incoming.lon;
+  incoming.fixMillis = updateMillis;
+
+  int i = find(incoming.icao);
+  if (i >= 0)
+  {
+    // Known: add the new fix to its own trail, newest first
+    AircraftHistory &history = histories[i];
+    AircraftPosition &last = history.positions[0];
+    if (history.counter == 0 || last.coordinates.lat != incoming.lat || last.coordinates.lon != incoming.lon)
+    {
+      memmove(&history.positions[1], &history.positions[0], (MAX_HISTORY - 1) * sizeof(AircraftPosition));
+      history.positions[0].coordinates = incoming.fix;
+      history.positions[0].altitude = incoming.altitude;
+      if (history.counter < MAX_HISTORY)
+        history.counter++;
     }
 
-  } else if (currentKey == F("Trt")) {
-    if (aircrafts[index].posStall) {
-      //-#ifdef DEBUG_SERIAL Serial.println(F("This aircraft is stalled. Ignoring it"));
-      counter--;
-      index = counter - 1;
+    // Some fields are only sent now and then
+    Aircraft &aircraft = aircrafts[i];
+    if (!incoming.call[0])
+      strcpy(incoming.call, aircraft.call);
+    if (!incoming.aircraftType[0])
+      strcpy(incoming.aircraftType, aircraft.aircraftType);
+    if (!incoming.fromShort[0])
+      strcpy(incoming.fromShort, aircraft.fromShort);
+    if (!incoming.toShort[0])
+      strcpy(incoming.toShort, aircraft.toShort);
+    aircraft = incoming;
+    strcpy(history.call, aircraft.call);
+    return;
+  }
+
+  // New: take a free slot, else the one not reported for longest if older than this update
+  if (counter < MAX_AIRCRAFTS)
+    i = counter++;
+  else
+  {
+    i = 0;
+    for (int j = 1; j < counter; j++)
+    {
+      if (aircrafts[j].fixMillis < aircrafts[i].fixMillis)
+        i = j;
     }
+    if (aircrafts[i].fixMillis == updateMillis)
+      return;
+  }
+
+  aircrafts[i] = incoming;
+
+  // Seed its trail with the one sent by the server
+  AircraftHistory &history = histories[i];
+  history = {};
+  int items = trailIndex / 4;
+  for (int j = 0; j < min(items, MAX_HISTORY); j++)
+  {
+    history.positions[j] = positionTemp[items - j - 1];
   }
+  history.counter = min(items, MAX_HISTORY);
+  strcpy(history.call, incoming.call);
+}
 
+void AdsbExchangeClient::remove(int i)
+{
+  counter--;
+  if (i != counter)
+  {
+    aircrafts[i] = aircrafts[counter];
+    histories[i] = histories[counter];
+  }
 }
 
-Aircraft AdsbExchangeClient::getAircraft(int i) {
-  if (i < MAX_AIRCRAFTS) {
-    return aircrafts[i];
+void AdsbExchangeClient::extrapolate()
+{
+  unsigned long now = millis();
+  for (int i = counter - 1; i >= 0; i--)
+  {
+    Aircraft &aircraft = aircrafts[i];
+    unsigned long age = now - aircraft.fixMillis;
+    if (age > MAX_AGE_MILLIS)
+    {
+      remove(i);
+      continue;
+    }
+
+    // Straight line at the last speed (knots) and track, one nautical mile is 1/60 degree of latitude
+    double miles = aircraft.speed * age / 3600000.0;
+    double heading = aircraft.heading * PI / 180;
+    aircraft.lat = aircraft.fix.lat + miles * cos(heading) / 60;
+    aircraft.lon = aircraft.fix.lon + miles * sin(heading) / (60 * cos(aircraft.fix.lat * PI / 180));
   }
-  //return nullptr;
 }
 
-AircraftHistory AdsbExchangeClient::getAircraftHistory(int i) {
+const Aircraft &AdsbExchangeClient::getAircraft(int i) {
+  return aircrafts[i];
+}
+
+const AircraftHistory &AdsbExchangeClient::getAircraftHistory(int i) {
   return histories[i];
 }
 
@@ -220,45 +342,27 @@ int AdsbExchangeClient::getNumberOfAircrafts() {
   return counter;
 }
 
-Aircraft AdsbExchangeClient::getClosestAircraft(double lat, double lon) {
+int AdsbExchangeClient::getClosestAircraft(double lat, double lon) {
   double minDistance = 999999.0;
-  Aircraft closestAircraft = aircrafts[0];
-  for (int i = 0; i < getNumberOfAircrafts(); i++) {
-    Aircraft currentAircraft = aircrafts[i];
-
-    if (currentAircraft.distance < minDistance) {
-      minDistance = currentAircraft.distance;
-      closestAircraft = currentAircraft;
+  int closest = -1;
+  for (int i = 0; i < counter; i++) {
+    Aircraft &aircraft = aircrafts[i];
+
+    // Flat earth is fine at map scale
+    double dy = (aircraft.lat - lat) * 111.2;
+    double dx = (aircraft.lon - lon) * 111.2 * cos(lat * PI / 180);
+    aircraft.distance = sqrt(dx * dx + dy * dy);
+
+    if (aircraft.distance < minDistance) {
+      minDistance = aircraft.distance;
+      closest = i;
     }
   }
-  return closestAircraft;
+  return closest;
 }
 
 void AdsbExchangeClient::endArray() {
-  if (counter >= MAX_AIRCRAFTS - 1) {
-    //-#ifdef DEBUG_SERIAL Serial.println(F("Max Aircrafts reached:end array"));
-    return;
-  }
-  if (currentKey == F("Cos") && trailIndex > 0) {
-    AircraftHistory history = {};
-    uint16_t items = (trailIndex / 4);
-    //-#ifdef DEBUG_SERIAL Serial.println("Finished history array: " + String(items) + " elements");
-    int historyCounter = 0;
-    for (int i = 0; i < min(items, MAX_HISTORY); i++) {
-      AircraftPosition position = {};
-      Coordinates coordinates = position.coordinates;
-      coordinates.lat = positionTemp[items - i - 1].coordinates.lat;
-      coordinates.lon = positionTemp[items - i - 1].coordinates.lon;
-      position.coordinates = coordinates;
-      position.altitude = positionTemp[items - i - 1].altitude;
-      history.positions[i] = position;
-      historyCounter++;
-    }
-    history.call = aircrafts[index].call;
-    history.counter = historyCounter;
-    histories[index] = history;
-    currentKey = F("");
-  }
+
 }
 
 void AdsbExchangeClient::endObject() {
@@ -266,14 +370,7 @@ void AdsbExchangeClient::endObject() {
 }
 
 void AdsbExchangeClient::endDocument() {
-  /*//-#ifdef DEBUG_SERIAL Serial.println("End of document:");
-    for (int i = 0; i < getNumberOfAircrafts(); i++) {
-    AircraftHistory history = histories[i];
-    for (int j = 0; j < history.counter; j++) {
-      AircraftPosition position = history.positions[j];
-      //-#ifdef DEBUG_SERIAL Serial.println(history.call + ": " + String(j) + ". " + String(position.coordinates.lat, 9) + ", " + String(position.coordinates.lon, 9) + ", " + String(position.altitude));
-    }
-    }*/
+  merge();
 }
 
 void AdsbExchangeClient::startArray() {
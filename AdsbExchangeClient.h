@@ -33,8 +33,11 @@
 #define MAX_AIRCRAFTS 8
 #define MAX_HISTORY 20
 #define MAX_HISTORY_TEMP 40 //80
+#define AIRCRAFT_CALL_SIZE 12
+#define AIRCRAFT_PLACE_SIZE 24
+#define AIRCRAFT_TYPE_SIZE 32
 
-//#define MAX_AGE_MILLIS 15000
+#define MAX_AGE_MILLIS 30000     // (ms) aircraft not reported for this long are dropped
 #define min(a,b) ((a)<(b)?(a):(b))
 
 struct AircraftPosition {
@@ -43,7 +46,7 @@ struct AircraftPosition {
 };
 
 struct AircraftHistory {
-  String call;
+  char call[AIRCRAFT_CALL_SIZE];
   AircraftPosition positions[MAX_HISTORY];
   int counter;
 };
@@ -51,47 +54,70 @@ struct AircraftHistory {
 struct Aircraft {
   // String from;
   // String fromCode;
-  String fromShort;
+  char fromShort[AIRCRAFT_PLACE_SIZE];
   // String to;
   // String toCode;
-  String toShort;
+  char toShort[AIRCRAFT_PLACE_SIZE];
   double speed;
   double lat;
   double lon;
   uint16_t altitude;
   double distance;
-  String aircraftType;
+  char aircraftType[AIRCRAFT_TYPE_SIZE];
   // String operatorCode;
   double heading;
-  // String icao;
-  String call;
+  uint32_t icao;               // 24 bit address, identity across updates
+  char call[AIRCRAFT_CALL_SIZE];
   bool posStall;
+  Coordinates fix;             // last reported position, lat/lon are extrapolated from it
+  unsigned long fixMillis;
 };
 
 
 class AdsbExchangeClient: public JsonListener {
+  public:
+    // Keys used from the aircraft list, in the order of the key table
+    enum Key : uint8_t
+    {
+      KEY_OTHER, KEY_ID, KEY_FROM, KEY_TO, KEY_OP_ICAO, KEY_DST, KEY_MDL, KEY_TRAK, KEY_ALT,
+      KEY_LAT, KEY_LONG, KEY_SPD, KEY_ICAO, KEY_CALL, KEY_POS_STALE, KEY_COS, KEY_TRT
+    };
+
   private:
+    // Tracked aircraft, kept across updates
     int counter = 0;
-    int index = 0;
-    String currentKey = "";
     Aircraft aircrafts[MAX_AIRCRAFTS];
     AircraftHistory histories[MAX_AIRCRAFTS];
+
+    // Aircraft being parsed, merged into the table when the next one starts
+    Key currentKey = KEY_OTHER;
+    Aircraft incoming;
+    bool isIncoming = false;
     AircraftPosition positionTemp[MAX_HISTORY_TEMP];
-    long lastSightingMillis = 0;
     int trailIndex = 0;
+    unsigned long updateMillis = 0;
+
+    int find(uint32_t icao);
+    void merge();
+    void remove(int i);
 
   public:
     AdsbExchangeClient();
 
-    void updateVisibleAircraft(String searchQuery);
+    // Download the aircraft list and merge it into the table. False on failure
+    bool updateVisibleAircraft(String searchQuery);
+
+    // Move every aircraft along its track to now, drop those not reported for MAX_AGE_MILLIS
+    void extrapolate();
 
-    Aircraft getAircraft(int i);
+    const Aircraft &getAircraft(int i);
 
-    AircraftHistory getAircraftHistory(int i);
+    const AircraftHistory &getAircraftHistory(int i);
 
     int getNumberOfAircrafts();
 
-    Aircraft getClosestAircraft(double lat, double lon);
+    // Index of the aircraft closest to lat/lon, -1 if none. Also refreshes their distance (km)
+    int getClosestAircraft(double lat, double lon);
 
     virtual void whitespace(char c);
 
@@ -7,9 +7,23 @@
 
 #include "AnalogMeter.h"
 #include "TFT_eSPI.h"
+#include "artwork.h"
 
 extern TFT_eSPI LCD;
 
+uint16_t AnalogMeter::line[ANALOG_METER_WIDTH];
+
+// sin(0..90 degrees) * 16384
+static const int16_t sineTable[91] PROGMEM = {
+  0, 286, 572, 857, 1143, 1428, 1713, 1997, 2280, 2563, 2845, 3126, 3406, 3686, 3964, 4240,
+  4516, 4790, 5063, 5334, 5604, 5872, 6138, 6402, 6664, 6924, 7182, 7438, 7692, 7943, 8192,
+  8438, 8682, 8923, 9162, 9397, 9630, 9860, 10087, 10311, 10531, 10749, 10963, 11174, 11381,
+  11585, 11786, 11982, 12176, 12365, 12551, 12733, 12911, 13085, 13255, 13421, 13583, 13741,
+  13894, 14044, 14189, 14330, 14466, 14598, 14726, 14849, 14968, 15082, 15191, 15296, 15396,
+  15491, 15582, 15668, 15749, 15826, 15897, 15964, 16026, 16083, 16135, 16182, 16225, 16262,
+  16294, 16322, 16344, 16362, 16374, 16382, 16384
+};
+
 AnalogMeter::AnalogMeter(int offsetY, int decades, int orangeValue, int redValue, String measurement, String units)
 {
   this->units = units;
@@ -24,6 +38,11 @@ AnalogMeter::AnalogMeter(int offsetY, int decades, int orangeValue, int redValue
   this->maxValue = pow(10, decades);
 }
 
+AnalogMeter::~AnalogMeter()
+{
+  delete[] mask;
+}
+
 void AnalogMeter::begin()
 {
   int label[5];
@@ -176,14 +195,21 @@ void AnalogMeter::begin()
     }
   }
 
-  LCD.setTextDatum(TR_DATUM);
-  LCD.drawString(measurement, 235 , 119 - 20 + offsetY, 2); // measurement at bottom right
-
-  //  LCD.drawString(measurement, 5 + 230 - 40 , 119 - 20 + offsetY, 2); // measurement at bottom right
-  LCD.drawCentreString(units, 120 , 70 + offsetY, 4); // Comment out to avoid font 4
   LCD.drawRect(5 , 3 + offsetY, 230, 119, TFT_BLACK); // Draw bezel line
 
-  drawNeedle(1); // Put meter needle at 0
+  // Put meter needle at 0
+  drawNeedle(1);
+  currentValue = targetValue;
+  needle = needleAt(currentValue);
+
+  // Labels the needle may cross go through the mask: measurement at bottom right, units in the middle
+  if (!mask)
+    mask = new uint8_t[ANALOG_METER_MASK_ROWS * ANALOG_METER_WIDTH / 8];
+  memset(mask, 0, ANALOG_METER_MASK_ROWS * ANALOG_METER_WIDTH / 8);
+  maskText(measurement, &Dialog_plain_12, 235 - textWidth(measurement, &Dialog_plain_12), 109);
+  maskText(units, &Dialog_plain_15, 120 - textWidth(units, &Dialog_plain_15) / 2, 83);
+
+  moveNeedle(currentValue);
 }
 
 void AnalogMeter::drawNeedle(float value)
@@ -194,8 +220,6 @@ void AnalogMeter::drawNeedle(float value)
   else
     scaledValue = int(mapf(log10(value), log10(minValue), log10(maxValue), 0, 100));
 
-  int us_delay = 100;
-
   LCD.setTextColor(TFT_BLACK, TFT_WHITE);
   char buf[8]; dtostrf(value, 4, 0, buf);
   LCD.drawRightString(buf, 40 , 119 - 20 + offsetY, 2);
@@ -203,54 +227,220 @@ void AnalogMeter::drawNeedle(float value)
   if (scaledValue < -10) scaledValue = -10; // Limit value to emulate needle end stops
   if (scaledValue > 110) scaledValue = 110;
 
-  // Move the needle util new value reached
-  while (!(scaledValue == currentValue))
-  {
-    int increment = abs(scaledValue - currentValue) > 10 ? 5 : 1;
+  targetValue = scaledValue;
+}
 
-    if (currentValue < scaledValue)
-      currentValue += increment;
-    else
-      currentValue -= increment;
+bool AnalogMeter::animate()
+{
+  if (currentValue == targetValue)
+    return false;
 
-    // if (us_delay == 0) currentValue = scaledValue; // Update immediately id delay is 0
+  // Ease in to the new value, a third of the way each frame
+  int step = (targetValue - currentValue) / 3;
+  if (step == 0)
+    step = targetValue > currentValue ? 1 : -1;
+  step = constrain(step, -ANALOG_METER_MAX_STEP, ANALOG_METER_MAX_STEP);
 
-    float sdeg = mapf(currentValue, -10, 110, -150, -30); // Map value to angle
-    // Calcualte tip of needle coords
-    float sx = cos(sdeg * 0.0174532925);
-    float sy = sin(sdeg * 0.0174532925);
+  moveNeedle(currentValue + step);
+  return currentValue != targetValue;
+}
 
-    // Calculate x delta of needle start (does not start at pivot point)
-    float tx = tan((sdeg + 90) * 0.0174532925);
+// Sine of whole degrees, scaled by 16384
+int16_t AnalogMeter::sinDegrees(int degrees)
+{
+  degrees %= 360;
+  if (degrees < 0)
+    degrees += 360;
+
+  if (degrees <= 90)
+    return pgm_read_word(&sineTable[degrees]);
+  if (degrees <= 180)
+    return pgm_read_word(&sineTable[180 - degrees]);
+  if (degrees <= 270)
+    return -pgm_read_word(&sineTable[degrees - 180]);
+  return -pgm_read_word(&sineTable[360 - degrees]);
+}
 
-    // Erase old needle image
-    LCD.drawLine(120 + 20 * ltx - 1 , 140 - 20 + offsetY, osx - 1 , osy + offsetY, TFT_WHITE);
-    LCD.drawLine(120 + 20 * ltx , 140 - 20 + offsetY, osx , osy + offsetY, TFT_WHITE);
-    LCD.drawLine(120 + 20 * ltx + 1 , 140 - 20 + offsetY, osx + 1 , osy + offsetY, TFT_WHITE);
+// One degree per value, -10..110 is -150..-30 degrees
+AnalogMeter::Needle AnalogMeter::needleAt(int value)
+{
+  int degrees = value - 140;
+  long s = sinDegrees(degrees);
+  long c = sinDegrees(degrees + 90);
+
+  // Tip 98 pixels from the pivot, start on row 120 (the needle does not start at the pivot)
+  Needle needle;
+  needle.tipX = ((120L << 14) + c * 98) >> 14;
+  needle.tipY = ((140L << 14) + s * 98) >> 14;
+  needle.startX = (120L * -s + 20 * c) / -s;
+  return needle;
+}
 
-    // Re-plot text under needle
-    LCD.setTextColor(TFT_BLACK);
-    LCD.drawCentreString(units, 120 , 70 + offsetY, 4); // // Comment out to avoid font 4
+// Pixels of row y on the line, y0 <= y <= y1: one pixel if steep, else those nearest to the row
+void AnalogMeter::lineRun(int x0, int y0, int x1, int y1, int y, int &from, int &to)
+{
+  int dx = abs(x1 - x0);
+  int dy = y1 - y0;
+  int k = y - y0;
+  int tFrom, tTo;
 
-    // Store new needle end coords for next erase
-    ltx = tx;
-    osx = sx * 98 + 120;
-    osy = sy * 98 + 140;
+  if (dy == 0)
+  {
+    tFrom = 0;
+    tTo = dx;
+  }
+  else if (dx <= dy)
+  {
+    tFrom = (2 * k * dx + dy) / (2 * dy);
+    tTo = tFrom;
+  }
+  else
+  {
+    tFrom = k == 0 ? 0 : ((2 * k - 1) * dx + 2 * dy - 1) / (2 * dy);
+    tTo = min(((2 * k + 1) * dx + 2 * dy - 1) / (2 * dy) - 1, dx);
+  }
 
-    // Draw the needle in the new postion, magenta makes needle a bit bolder
-    // draws 3 lines to thicken needle
-    LCD.drawLine(120 + 20 * ltx - 1 , 140 - 20 + offsetY, osx - 1 , osy + offsetY, TFT_RED);
-    LCD.drawLine(120 + 20 * ltx , 140 - 20 + offsetY, osx , osy + offsetY, TFT_MAGENTA);
-    LCD.drawLine(120 + 20 * ltx + 1 , 140 - 20 + offsetY, osx + 1 , osy + offsetY, TFT_RED);
+  if (x1 >= x0)
+  {
+    from = x0 + tFrom;
+    to = x0 + tTo;
+  }
+  else
+  {
+    from = x0 - tTo;
+    to = x0 - tFrom;
+  }
+}
 
-    // Slow needle down slightly as it approaches new postion
-    if (abs(currentValue - scaledValue) < 7) us_delay += us_delay / 5;
+// Redraw every row the needle leaves or enters, across both
+void AnalogMeter::moveNeedle(int value)
+{
+  Needle old = needle;
+  needle = needleAt(value);
+  currentValue = value;
 
-    // Wait before next update
-    delayMicroseconds(us_delay);
+  for (int y = min(old.tipY, needle.tipY); y <= 120; y++)
+  {
+    int x0 = ANALOG_METER_WIDTH;
+    int x1 = -1;
+    int from, to;
+    if (y >= old.tipY)
+    {
+      lineRun(old.tipX, old.tipY, old.startX, 120, y, from, to);
+      x0 = from;
+      x1 = to;
+    }
+    if (y >= needle.tipY)
+    {
+      lineRun(needle.tipX, needle.tipY, needle.startX, 120, y, from, to);
+      x0 = min(x0, from);
+      x1 = max(x1, to);
+    }
+    drawRow(y, x0 - 1, x1 + 1);
+  }
+}
+
+void AnalogMeter::drawRows(int top, int bottom, int x0, int x1)
+{
+  for (int y = top; y <= bottom; y++)
+    drawRow(y, x0, x1);
+}
+
+// Face, labels and needle from x0 to x1 of row y, in one push
+void AnalogMeter::drawRow(int y, int x0, int x1)
+{
+  // Inside the bezel
+  x0 = max(x0, 6);
+  x1 = min(x1, 233);
+  if (x0 > x1)
+    return;
+
+  int row = y - ANALOG_METER_MASK_TOP;
+  bool masked = mask && row >= 0 && row < ANALOG_METER_MASK_ROWS;
+  for (int x = x0; x <= x1; x++)
+    line[x - x0] = masked && (mask[row * ANALOG_METER_WIDTH / 8 + x / 8] & (0x80 >> (x & 7))) ? TFT_BLACK : TFT_WHITE;
+
+  // Three lines thicken the needle, magenta makes it a bit bolder
+  if (y >= needle.tipY)
+  {
+    static const uint16_t colours[3] = {TFT_RED, TFT_MAGENTA, TFT_RED};
+    int from, to;
+    lineRun(needle.tipX, needle.tipY, needle.startX, 120, y, from, to);
+    for (int i = 0; i < 3; i++)
+    {
+      for (int x = max(from + i - 1, x0); x <= min(to + i - 1, x1); x++)
+        line[x - x0] = colours[i];
+    }
+  }
+
+  LCD.setWindow(x0, y + offsetY, x1, y + offsetY);
+  LCD.pushColors(line, x1 - x0 + 1);
+}
+
+int AnalogMeter::textWidth(const String &text, const GFXfont *font)
+{
+  GFXglyph *glyphs = (GFXglyph *) pgm_read_ptr(&font->glyph);
+  uint16_t first = pgm_read_word(&font->first);
+  uint16_t last = pgm_read_word(&font->last);
+  int width = 0;
+  for (unsigned int i = 0; i < text.length(); i++)
+  {
+    uint8_t c = text[i];
+    if (c >= first && c <= last)
+      width += pgm_read_byte(&glyphs[c - first].xAdvance);
   }
+  return width;
 }
 
+// Text into the label mask, then onto the face
+void AnalogMeter::maskText(const String &text, const GFXfont *font, int x, int baseline)
+{
+  uint8_t *bitmap = (uint8_t *) pgm_read_ptr(&font->bitmap);
+  GFXglyph *glyphs = (GFXglyph *) pgm_read_ptr(&font->glyph);
+  uint16_t first = pgm_read_word(&font->first);
+  uint16_t last = pgm_read_word(&font->last);
+  int left = ANALOG_METER_WIDTH, right = -1, top = ANALOG_METER_MASK_ROWS, bottom = -1;
+
+  for (unsigned int i = 0; i < text.length(); i++)
+  {
+    uint8_t c = text[i];
+    if (c < first || c > last)
+      continue;
+
+    GFXglyph *glyph = glyphs + c - first;
+    uint16_t offset = pgm_read_word(&glyph->bitmapOffset);
+    int width = pgm_read_byte(&glyph->width);
+    int height = pgm_read_byte(&glyph->height);
+    int glyphX = x + (int8_t) pgm_read_byte(&glyph->xOffset);
+    int glyphY = baseline + (int8_t) pgm_read_byte(&glyph->yOffset) - ANALOG_METER_MASK_TOP;
+
+    // Glyph bits run on from one row to the next
+    uint8_t bits = 0;
+    int bit = 0;
+    for (int gy = 0; gy < height; gy++)
+    {
+      for (int gx = 0; gx < width; gx++, bit++)
+      {
+        if (!(bit & 7))
+          bits = pgm_read_byte(&bitmap[offset++]);
+        int px = glyphX + gx;
+        int py = glyphY + gy;
+        if ((bits & (0x80 >> (bit & 7))) && px >= 0 && px < ANALOG_METER_WIDTH && py >= 0 && py < ANALOG_METER_MASK_ROWS)
+        {
+          mask[py * ANALOG_METER_WIDTH / 8 + px / 8] |= 0x80 >> (px & 7);
+          left = min(left, px);
+          right = max(right, px);
+          top = min(top, py);
+          bottom = max(bottom, py);
+        }
+      }
+    }
+    x += pgm_read_byte(&glyph->xAdvance);
+  }
+
+  if (bottom >= 0)
+    drawRows(top + ANALOG_METER_MASK_TOP, bottom + ANALOG_METER_MASK_TOP, left, right);
+}
 
 float AnalogMeter::mapf(float x, float in_min, float in_max, float out_min, float out_max)
 {
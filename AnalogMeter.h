@@ -1,30 +1,69 @@
-
 #pragma once
 
 #include "Arduino.h"
+#include <TFT_eSPI.h>             // https://github.com/Bodmer/TFT_eSPI
 
 #define TFT_GREY 0x5AEB
 
-// Screen Handler definition
+#define ANALOG_METER_WIDTH 240
+#define ANALOG_METER_MASK_TOP 42       // rows the needle sweeps, from its tip at the top...
+#define ANALOG_METER_MASK_ROWS 80      // ...to its start below the pivot
+#define ANALOG_METER_MAX_STEP 12       // (degrees) needle travel per frame, bounds the redraw
+
+// -------------------------------------------------------
+// Analog meter
+// -------------------------------------------------------
+//
+// The needle moves towards the last value set a frame at a time: animate()
+// is called between screen refreshes and returns as soon as the frame is
+// drawn. Each frame works out where the needle was and where it goes from
+// a sine table, then composes every row between the two, one span per
+// row, in a line buffer: the white face, the labels the needle crosses and
+// the needle on top, pushed with one window per row. The labels come from
+// a one bit mask built in begin(), so nothing under the needle is redrawn
+// with the text functions.
+
 class AnalogMeter
 {
   public:
     AnalogMeter(int offsetY, int decades, int orangeValue, int redValue, String measurement, String units);
+    ~AnalogMeter();
     void begin();
+
+    // Show the value and start moving the needle to it
     void drawNeedle(float value);
 
+    // One frame of needle movement, true while the needle still has to move
+    bool animate();
+
   private:
+    struct Needle
+    {
+      int16_t tipX;       // tip at the top, start at row 120
+      int16_t tipY;
+      int16_t startX;
+    };
+
     String units, measurement;
     int offsetY;
-    int currentValue = 0;
+    int currentValue = 0;     // needle position, 0..100 is the scale
+    int targetValue = 0;
     int decades, orangeValue, redValue, minValue, maxValue;
-    float ltx = 0;
-    uint16_t osx = 120, osy = 120; // Saved x & y coords
+    uint8_t *mask = nullptr;  // labels, a bit per pixel
+    Needle needle;
+
+    static int16_t sinDegrees(int degrees);
+    static Needle needleAt(int value);
+    static void lineRun(int x0, int y0, int x1, int y1, int y, int &from, int &to);
+    void moveNeedle(int value);
+    void drawRows(int top, int bottom, int x0, int x1);
+    void drawRow(int y, int x0, int x1);
+    static int textWidth(const String &text, const GFXfont *font);
+    void maskText(const String &text, const GFXfont *font, int x, int baseline);
 
     float mapf(float x, float in_min, float in_max, float out_min, float out_max);
     void fillArc(int x, int y, int start_angle, int seg_count, int rx, int ry, int w, unsigned int colour);
     void drawArc(int x, int y, int start_angle, int end_angle, int r,  unsigned int colour);
 
+    static uint16_t line[ANALOG_METER_WIDTH];
 };
-
-
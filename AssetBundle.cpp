@@ -0,0 +1,615 @@
+#include "AssetBundle.h"
+#include <Syslog.h>               // https://github.com/arcao/ESP8266_Syslog
+
+// External variables
+extern Syslog syslog;
+
+// Prototypes
+void setTurbo(bool setTurbo);
+bool isTurbo();
+void errLog(String msg);
+
+#define ASSET_BUNDLE_MAGIC 0x31545341   // "AST1"
+#define ASSET_TABLE_START sizeof(AssetBundleHeader)
+#define ASSET_DATA_START (ASSET_TABLE_START + ASSET_BUNDLE_SLOTS * sizeof(AssetEntry))
+
+struct AssetBundleHeader
+{
+  uint32_t magic;
+  uint16_t slots;
+  uint16_t count;
+};
+
+struct BmpInfo
+{
+  uint32_t offset;      // of the pixels in the file
+  int32_t width;
+  int32_t height;
+  uint32_t rowSize;     // rows are padded to 4 bytes
+};
+
+// Bytes of a file, a block at a time
+class BlockReader
+{
+  public:
+    BlockReader(fs::File &file, uint8_t *buffer, uint32_t size) : _file(file), _buffer(buffer), _left(size) {}
+
+    // Next byte, -1 past the end
+    int get()
+    {
+      if (_pos == _len)
+      {
+        if (_left == 0)
+          return -1;
+        _len = _file.read(_buffer, min(_left, (uint32_t) ASSET_BLOCK));
+        if (_len <= 0)
+        {
+          _left = 0;
+          _len = 0;
+          return -1;
+        }
+        _left -= _len;
+        _pos = 0;
+      }
+      return _buffer[_pos++];
+    }
+
+  private:
+    fs::File &_file;
+    uint8_t *_buffer;
+    uint32_t _left;
+    int _pos = 0;
+    int _len = 0;
+};
+
+// Bytes gathered into whole blocks for the file, or only counted without one
+class PackWriter
+{
+  public:
+    PackWriter(fs::File *file, uint8_t *buffer) : _file(file), _buffer(buffer) {}
+
+    void put(uint8_t b)
+    {
+      _bytes++;
+      if (!_file)
+        return;
+      _buffer[_used++] = b;
+      if (_used == ASSET_BLOCK)
+        flush();
+    }
+
+    void write(const uint8_t *data, uint32_t count)
+    {
+      while (count--)
+        put(*data++);
+    }
+
+    void flush()
+    {
+      if (_file && _used && _file->write(_buffer, _used) != (size_t) _used)
+        _failed = true;
+      _used = 0;
+    }
+
+    uint32_t getBytes()
+    {
+      return _bytes;
+    }
+
+    bool isFailed()
+    {
+      return _failed;
+    }
+
+  private:
+    fs::File *_file;
+    uint8_t *_buffer;
+    int _used = 0;
+    uint32_t _bytes = 0;
+    bool _failed = false;
+};
+
+// Runs of 3 pixels or more as one pixel and a count, the rest as they are
+class RleEncoder
+{
+  public:
+    RleEncoder(PackWriter &out) : _out(out) {}
+
+    void put(uint16_t color)
+    {
+      if (_run > 0 && color == _color && _run < 128)
+      {
+        _run++;
+        return;
+      }
+      flushRun();
+      _color = color;
+      _run = 1;
+    }
+
+    void finish()
+    {
+      flushRun();
+      flushLiterals();
+    }
+
+  private:
+    void flushRun()
+    {
+      if (_run >= 3)
+      {
+        flushLiterals();
+        _out.put(0x80 | (_run - 1));
+        _out.put(_color >> 8);
+        _out.put(_color & 0xFF);
+      }
+      else
+      {
+        for (int i = 0; i < _run; i++)
+        {
+          _literal[_literals++] = _color;
+          if (_literals == 128)
+            flushLiterals();
+        }
+      }
+      _run = 0;
+    }
+
+    void flushLiterals()
+    {
+      if (_literals == 0)
+        return;
+      _out.put(_literals - 1);
+      for (int i = 0; i < _literals; i++)
+      {
+        _out.put(_literal[i] >> 8);
+        _out.put(_literal[i] & 0xFF);
+      }
+      _literals = 0;
+    }
+
+    PackWriter &_out;
+    uint16_t _literal[128];
+    int _literals = 0;
+    uint16_t _color = 0;
+    int _run = 0;
+};
+
+static uint16_t get16(const uint8_t *p)
+{
+  return p[0] | p[1] << 8;
+}
+
+static uint32_t get32(const uint8_t *p)
+{
+  return get16(p) | (uint32_t) get16(p + 2) << 16;
+}
+
+// Whole header in one read. Uncompressed 24 bit bottom-up images only, as GfxUi::drawBmp()
+static bool readBmpHeader(fs::File &bmp, BmpInfo &info)
+{
+  uint8_t header[54];
+  if (bmp.read(header, sizeof(header)) != sizeof(header) || get16(header) != 0x4D42)
+    return false;
+
+  info.offset = get32(header + 10);
+  info.width = (int32_t) get32(header + 18);
+  info.height = (int32_t) get32(header + 22);
+  if (get16(header + 26) != 1 || get16(header + 28) != 24 || get32(header + 30) != 0)
+    return false;
+  if (info.width <= 0 || info.width > ASSET_MAX_WIDTH || info.height <= 0 || info.height > 0xFFFF)
+    return false;
+
+  info.rowSize = (info.width * 3 + 3) & ~3;
+  return bmp.size() >= info.offset + info.rowSize * info.height;
+}
+
+// BMP rows bottom up, out top down in RGB565 with the high byte first
+static bool convert(fs::File &bmp, const BmpInfo &info, uint8_t encoding, PackWriter &out)
+{
+  uint8_t *row = new uint8_t[info.rowSize];
+  RleEncoder rle(out);
+  bool ok = true;
+
+  for (int y = info.height - 1; y >= 0 && ok; y--)
+  {
+    bmp.seek(info.offset + y * info.rowSize, fs::SeekSet);
+    if (bmp.read(row, info.rowSize) != info.rowSize)
+    {
+      ok = false;
+      break;
+    }
+
+    // Blue, green, red
+    for (int x = 0; x < info.width; x++)
+    {
+      uint8_t *p = row + x * 3;
+      uint16_t color = ((p[2] & 0xF8) << 8) | ((p[1] & 0xFC) << 3) | (p[0] >> 3);
+      if (encoding == ASSET_RLE)
+        rle.put(color);
+      else
+      {
+        out.put(color >> 8);
+        out.put(color & 0xFF);
+      }
+    }
+  }
+  if (encoding == ASSET_RLE)
+    rle.finish();
+
+  delete[] row;
+  return ok;
+}
+
+AssetBundle::AssetBundle(TFT_eSPI *tft)
+{
+  _tft = tft;
+}
+
+AssetBundle::~AssetBundle()
+{
+  close();
+}
+
+// FNV-1a
+uint32_t AssetBundle::hash(const String &name)
+{
+  uint32_t h = 2166136261UL;
+  for (unsigned int i = 0; i < name.length(); i++)
+  {
+    h ^= (uint8_t) name[i];
+    h *= 16777619UL;
+  }
+  return h;
+}
+
+bool AssetBundle::contains(const String &name)
+{
+  AssetEntry entry;
+  return find(name, entry);
+}
+
+bool AssetBundle::draw(const String &name, int x, int y)
+{
+  AssetEntry entry;
+  if (!find(name, entry))
+    return false;
+
+  // File blocks in, display blocks out
+  uint8_t *in = new uint8_t[2 * ASSET_BLOCK];
+  if (!in)
+    return false;
+  uint8_t *out = in + ASSET_BLOCK;
+
+  //  TURBO mode, unless the caller is in it already
+  bool wasTurbo = isTurbo();
+  if (!wasTurbo)
+    setTurbo(true);
+
+  _tft->setWindow(x, y, x + entry.width - 1, y + entry.height - 1);
+  _file.seek(entry.offset, fs::SeekSet);
+
+  if (entry.encoding == ASSET_RAW)
+  {
+    uint32_t left = entry.size;
+    while (left > 0)
+    {
+      int n = _file.read(in, min(left, (uint32_t) ASSET_BLOCK));
+      if (n <= 0)
+        break;
+      _tft->pushColors(in, n);
+      left -= n;
+    }
+  }
+  else
+  {
+    // Packets decoded into whole blocks for the display
+    BlockReader reader(_file, in, entry.size);
+    uint32_t pixels = (uint32_t) entry.width * entry.height;
+    int used = 0;
+    while (pixels > 0)
+    {
+      int packet = reader.get();
+      if (packet < 0)
+        break;
+
+      uint32_t n = min((uint32_t) (packet & 0x7F) + 1, pixels);
+      bool run = packet & 0x80;
+      int hi = 0;
+      int lo = 0;
+      if (run)
+      {
+        hi = reader.get();
+        lo = reader.get();
+      }
+      for (uint32_t i = 0; i < n; i++)
+      {
+        if (!run)
+        {
+          hi = reader.get();
+          lo = reader.get();
+        }
+        out[used++] = hi;
+        out[used++] = lo;
+        if (used == ASSET_BLOCK)
+        {
+          _tft->pushColors(out, used);
+          used = 0;
+        }
+      }
+      pixels -= n;
+    }
+    if (used)
+      _tft->pushColors(out, used);
+  }
+
+  //  NORMAL mode
+  if (!wasTurbo)
+    setTurbo(false);
+
+  delete[] in;
+  return true;
+}
+
+int AssetBundle::pack(const String *names, int count, PackCallback packCallback)
+{
+  AssetEntry *table = new AssetEntry[ASSET_BUNDLE_SLOTS]();
+  bool *fresh = new bool[count]();
+  int packed = 0;
+  int total = 0;
+
+  // The BMP files there, each stored whichever way is smaller. Offsets come later
+  for (int i = 0; i < count; i++)
+  {
+    if (total == ASSET_BUNDLE_MAX_ASSETS || !SPIFFS.exists(names[i]))
+      continue;
+
+    fs::File bmp = SPIFFS.open(names[i], "r");
+    BmpInfo info;
+    if (!bmp || !readBmpHeader(bmp, info))
+    {
+      if (bmp)
+        bmp.close();
+      continue;
+    }
+
+    PackWriter counter(nullptr, nullptr);
+    convert(bmp, info, ASSET_RLE, counter);
+    bmp.close();
+
+    AssetEntry entry = {};
+    entry.hash = hash(names[i]);
+    entry.offset = 1;
+    entry.width = info.width;
+    entry.height = info.height;
+    uint32_t rawSize = (uint32_t) info.width * info.height * 2;
+    entry.encoding = counter.getBytes() < rawSize ? ASSET_RLE : ASSET_RAW;
+    entry.size = entry.encoding == ASSET_RLE ? counter.getBytes() : rawSize;
+    if (!insert(table, entry))
+    {
+      errLog(String(F("Asset name clash: ")) + names[i]);
+      continue;
+    }
+    fresh[i] = true;
+    total++;
+  }
+
+  if (total == 0)
+  {
+    delete[] table;
+    delete[] fresh;
+    return 0;
+  }
+
+  // Images packed before stay, unless they were just downloaded again
+  AssetEntry *old = new AssetEntry[ASSET_BUNDLE_SLOTS]();
+  if (open() && readTable(old))
+  {
+    for (int i = 0; i < ASSET_BUNDLE_SLOTS; i++)
+    {
+      if (old[i].offset == 0)
+        continue;
+      AssetEntry entry = old[i];
+      entry.offset = 1;
+      if (!insert(table, entry))
+        old[i].offset = 0;
+    }
+  }
+  else
+    memset(old, 0, ASSET_BUNDLE_SLOTS * sizeof(AssetEntry));
+
+  // Lay the images out: the old ones, then the new ones, in the order written below
+  uint32_t offset = ASSET_DATA_START;
+  uint16_t assets = 0;
+  for (int i = 0; i < ASSET_BUNDLE_SLOTS; i++)
+  {
+    if (old[i].offset == 0)
+      continue;
+    AssetEntry *entry = table + slotOf(table, old[i].hash);
+    entry->offset = offset;
+    offset += entry->size;
+    assets++;
+  }
+  for (int i = 0; i < count; i++)
+  {
+    if (!fresh[i])
+      continue;
+    AssetEntry *entry = table + slotOf(table, hash(names[i]));
+    entry->offset = offset;
+    offset += entry->size;
+    assets++;
+  }
+
+  //  TURBO mode, unless the caller is in it already
+  bool wasTurbo = isTurbo();
+  if (!wasTurbo)
+    setTurbo(true);
+
+  SPIFFS.remove(F(ASSET_BUNDLE_TEMP));
+  fs::File file = SPIFFS.open(F(ASSET_BUNDLE_TEMP), "w");
+  uint8_t *buffer = file ? new uint8_t[2 * ASSET_BLOCK] : nullptr;
+  bool ok = file && buffer;
+  if (file && !buffer)
+    file.close();
+  if (ok)
+  {
+    PackWriter out(&file, buffer + ASSET_BLOCK);
+    AssetBundleHeader header = {ASSET_BUNDLE_MAGIC, ASSET_BUNDLE_SLOTS, assets};
+    out.write((uint8_t *) &header, sizeof(header));
+    out.write((uint8_t *) table, ASSET_BUNDLE_SLOTS * sizeof(AssetEntry));
+
+    for (int i = 0; i < ASSET_BUNDLE_SLOTS && ok; i++)
+    {
+      if (old[i].offset == 0)
+        continue;
+      _file.seek(old[i].offset, fs::SeekSet);
+      BlockReader in(_file, buffer, old[i].size);
+      for (uint32_t n = 0; n < old[i].size && ok; n++)
+      {
+        int b = in.get();
+        ok = b >= 0;
+        out.put(b);
+      }
+    }
+
+    for (int i = 0; i < count && ok; i++)
+    {
+      if (!fresh[i])
+        continue;
+      AssetEntry &entry = table[slotOf(table, hash(names[i]))];
+      fs::File bmp = SPIFFS.open(names[i], "r");
+      BmpInfo info;
+      uint32_t start = out.getBytes();
+      ok = bmp && readBmpHeader(bmp, info) && convert(bmp, info, entry.encoding, out) && out.getBytes() - start == entry.size;
+      if (bmp)
+        bmp.close();
+      if (packCallback)
+        packCallback(names[i], ++packed, total);
+    }
+
+    out.flush();
+    ok = ok && !out.isFailed() && file.size() == offset;
+    file.close();
+  }
+
+  // A short file (full SPIFFS) changes nothing, the images stay as they were
+  close();
+  if (ok)
+  {
+    SPIFFS.remove(F(ASSET_BUNDLE_FILE));
+    ok = SPIFFS.rename(F(ASSET_BUNDLE_TEMP), F(ASSET_BUNDLE_FILE));
+  }
+  if (ok)
+  {
+    for (int i = 0; i < count; i++)
+    {
+      if (fresh[i])
+        SPIFFS.remove(names[i]);
+    }
+  }
+  else
+  {
+    SPIFFS.remove(F(ASSET_BUNDLE_TEMP));
+    errLog(F("Can't pack bitmaps"));
+    packed = 0;
+  }
+
+  //  NORMAL mode
+  if (!wasTurbo)
+    setTurbo(false);
+
+#ifdef DEBUG_SYSLOG
+  syslog.logf(LOG_DEBUG, "Packed %d bitmaps, bundle is %u bytes", packed, offset);
+#endif
+
+  delete[] buffer;
+  delete[] table;
+  delete[] old;
+  delete[] fresh;
+  return packed;
+}
+
+uint16_t AssetBundle::getCount()
+{
+  open();
+  return _count;
+}
+
+// Once, then kept open
+bool AssetBundle::open()
+{
+  if (_checked)
+    return (bool) _file;
+  _checked = true;
+
+  _file = SPIFFS.open(F(ASSET_BUNDLE_FILE), "r");
+  if (!_file)
+    return false;
+
+  AssetBundleHeader header;
+  if (_file.read((uint8_t *) &header, sizeof(header)) != sizeof(header) || header.magic != ASSET_BUNDLE_MAGIC
+      || header.slots != ASSET_BUNDLE_SLOTS || _file.size() < ASSET_DATA_START)
+  {
+    _file.close();
+    return false;
+  }
+  _count = header.count;
+  return true;
+}
+
+void AssetBundle::close()
+{
+  if (_file)
+    _file.close();
+  _checked = false;
+  _count = 0;
+}
+
+// Linear probing from the home slot of the hash, up to a free slot
+bool AssetBundle::find(const String &name, AssetEntry &entry)
+{
+  if (!open())
+    return false;
+
+  uint32_t h = hash(name);
+  uint32_t slot = h & (ASSET_BUNDLE_SLOTS - 1);
+  for (int i = 0; i < ASSET_BUNDLE_SLOTS; i++)
+  {
+    _file.seek(ASSET_TABLE_START + slot * sizeof(AssetEntry), fs::SeekSet);
+    if (_file.read((uint8_t *) &entry, sizeof(entry)) != sizeof(entry) || entry.offset == 0)
+      return false;
+    if (entry.hash == h)
+      return true;
+    slot = (slot + 1) & (ASSET_BUNDLE_SLOTS - 1);
+  }
+  return false;
+}
+
+bool AssetBundle::readTable(AssetEntry *table)
+{
+  _file.seek(ASSET_TABLE_START, fs::SeekSet);
+  return _file.read((uint8_t *) table, ASSET_BUNDLE_SLOTS * sizeof(AssetEntry)) == ASSET_BUNDLE_SLOTS * sizeof(AssetEntry);
+}
+
+// Slot holding the hash, or the free slot it would take
+int AssetBundle::slotOf(const AssetEntry *table, uint32_t hash)
+{
+  uint32_t slot = hash & (ASSET_BUNDLE_SLOTS - 1);
+  for (int i = 0; i < ASSET_BUNDLE_SLOTS; i++)
+  {
+    if (table[slot].offset == 0 || table[slot].hash == hash)
+      return slot;
+    slot = (slot + 1) & (ASSET_BUNDLE_SLOTS - 1);
+  }
+  return -1;
+}
+
+// False if the hash is there already, or the table is full
+bool AssetBundle::insert(AssetEntry *table, const AssetEntry &entry)
+{
+  int slot = slotOf(table, entry.hash);
+  if (slot < 0 || table[slot].offset != 0)
+    return false;
+  table[slot] = entry;
+  return true;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#define FS_NO_GLOBALS
+#include <FS.h>
+#include <TFT_eSPI.h>             // https://github.com/Bodmer/TFT_eSPI
+
+#define ASSET_BUNDLE_FILE "/assets.bin"
+#define ASSET_BUNDLE_TEMP "/assets.tmp"
+#define ASSET_BUNDLE_SLOTS 128        // hash table size, a power of two
+#define ASSET_BUNDLE_MAX_ASSETS 96    // table at most 3/4 full, probes stay short
+#define ASSET_BLOCK 512               // (bytes) file reads and display pushes, on the heap while drawing or packing
+#define ASSET_MAX_WIDTH 320           // (pixels) widest bitmap packed
+
+// Pixels as stored
+#define ASSET_RAW 0
+#define ASSET_RLE 1
+
+// One bitmap packed, done of total
+typedef void (*PackCallback)(String fileName, uint16_t done, uint16_t total);
+
+// -------------------------------------------------------
+// Packed bitmaps
+// -------------------------------------------------------
+//
+// The weather icons and moon phases live in one SPIFFS file instead of a
+// BMP file each. A header and an open addressing hash table of
+// ASSET_BUNDLE_SLOTS entries, keyed by the FNV-1a hash of the file name,
+// are followed by the images, top row first, already in the RGB565 byte
+// order the display takes. Images with large flat areas are run-length
+// coded: a count byte, top bit set for a run of one pixel repeated, clear
+// for that many pixels as they are; each image keeps whichever is
+// smaller. The bundle stays open, so drawing an image is a few table
+// reads and then straight block pushes to the display, without parsing
+// or converting anything.
+//
+// Bitmaps are downloaded as BMP files as before and packed in one go
+// afterwards, the BMP files are then removed. Anything not packed is
+// still drawn from its BMP file.
+
+struct AssetEntry
+{
+  uint32_t hash;        // of the file name
+  uint32_t offset;      // of the pixels in the bundle, 0 for a free slot
+  uint32_t size;        // (bytes) stored
+  uint16_t width;
+  uint16_t height;
+  uint8_t encoding;     // ASSET_RAW or ASSET_RLE
+  uint8_t reserved[3];
+};
+
+class AssetBundle
+{
+  public:
+    AssetBundle(TFT_eSPI *tft);
+    ~AssetBundle();
+
+    static uint32_t hash(const String &name);
+
+    bool contains(const String &name);
+
+    // Image of that file name with its top left corner at x, y. False if not in the bundle
+    bool draw(const String &name, int x, int y);
+
+    // Move the BMP files of the list that exist into the bundle, with those packed before.
+    // Returns how many were packed
+    int pack(const String *names, int count, PackCallback packCallback = nullptr);
+
+    uint16_t getCount();
+
+  private:
+    bool open();
+    void close();
+    bool find(const String &name, AssetEntry &entry);
+    bool readTable(AssetEntry *table);
+    static int slotOf(const AssetEntry *table, uint32_t hash);
+    static bool insert(AssetEntry *table, const AssetEntry &entry);
+
+    TFT_eSPI *_tft;
+    fs::File _file;
+    bool _checked = false;    // opened, or found missing, since the last pack
+    uint16_t _count = 0;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Arduino.h"
+
+// -------------------------------------------------------
+// Single producer / single consumer event ring
+// -------------------------------------------------------
+//
+// Lock free hand-over of events from an interrupt handler (producer) to a
+// process (consumer). The producer only writes _head, the consumer only
+// writes _tail, so neither side needs to mask interrupts.
+// SIZE must be a power of 2, one slot is always left free.
+
+template <typename T, uint16_t SIZE>
+class EventRing
+{
+    static_assert(SIZE >= 2 && (SIZE & (SIZE - 1)) == 0, "EventRing SIZE must be a power of 2");
+
+  public:
+    // Producer side (ISR). Returns false if the ring is full.
+    // Always inlined so it ends up in the caller's IRAM section
+    inline __attribute__((always_inline)) bool push(const T &event)
+    {
+      uint16_t head = _head;
+      uint16_t next = (head + 1) & (SIZE - 1);
+
+      if (next == _tail)
+        return false;
+
+      _events[head] = event;
+
+      // Publish the slot only once it has been written
+      barrier();
+      _head = next;
+      return true;
+    }
+
+    // Consumer side (process). Returns false if the ring is empty
+    bool pop(T &event)
+    {
+      uint16_t tail = _tail;
+
+      if (tail == _head)
+        return false;
+
+      barrier();
+      event = _events[tail];
+
+      // Free the slot only once it has been read
+      barrier();
+      _tail = (tail + 1) & (SIZE - 1);
+      return true;
+    }
+
+    uint16_t numElements() const
+    {
+      return (_head - _tail) & (SIZE - 1);
+    }
+
+    bool isEmpty() const
+    {
+      return _head == _tail;
+    }
+
+  private:
+    static inline __attribute__((always_inline)) void barrier()
+    {
+      __asm__ __volatile__("" ::: "memory");
+    }
+
+    T _events[SIZE];
+    volatile uint16_t _head = 0;
+    volatile uint16_t _tail = 0;
+};
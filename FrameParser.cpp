@@ -0,0 +1,179 @@
+#include "FrameParser.h"
+
+#define PMS7003_HEADER_SIZE 4   // header + 16 bit length
+#define MHZ19_FRAME_SIZE 9
+
+FrameParser::FrameParser(FrameFormat format)
+{
+  _format = format;
+
+  if (format == PMS7003_FRAME)
+  {
+    _header1 = 0x42;
+    _header2 = 0x4d;
+  }
+  else
+  {
+    _header1 = 0xFF;
+    _header2 = 0x86;
+  }
+}
+
+bool FrameParser::poll(Stream &stream)
+{
+  while (true)
+  {
+    bool done;
+
+    // Bytes left over by a resync come first, also after one in the middle of the stream
+    if (_replayPos < _replayCount)
+      done = feed(_replay[_replayPos++]);
+
+    // Then only what is already in the receive buffer, stop at the first complete frame
+    else if (stream.available() > 0)
+      done = feed((unsigned char) stream.read());
+    else
+      return false;
+
+    if (done)
+      return true;
+  }
+}
+
+void FrameParser::reset()
+{
+  _state = WAIT_HEADER1;
+  _received = 0;
+  _expected = 0;
+  _replayPos = 0;
+  _replayCount = 0;
+}
+
+const unsigned char *FrameParser::frame()
+{
+  return _buffer;
+}
+
+int FrameParser::frameSize()
+{
+  return _expected;
+}
+
+unsigned long FrameParser::getChecksumErrors()
+{
+  return _checksumErrors;
+}
+
+unsigned long FrameParser::getDiscardedBytes()
+{
+  return _discardedBytes;
+}
+
+bool FrameParser::feed(unsigned char c)
+{
+  switch (_state)
+  {
+    case WAIT_HEADER1:
+      if (c == _header1)
+      {
+        _buffer[0] = c;
+        _received = 1;
+        _state = WAIT_HEADER2;
+      }
+      else
+        _discardedBytes++;
+      break;
+
+    case WAIT_HEADER2:
+      if (c == _header2)
+      {
+        _buffer[1] = c;
+        _received = 2;
+        _expected = (_format == PMS7003_FRAME) ? PMS7003_HEADER_SIZE : MHZ19_FRAME_SIZE;
+        _state = READ_BODY;
+      }
+      else
+      {
+        _discardedBytes++;
+
+        // This byte may itself start a frame
+        _state = WAIT_HEADER1;
+        return feed(c);
+      }
+      break;
+
+    case READ_BODY:
+      _buffer[_received++] = c;
+
+      // PMS7003: frame size is known once the length field is in
+      if (_format == PMS7003_FRAME && _received == PMS7003_HEADER_SIZE)
+      {
+        _expected = PMS7003_HEADER_SIZE + ((_buffer[2] << 8) | _buffer[3]);
+        if (_expected < PMS7003_HEADER_SIZE + 2 || _expected > FRAME_PARSER_MAX_SIZE)
+        {
+          resync();
+          break;
+        }
+      }
+
+      if (_received == _expected)
+        return complete();
+      break;
+  }
+
+  return false;
+}
+
+bool FrameParser::complete()
+{
+  if (verifyChecksum())
+  {
+    // Frame stays in _buffer until the next byte is fed
+    _state = WAIT_HEADER1;
+    return true;
+  }
+
+  _checksumErrors++;
+  resync();
+  return false;
+}
+
+bool FrameParser::verifyChecksum()
+{
+  if (_format == PMS7003_FRAME)
+  {
+    unsigned int sum = 0;
+    for (int i = 0; i < _expected - 2; i++)
+      sum += _buffer[i];
+    return sum == (unsigned int) ((_buffer[_expected - 2] << 8) | _buffer[_expected - 1]);
+  }
+  else
+  {
+    unsigned char sum = 0;
+    for (int i = 1; i < MHZ19_FRAME_SIZE - 1; i++)
+      sum += _buffer[i];
+    return (unsigned char) (0xFF - sum + 1) == _buffer[MHZ19_FRAME_SIZE - 1];
+  }
+}
+
+// Bad frame: drop its first byte and queue the rest to be scanned again for a header.
+// Frame bytes plus pending replay bytes never exceed FRAME_PARSER_MAX_SIZE
+void FrameParser::resync()
+{
+  unsigned char pending[FRAME_PARSER_MAX_SIZE];
+  int count = 0;
+
+  for (int i = 1; i < _received; i++)
+    pending[count++] = _buffer[i];
+  while (_replayPos < _replayCount)
+    pending[count++] = _replay[_replayPos++];
+
+  memcpy(_replay, pending, count);
+  _replayPos = 0;
+  _replayCount = count;
+
+  _discardedBytes++;
+  _state = WAIT_HEADER1;
+  _received = 0;
+  _expected = 0;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Arduino.h"
+
+#define FRAME_PARSER_MAX_SIZE 32
+
+// -------------------------------------------------------
+// Incremental UART frame parser
+// -------------------------------------------------------
+//
+// Consumes whatever bytes are available on a stream, never waits for more.
+// Hunts for the 2 byte frame header, collects the frame and verifies its
+// checksum. On a bad frame it resyncs on the next header found in the bytes
+// already received.
+//
+//  PMS7003: 0x42 0x4d, 16 bit length, ..., 16 bit sum of all previous bytes
+//  MH-Z19:  0xFF 0x86, 9 bytes, 8 bit two's complement of sum of bytes 1..7
+
+class FrameParser
+{
+  public:
+    enum FrameFormat
+    {
+      PMS7003_FRAME,
+      MHZ19_FRAME
+    };
+
+    FrameParser(FrameFormat format);
+
+    // Feed the available bytes. True when a valid frame has been completed, see frame()
+    bool poll(Stream &stream);
+
+    // Drop any partial frame
+    void reset();
+
+    const unsigned char *frame();
+    int frameSize();
+
+    unsigned long getChecksumErrors();
+    unsigned long getDiscardedBytes();
+
+  private:
+    enum ParserState
+    {
+      WAIT_HEADER1,
+      WAIT_HEADER2,
+      READ_BODY
+    };
+
+    bool feed(unsigned char c);
+    bool complete();
+    bool verifyChecksum();
+    void resync();
+
+    FrameFormat _format;
+    unsigned char _header1;
+    unsigned char _header2;
+    ParserState _state = WAIT_HEADER1;
+    unsigned char _buffer[FRAME_PARSER_MAX_SIZE];
+    int _received = 0;
+    int _expected = 0;
+    unsigned char _replay[FRAME_PARSER_MAX_SIZE];
+    int _replayPos = 0;
+    int _replayCount = 0;
+    unsigned long _checksumErrors = 0;
+    unsigned long _discardedBytes = 0;
+};
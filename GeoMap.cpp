@@ -29,9 +29,8 @@
 extern Syslog syslog;
 extern WebResource webResource;
 
-GeoMap::GeoMap(MapProvider mapProvider, String apiKey, int mapWidth, int mapHeight) {
+GeoMap::GeoMap(MapProvider mapProvider, int mapWidth, int mapHeight) : tileCache_(TILE_CACHE_BUDGET) {
   mapProvider_ = mapProvider;
-  apiKey_ = apiKey;
   mapWidth_ = mapWidth;
   mapHeight_ = mapHeight;
 }
@@ -72,60 +71,100 @@ bool GeoMap::setMap(Coordinates mapCenter, int zoom)
   mapCenter_ = mapCenter;
   zoom_ = zoom;
 
-  return SPIFFS.exists(getMapName());
+  CoordinatesTiles centerTile = convertToTiles(mapCenter_);
+  originX_ = lround(centerTile.x * MAP_TILE_SIZE) - mapWidth_ / 2;
+  originY_ = lround(centerTile.y * MAP_TILE_SIZE) - mapHeight_ / 2;
+
+  // Touch them all, they are the most recently used now
+  bool cached = true;
+  for (int i = 0; i < getTileCount(); i++)
+  {
+    if (!tileCache_.touch(zoom_, getTileX(i), getTileY(i)))
+      cached = false;
+  }
+  tileCache_.save();
+
+  return cached;
 }
 
 
 void GeoMap::downloadMap(ProgressCallback progressCallback)
 {
+  // All missing tiles at once, ahead of background downloads, they come down one connection
+  for (int i = 0; i < getTileCount(); i++)
+  {
+    if (!tileCache_.touch(zoom_, getTileX(i), getTileY(i)))
+      webResource.enqueue(getTileUrl(getTileX(i), getTileY(i)), getTileName(i), true);
+  }
+  webResource.finish(nullptr, progressCallback, true);
+
+  for (int i = 0; i < getTileCount(); i++)
+  {
+    if (!tileCache_.touch(zoom_, getTileX(i), getTileY(i)))
+      tileCache_.add(zoom_, getTileX(i), getTileY(i));
+  }
+  tileCache_.save();
+
+#ifdef DEBUG_SYSLOG
+  syslog.logf(LOG_DEBUG, "Map tiles cached: %d, %u bytes", tileCache_.getTileCount(), tileCache_.getUsedBytes());
+#endif
+}
+
+String GeoMap::getTileUrl(uint32_t x, uint32_t y)
+{
+  String service;
   switch (mapProvider_) {
-    case MapProvider::MapQuest:
-      /*     downloadFile("http://open.mapquestapi.com/staticmap/v4/getmap?key=" + apiKey_ + "&type=map&scalebar=false&size="
-                        + String(mapWidth_) + "," + String(mapHeight_) + "&zoom=" + String(zoom_) + "&center=" + String(mapCenter_.lat) + "," + String(mapCenter_.lon), getMapName(), progressCallback);
-      */
-      webResource.downloadFile("http://open.mapquestapi.com/staticmap/v4/getmap?key="
-                               + apiKey_
-                               + F("&type=map&scalebar=false&size=")
-                               + String(mapWidth_)
-                               + F(",")
-                               + String(mapHeight_)
-                               + F("&zoom=")
-                               + String(zoom_)
-                               + F("&center=")
-                               + String(mapCenter_.lat)
-                               + F(",")
-                               + String(mapCenter_.lon), getMapName(), progressCallback);
+    case MapProvider::ArcGisStreet:
+      service = F("World_Street_Map");
       break;
-    case MapProvider::Google:
-      webResource.downloadFile("http://maps.googleapis.com/maps/api/staticmap?key="
-                               + apiKey_
-                               + F("&center=")
-                               + String(mapCenter_.lat)
-                               + F(",")
-                               + String(mapCenter_.lon)
-                               + F("&zoom=")
-                               + String(zoom_)
-                               + F("&size=")
-                               + String(mapWidth_)
-                               + F("x")
-                               + String(mapHeight_)
-                               + F("&format=jpg-baseline&maptype=roadmap"), getMapName(), progressCallback);
+    case MapProvider::ArcGisTopo:
+      service = F("World_Topo_Map");
       break;
   }
 
+  // Note the order: zoom, row, column
+  return String(F("http://server.arcgisonline.com/ArcGIS/rest/services/")) + service + F("/MapServer/tile/")
+         + String(zoom_) + "/" + String(y) + "/" + String(x);
 }
 
 String GeoMap::getMapName() {
-  return "/map" + String(mapCenter_.lat) + "_" + String(mapCenter_.lon) + "_" + String(zoom_) + ".jpg";
+  return String(mapProvider_) + "_" + String(zoom_) + "_" + String(originX_) + "_" + String(originY_);
+}
+
+int GeoMap::getTileColumns() {
+  return (originX_ + mapWidth_ - 1) / MAP_TILE_SIZE - originX_ / MAP_TILE_SIZE + 1;
+}
+
+int GeoMap::getTileCount() {
+  int rows = (originY_ + mapHeight_ - 1) / MAP_TILE_SIZE - originY_ / MAP_TILE_SIZE + 1;
+  return getTileColumns() * rows;
+}
+
+uint32_t GeoMap::getTileX(int i) {
+  return originX_ / MAP_TILE_SIZE + i % getTileColumns();
+}
+
+uint32_t GeoMap::getTileY(int i) {
+  return originY_ / MAP_TILE_SIZE + i / getTileColumns();
+}
+
+String GeoMap::getTileName(int i) {
+  return TileCache::getTileName(zoom_, getTileX(i), getTileY(i));
+}
+
+CoordinatesPixel GeoMap::getTileOrigin(int i) {
+  CoordinatesPixel origin;
+  origin.x = getTileX(i) * MAP_TILE_SIZE - originX_;
+  origin.y = getTileY(i) * MAP_TILE_SIZE - originY_;
+  return origin;
 }
 
 CoordinatesPixel GeoMap::convertToPixel(Coordinates coordinates)
 {
-  CoordinatesTiles centerTile = convertToTiles(mapCenter_);
   CoordinatesTiles poiTile = convertToTiles(coordinates);
   CoordinatesPixel poiPixel;
-  poiPixel.x = (poiTile.x - centerTile.x) * MAPQUEST_TILE_LENGTH + mapWidth_ / 2;
-  poiPixel.y = (poiTile.y - centerTile.y) * MAPQUEST_TILE_LENGTH + mapHeight_ / 2 + TOP_BAR_HEIGHT;
+  poiPixel.x = lround(poiTile.x * MAP_TILE_SIZE) - originX_;
+  poiPixel.y = lround(poiTile.y * MAP_TILE_SIZE) - originY_ + TOP_BAR_HEIGHT;
   return poiPixel;
 }
 
@@ -155,11 +194,9 @@ Coordinates GeoMap::convertToCoordinatesFromTiles(CoordinatesTiles tiles) {
 }
 
 Coordinates GeoMap::convertToCoordinates(CoordinatesPixel poiPixel) {
-  CoordinatesTiles centerTile = convertToTiles(mapCenter_);
   CoordinatesTiles poiTile;
-  //-#ifdef DEBUG_SERIAL Serial.println(String(centerTile.x, 9) + ", " + String(centerTile.y, 9));
-  poiTile.x = ((poiPixel.x - (mapWidth_ / 2.0)) / MAPQUEST_TILE_LENGTH) + centerTile.x;
-  poiTile.y = ((poiPixel.y - (mapHeight_ / 2.0)) / MAPQUEST_TILE_LENGTH) + centerTile.y;
+  poiTile.x = (double) (poiPixel.x + originX_) / MAP_TILE_SIZE;
+  poiTile.y = (double) (poiPixel.y + originY_) / MAP_TILE_SIZE;
   //-#ifdef DEBUG_SERIAL Serial.println(String(poiTile.x, 9) + ", " + String(poiTile.y, 9));
   Coordinates poiCoordinates = convertToCoordinatesFromTiles(poiTile);
   return poiCoordinates;
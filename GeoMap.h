@@ -35,13 +35,16 @@
 #include "ScreenPlaneSpotterSettings.h"
 #include "WebResource.h"
 
-#define MAPQUEST_TILE_LENGTH 256.0
+#include "TileCache.h"
+
+#define MAP_TILE_SIZE 256     // (pixels) web mercator tiles
 
 //typedef void (*ProgressCallback)(String fileName, uint32_t bytesDownloaded, uint32_t bytesTotal);
 
+// Tile servers handing out JPEG tiles, the only format the decoder takes
 enum MapProvider {
-  MapQuest,
-  Google
+  ArcGisStreet,
+  ArcGisTopo
 };
 
 struct Coordinates {
@@ -59,31 +62,45 @@ struct CoordinatesTiles {
   double y;
 };
 
+// The map is cut from the 256 pixel tiles covering it, kept in a TileCache
+// between views and reboots. Its top left corner is a whole pixel of the
+// zoom level, so tiles and overlays line up exactly.
 class GeoMap {
   private:
     MapProvider mapProvider_;
-    String apiKey_;
     int mapWidth_, mapHeight_;
     long zoom_;
     Coordinates mapCenter_;
-    // WebResource webResource;
+    long originX_, originY_;    // (pixels) top left corner at this zoom
+    TileCache tileCache_;
+
+    int getTileColumns();
+    uint32_t getTileX(int i);
+    uint32_t getTileY(int i);
+    String getTileUrl(uint32_t x, uint32_t y);
 
   public:
-    GeoMap(MapProvider mapProvider, String apiKey, int mapWidth, int mapHeight);
+    GeoMap(MapProvider mapProvider, int mapWidth, int mapHeight);
     ~GeoMap();
     void downloadMap(ProgressCallback progressCallback);
     void downloadMap();
+
+    // True if all the tiles of the view are cached
     bool setMap(Coordinates mapCenter, int zoom);
 
+    // Identifies the view: provider, zoom and corner
     String getMapName();
+
+    // Tiles covering the view, row by row, with their corner relative to the map
+    int getTileCount();
+    String getTileName(int i);
+    CoordinatesPixel getTileOrigin(int i);
+
     CoordinatesPixel convertToPixel(Coordinates coordinates);
     Coordinates convertToCoordinates(CoordinatesPixel coordinatesPixel);
     CoordinatesTiles convertToTiles(Coordinates coordinates);
     Coordinates convertToCoordinatesFromTiles(CoordinatesTiles tiles);
-    // void downloadFile(String url, String filename, ProgressCallback progressCallback);
-    // void downloadFile(String url, String filename);
     int getMapWidth();
     int getMapHeight();
 
 };
-
@@ -25,10 +25,14 @@
 */
 
 #include "GfxUi.h"
+#include "AssetBundle.h"
 
 #define min(a,b)     (((a) < (b)) ? (a) : (b))
 
 
+// External variables
+extern AssetBundle assets;
+
 // Prototypes
 void setTurbo(bool setTurbo);
 bool isTurbo();
@@ -54,6 +58,19 @@ void GfxUi::drawProgressBar(uint16_t x0, uint16_t y0, uint16_t w, uint16_t h, ui
 // https://github.com/adafruit/Adafruit_ILI9341/blob/master/examples/spitftbitmap/spitftbitmap.ino
 // Here is Bodmer's version: this uses the ILI9341 CGRAM coordinate rotation features inside the display and
 // buffers both file and TFT pixel blocks, it typically runs about 2x faster for bottom up encoded BMP images
+// Now reads as many whole rows as fit in BMP_BLOCK per SPIFFS call, and 16 bit RGB565 images
+// (bit fields F800/07E0/001F) go to the display as they are read, without any conversion.
+// 24 bit rows are converted in place: pixel n is written at byte 2n, never ahead of byte 3n read
+
+static uint16_t get16(const uint8_t *p)
+{
+  return p[0] | p[1] << 8;
+}
+
+static uint32_t get32(const uint8_t *p)
+{
+  return get16(p) | (uint32_t) get16(p + 2) << 16;
+}
 
 //void GfxUi::drawBMP(String filename, uint8_t x, uint16_t y, bool flip) { // Alernative for caller control of flip
 void GfxUi::drawBmp(String filename, uint8_t x, uint16_t y)
@@ -64,148 +81,118 @@ void GfxUi::drawBmp(String filename, uint8_t x, uint16_t y)
 
   if ((x >= _tft->width()) || (y >= _tft->height())) return;
 
-  fs::File bmpFile;
-  int16_t  bmpWidth, bmpHeight;   // Image W+H in pixels
-  uint32_t bmpImageoffset;        // Start address of image data in file
-  uint32_t rowSize;               // Not always = bmpWidth; may have padding
-  uint8_t  sdbuffer[3 * BUFFPIXEL];    // file read pixel buffer (8 bits each R+G+B per pixel)
-  uint16_t tftbuffer[BUFFPIXEL];       // TFT pixel out buffer (16-bit per pixel)
-  uint8_t  rgb_ptr = sizeof(sdbuffer); // read 24 bit RGB pixel data buffer pointer (8 bit so BUFF_SIZE must be less than 86)
-  bool  goodBmp = false;            // Flag set to true on valid header parse
-  int16_t  w, h, row, col;             // to store width, height, row and column
-  uint8_t rotation;      // to restore rotation
-  uint8_t  tft_ptr = 0;  // TFT 16 bit 565 format pixel data buffer pointer
+  // Packed already: straight to the display
+  if (assets.draw(filename, x, y)) return;
 
   // Check file exists and open it
 #ifdef DEBUG_SERIAL 
   Serial.println(filename);
 #endif
-  if ( !(bmpFile = SPIFFS.open(filename, "r")) ) {
+  fs::File bmpFile = SPIFFS.open(filename, "r");
+  if (!bmpFile) {
 #ifdef DEBUG_SERIAL 
     Serial.println(F(" File not found")); // Can comment out if not needed
 #endif
     return;
   }
 
-  //  TURBO mode
-  setTurbo(true);
-
-  // Parse BMP header to get the information we need
-  if (read16(bmpFile) == 0x4D42)
-  { // BMP file start signature check
-    read32(bmpFile);       // Dummy read to throw away and move on
-    read32(bmpFile);       // Read & ignore creator bytes
-    bmpImageoffset = read32(bmpFile); // Start of image data
-    read32(bmpFile);       // Dummy read to throw away and move on
-    bmpWidth  = read32(bmpFile);  // Image width
-    bmpHeight = read32(bmpFile);  // Image height
-
-    // Only proceed if we pass a bitmap file check
-    // Number of image planes -- must be '1', depth 24 and 0 (uncompressed format)
-    if ((read16(bmpFile) == 1) && (read16(bmpFile) == 24) && (read32(bmpFile) == 0)) {
-      goodBmp = true; // Supported BMP format
-      // BMP rows are padded (if needed) to 4-byte boundary
-      rowSize = (bmpWidth * 3 + 3) & ~3;
-      // Crop area to be loaded
-      w = bmpWidth;
-      h = bmpHeight;
-
-      // We might need to alter rotation to avoid tedious file pointer manipulation
-      // Save the current value so we can restore it later
-      rotation = _tft->getRotation();
-      // Use TFT SGRAM coord rotation if flip is set for 25% faster rendering (new rotations 4-7 supported by library)
-      if (flip) _tft->setRotation((rotation + (flip << 2)) % 8); // Value 0-3 mapped to 4-7
-
-      // Calculate new y plot coordinate if we are flipping
-      switch (rotation) {
-        case 0:
-          if (flip) y = _tft->height() - y - h; break;
-        case 1:
-          y = _tft->height() - y - h; break;
-          break;
-        case 2:
-          if (flip) y = _tft->height() - y - h; break;
-          break;
-        case 3:
-          y = _tft->height() - y - h; break;
-          break;
-      }
-
-      // Set TFT address window to image bounds
-      // Currently, image will not draw or will be corrputed if it does not fit
-      // TODO -> efficient clipping, but I don't need it to be idiot proof ;-)
-      _tft->setAddrWindow(x, y, x + w - 1, y + h - 1);
-
-      // Finally we are ready to send rows of pixels, writing like this avoids slow 32 bit multiply in 8 bit processors
-      for (uint32_t pos = bmpImageoffset; pos < bmpImageoffset + h * rowSize ; pos += rowSize) {
-        // Seek if we need to on boundaries and arrange to dump buffer and start again
-        if (bmpFile.position() != pos) {
-          bmpFile.seek(pos, fs::SeekSet);
-          rgb_ptr = sizeof(sdbuffer);
-        }
-
-        // Fill the pixel buffer and plot
-        for (col = 0; col < w; col++) { // For each column...
-          // Time to read more pixel data?
-          if (rgb_ptr >= sizeof(sdbuffer)) {
-            // Push tft buffer to the display
-            if (tft_ptr) {
-              // Here we are sending a uint16_t array to the function
-              _tft->pushColors(tftbuffer, tft_ptr);
-              tft_ptr = 0; // tft_ptr and rgb_ptr are not always in sync...
-            }
-            // Finally reading bytes from SD Card
-            bmpFile.read(sdbuffer, sizeof(sdbuffer));
-            rgb_ptr = 0; // Set buffer index to start
-          }
-          // Convert pixel from BMP 8+8+8 format to TFT compatible 16 bit word
-          // Blue 5 bits, green 6 bits and red 5 bits (16 bits total)
-          // Is is a long line but it is faster than calling a library fn for this
-          tftbuffer[tft_ptr] = (sdbuffer[rgb_ptr++] >> 3) ;
-          tftbuffer[tft_ptr] |= ((sdbuffer[rgb_ptr++] & 0xFC) << 3);
-          tftbuffer[tft_ptr] |= ((sdbuffer[rgb_ptr++] & 0xF8) << 8);
-          tft_ptr++;
-        } // Next row
-      }   // All rows done
-
-      // Write any partially full buffer to TFT
-      if (tft_ptr) _tft->pushColors(tftbuffer, tft_ptr);
-
-    } // End of bitmap access
-  }   // End of bitmap file check
-
-
-  bmpFile.close();
-
+  // Parse BMP header in one read: file header, info header and the bit fields that follow it
+  uint8_t header[66];
+  int headerSize = bmpFile.read(header, sizeof(header));
+  uint32_t bmpImageoffset = get32(header + 10);  // Start of image data
+  int32_t bmpWidth = get32(header + 18);         // Image width
+  int32_t bmpHeight = get32(header + 22);        // Image height
+  uint16_t depth = get16(header + 28);
+  uint32_t compression = get32(header + 30);
+
+  // 24 bit uncompressed, or 16 bit with the RGB565 bit fields
+  bool bgr888 = depth == 24 && compression == 0;
+  bool rgb565 = depth == 16 && compression == 3 && headerSize == sizeof(header)
+                && get32(header + 54) == 0xF800 && get32(header + 58) == 0x07E0 && get32(header + 62) == 0x001F;
+
+  if (headerSize < 54 || get16(header) != 0x4D42 || get16(header + 26) != 1 || !(bgr888 || rgb565)
+      || bmpWidth <= 0 || bmpWidth > BMP_MAX_WIDTH || bmpHeight <= 0) {
+    bmpFile.close();
 #ifdef DEBUG_SERIAL 
-  if (!goodBmp)
     Serial.println(F("BMP format not recognised."));
 #endif
+    return;
+  }
 
-  _tft->setRotation(rotation); // Put back original rotation
+  // BMP rows are padded (if needed) to 4-byte boundary
+  uint32_t rowSize = (bmpWidth * depth / 8 + 3) & ~3;
+  int rowsPerBlock = BMP_BLOCK / rowSize;
+  int16_t w = bmpWidth;
+  int16_t h = bmpHeight;
 
-  //  NORMAL mode
-  setTurbo(false);
-}
+  // File rows in, display pixels out. Words, so a block of RGB565 rows can be pushed as it is
+  uint16_t *bmpBlock = new uint16_t[BMP_BLOCK / 2];
+  if (!bmpBlock) {
+    bmpFile.close();
+    return;
+  }
 
-// These read 16- and 32-bit types from the SD card file.
-// BMP data is stored little-endian, Arduino is little-endian too.
-// May need to reverse subscript order if porting elsewhere.
+  //  TURBO mode, unless the caller is in it already
+  bool wasTurbo = isTurbo();
+  if (!wasTurbo) setTurbo(true);
+
+  // We might need to alter rotation to avoid tedious file pointer manipulation
+  // Save the current value so we can restore it later
+  uint8_t rotation = _tft->getRotation();
+  // Use TFT SGRAM coord rotation if flip is set for 25% faster rendering (new rotations 4-7 supported by library)
+  if (flip) _tft->setRotation((rotation + (flip << 2)) % 8); // Value 0-3 mapped to 4-7
+
+  // Calculate new y plot coordinate if we are flipping
+  switch (rotation) {
+    case 0:
+      if (flip) y = _tft->height() - y - h; break;
+    case 1:
+      y = _tft->height() - y - h; break;
+      break;
+    case 2:
+      if (flip) y = _tft->height() - y - h; break;
+      break;
+    case 3:
+      y = _tft->height() - y - h; break;
+      break;
+  }
 
-uint16_t GfxUi::read16(fs::File &f) {
-  uint16_t result;
-  ((uint8_t *)&result)[0] = f.read(); // LSB
-  ((uint8_t *)&result)[1] = f.read(); // MSB
-  return result;
-}
+  // Set TFT address window to image bounds
+  // Currently, image will not draw or will be corrputed if it does not fit
+  // TODO -> efficient clipping, but I don't need it to be idiot proof ;-)
+  _tft->setAddrWindow(x, y, x + w - 1, y + h - 1);
+
+  // Rows are in display order once flipped: read them a block at a time, straight through
+  bmpFile.seek(bmpImageoffset, fs::SeekSet);
+  for (int row = 0; row < h; row += rowsPerBlock) {
+    int rows = min(rowsPerBlock, h - row);
+    if (bmpFile.read((uint8_t *) bmpBlock, rows * rowSize) != rows * rowSize) break;
+
+    if (rgb565) {
+      // Little endian words as the CPU has them, unpadded rows go out in one push
+      if (rowSize == (uint32_t) w * 2) _tft->pushColors(bmpBlock, w * rows);
+      else for (int r = 0; r < rows; r++) _tft->pushColors(bmpBlock + r * rowSize / 2, w);
+      continue;
+    }
 
-uint32_t GfxUi::read32(fs::File &f) {
-  uint32_t result;
-  ((uint8_t *)&result)[0] = f.read(); // LSB
-  ((uint8_t *)&result)[1] = f.read();
-  ((uint8_t *)&result)[2] = f.read();
-  ((uint8_t *)&result)[3] = f.read(); // MSB
-  return result;
+    for (int r = 0; r < rows; r++) {
+      uint16_t *line = bmpBlock + r * rowSize / 2;
+      const uint8_t *bgr = (const uint8_t *) line;
+      // Convert pixel from BMP 8+8+8 format to TFT compatible 16 bit word
+      // Blue 5 bits, green 6 bits and red 5 bits (16 bits total)
+      for (int col = 0; col < w; col++, bgr += 3)
+        line[col] = (bgr[0] >> 3) | ((bgr[1] & 0xFC) << 3) | ((bgr[2] & 0xF8) << 8);
+      _tft->pushColors(line, w);
+    }
+  }
+
+  delete[] bmpBlock;
+  bmpFile.close();
+
+  _tft->setRotation(rotation); // Put back original rotation
+
+  //  NORMAL mode
+  if (!wasTurbo) setTurbo(false);
 }
 
 /*====================================================================================
@@ -466,7 +453,7 @@ void GfxUi::fillSegment(int x, int y, int start_angle, int sub_angle, int r, uns
 // colour = 16 bit colour value
 // Note if rx and ry are the same then an arc of a circle is drawn
 
-int GfxUi::fillArc(int x, int y, int start_angle, int seg_count, int rx, int ry, int w, unsigned int colour)
+void GfxUi::fillArc(int x, int y, int start_angle, int seg_count, int rx, int ry, int w, unsigned int colour)
 {
 
   byte seg = 6; // Segments are 3 degrees wide = 120 segments for 360 degrees
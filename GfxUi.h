@@ -30,10 +30,11 @@
 #ifndef _GFX_UI_H
 #define _GFX_UI_H
 
-// Maximum of 85 for BUFFPIXEL as 3 x this value is stored in an 8 bit variable!
-// 32 is an efficient size for SPIFFS due to SPI hardware pipeline buffer size
-// A larger value of 80 is better for SD cards
-#define BUFFPIXEL 32
+// SPIFFS reads for drawBmp() take as many whole rows as fit in this, each read call costs
+// about as much as a hundred bytes more; the widest row (24 bit, 320 pixels) has to fit.
+// On the heap while an image is drawn
+#define BMP_BLOCK 1200
+#define BMP_MAX_WIDTH 320
 
 class GfxUi
 {
@@ -45,7 +46,7 @@ class GfxUi
 
     void drawSeparator(uint16_t y);
     void fillSegment(int x, int y, int start_angle, int sub_angle, int r, unsigned int colour);
-    int fillArc(int x, int y, int start_angle, int seg_count, int rx, int ry, int w, unsigned int colour);
+    void fillArc(int x, int y, int start_angle, int seg_count, int rx, int ry, int w, unsigned int colour);
 
     void drawBitmap(const unsigned short * icon, uint16_t x, uint16_t y, uint16_t width, uint16_t height);
 
@@ -61,8 +62,6 @@ class GfxUi
   protected:
 
     TFT_eSPI * _tft;
-    uint16_t read16(fs::File &f);
-    uint32_t read32(fs::File &f);
 
 };
 
@@ -4,7 +4,14 @@
 #include "P_MQTT.h"
 #include "P_AirSensors.h"
 #include "P_GeoLocation.h"
+#include "P_History.h"
+#include "P_Downloader.h"
+#include "P_Animator.h"
+#include "SensorRegistry.h"
+#include "PowerManager.h"
+#include "I2CBus.h"
 #include "WundergroundClient.h"
+#include "AdsbExchangeClient.h"
 #include <RingBufCPP.h>           //https://github.com/wizard97/Embedded_RingBuf_CPP
 
 // -------------------------------------------------------
@@ -48,12 +55,23 @@
 #define VOLT_LOW 3.2
 #define VOLT_HIGH 3.9
 
-#define AVERAGING_WINDOW 12         // NOTE: 12 * 5 sec sensor sampling rate = 1 minute
-
-#define FAST_SAMPLE_PERIOD 2000     // (ms) Used for Geiger sensor 
+#define FAST_SAMPLE_PERIOD 2000     // (ms) Used for Geiger sensor and screen
 #define SLOW_SAMPLE_PERIOD 5000     // (ms) Used for other sensors 
+#define ADAPTIVE_MIN_PERIOD 2000    // (ms) fastest sensor sampling, during a transient
+#define ADAPTIVE_MAX_PERIOD 30000   // (ms) slowest sensor sampling, while the signal is flat
+#define ADAPTIVE_AIR_MAX_PERIOD 10000   // (ms) same for CO2 and particles, whose transients (breath, cooking) come fastest
 #define MQTT_UPDATE_PERIOD 60000    // (ms)
+#define MQTT_POLL_PERIOD 1000       // (ms) MQTT process period, checks whether an update or a retry is due
+#define MQTT_DIAG_PERIOD 300000     // (ms) process statistics on the diagnostics topic
 #define GEOLOC_RETRY_PERIOD 10000   // (ms)
+#define HISTORY_SAMPLE_PERIOD 5000  // (ms) Raw history resolution
+#define DOWNLOAD_PERIOD 50          // (ms) between slices of background downloading
+#define ANIMATION_FRAME_PERIOD 40   // (ms) between frames of a screen animation
+#define DOWNLOAD_IDLE_PERIOD 1000   // (ms) between looks at an empty download queue
+
+// MQTT payload formats
+#define MQTT_FORMAT_TEXT 0          // "1=..&2=.." on three topics
+#define MQTT_FORMAT_BINARY 1        // one packed record on topic 1, see Telemetry.h
 
 // -------------------------------------------------------
 //  Global constants
@@ -70,6 +88,22 @@ const char PROGMEM ntpServerName[] = "pool.ntp.org";
 // Holds pointers to processes
 struct ProcessContainer
 {
+  // Built in place: a process can't be copied or moved, its monitor is linked by address
+  ProcessContainer(Scheduler &sched)
+    : ComboTemperatureHumiditySensor(sched, MEDIUM_PRIORITY, SLOW_SAMPLE_PERIOD, RUNTIME_FOREVER),
+      ComboPressureHumiditySensor(sched, MEDIUM_PRIORITY, SLOW_SAMPLE_PERIOD, RUNTIME_FOREVER),
+      CO2Sensor(sched, MEDIUM_PRIORITY, SLOW_SAMPLE_PERIOD, RUNTIME_FOREVER),
+      ParticleSensor(sched, MEDIUM_PRIORITY, SLOW_SAMPLE_PERIOD, RUNTIME_FOREVER),
+      VOCSensor(sched, MEDIUM_PRIORITY, SLOW_SAMPLE_PERIOD, RUNTIME_FOREVER),
+      MultiGasSensor(sched, MEDIUM_PRIORITY, SLOW_SAMPLE_PERIOD, RUNTIME_FOREVER),
+      GeigerSensor(sched, MEDIUM_PRIORITY, FAST_SAMPLE_PERIOD, RUNTIME_FOREVER),
+      UIManager(sched, HIGH_PRIORITY, SLOW_SAMPLE_PERIOD, RUNTIME_FOREVER),
+      MQTTUpdate(sched, MEDIUM_PRIORITY, MQTT_POLL_PERIOD, RUNTIME_FOREVER),
+      GeoLocation(sched, MEDIUM_PRIORITY, GEOLOC_RETRY_PERIOD, RUNTIME_FOREVER),
+      History(sched, LOW_PRIORITY, HISTORY_SAMPLE_PERIOD, RUNTIME_FOREVER),
+      Downloader(sched, LOW_PRIORITY, DOWNLOAD_PERIOD, RUNTIME_FOREVER),
+      Animator(sched, HIGH_PRIORITY, ANIMATION_FRAME_PERIOD, RUNTIME_FOREVER) {}
+
   // Members
 
   Proc_ComboTemperatureHumiditySensor ComboTemperatureHumiditySensor ;
@@ -82,6 +116,9 @@ struct ProcessContainer
   Proc_UIManager UIManager;
   Proc_MQTTUpdate MQTTUpdate;
   Proc_GeoLocation GeoLocation;
+  Proc_History History;
+  Proc_Downloader Downloader;
+  Proc_Animator Animator;
 
 };
 
@@ -93,10 +130,14 @@ struct Configuration
   char mqtt_topic1[64];
   char mqtt_topic2[64];
   char mqtt_topic3[64];
+  char mqtt_diag_topic[64] = "";
   char mqtt_server[40];
   char syslog_server[20];
+  uint8_t mqttFormat = MQTT_FORMAT_TEXT;
+  uint8_t powerMode = POWER_MODE_MODEM_SLEEP;
   WundergroundClient *wunderground;
   bool wunderValid = false;
+  AdsbExchangeClient *adsbClient = nullptr;   // created when the Plane Spotter is first shown, then kept
   bool configValid = false;
 };
 
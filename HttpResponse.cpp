@@ -0,0 +1,221 @@
+#include "HttpResponse.h"
+
+uint8_t HttpResponse::_sharedBuffer[HTTP_BUFFER_SIZE];
+
+HttpResponse::HttpResponse(Client &client, unsigned long timeout, uint8_t *buffer) : _client(client)
+{
+  _timeout = timeout;
+  _buffer = buffer ? buffer : _sharedBuffer;
+}
+
+void HttpResponse::next()
+{
+  _status = 0;
+  _contentLength = -1;
+  _chunked = false;
+  _keepAlive = true;
+  _firstChunk = true;
+  _left = 0;
+  _ended = false;
+  _complete = false;
+}
+
+void HttpResponse::clear()
+{
+  next();
+  _pos = 0;
+  _end = 0;
+}
+
+// Bytes, or the end of a body of known length, to read without waiting
+bool HttpResponse::isReady()
+{
+  if (_pos < _end || _client.available() > 0 || _ended)
+    return true;
+  return _status && !_chunked && _contentLength >= 0 && _left == 0;
+}
+
+// Wait for bytes if the buffer is empty, then take all that fit in one read
+bool HttpResponse::fill()
+{
+  if (_pos < _end)
+    return true;
+
+  unsigned long start = millis();
+  while (true)
+  {
+    int ready = _client.available();
+    if (ready > 0)
+    {
+      int count = _client.read(_buffer, ready < HTTP_BUFFER_SIZE ? ready : HTTP_BUFFER_SIZE);
+      if (count > 0)
+      {
+        _pos = 0;
+        _end = count;
+        return true;
+      }
+    }
+
+    // Closed with nothing left, or nothing for too long
+    if (!_client.connected() || millis() - start >= _timeout)
+      return false;
+
+    delay(1);
+  }
+}
+
+int HttpResponse::readByte()
+{
+  if (!fill())
+    return -1;
+  return _buffer[_pos++];
+}
+
+// One line without its CR LF, cut to HTTP_LINE_SIZE - 1 characters
+bool HttpResponse::readLine(char *line)
+{
+  int length = 0;
+  while (true)
+  {
+    int c = readByte();
+    if (c < 0)
+      return false;
+    if (c == '\n')
+      break;
+    if (c != '\r' && length < HTTP_LINE_SIZE - 1)
+      line[length++] = c;
+  }
+  line[length] = 0;
+  return true;
+}
+
+bool HttpResponse::begin()
+{
+  char line[HTTP_LINE_SIZE];
+
+  // HTTP/1.1 200 OK
+  if (!readLine(line) || strncmp(line, "HTTP/", 5) != 0)
+    return false;
+  char *space = strchr(line, ' ');
+  _status = space ? atoi(space + 1) : 0;
+  _keepAlive = strncmp(line, "HTTP/1.0", 8) != 0;
+
+  // Headers up to the empty line
+  while (true)
+  {
+    if (!readLine(line))
+      return false;
+    if (!line[0])
+      break;
+
+    char *colon = strchr(line, ':');
+    if (!colon)
+      continue;
+    *colon = 0;
+    char *value = colon + 1;
+    while (*value == ' ')
+      value++;
+
+    if (strcasecmp(line, "Content-Length") == 0)
+      _contentLength = atol(value);
+    else if (strcasecmp(line, "Transfer-Encoding") == 0 && strncasecmp(value, "chunked", 7) == 0)
+      _chunked = true;
+    else if (strcasecmp(line, "Connection") == 0)
+      _keepAlive = strncasecmp(value, "close", 5) != 0;
+  }
+
+  _left = _chunked ? 0 : _contentLength;
+  return true;
+}
+
+int HttpResponse::getStatus()
+{
+  return _status;
+}
+
+long HttpResponse::getContentLength()
+{
+  return _contentLength;
+}
+
+bool HttpResponse::isChunked()
+{
+  return _chunked;
+}
+
+bool HttpResponse::isKeepAlive()
+{
+  return _keepAlive;
+}
+
+int HttpResponse::read(const uint8_t *&data)
+{
+  if (_ended)
+    return 0;
+
+  if (_chunked && _left == 0)
+  {
+    char line[HTTP_LINE_SIZE];
+
+    // CR LF closing the previous chunk, then the size of the next one (hex, maybe with extensions)
+    if ((!_firstChunk && !readLine(line)) || !readLine(line))
+    {
+      _ended = true;
+      return 0;
+    }
+    _firstChunk = false;
+    _left = strtol(line, nullptr, 16);
+
+    // Last chunk: skip the trailers
+    if (_left <= 0)
+    {
+      while (readLine(line) && line[0])
+        ;
+      _ended = true;
+      _complete = true;
+      return 0;
+    }
+  }
+  else if (!_chunked && _contentLength >= 0 && _left == 0)
+  {
+    _ended = true;
+    _complete = true;
+    return 0;
+  }
+
+  if (!fill())
+  {
+    // Without a length, the body ends when the server closes
+    _ended = true;
+    _complete = !_chunked && _contentLength < 0 && !_client.connected();
+    return 0;
+  }
+
+  int count = _end - _pos;
+  if ((_chunked || _contentLength >= 0) && count > _left)
+    count = _left;
+
+  data = _buffer + _pos;
+  _pos += count;
+  if (_chunked || _contentLength >= 0)
+    _left -= count;
+
+  return count;
+}
+
+bool HttpResponse::parse(JsonStreamingParser &parser)
+{
+  const uint8_t *data;
+  int count;
+  while ((count = read(data)) > 0)
+  {
+    for (int i = 0; i < count; i++)
+      parser.parse(data[i]);
+  }
+  return _complete;
+}
+
+bool HttpResponse::isComplete()
+{
+  return _complete;
+}
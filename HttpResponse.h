@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Arduino.h"
+#include <WiFiClient.h>
+#include <JsonStreamingParser.h>  // https://github.com/squix78/json-streaming-parser
+
+#define HTTP_BUFFER_SIZE 512      // (bytes) shared read buffer
+#define HTTP_LINE_SIZE 96         // (bytes) longest header line kept, longer ones are cut
+#define HTTP_TIMEOUT 10000        // (ms) longest wait for the next bytes
+
+// -------------------------------------------------------
+// HTTP response reader
+// -------------------------------------------------------
+//
+// Reads the response to a request already sent on client: status line and
+// headers first, then the body in spans straight out of one shared buffer,
+// filled with bulk reads. Chunked bodies are decoded on the way.
+// The body ends at Content-Length, at the last chunk or when the server
+// closes; waiting for data sleeps in short delays and gives up after the
+// timeout, so a dead connection never spins.
+// Only one response can be read at a time from the shared buffer; a reader
+// that keeps a response open across process runs brings its own.
+// On a kept-alive connection next() moves on to the following response,
+// keeping the bytes of it already buffered.
+
+class HttpResponse
+{
+  public:
+    // buffer: HTTP_BUFFER_SIZE bytes, the shared one if none
+    HttpResponse(Client &client, unsigned long timeout = HTTP_TIMEOUT, uint8_t *buffer = nullptr);
+
+    // Status line and headers. False on timeout or if the server closed first
+    bool begin();
+
+    // Following response on the same connection
+    void next();
+
+    // New connection: drop what is buffered too
+    void clear();
+
+    // Something to read without waiting: bytes, or the end of the body
+    bool isReady();
+
+    int getStatus();
+    long getContentLength();   // -1 if not given
+    bool isChunked();
+    bool isKeepAlive();        // the server leaves the connection open after this response
+
+    // Next span of body bytes, valid until the next call. 0 at the end of the body
+    int read(const uint8_t *&data);
+
+    // Whole body into a JSON parser. True if complete
+    bool parse(JsonStreamingParser &parser);
+
+    // Whole body read up to its end (not cut by a timeout or a closed connection)
+    bool isComplete();
+
+  private:
+    bool fill();
+    int readByte();
+    bool readLine(char *line);
+
+    Client &_client;
+    unsigned long _timeout;
+    int _status = 0;
+    long _contentLength = -1;
+    bool _chunked = false;
+    bool _keepAlive = true;
+    bool _firstChunk = true;
+    long _left = 0;            // bytes left in the body (Content-Length) or in the current chunk
+    bool _ended = false;
+    bool _complete = false;
+    uint16_t _pos = 0;
+    uint16_t _end = 0;
+    uint8_t *_buffer;
+
+    static uint8_t _sharedBuffer[HTTP_BUFFER_SIZE];
+};
@@ -0,0 +1,139 @@
+#include "I2CBus.h"
+
+#include <Wire.h>
+
+// Prototypes
+void errLog(String msg);
+
+// Timeouts cover the conversion delays of the drivers, e.g. 9 ms per HDC1080 register
+const I2CDevice I2CBus::devices[I2C_DEVICE_COUNT] =
+{
+  { "HDC1080", 0x40, 40000 },
+  { "BME280", 0x76, 10000 },
+  { "MultiGas", 0x04, 10000 },
+  { "PAJ7620", 0x73, 30000 },
+  { "MAX17043", 0x36, 5000 }
+};
+
+void I2CBus::begin(uint8_t sda, uint8_t scl)
+{
+  this->sda = sda;
+  this->scl = scl;
+
+  // A slave may still be mid-byte from before a reset of the ESP8266
+  pinMode(sda, INPUT_PULLUP);
+  if (digitalRead(sda) == LOW)
+    recover();
+
+  Wire.begin(sda, scl);
+  Wire.setClockStretchLimit(I2C_STRETCH_LIMIT);
+}
+
+bool I2CBus::acquire(uint8_t device)
+{
+  I2CDeviceStats &s = stats[device];
+
+  if (owner >= 0 || (s.consecutiveErrors >= I2C_MAX_ERRORS && (int32_t) (millis() - retryAt[device]) < 0))
+  {
+    s.skipped++;
+    return false;
+  }
+
+  owner = device;
+  startMicros = micros();
+  return true;
+}
+
+void I2CBus::release(uint8_t device, bool ok)
+{
+  uint32_t elapsed = micros() - startMicros;
+  I2CDeviceStats &s = stats[device];
+  owner = -1;
+
+  s.transactions++;
+  s.totalMicros += elapsed;
+  if (elapsed > s.maxMicros)
+    s.maxMicros = elapsed;
+
+  if (elapsed > devices[device].timeout)
+  {
+    s.timeouts++;
+    ok = false;
+  }
+
+  // Nobody else gets through while SDA is held, free it right away
+  if (digitalRead(sda) == LOW)
+  {
+    ok = false;
+    recover();
+  }
+
+  if (ok)
+  {
+    if (s.consecutiveErrors >= I2C_MAX_ERRORS)
+      errLog(String(devices[device].name) + F(" answering again"));
+    s.consecutiveErrors = 0;
+    backoff[device] = 0;
+    return;
+  }
+
+  s.errors++;
+  if (s.consecutiveErrors < UINT16_MAX)
+    s.consecutiveErrors++;
+
+  if (s.consecutiveErrors >= I2C_MAX_ERRORS)
+  {
+    if (s.consecutiveErrors == I2C_MAX_ERRORS)
+      errLog(String(devices[device].name) + F(" failing, skipped for a while"));
+
+    backoff[device] = backoff[device] ? min(backoff[device] * 2, (uint32_t) I2C_MAX_BACKOFF) : I2C_BACKOFF;
+    retryAt[device] = millis() + backoff[device];
+  }
+}
+
+bool I2CBus::recover()
+{
+  recoveries++;
+
+  pinMode(sda, INPUT_PULLUP);
+  pinMode(scl, OUTPUT_OPEN_DRAIN);
+  digitalWrite(scl, HIGH);
+
+  // Each clock lets the slave shift out one more bit, a byte and its ACK at most
+  for (int i = 0; i < I2C_RECOVERY_CLOCKS && digitalRead(sda) == LOW; i++)
+  {
+    digitalWrite(scl, LOW);
+    delayMicroseconds(5);
+    digitalWrite(scl, HIGH);
+    delayMicroseconds(5);
+  }
+
+  // STOP: SDA rises while SCL is high
+  pinMode(sda, OUTPUT_OPEN_DRAIN);
+  digitalWrite(sda, LOW);
+  delayMicroseconds(5);
+  digitalWrite(sda, HIGH);
+  delayMicroseconds(5);
+
+  Wire.begin(sda, scl);
+  Wire.setClockStretchLimit(I2C_STRETCH_LIMIT);
+
+  bool released = digitalRead(sda) == HIGH;
+  errLog(released ? F("I2C bus recovered") : F("I2C bus stuck, SDA held low"));
+  return released;
+}
+
+bool I2CBus::isHealthy(uint8_t device)
+{
+  return stats[device].consecutiveErrors == 0;
+}
+
+const I2CDeviceStats &I2CBus::getStats(uint8_t device)
+{
+  return stats[device];
+}
+
+unsigned long I2CBus::getRecoveries()
+{
+  return recoveries;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "Arduino.h"
+
+#define I2C_STRETCH_LIMIT 1500        // (us) longest clock stretch per byte, bounds a hung transaction
+#define I2C_MAX_ERRORS 3              // consecutive failures before a device is skipped
+#define I2C_BACKOFF 5000              // (ms) first skip period of a failing device, doubled on each further failure
+#define I2C_MAX_BACKOFF 300000        // (ms)
+#define I2C_RECOVERY_CLOCKS 9         // SCL pulses that release any slave stopped mid-byte
+
+// Devices sharing the bus, index into I2CBus::devices
+enum I2CDeviceId
+{
+  I2C_HDC1080,
+  I2C_BME280,
+  I2C_MULTIGAS,
+  I2C_GESTURE,
+  I2C_FUEL_GAUGE,
+  I2C_DEVICE_COUNT
+};
+
+struct I2CDevice
+{
+  const char *name;
+  uint8_t address;
+  uint32_t timeout;                   // (us) longest transaction expected, driver delays included
+};
+
+struct I2CDeviceStats
+{
+  uint32_t transactions;
+  uint32_t errors;                    // failed, timeouts included
+  uint32_t timeouts;                  // took longer than the device timeout
+  uint32_t skipped;                   // not attempted, the device was backing off
+  uint64_t totalMicros;
+  uint32_t maxMicros;
+  uint16_t consecutiveErrors;
+};
+
+// -------------------------------------------------------
+// I2C bus arbiter
+// -------------------------------------------------------
+//
+// HDC1080, BME280, MiCS6814, PAJ7620 and MAX17043 share one Wire bus, each
+// driven by its own library from a different process. Every use of a
+// device is wrapped in an I2CTransaction: the bus is handed to one device
+// at a time, the transaction is timed against the timeout of the device,
+// and the caller tells whether the driver saw an error. A device that
+// fails I2C_MAX_ERRORS times in a row is skipped for a backoff period that
+// doubles while it keeps failing, so a dead or slow sensor costs one try
+// per period instead of its timeouts on every run.
+//
+// A slave reset or interrupted mid-byte can hold SDA low and block every
+// other device. When SDA is found low after a transaction, recover()
+// clocks SCL until the slave lets go and ends with a STOP.
+//
+// The scheduler runs one process at a time, so requests never wait for
+// each other: acquire() only refuses a nested use of the bus.
+
+class I2CBus
+{
+  public:
+    void begin(uint8_t sda, uint8_t scl);
+
+    // Bus to device, false if the device is backing off or the bus is already held
+    bool acquire(uint8_t device);
+
+    // End of the transaction started by acquire(), ok false if the driver saw an error
+    void release(uint8_t device, bool ok);
+
+    // Clock a stuck slave free and send a STOP, true if SDA is released
+    bool recover();
+
+    // Answered its last transaction, or was not tried yet
+    bool isHealthy(uint8_t device);
+
+    const I2CDeviceStats &getStats(uint8_t device);
+    unsigned long getRecoveries();
+
+    static const I2CDevice devices[I2C_DEVICE_COUNT];
+
+  private:
+    uint8_t sda = 0;
+    uint8_t scl = 0;
+    int8_t owner = -1;                // device holding the bus, -1 if free
+    uint32_t startMicros = 0;
+
+    I2CDeviceStats stats[I2C_DEVICE_COUNT] = {};
+    uint32_t backoff[I2C_DEVICE_COUNT] = {};   // (ms) current skip period, 0 while healthy
+    uint32_t retryAt[I2C_DEVICE_COUNT] = {};   // (ms) end of the skip period
+    unsigned long recoveries = 0;
+};
+
+// Holds the bus for one device over the enclosing scope
+class I2CTransaction
+{
+  public:
+    I2CTransaction(I2CBus &bus, uint8_t device) : _bus(bus), _device(device) { _granted = _bus.acquire(_device); }
+    ~I2CTransaction() { if (_granted) _bus.release(_device, _ok); }
+
+    // False if the device is to be left alone this time
+    bool granted() { return _granted; }
+
+    // The driver reported an error, or the data read makes no sense
+    void fail() { _ok = false; }
+
+  private:
+    I2CBus &_bus;
+    uint8_t _device;
+    bool _granted;
+    bool _ok = true;
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "Arduino.h"
+
+// -------------------------------------------------------
+// Compile-time JSON key tables
+// -------------------------------------------------------
+//
+// Maps the keys a JSON listener cares about to small ids with a perfect
+// hash the compiler builds: FNV-1a of the key, times a multiplier searched
+// at compile time so that no two keys land in the same slot. A lookup is
+// one pass over the key, a multiply and a compare against the stored hash,
+// so dispatch costs the same for every key and allocates nothing.
+// Id 0 is any other key; keys[i] gets id i + 1.
+//
+// The ESP8266 core 2.x compiles sketches as C++11, so everything evaluated
+// at compile time is a single return statement: loops are recursions, kept
+// shallow enough for the compiler's constexpr depth limit (512).
+
+constexpr uint32_t jsonKeyHash(const char *key, uint32_t hash = 2166136261u)
+{
+  return *key ? jsonKeyHash(key + 1, (hash ^ (uint8_t) *key) * 16777619u) : hash;
+}
+
+// 0, 1 .. N - 1 as a parameter pack, to fill the tables element by element
+template <size_t... I> struct JsonKeyIndices {};
+template <size_t N, size_t... I> struct JsonKeyMakeIndices : JsonKeyMakeIndices<N - 1, N - 1, I...> {};
+template <size_t... I> struct JsonKeyMakeIndices<0, I...>
+{
+  typedef JsonKeyIndices<I...> type;
+};
+
+// Hashes of a key table's keys, computed once for the multiplier search
+template <size_t COUNT>
+struct JsonKeyHashes
+{
+  uint32_t values[COUNT];
+};
+
+template <size_t COUNT, uint8_t BITS>
+class JsonKeyTable
+{
+    static_assert(COUNT < 255 && COUNT <= (1u << BITS), "Too many keys for the table");
+
+    typedef const char *const (&Keys)[COUNT];
+    typedef JsonKeyHashes<COUNT> Hashes;
+
+  public:
+    constexpr JsonKeyTable(Keys keys)
+      : JsonKeyTable(hash(keys, typename JsonKeyMakeIndices<COUNT>::type())) {}
+
+    // False if no multiplier spreads the keys, the table needs more bits
+    constexpr bool isPerfect() const
+    {
+      return _multiplier != 0;
+    }
+
+    uint8_t lookup(const char *key) const
+    {
+      uint32_t hash = jsonKeyHash(key);
+      uint8_t id = _slots[slot(hash, _multiplier)];
+      return id && _hashes.values[id - 1] == hash ? id : 0;
+    }
+
+  private:
+    constexpr JsonKeyTable(const Hashes &hashes)
+      : JsonKeyTable(hashes, search(hashes, 1, 0x20000), typename JsonKeyMakeIndices<(1u << BITS)>::type()) {}
+
+    template <size_t... S>
+    constexpr JsonKeyTable(const Hashes &hashes, uint32_t multiplier, JsonKeyIndices<S...>)
+      : _hashes(hashes), _slots { owner(hashes, S, 0, multiplier)... }, _multiplier(multiplier) {}
+
+    template <size_t... K>
+    static constexpr Hashes hash(Keys keys, JsonKeyIndices<K...>)
+    {
+      return Hashes { { jsonKeyHash(keys[K])... } };
+    }
+
+    static constexpr uint8_t slot(uint32_t hash, uint32_t multiplier)
+    {
+      return (uint32_t)(hash * multiplier) >> (32 - BITS);
+    }
+
+    // Key i shares its slot with key j or a later one
+    static constexpr bool collides(const Hashes &hashes, size_t i, size_t j, uint32_t multiplier)
+    {
+      return j < COUNT && (slot(hashes.values[i], multiplier) == slot(hashes.values[j], multiplier)
+                           || collides(hashes, i, j + 1, multiplier));
+    }
+
+    // Keys from i on all have a slot of their own
+    static constexpr bool spreads(const Hashes &hashes, size_t i, uint32_t multiplier)
+    {
+      return i >= COUNT || (!collides(hashes, i, i + 1, multiplier) && spreads(hashes, i + 1, multiplier));
+    }
+
+    // First of count odd multipliers from first that spreads the keys, 0 if none.
+    // Halving the range keeps the recursion depth at log2(count)
+    static constexpr uint32_t search(const Hashes &hashes, uint32_t first, uint32_t count)
+    {
+      return count == 1 ? (spreads(hashes, 0, first) ? first : 0)
+             : searchOn(search(hashes, first, count / 2), hashes, first + 2 * (count / 2), count - count / 2);
+    }
+
+    static constexpr uint32_t searchOn(uint32_t found, const Hashes &hashes, uint32_t first, uint32_t count)
+    {
+      return found ? found : search(hashes, first, count);
+    }
+
+    // Id of the key in slot s, from key i on
+    static constexpr uint8_t owner(const Hashes &hashes, size_t s, size_t i, uint32_t multiplier)
+    {
+      return i >= COUNT ? 0 : slot(hashes.values[i], multiplier) == s ? i + 1 : owner(hashes, s, i + 1, multiplier);
+    }
+
+    Hashes _hashes;
+    uint8_t _slots[1u << BITS];
+    uint32_t _multiplier;
+};
+
+// Copies up to length characters of value, cut to fit size, always terminated
+inline void copyJsonValue(char *dest, size_t size, const char *value, size_t length = (size_t) -1)
+{
+  size_t n = 0;
+  while (n < length && n < size - 1 && value[n])
+  {
+    dest[n] = value[n];
+    n++;
+  }
+  dest[n] = 0;
+}
@@ -1,4 +1,3 @@
-
 #include "LogChart.h"
 #include "TFT_eSPI.h"
 #include "artwork.h"
@@ -6,154 +5,149 @@
 // External variables
 extern TFT_eSPI LCD;
 
+uint16_t LogChart::_block[LOGCHART_BLOCK];
+
+// Background, minor and major grid lines
+static const uint16_t gridColours[3] = {TFT_BLACK, TFT_GREY, TFT_RED};
+
+// log10(1.0 .. 10.0 in steps of 0.1) * 4096
+static const uint16_t log10Table[91] PROGMEM = {
+  0, 170, 324, 467, 599, 721, 836, 944, 1046, 1142, 1233, 1320, 1403, 1482, 1557, 1630,
+  1700, 1767, 1832, 1894, 1954, 2013, 2069, 2124, 2177, 2229, 2279, 2327, 2375, 2421, 2466,
+  2510, 2553, 2595, 2636, 2676, 2715, 2753, 2790, 2827, 2863, 2898, 2933, 2967, 3000, 3033,
+  3065, 3096, 3127, 3157, 3187, 3217, 3246, 3274, 3302, 3330, 3357, 3384, 3410, 3436, 3462,
+  3487, 3512, 3536, 3560, 3584, 3608, 3631, 3654, 3677, 3699, 3721, 3743, 3765, 3786, 3807,
+  3828, 3848, 3869, 3889, 3909, 3928, 3948, 3967, 3986, 4005, 4023, 4042, 4060, 4078, 4096
+};
+
 
 LogChart::LogChart(int topY, int height, int numDecades)
 {
 
   _topY = topY;
-  _height = height;
-  _decadeHeight = float(height) / float(numDecades);
+  _height = min(height, LOGCHART_MAX_HEIGHT);
+  _decadeHeight = float(_height) / float(numDecades);
   _numDecades = numDecades;
 
+  for (int i = 0; i < BUFFER_DEPTH; i++)
+    _values[i] = LOGCHART_NONE;
+
+  // Grid rows, from the bottom up
+
+  memset(_grid, 0, sizeof(_grid));
+
+  // linear portion
+  _grid[_height] = 2;
+  for (int i = 1; i < 10; i ++)
+    _grid[int(_height - _decadeHeight * i / 10.0)] = 1;
+
+  // Logarithmic portion
+  for (int div = 1; div <= 9; div++)
+  {
+    for (int dec = 1; dec < _numDecades; dec ++)
+      _grid[int(_height - _decadeHeight * (logs[div]  +  dec))] = (div == 1) ? 2 : 1;
+  }
+
+  // Handle highest line
+  _grid[_height - _decadeHeight * _numDecades] = 2;
 }
 
 void LogChart::begin()
 {
-  drawDiv(true);
-  // LCD.drawRect(0, _topY - 1, LCD.width(), _numDecades * _decadeHeight + 2, TFT_RED);
+  LCD.setFreeFont(&Dialog_plain_9);
+  LCD.setTextColor(TFT_WHITE, TFT_BLACK);
+  LCD.setTextDatum(BL_DATUM);
 
-  // Loop through all existing elements (if any) to redraw element in new positions
-  // This is to accommodate screen rotation...
-  for ( int x = buf.numElements(); x > 0; x--)
+  // Decade labels
+  LCD.drawString(F("0"), 2, _topY + _height);
+  long label = 1;
+  for (int dec = 1; dec <= _numDecades; dec++)
   {
-    // Retrieve element
-    int y = *buf.peek(x - 1);
-
-    // If not negative...
-    if (y > -1)
-      // Draw it in new position
-      LCD.drawPixel(HOFFSET + x - 1, _topY + _height -  y , TFT_YELLOW);
+    label *= 10;
+    LCD.drawString(String(label), 2, _topY + _height - _decadeHeight * dec);
   }
+
+  // Grid and existing points (if any), also after a screen rotation
+  drawColumns(0, BUFFER_DEPTH);
 }
 
 
 void LogChart::drawPoint(int value)
 {
-  int chartValue, num, first, x, y;
+  int column = _cursor;
+  _values[column] = chartValue(value);
+  _cursor = (_cursor + 1) % BUFFER_DEPTH;
 
-  chartValue = -1;
-
-  // Handle linear and log portions of the chart
-  if (value >= 10)
-    chartValue = log10(value) * _decadeHeight;
+  // The new point and the gap after it, where the oldest point was
+  if (_cursor)
+    drawColumns(column, 2);
   else
-    chartValue = value * _decadeHeight / 10.0 ;
-
-  // If off chart, dont draw it
-  if (chartValue > pow(10, _numDecades))
-    chartValue = -1;
-
-  // If still not full, just draw point
-  num = buf.numElements();
-  if (num < BUFFER_DEPTH)
   {
-    // If not negative, draw it
-    if (chartValue > -1)
-      LCD.drawPixel(HOFFSET + num, _topY + _height - chartValue, TFT_YELLOW);
+    drawColumns(column, 1);
+    drawColumns(0, 1);
   }
+}
 
-  // if full
-  else
+// Pixels above the bottom line: linear up to 10, then a decade every _decadeHeight
+int LogChart::chartValue(int value)
+{
+  if (value < 0)
+    return LOGCHART_NONE;
+  if (value < 10)
+    return value * _decadeHeight / 10;
+
+  // log10(value) is decades + log10(m / 100), m the first three digits of value
+  uint32_t m = value;
+  long decades = 2;
+  if (m < 100)
   {
-
-    // Remove oldest (outgoing) element on leftmost position
-    //first;
-    buf.pull(&first);
-
-    // If not negative, Erase it from screen
-    if (first > -1)
-    {
-      Serial.println("First = " + String(first));
-      LCD.drawPixel(HOFFSET, _topY + _height -  first, first = 0 ? TFT_RED : TFT_BLACK);
-    }
-
-    // Loop through all elements to erase old
-    for (x = buf.numElements(); x > 0; x--)
-    {
-      // Retrieve element
-      y = *buf.peek(x - 1);
-
-      // If not negative...
-      if (y > -1)
-        // Erase it from prior position
-        if ((x >= 0) && (x < BUFFER_DEPTH))
-          LCD.drawPixel(HOFFSET + x, _topY + _height -  y , y = 0 ? TFT_RED : TFT_BLACK);
-    }
-
-    // Draw grid
-    drawDiv (false);
-
-    // Draw new point
-    LCD.drawPixel(HOFFSET + BUFFER_DEPTH - 1, _topY + _height - chartValue , TFT_YELLOW);
-
-    // Loop through all elements to redraw element in new positions
-    for ( x = buf.numElements(); x > 0; x--)
-    {
-      // Retrieve element
-      y = *buf.peek(x - 1);
-
-      // If not negative...
-      if (y > -1)
-        // Draw it in new position
-        LCD.drawPixel(HOFFSET + x - 1, _topY + _height -  y , TFT_YELLOW);
-    }
+    m *= 10;
+    decades = 1;
+  }
+  while (m >= 1000)
+  {
+    m /= 10;
+    decades++;
   }
 
-  // Add new element to buffer
-  buf.add(chartValue);
-}
+  // Table by the first two digits, interpolated on the third
+  int i = m / 10 - 10;
+  long low = pgm_read_word(&log10Table[i]);
+  long high = pgm_read_word(&log10Table[i + 1]);
+  long logValue = (decades << 12) + low + (high - low) * (m % 10) / 10;
 
+  // If off chart, dont draw it
+  int chartValue = (logValue * _decadeHeight) >> 12;
+  if (chartValue > _decadeHeight * _numDecades)
+    return LOGCHART_NONE;
+  return chartValue;
+}
 
-void LogChart::drawDiv(bool axis)
+// Columns first .. first + count - 1 in one window, as many rows per push as fit the block
+void LogChart::drawColumns(int first, int count)
 {
-  int div, color, dec ;
-  float divCoord;
-
-  LCD.setFreeFont(&Dialog_plain_9);
-  LCD.setTextColor(TFT_WHITE, TFT_BLACK);
-  LCD.setTextDatum(BL_DATUM);
-
+  int rowsPerBlock = LOGCHART_BLOCK / count;
+  LCD.setWindow(HOFFSET + first, _topY, HOFFSET + first + count - 1, _topY + _height);
 
-  // linear portion
-  LCD.drawFastHLine(HOFFSET, _topY + _height, BUFFER_DEPTH, TFT_RED);
-
-  for (int i = 1; i < 10; i ++)
+  int row = 0;
+  while (row <= _height)
   {
-    LCD.drawFastHLine(HOFFSET, _topY + _height - _decadeHeight * i / 10.0, BUFFER_DEPTH, TFT_GREY);
-  }
-  if (axis)
-    LCD.drawString(F("0"), 2, _topY + _height);
-
-  // Logarithmic portion
-  for (div = 1; div <= 9; div++)
-  {
-    // float divCoord = log10(div);
-    divCoord = logs[div];
-    color = (div == 1) ? TFT_RED : TFT_GREY;
-
-    for (dec = 1; dec < _numDecades; dec ++)
+    int rows = min(rowsPerBlock, _height + 1 - row);
+    uint16_t *p = _block;
+    for (int r = row; r < row + rows; r++)
     {
-      // x, y , w, c
-      LCD.drawFastHLine(HOFFSET, _topY + _height - _decadeHeight * (divCoord  +  dec), BUFFER_DEPTH, color);
-      if (axis && div == 1)
-      {
-        LCD.drawString(String(div * pow(10, dec), 0), 2, _topY + _height - _decadeHeight * (divCoord  +  dec));
-      }
+      for (int column = first; column < first + count; column++)
+        *p++ = pixel(column, r);
     }
+    LCD.pushColors(_block, rows * count);
+    row += rows;
   }
-  // Handle highest line
-  LCD.drawFastHLine(HOFFSET, _topY + _height - _decadeHeight * _numDecades, BUFFER_DEPTH, TFT_RED);
-  if (axis)
-    LCD.drawString(String(pow(10, _numDecades), 0), 2, _topY + _height - _decadeHeight * _numDecades);
 }
 
+// Point or grid, none in the gap under the cursor
+uint16_t LogChart::pixel(int column, int row)
+{
+  if (column != _cursor && _values[column] != LOGCHART_NONE && _values[column] == _height - row)
+    return TFT_YELLOW;
+  return gridColours[_grid[row]];
+}
@@ -1,13 +1,27 @@
-
 #pragma once
 
 #include "Arduino.h"
-#include <RingBufCPP.h> //https://github.com/wizard97/Embedded_RingBuf_CPP
 
 #define TFT_GREY 0x5AEB
 #define BUFFER_DEPTH 195
 #define SCREEN_WIDTH 240
 #define HOFFSET 44
+#define LOGCHART_MAX_HEIGHT 160       // (pixels)
+#define LOGCHART_BLOCK 256            // (pixels) composed per push
+#define LOGCHART_NONE -1              // no point in the column, or off chart
+
+// -------------------------------------------------------
+// Logarithmic chart
+// -------------------------------------------------------
+//
+// Points go into a ring of BUFFER_DEPTH columns, like a sweep recorder:
+// each new point is written at the cursor, which then moves one column
+// right and wraps around. The column under the cursor is left blank, so
+// the newest point is always just left of the gap and the oldest just
+// right of it. Adding a point redraws only its column and the gap, as
+// one window composed from the grid and the points; nothing scrolls.
+// The grid rows are worked out once in the constructor, and values are
+// scaled with a log10 table, without any float maths per point.
 
 class LogChart
 {
@@ -17,15 +31,18 @@ class LogChart
     void drawPoint(int value);
 
   private:
-    // Stack allocate the buffer to hold event structs
-    RingBufCPP<int, BUFFER_DEPTH> buf;
+    int chartValue(int value);
+    void drawColumns(int first, int count);
+    uint16_t pixel(int column, int row);
 
-    void drawDiv(bool axis = false );
+    int16_t _values[BUFFER_DEPTH];    // chart value of each column's point
+    int _cursor = 0;                  // next column written, shown blank
 
     int _topY;
     int _height;
     int _decadeHeight;
     int _numDecades;
+    uint8_t _grid[LOGCHART_MAX_HEIGHT + 1];   // colour of each row, top down, an index in gridColours
 
     const float logs[11] = { -1,                   // 0
                              0,                    // 1
@@ -40,6 +57,5 @@ class LogChart
                              1                     // 10
                            };
 
+    static uint16_t _block[LOGCHART_BLOCK];
 };
-
-
@@ -0,0 +1,275 @@
+#include "MapBackground.h"
+#include <JPEGDecoder.h>          // https://github.com/Bodmer/JPEGDecoder
+
+// Prototypes
+void setTurbo(bool setTurbo);
+void errLog(String msg);
+
+uint8_t MapBackground::_line[MAP_BACKGROUND_MAX_WIDTH * 2];
+
+MapBackground::MapBackground(TFT_eSPI *tft, int x, int y, int width, int height)
+{
+  _tft = tft;
+  _x = x;
+  _y = y;
+  _width = width < MAP_BACKGROUND_MAX_WIDTH ? width : MAP_BACKGROUND_MAX_WIDTH;
+  _height = height < MAP_BACKGROUND_MAX_HEIGHT ? height : MAP_BACKGROUND_MAX_HEIGHT;
+  clearMarks();
+}
+
+MapBackground::~MapBackground()
+{
+  if (_raw)
+    _raw.close();
+}
+
+bool MapBackground::load(GeoMap *geoMap)
+{
+  if (_raw)
+    _raw.close();
+  clearMarks();
+
+  // The part of each tile inside the map, one after the other in the file
+  _pieceCount = min(geoMap->getTileCount(), MAP_BACKGROUND_MAX_PIECES);
+  uint32_t offset = MAP_BACKGROUND_NAME_SIZE;
+  for (int i = 0; i < _pieceCount; i++)
+  {
+    CoordinatesPixel origin = geoMap->getTileOrigin(i);
+    Piece &piece = _pieces[i];
+    piece.x = max(origin.x, 0);
+    piece.y = max(origin.y, 0);
+    piece.width = min(origin.x + MAP_TILE_SIZE, _width) - piece.x;
+    piece.height = min(origin.y + MAP_TILE_SIZE, _height) - piece.y;
+    piece.offset = offset;
+    offset += (uint32_t) piece.width * piece.height * 2;
+  }
+
+  _raw = SPIFFS.open(F(MAP_BACKGROUND_FILE), "r");
+  if (_raw && _raw.size() == offset)
+  {
+    char name[MAP_BACKGROUND_NAME_SIZE];
+    if (_raw.read((uint8_t *) name, sizeof(name)) == sizeof(name) && geoMap->getMapName() == name)
+    {
+      draw();
+      return true;
+    }
+  }
+  if (_raw)
+    _raw.close();
+
+  return build(geoMap);
+}
+
+bool MapBackground::build(GeoMap *geoMap)
+{
+  //  TURBO mode
+  setTurbo(true);
+
+  fs::File raw = SPIFFS.open(F(MAP_BACKGROUND_FILE), "w");
+  char name[MAP_BACKGROUND_NAME_SIZE] = {};
+  strncpy(name, geoMap->getMapName().c_str(), sizeof(name) - 1);
+  if (raw)
+    raw.write((uint8_t *) name, sizeof(name));
+
+  bool complete = true;
+  for (int i = 0; i < _pieceCount; i++)
+  {
+    if (!buildPiece(geoMap->getTileName(i), geoMap->getTileOrigin(i), _pieces[i], raw))
+      complete = false;
+  }
+
+  //  NORMAL mode
+  setTurbo(false);
+
+  // A short file (full SPIFFS) or a missing tile is no cache
+  Piece &last = _pieces[_pieceCount - 1];
+  complete = complete && raw && raw.size() == last.offset + (uint32_t) last.width * last.height * 2;
+  if (raw)
+    raw.close();
+  if (!complete)
+  {
+    SPIFFS.remove(F(MAP_BACKGROUND_FILE));
+    errLog(F("Can't cache map background"));
+    return false;
+  }
+
+  _raw = SPIFFS.open(F(MAP_BACKGROUND_FILE), "r");
+  return true;
+}
+
+// Decode, draw and write one piece a row of MCUs at a time, so it is written in order
+bool MapBackground::buildPiece(String jpegName, CoordinatesPixel origin, Piece &piece, fs::File &raw)
+{
+  if (!JpegDec.decodeFsFile(jpegName))
+  {
+    _tft->fillRect(_x + piece.x, _y + piece.y, piece.width, piece.height, TFT_BLACK);
+    return false;
+  }
+
+  int mcuWidth = JpegDec.MCUWidth;
+  int mcuHeight = JpegDec.MCUHeight;
+  int right = piece.x + piece.width;
+  int bottom = piece.y + piece.height;
+  uint16_t *strip = new uint16_t[piece.width * mcuHeight]();
+  int stripY = origin.y;
+  bool more = true;
+
+  while (more)
+  {
+    more = JpegDec.readSwappedBytes();
+    int mcuX = origin.x + JpegDec.MCUx * mcuWidth;
+    int mcuY = origin.y + JpegDec.MCUy * mcuHeight;
+
+    // Strip complete: what is inside the map to the screen and to the file
+    if (!more || mcuY != stripY)
+    {
+      int top = max(stripY, (int) piece.y);
+      int rows = min(stripY + mcuHeight, bottom) - top;
+      if (rows > 0)
+      {
+        _tft->setWindow(_x + piece.x, _y + top, _x + right - 1, _y + top + rows - 1);
+        _tft->pushColors((uint8_t *) strip, piece.width * rows * 2);
+        if (raw)
+          raw.write((uint8_t *) strip, piece.width * rows * 2);
+      }
+      memset(strip, 0, piece.width * mcuHeight * 2);
+      stripY = mcuY;
+    }
+
+    if (!more)
+      break;
+    if (mcuY >= bottom)
+    {
+      JpegDec.abort();
+      break;
+    }
+
+    int x0 = max(mcuX, (int) piece.x);
+    int x1 = min(mcuX + mcuWidth, right);
+    int y0 = max(mcuY, (int) piece.y);
+    int y1 = min(mcuY + mcuHeight, bottom);
+    int top = max(stripY, (int) piece.y);
+    for (int y = y0; y < y1 && x0 < x1; y++)
+      memcpy(strip + (y - top) * piece.width + x0 - piece.x, JpegDec.pImage + (y - mcuY) * mcuWidth + x0 - mcuX, (x1 - x0) * 2);
+  }
+
+  delete[] strip;
+  return true;
+}
+
+void MapBackground::draw()
+{
+  if (!_raw)
+    return;
+
+  for (int i = 0; i < _pieceCount; i++)
+  {
+    Piece &piece = _pieces[i];
+    _raw.seek(piece.offset);
+    _tft->setWindow(_x + piece.x, _y + piece.y, _x + piece.x + piece.width - 1, _y + piece.y + piece.height - 1);
+    for (int row = 0; row < piece.height; row++)
+    {
+      _raw.read(_line, piece.width * 2);
+      _tft->pushColors(_line, piece.width * 2);
+    }
+  }
+  clearMarks();
+}
+
+void MapBackground::mark(int x0, int y0, int x1, int y1)
+{
+  x0 -= _x;
+  x1 -= _x;
+  y0 -= _y;
+  y1 -= _y;
+  if (x0 > x1 || y0 > y1 || x1 < 0 || y1 < 0 || x0 >= _width || y0 >= _height)
+    return;
+  if (x0 < 0)
+    x0 = 0;
+  if (y0 < 0)
+    y0 = 0;
+  if (x1 >= _width)
+    x1 = _width - 1;
+  if (y1 >= _height)
+    y1 = _height - 1;
+
+  for (int y = y0; y <= y1; y++)
+  {
+    if (x0 < _spanStart[y])
+      _spanStart[y] = x0;
+    if (x1 > _spanEnd[y])
+      _spanEnd[y] = x1;
+  }
+}
+
+// Row by row, from where the line enters the row to where it leaves it
+void MapBackground::markLine(int x0, int y0, int x1, int y1)
+{
+  if (y0 > y1)
+  {
+    int t = x0; x0 = x1; x1 = t;
+    t = y0; y0 = y1; y1 = t;
+  }
+
+  int dy = y1 - y0;
+  if (dy == 0)
+  {
+    mark(min(x0, x1), y0, max(x0, x1), y0);
+    return;
+  }
+
+  for (int y = y0; y <= y1; y++)
+  {
+    int xa = x0 + (long) (x1 - x0) * max(y - y0 - 1, 0) / dy;
+    int xb = x0 + (long) (x1 - x0) * min(y - y0 + 1, dy) / dy;
+    mark(min(xa, xb), y, max(xa, xb), y);
+  }
+}
+
+void MapBackground::restore()
+{
+  if (!_raw)
+    return;
+
+  int y = 0;
+  while (y < _height)
+  {
+    if (_spanStart[y] > _spanEnd[y])
+    {
+      y++;
+      continue;
+    }
+
+    int x0 = _spanStart[y];
+    int x1 = _spanEnd[y];
+    int last = y;
+    while (last + 1 < _height && _spanStart[last + 1] == x0 && _spanEnd[last + 1] == x1)
+      last++;
+
+    _tft->setWindow(_x + x0, _y + y, _x + x1, _y + last);
+    for (int row = y; row <= last; row++)
+    {
+      // The span may cross from one piece into the next
+      for (int i = 0; i < _pieceCount; i++)
+      {
+        Piece &piece = _pieces[i];
+        int a = max(x0, (int) piece.x);
+        int b = min(x1, piece.x + piece.width - 1);
+        if (row < piece.y || row >= piece.y + piece.height || a > b)
+          continue;
+        _raw.seek(piece.offset + ((uint32_t) (row - piece.y) * piece.width + a - piece.x) * 2);
+        _raw.read(_line + (a - x0) * 2, (b - a + 1) * 2);
+      }
+      _tft->pushColors(_line, (x1 - x0 + 1) * 2);
+    }
+    y = last + 1;
+  }
+
+  clearMarks();
+}
+
+void MapBackground::clearMarks()
+{
+  memset(_spanStart, 0xFF, sizeof(_spanStart));
+  memset(_spanEnd, 0, sizeof(_spanEnd));
+}
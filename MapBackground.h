@@ -0,0 +1,72 @@
+#pragma once
+
+#define FS_NO_GLOBALS
+#include <FS.h>
+#include <TFT_eSPI.h>             // https://github.com/Bodmer/TFT_eSPI
+#include "GeoMap.h"
+
+#define MAP_BACKGROUND_FILE "/map.raw"
+#define MAP_BACKGROUND_MAX_WIDTH 256     // (pixels) spans are kept in bytes
+#define MAP_BACKGROUND_MAX_HEIGHT 240    // (pixels)
+#define MAP_BACKGROUND_MAX_PIECES 4      // a map up to one tile in size touches up to 2 x 2 tiles
+#define MAP_BACKGROUND_NAME_SIZE 32
+
+// -------------------------------------------------------
+// Map background cache
+// -------------------------------------------------------
+//
+// The map tiles are decoded once into a raw RGB565 file, in the byte order
+// the display takes. Each tile adds the piece of it inside the map, row by
+// row, after the pieces before it; a header names the view so the file is
+// reused for as long as the view does not change. Overlays drawn on the map
+// mark what they cover, as one x span per row; restore() reads back only
+// those spans from the raw file and pushes them, instead of decoding the
+// tiles. Rows with the same span share one display window.
+
+class MapBackground
+{
+  public:
+    // Area of the screen the map covers
+    MapBackground(TFT_eSPI *tft, int x, int y, int width, int height);
+    ~MapBackground();
+
+    // Draw the current view of the map, decoding its tiles into the cache first if it holds another one
+    bool load(GeoMap *geoMap);
+
+    // Whole map from the cache
+    void draw();
+
+    // Screen areas about to be covered by the overlay (clipped to the map)
+    void mark(int x0, int y0, int x1, int y1);
+    void markLine(int x0, int y0, int x1, int y1);
+
+    // Put the map back under everything marked since the last restore
+    void restore();
+
+  private:
+    struct Piece
+    {
+      int16_t x;      // map area covered
+      int16_t y;
+      int16_t width;
+      int16_t height;
+      uint32_t offset;
+    };
+
+    bool build(GeoMap *geoMap);
+    bool buildPiece(String jpegName, CoordinatesPixel origin, Piece &piece, fs::File &raw);
+    void clearMarks();
+
+    TFT_eSPI *_tft;
+    int _x;
+    int _y;
+    int _width;
+    int _height;
+    Piece _pieces[MAP_BACKGROUND_MAX_PIECES];
+    int _pieceCount = 0;
+    fs::File _raw;
+    uint8_t _spanStart[MAP_BACKGROUND_MAX_HEIGHT];   // empty row: start > end
+    uint8_t _spanEnd[MAP_BACKGROUND_MAX_HEIGHT];
+
+    static uint8_t _line[MAP_BACKGROUND_MAX_WIDTH * 2];
+};
@@ -7,17 +7,21 @@
 #include <Syslog.h>                 // https://github.com/arcao/ESP8266_Syslog
 #include <Adafruit_BME280.h>        // https://github.com/adafruit/Adafruit_BME280_Library
 #include <MutichannelGasSensor.h>   // https://github.com/Seeed-Studio/Mutichannel_Gas_Sensor
+#include <Wire.h>
 
 // External variables
 extern Syslog syslog;
 extern struct ProcessContainer procPtr;
 extern struct Configuration config;
+extern I2CBus i2cBus;
 
 // Prototypes
 void errLog(String msg);
 
 // Geiger tube definitions
 #define LND712_CONV_FACTOR  123 // CPS * 1/123 = uSv/h
+#define LND712_DEAD_TIME    90  // (us) tube dead time, events closer than this are not registered
+#define GEIGER_MIN_WINDOW   500 // (ms) shorter measurement windows are merged into the next one
 
 // Particle sensor PMS7003 definitions
 #define PMS7003_COMMAND_SIZE 7
@@ -27,9 +31,23 @@ void errLog(String msg);
 #define MHZ19_COMMAND_SIZE 9
 #define MHZ19_RESPONSE_SIZE 9
 
+// UART sensors: the reply is read this long after the request, so a sample is not a period old
+#define UART_REPLY_TIME 100         // (ms)
+
 // Temperature sensor definitions
 #define TEMPERATURE_ADJUSTMENT_FACTOR 1.5 // NOTE: empirical correction based on observations, TBC
 
+// Adaptive sampling: smallest change worth sampling faster for
+#define TEMPERATURE_RESOLUTION 0.1  // (C)
+#define HUMIDITY_RESOLUTION 0.5     // (%RH)
+#define PRESSURE_RESOLUTION 0.2     // (hPa)
+#define CO2_RESOLUTION 20           // (ppm)
+#define PM_RESOLUTION 2             // (ug/m3)
+#define VOC_RESOLUTION 5            // (ADC counts)
+#define CO_RESOLUTION 0.1           // (ppm)
+#define NO2_RESOLUTION 0.02         // (ppm)
+#define NH3_RESOLUTION 0.1          // (ppm)
+
 
 // Particle sensor PMS7003 definitions
 static const  char PMS7003_cmdPassiveEnable[] = {0x42, 0x4d, 0xe1, 0x00, 0x00, 0x01, 0x70};
@@ -40,17 +58,45 @@ static const  char PMS7003_cmdWakeup[] = {0x42, 0x4d, 0xe4, 0x00, 0x01, 0x01, 0x
 // CO2 Sensor MH-Z19 definitions
 static const byte MHZ19_cmdRead[9] = {0xFF, 0x01, 0x86, 0x00, 0x00, 0x00, 0x00, 0x00, 0x79};
 
+// MultiGas sensor MiCS6814 definitions, firmware version 2 conversion curves of the library:
+// ppm = factor * ratio^exponent, ratio = Rs/R0 of one sensing element (0 NH3, 1 RED, 2 OX)
+struct GasCurve
+{
+  uint8_t channel;
+  float exponent;
+  float factor;
+};
+
+static const GasCurve MICS6814_curves[MULTIGAS_GASES] =
+{
+  { 1, -1.179, 4.385 },           // CO
+  { 2, 1.007, 1 / 6.855 },        // NO2
+  { 0, -1.67, 1 / 1.47 },         // NH3
+  { 0, -2.518, 570.164 },         // C3H8
+  { 0, -2.138, 398.107 },         // C4H10
+  { 1, -4.363, 630.957 },         // CH4
+  { 1, -1.8, 0.73 },              // H2
+  { 1, -1.552, 1.622 }            // C2H5OH
+};
+
 
 // Sensor processes implementation
 
+// One channel of a new sample, before it is pushed: change since the previous sample and noise of the window
+template <typename T, uint16_t N>
+static void observe(AdaptivePeriod &rate, const RollingStats<T, N> &window, float value, float resolution)
+{
+  if (window.getCount() > 0)
+    rate.observe(value - window.last(), window.jitter(), resolution, N);
+}
+
 // -------------------------------------------------------
 // Combo Temperature & Umidity Sensor wrapper (HDC1080)
 // -------------------------------------------------------
 
 Proc_ComboTemperatureHumiditySensor::Proc_ComboTemperatureHumiditySensor(Scheduler &manager, ProcPriority pr, unsigned int period, int iterations)
-  :  Process(manager, pr, period, iterations),
-     avgTemperature(AVERAGING_WINDOW),
-     avgHumidity(AVERAGING_WINDOW) {}
+  :  MonitoredProcess(manager, pr, period, iterations, "HDC1080"),
+     rate(ADAPTIVE_MIN_PERIOD, ADAPTIVE_MAX_PERIOD, period) {}
 
 void Proc_ComboTemperatureHumiditySensor::setup()
 {
@@ -58,6 +104,8 @@ void Proc_ComboTemperatureHumiditySensor::setup()
   syslog.log(LOG_DEBUG, "Proc_ComboTemperatureHumiditySensor::setup()");
 #endif
 
+  I2CTransaction bus(i2cBus, I2C_HDC1080);
+
   //  Sensor begin
   hdc1080.begin(0x40);
 
@@ -65,6 +113,7 @@ void Proc_ComboTemperatureHumiditySensor::setup()
   if (!(hdc1080.readDeviceId() == 0x1050))
   {
     // There was a problem detecting the sensor
+    bus.fail();
     errLog(F("Could not find a valid hdc1080 sensor"));
   }
 
@@ -74,18 +123,34 @@ void Proc_ComboTemperatureHumiditySensor::setup()
 #endif
 }
 
-void Proc_ComboTemperatureHumiditySensor::service()
+void Proc_ComboTemperatureHumiditySensor::run()
 {
 #ifdef DEBUG_SYSLOG
-  syslog.log(LOG_DEBUG, "Proc_ComboTemperatureHumiditySensor::service()");
+  syslog.log(LOG_DEBUG, "Proc_ComboTemperatureHumiditySensor::run()");
 #endif
 
+  I2CTransaction bus(i2cBus, I2C_HDC1080);
+  if (!bus.granted())
+    return;
+
   // Get temperature event
   float temp = hdc1080.readTemperature();
 
   // Get humidity event
   float humidity = hdc1080.readHumidity();
 
+  // A sensor that does not answer reads all zeros or all ones in both registers
+  if ((temp <= -40 && humidity <= 0) || (temp > 124.99 && humidity > 99.99))
+  {
+    bus.fail();
+    return;
+  }
+
+  // Next sample sooner if either moves
+  observe(rate, avgTemperature, temp - TEMPERATURE_ADJUSTMENT_FACTOR, TEMPERATURE_RESOLUTION);
+  observe(rate, avgHumidity, humidity, HUMIDITY_RESOLUTION);
+  this->setPeriod(rate.next());
+
   // averages
   avgTemperature.push(temp - TEMPERATURE_ADJUSTMENT_FACTOR); 
   avgHumidity.push(humidity);
@@ -97,10 +162,20 @@ float Proc_ComboTemperatureHumiditySensor::getTemperature()
   return avgTemperature.mean();
 }
 
+SensorStats Proc_ComboTemperatureHumiditySensor::getTemperatureStats()
+{
+  return avgTemperature.stats();
+}
+
 float Proc_ComboTemperatureHumiditySensor::getHumidity()
 {
   return avgHumidity.mean();
 }
+
+SensorStats Proc_ComboTemperatureHumiditySensor::getHumidityStats()
+{
+  return avgHumidity.stats();
+}
 // END Combo Temperature & Umidity Sensor wrapper (HDC1080)
 
 
@@ -109,10 +184,8 @@ float Proc_ComboTemperatureHumiditySensor::getHumidity()
 // -------------------------------------------------------
 
 Proc_ComboPressureHumiditySensor::Proc_ComboPressureHumiditySensor(Scheduler &manager, ProcPriority pr, unsigned int period, int iterations)
-  :  Process(manager, pr, period, iterations),
-     avgPressure(AVERAGING_WINDOW),
-     avgHumidity(AVERAGING_WINDOW),
-     avgTemperature(AVERAGING_WINDOW)
+  :  MonitoredProcess(manager, pr, period, iterations, "BME280"),
+     rate(ADAPTIVE_MIN_PERIOD, ADAPTIVE_MAX_PERIOD, period)
 {
 }
 
@@ -122,26 +195,46 @@ void Proc_ComboPressureHumiditySensor::setup()
   syslog.log(LOG_DEBUG, "Proc_ComboPressureHumiditySensor::setup()");
 #endif
 
+  I2CTransaction bus(i2cBus, I2C_BME280);
+
   // Initialise the sensor
   if (!bme.begin(0x76))
   {
     // There was a problem detecting the sensor
+    bus.fail();
     errLog(F("No valid BME280 sensor"));
   }
 }
 
-void Proc_ComboPressureHumiditySensor::service()
+void Proc_ComboPressureHumiditySensor::run()
 {
   // syslog.log(LOG_DEBUG, "2 - BME280");
 #ifdef DEBUG_SYSLOG
-  syslog.log(LOG_DEBUG, "Proc_ComboPressureHumiditySensor::service()");
+  syslog.log(LOG_DEBUG, "Proc_ComboPressureHumiditySensor::run()");
 #endif
 
+  I2CTransaction bus(i2cBus, I2C_BME280);
+  if (!bus.granted())
+    return;
+
   // Get values
   float pressure = bme.readPressure() / 100.0F;
   float humidity = bme.readHumidity();
   float temperature = bme.readTemperature();
 
+  // Outside the operating range of the sensor (NAN included): not a reading
+  if (!(pressure >= 300 && pressure <= 1100))
+  {
+    bus.fail();
+    return;
+  }
+
+  // Next sample sooner if any moves
+  observe(rate, avgPressure, pressure, PRESSURE_RESOLUTION);
+  observe(rate, avgHumidity, humidity, HUMIDITY_RESOLUTION);
+  observe(rate, avgTemperature, temperature, TEMPERATURE_RESOLUTION);
+  this->setPeriod(rate.next());
+
   avgPressure.push(pressure);
   avgHumidity.push(humidity);
   avgTemperature.push(temperature);
@@ -154,15 +247,30 @@ float Proc_ComboPressureHumiditySensor::getPressure()
   return avgPressure.mean();
 }
 
+SensorStats Proc_ComboPressureHumiditySensor::getPressureStats()
+{
+  return avgPressure.stats();
+}
+
 float Proc_ComboPressureHumiditySensor::getHumidity()
 {
   return avgHumidity.mean();
 }
 
+SensorStats Proc_ComboPressureHumiditySensor::getHumidityStats()
+{
+  return avgHumidity.stats();
+}
+
 float Proc_ComboPressureHumiditySensor::getTemperature()
 {
   return avgTemperature.mean();
 }
+
+SensorStats Proc_ComboPressureHumiditySensor::getTemperatureStats()
+{
+  return avgTemperature.stats();
+}
 // END Pressure Sensor process (BME280)
 
 
@@ -171,9 +279,10 @@ float Proc_ComboPressureHumiditySensor::getTemperature()
 // -------------------------------------------------------
 
 Proc_CO2Sensor::Proc_CO2Sensor(Scheduler &manager, ProcPriority pr, unsigned int period, int iterations)
-  :  Process(manager, pr, period, iterations),
-     avgCO2(AVERAGING_WINDOW),
-     co2(CO2_RX_PIN, CO2_TX_PIN, false, 256)
+  :  MonitoredProcess(manager, pr, period, iterations, "CO2"),
+     co2(CO2_RX_PIN, CO2_TX_PIN, false, 256),
+     parser(FrameParser::MHZ19_FRAME),
+     rate(ADAPTIVE_MIN_PERIOD, ADAPTIVE_AIR_MAX_PERIOD, period)
 {
 }
 
@@ -186,83 +295,83 @@ void Proc_CO2Sensor::setup()
   // SW  for CO2 sensor MH-Z19
   co2.begin(9600);
 
-  // dummy read to clear buffer
-  co2.write(MHZ19_cmdRead, MHZ19_COMMAND_SIZE); //request PPM CO2
-
-  // Receive more data than needed, to empty  buffer (should generate  timeout)
-  unsigned char response[32];
-  co2.readBytes(response, MHZ19_RESPONSE_SIZE);
-
-  // Log BUFFER
-#ifdef DEBUG_SYSLOG
-  syslog.log(LOG_DEBUG, "MH-Z19 RESPONSE " + bytes2hex(response, sizeof(response)));
-#endif
-
+  // Whatever is in the buffer gets skipped by the parser while hunting for a header
+  parser.reset();
+  requestPending = false;
 }
 
-void Proc_CO2Sensor::service()
+// Non blocking, two runs per sample: one sends the request, the next one UART_REPLY_TIME
+// later parses the response from whatever bytes have arrived. The scheduler has timed the
+// next run before service() is called, a new period counts from the run after it: each
+// run sets the wait that follows the other one
+void Proc_CO2Sensor::run()
 {
   // syslog.log(LOG_DEBUG, "3 - MH-Z19");
 #ifdef DEBUG_SYSLOG
-  syslog.log(LOG_DEBUG, "Proc_CO2Sensor::service()");
+  syslog.log(LOG_DEBUG, "Proc_CO2Sensor::run()");
 #endif
 
-  unsigned char Buffer[MHZ19_RESPONSE_SIZE];
+  if (parser.poll(co2))
+  {
+    const unsigned char *frame = parser.frame();
 
+    //  PRINT BUFFER
 #ifdef DEBUG_SYSLOG
-  syslog.log(LOG_DEBUG, "Reading  for CO2 data");
+    syslog.log(LOG_DEBUG, "CO2 sensor response - " + bytes2hex((unsigned char *) frame, MHZ19_RESPONSE_SIZE));
 #endif
 
-  //request PPM CO2
-  co2.write(MHZ19_cmdRead, MHZ19_COMMAND_SIZE);
+    // Get value
+    int responseHigh = (int) frame[2];
+    int responseLow = (int) frame[3];
+    float co2 = (256 * responseHigh) + responseLow;
 
-  // Read response
-  co2.readBytes(Buffer, MHZ19_RESPONSE_SIZE);
+    // Next request sooner if it moves
+    observe(rate, avgCO2, co2, CO2_RESOLUTION);
+    rate.next();
 
-  //  PRINT BUFFER
-#ifdef DEBUG_SYSLOG
-  syslog.log(LOG_DEBUG, "CO2 sensor response - " + bytes2hex(Buffer, MHZ19_RESPONSE_SIZE));
-#endif
-
-  if (Buffer[0] != 0xFF)
+    // Average
+    avgCO2.push(co2);
+  }
+  else if (requestPending)
   {
-    delay(1000);
-    errLog(F("CO2 Sensor - Wrong starting byte"));
-
-    // empty buffer
-    co2.readBytes(Buffer, MHZ19_RESPONSE_SIZE * 2);
-
-    return ;
+    errLog(F("CO2 Sensor - timeout"));
   }
 
-  if (Buffer[1] != 0x86)
+  if (parser.getChecksumErrors() != checksumErrors)
   {
-    delay(1000);
-    errLog(F("CO2 Sensor - Wrong command"));
-
-    // empty buffer
-    co2.readBytes(Buffer, MHZ19_RESPONSE_SIZE * 2);
+    checksumErrors = parser.getChecksumErrors();
+    errLog(F("CO2 Sensor - Checksum wrong"));
+  }
 
-    return ;
+  // Reply run: the request that follows waits for its reply
+  if (requestPending)
+  {
+    requestPending = false;
+    this->setPeriod(UART_REPLY_TIME);
+    return;
   }
 
 #ifdef DEBUG_SYSLOG
-  syslog.log(LOG_DEBUG, "CO2 Sensor - header OK");
+  syslog.log(LOG_DEBUG, "Requesting CO2 data");
 #endif
 
-  // Get value
-  int responseHigh = (int) Buffer[2];
-  int responseLow = (int) Buffer[3];
-  float co2 = (256 * responseHigh) + responseLow;
+  //request PPM CO2
+  co2.write(MHZ19_cmdRead, MHZ19_COMMAND_SIZE);
+  requestPending = true;
 
-  // Average
-  avgCO2.push(co2);
+  // The reply run waits for the next sample to be due
+  this->setPeriod(rate.getPeriod() - UART_REPLY_TIME);
 }
 
 float Proc_CO2Sensor::getCO2()
 {
   return avgCO2.mean();
 }
+
+SensorStats Proc_CO2Sensor::getCO2Stats()
+{
+  return avgCO2.stats();
+}
 // END CO2 Sensor process (MH-Z19)
 
 
@@ -272,10 +381,9 @@ float Proc_CO2Sensor::getCO2()
 // -------------------------------------------------------
 
 Proc_ParticleSensor::Proc_ParticleSensor(Scheduler &manager, ProcPriority pr, unsigned int period, int iterations)
-  :  Process(manager, pr, period, iterations),
-     avgPM01(AVERAGING_WINDOW),
-     avgPM2_5(AVERAGING_WINDOW),
-     avgPM10(AVERAGING_WINDOW)
+  :  MonitoredProcess(manager, pr, period, iterations, "PMS7003"),
+     parser(FrameParser::PMS7003_FRAME),
+     rate(ADAPTIVE_MIN_PERIOD, ADAPTIVE_AIR_MAX_PERIOD, period)
 {
 }
 
@@ -285,87 +393,94 @@ void Proc_ParticleSensor::setup()
   syslog.log(LOG_DEBUG, "Proc_ParticleSensor::setup()");
 #endif
 
-  unsigned char Buffer[256];
-
   // HW  for particle sensor PMS7003
   Serial.begin(9600);
 
-  Serial.setTimeout(3000);
-
   // Set passive mode
 #ifdef DEBUG_SYSLOG
   syslog.log(LOG_DEBUG, "PMS7003 SETTING PASSIVE MODE");
 #endif
 
-  Serial.write(PMS7003_cmdPassiveEnable, 7);
-  Serial.flush();
-
-  //Dummy read to clear  buffer
-  Serial.write(PMS7003_cmdPassiveRead, 7);
-  Serial.flush();
+  Serial.write(PMS7003_cmdPassiveEnable, PMS7003_COMMAND_SIZE);
 
-  // Receive more data than needed, to empty  buffer (should generate  timeout)
-  Serial.readBytes(Buffer, sizeof(Buffer));
+  // Whatever is in the buffer (active mode frames, the mode change ack) gets skipped by the parser
+  parser.reset();
+  requestPending = false;
 }
 
-void Proc_ParticleSensor::service()
+// Non blocking, two runs per sample as for the CO2 sensor
+void Proc_ParticleSensor::run()
 {
   // syslog.log(LOG_DEBUG, "4 - PMS7003");
 #ifdef DEBUG_SYSLOG
-  syslog.log(LOG_DEBUG, "Proc_ParticleSensor::service()");
-#endif
-
-  unsigned char Buffer[PMS7003_RESPONSE_SIZE];
-
-#ifdef DEBUG_SYSLOG
-  syslog.log(LOG_DEBUG, "Reading  for particle data");
+  syslog.log(LOG_DEBUG, "Proc_ParticleSensor::run()");
 #endif
 
-  // Send READ command
-  Serial.write(PMS7003_cmdPassiveRead, PMS7003_COMMAND_SIZE);
-  Serial.flush();
+  bool gotData = false;
+  unsigned char frame[PMS7003_RESPONSE_SIZE];
 
-  // Receive response
-  Serial.readBytes(Buffer, PMS7003_RESPONSE_SIZE);
+  // Skip acks and stale frames, keep the last data frame
+  while (parser.poll(Serial))
+  {
+    if (parser.frameSize() != PMS7003_RESPONSE_SIZE)
+      continue;
 
-  // PRINT BUFFER
-#ifdef DEBUG_SYSLOG
-  syslog.log(LOG_DEBUG, "Particle sensor response - " + bytes2hex(Buffer, PMS7003_RESPONSE_SIZE));
-#endif
+    memcpy(frame, parser.frame(), PMS7003_RESPONSE_SIZE);
+    gotData = true;
+  }
 
-  //start to read when detect 0x42 0x4d
-  if (Buffer[0] == 0x42 && Buffer[1] == 0x4d)
+  if (gotData)
   {
+    // PRINT BUFFER
 #ifdef DEBUG_SYSLOG
-    syslog.log(LOG_DEBUG, "Particle sensor - header OK");
+    syslog.log(LOG_DEBUG, "Particle sensor response - " + bytes2hex(frame, PMS7003_RESPONSE_SIZE));
 #endif
 
-    // Is checksum ok?
-    if (verifyChecksum(Buffer, PMS7003_RESPONSE_SIZE))
-    {
-#ifdef DEBUG_SYSLOG
-      syslog.log(LOG_DEBUG, "Buffer valid");
-#endif
-      // Get values
-      int PM01 = extractPM01(Buffer);
-      int PM2_5 = extractPM2_5(Buffer);
-      int PM10 = extractPM10(Buffer);
+    // Get values
+    int PM01 = extractPM01(frame);
+    int PM2_5 = extractPM2_5(frame);
+    int PM10 = extractPM10(frame);
 
-      // Average
-      avgPM01.push(PM01);    //count PM1.0 value of the air detector module
-      avgPM2_5.push(PM2_5);  //count PM2.5 value of the air detector module
-      avgPM10.push(PM10);    //count PM10 value of the air detector module
+    // Next request sooner if any moves
+    observe(rate, avgPM01, PM01, PM_RESOLUTION);
+    observe(rate, avgPM2_5, PM2_5, PM_RESOLUTION);
+    observe(rate, avgPM10, PM10, PM_RESOLUTION);
 
-    }
-    else
-    {
-      errLog(F("Particle sensor - Checksum wrong"));
-    }
+    // Average
+    avgPM01.push(PM01);    //count PM1.0 value of the air detector module
+    avgPM2_5.push(PM2_5);  //count PM2.5 value of the air detector module
+    avgPM10.push(PM10);    //count PM10 value of the air detector module
   }
-  else
+
+  if (parser.getChecksumErrors() != checksumErrors)
   {
+    checksumErrors = parser.getChecksumErrors();
+    errLog(F("Particle sensor - Checksum wrong"));
+  }
+
+  if (gotData)
+    rate.next();
+  else if (requestPending)
     errLog(F("Particle sensor -  timeout"));
+
+  // Reply run: the request that follows waits for its reply
+  if (requestPending)
+  {
+    requestPending = false;
+    this->setPeriod(UART_REPLY_TIME);
+    return;
   }
+
+#ifdef DEBUG_SYSLOG
+  syslog.log(LOG_DEBUG, "Requesting particle data");
+#endif
+
+  // Send READ command
+  Serial.write(PMS7003_cmdPassiveRead, PMS7003_COMMAND_SIZE);
+  requestPending = true;
+
+  // The reply run waits for the next sample to be due
+  this->setPeriod(rate.getPeriod() - UART_REPLY_TIME);
 }
 
 
@@ -374,36 +489,32 @@ float Proc_ParticleSensor::getPM01()
   return avgPM01.mean();
 }
 
+SensorStats Proc_ParticleSensor::getPM01Stats()
+{
+  return avgPM01.stats();
+}
+
 float Proc_ParticleSensor::getPM2_5()
 {
   return avgPM2_5.mean();
 }
 
+SensorStats Proc_ParticleSensor::getPM2_5Stats()
+{
+  return avgPM2_5.stats();
+}
+
 float Proc_ParticleSensor::getPM10()
 {
   return avgPM10.mean();
 }
 
-char Proc_ParticleSensor::verifyChecksum(unsigned char *thebuf, int leng)
+SensorStats Proc_ParticleSensor::getPM10Stats()
 {
-  char receiveflag = 0;
-  int receiveSum = 0;
-
-  for (int i = 0; i < (leng - 2); i++)
-  {
-    receiveSum = receiveSum + thebuf[i];
-  }
-  // receiveSum = receiveSum;// + 0x42 + 0x4d;
-
-  if (receiveSum == ((thebuf[leng - 2] << 8) + thebuf[leng - 1])) //check the  data
-  {
-    receiveSum = 0;
-    receiveflag = 1;
-  }
-  return receiveflag;
+  return avgPM10.stats();
 }
 
-int Proc_ParticleSensor::extractPM01(unsigned char *thebuf)
+int Proc_ParticleSensor::extractPM01(const unsigned char *thebuf)
 {
   int PM01Val;
   PM01Val = ((thebuf[4] << 8) + thebuf[5]); //count PM1.0 value of the air detector module
@@ -411,7 +522,7 @@ int Proc_ParticleSensor::extractPM01(unsigned char *thebuf)
 }
 
 //extract PM Value to PC
-int Proc_ParticleSensor::extractPM2_5(unsigned char *thebuf)
+int Proc_ParticleSensor::extractPM2_5(const unsigned char *thebuf)
 {
   int PM2_5Val;
   PM2_5Val = ((thebuf[6] << 8) + thebuf[7]); //count PM2.5 value of the air detector module
@@ -419,7 +530,7 @@ int Proc_ParticleSensor::extractPM2_5(unsigned char *thebuf)
 }
 
 //extract PM Value to PC
-int Proc_ParticleSensor::extractPM10(unsigned char *thebuf)
+int Proc_ParticleSensor::extractPM10(const unsigned char *thebuf)
 {
   int PM10Val;
   PM10Val = ((thebuf[8] << 8) + thebuf[9]); //count PM10 value of the air detector module
@@ -434,9 +545,8 @@ int Proc_ParticleSensor::extractPM10(unsigned char *thebuf)
 // -------------------------------------------------------
 
 Proc_VOCSensor::Proc_VOCSensor(Scheduler &manager, ProcPriority pr, unsigned int period, int iterations)
-  :  Process(manager, pr, period, iterations),
-     //avgVOC(AVERAGING_WINDOW)
-     avgVOC(60)
+  :  MonitoredProcess(manager, pr, period, iterations, "VOC"),
+     rate(ADAPTIVE_MIN_PERIOD, ADAPTIVE_MAX_PERIOD, period)
 {
 }
 
@@ -447,16 +557,20 @@ void Proc_VOCSensor::setup()
 #endif
 }
 
-void Proc_VOCSensor::service()
+void Proc_VOCSensor::run()
 {
   // syslog.log(LOG_DEBUG, "5 - VOC");
 #ifdef DEBUG_SYSLOG
-  syslog.log(LOG_DEBUG, "Proc_VOCSensor::service()");
+  syslog.log(LOG_DEBUG, "Proc_VOCSensor::run()");
 #endif
 
   // Air Quality reading
   float voc = analogRead(VOC_PIN);
 
+  // Next sample sooner if it moves
+  observe(rate, avgVOC, voc, VOC_RESOLUTION);
+  this->setPeriod(rate.next());
+
   // Average
   avgVOC.push(voc);
 }
@@ -465,6 +579,11 @@ float Proc_VOCSensor::getVOC()
 {
   return avgVOC.mean();
 }
+
+SensorStats Proc_VOCSensor::getVOCStats()
+{
+  return avgVOC.stats();
+}
 // END VOC Sensor process (Grove - Air quality sensor v1.3)
 
 // -------------------------------------------------------
@@ -474,8 +593,8 @@ float Proc_VOCSensor::getVOC()
 Proc_GeigerSensor *Proc_GeigerSensor::instance = nullptr;
 
 Proc_GeigerSensor::Proc_GeigerSensor(Scheduler &manager, ProcPriority pr, unsigned int period, int iterations)
-  :  Process(manager, pr, period, iterations),
-     avgCPM(AVERAGING_WINDOW)
+  :  MonitoredProcess(manager, pr, period, iterations, "Geiger"),
+     rate(ADAPTIVE_MIN_PERIOD, ADAPTIVE_MAX_PERIOD, period)
 {
 }
 
@@ -487,65 +606,99 @@ void Proc_GeigerSensor::setup()
 
   instance = this;
 
+  // Start the first measurement window
+  lastCounts = counts;
+  lastWindowStart = micros();
+
   // Set interrupt pin as input and attach interrupt
   pinMode(GEIGER_INTERRUPT_PIN, INPUT);
   attachInterrupt(digitalPinToInterrupt(GEIGER_INTERRUPT_PIN), onTubeEventISR, RISING);
-  counts = 0;
   avgCPM.push(10.0);
 }
 
-void Proc_GeigerSensor::service()
+void Proc_GeigerSensor::run()
 {
-
 #ifdef DEBUG_SYSLOG
-  syslog.log(LOG_DEBUG, "Proc_GeigerSensor::service()");
+  syslog.log(LOG_DEBUG, "Proc_GeigerSensor::run()");
 #endif
 
-  unsigned long interval = millis() - lastCountReset;
-
-#ifdef DEBUG_SYSLOG
-  syslog.log(LOG_DEBUG, "Geiger: counts = " + String(counts));
-#endif
-
-  // SPURIOUS INTERVAL GUARD - If interval is too short or too long we skip the reading (spurious activation of process due to starvation)
-  if ((interval < FAST_SAMPLE_PERIOD * 0.9) || (interval > FAST_SAMPLE_PERIOD * 2))
+  // Timestamps were dropped since the last check, while the ring was full: the pulses queued
+  // now all came before the gap, the interval from the last of them to the next one spans it
+  int beforeGap = -1;
+  if (lostTimestamps != seenLost)
   {
-
-#ifdef DEBUG_SYSLOG
-    syslog.log(LOG_DEBUG, "Geiger: skipping this reading as interval is out of range " + String(interval));
-#endif
+    seenLost = lostTimestamps;
+    beforeGap = pulses.numElements();
   }
 
-  else
+  // Drain the timestamps into the inter-arrival histogram
+  unsigned long pulse;
+  while (true)
   {
-    // INTERVAL OK, Measure normally
-    float thisCPM = (float(counts) * 60000.0 / float(interval));
+    if (beforeGap-- == 0)
+      hasLastPulse = false;
+    if (!pulses.pop(pulse))
+      break;
 
-    // SPURIOUS MEASUREMENT GUARD - If cpm is obviously out of range, discard it 
-    if (thisCPM > 100000 || thisCPM < 0)
+    if (hasLastPulse)
     {
-      // Spurious run
-#ifdef DEBUG_SYSLOG
-      syslog.log(LOG_DEBUG, "WARNING - Geiger thisCPM = " + String(thisCPM));
-#endif
+      unsigned long slot = (pulse - lastPulse) / GEIGER_HISTOGRAM_UNIT;
+      int bin = 0;
+      while (slot > 1 && bin < GEIGER_HISTOGRAM_BINS - 1)
+      {
+        slot >>= 1;
+        bin++;
+      }
+      intervalHistogram[bin]++;
     }
-    else
-    {
-      // Good run, record it
-      avgCPM.push(thisCPM);
-      //lastCPM = thisCPM;
+    lastPulse = pulse;
+    hasLastPulse = true;
+  }
+
+  // Counts are taken from the ISR counter, so they are exact even when the ring overflows.
+  // The window is measured, not assumed: a late (starved) run just makes it longer
+  unsigned long nowCounts = counts;
+  unsigned long now = micros();
+  unsigned long window = now - lastWindowStart;
+
+  if (window < GEIGER_MIN_WINDOW * 1000UL)
+    return;
+
+  unsigned long windowCounts = nowCounts - lastCounts;
+  lastCounts = nowCounts;
+  lastWindowStart = now;
 
 #ifdef DEBUG_SYSLOG
-      syslog.log(LOG_DEBUG, "Geiger last CPM = " + String(thisCPM));
-      syslog.log(LOG_DEBUG, "Geiger mean CPM = " + String(avgCPM.mean()));
+  syslog.log(LOG_DEBUG, "Geiger: counts = " + String(windowCounts) + " in " + String(window / 1000) + " ms");
 #endif
-    }
 
+  // Non-paralyzable dead time correction: n = m / (1 - m * tau)
+  float measuredRate = float(windowCounts) / float(window);   // events/us
+  float busyFraction = measuredRate * LND712_DEAD_TIME;
+
+  // SATURATION GUARD - the tube cannot register more events than this, discard the reading
+  if (busyFraction >= 0.9)
+  {
+#ifdef DEBUG_SYSLOG
+    syslog.log(LOG_DEBUG, "WARNING - Geiger saturated, dead time fraction = " + String(busyFraction));
+#endif
+    return;
   }
 
-  // In any case reset counters
-  lastCountReset = millis();
-  counts = 0;
+  float thisCPM = measuredRate / (1.0 - busyFraction) * 60000000.0;
+
+  // Longer windows while the rate is steady, short ones when it departs from the mean by
+  // more than the counting noise of this window: sqrt(counts) / minutes = sqrt(CPM / minutes)
+  float noise = sqrt(max(avgCPM.mean(), 1.0f) * 60000000.0f / window);
+  rate.observe(thisCPM - avgCPM.mean(), noise, 0);
+  this->setPeriod(rate.next());
+
+  avgCPM.push(thisCPM);
+
+#ifdef DEBUG_SYSLOG
+  syslog.log(LOG_DEBUG, "Geiger last CPM = " + String(thisCPM));
+  syslog.log(LOG_DEBUG, "Geiger mean CPM = " + String(avgCPM.mean()));
+#endif
 }
 
 /*
@@ -560,19 +713,39 @@ float Proc_GeigerSensor::getCPM()
   return avgCPM.mean();
 }
 
+SensorStats Proc_GeigerSensor::getCPMStats()
+{
+  return avgCPM.stats();
+}
+
 float Proc_GeigerSensor::getRadiation()
 {
   return avgCPM.mean() / LND712_CONV_FACTOR;
 }
 
-void Proc_GeigerSensor::onTubeEventISR()
+const unsigned long *Proc_GeigerSensor::getIntervalHistogram()
+{
+  return intervalHistogram;
+}
+
+unsigned long Proc_GeigerSensor::getLostTimestamps()
+{
+  return lostTimestamps;
+}
+
+void ICACHE_RAM_ATTR Proc_GeigerSensor::onTubeEventISR()
 {
   instance->onTubeEvent();
 }
 
-void Proc_GeigerSensor::onTubeEvent()
+void ICACHE_RAM_ATTR Proc_GeigerSensor::onTubeEvent()
 {
   counts++;
+
+  // Timestamp for the inter-arrival statistics. If the process is starved and the ring
+  // fills up the event is still counted
+  if (!pulses.push(micros()))
+    lostTimestamps++;
 }
 
 // END Geiger Sensor wrapper (LND712)
@@ -585,15 +758,8 @@ void Proc_GeigerSensor::onTubeEvent()
 
 
 Proc_MultiGasSensor::Proc_MultiGasSensor(Scheduler & manager, ProcPriority pr, unsigned int period, int iterations)
-  :  Process(manager, pr, period, iterations),
-     avgNH3(AVERAGING_WINDOW),
-     avgCO(AVERAGING_WINDOW),
-     avgNO2(AVERAGING_WINDOW),
-     avgC3H8(AVERAGING_WINDOW),
-     avgC4H10(AVERAGING_WINDOW),
-     avgCH4(AVERAGING_WINDOW),
-     avgH2(AVERAGING_WINDOW),
-     avgC2H5OH(AVERAGING_WINDOW)
+  :  MonitoredProcess(manager, pr, period, iterations, "MultiGas"),
+     rate(ADAPTIVE_MIN_PERIOD, ADAPTIVE_MAX_PERIOD, period)
 
 {
 }
@@ -604,29 +770,126 @@ void Proc_MultiGasSensor::setup()
   syslog.log(LOG_DEBUG, "Proc_MultiGasSensor::setup()");
 #endif
 
-  gas.begin(0x04);//the default I2C address of the slave is 0x04
-  gas.powerOn();
+  {
+    I2CTransaction bus(i2cBus, I2C_MULTIGAS);
+    gas.begin(MULTIGAS_ADDRESS);
+    gas.powerOn();
+  }
   delay(1000);
-  syslog.log(LOG_INFO, "MultiGas firmware Version = " + String(gas.getVersion()));
+
+  I2CTransaction bus(i2cBus, I2C_MULTIGAS);
+  unsigned char version = gas.getVersion();
+  syslog.log(LOG_INFO, "MultiGas firmware Version = " + String(version));
+
+  // Calibration does not change at runtime, read it once. Version 1 keeps the library path
+  batched = version == 2;
+  for (int i = 0; i < MULTIGAS_CHANNELS && batched; i++)
+  {
+    int adc = readRegister(CMD_READ_EEPROM, ADDR_USER_ADC_HN3 + 2 * i);
+    batched = adc > 0 && adc < 1023;
+    adcR0[i] = adc;
+  }
+
+  if (version == 2 && !batched)
+  {
+    bus.fail();
+    errLog(F("MultiGas calibration not readable, reading through the library"));
+  }
 }
 
-void Proc_MultiGasSensor::service()
+// Command to the sensor board and its 16 bit reply, negative if the board does not answer
+int Proc_MultiGasSensor::readRegister(uint8_t cmd, int arg)
+{
+  Wire.beginTransmission(MULTIGAS_ADDRESS);
+  Wire.write(cmd);
+  if (arg >= 0)
+    Wire.write((uint8_t) arg);
+  if (Wire.endTransmission() != 0)
+    return -1;
+
+  if (Wire.requestFrom(MULTIGAS_ADDRESS, 2) != 2)
+    return -1;
+  int high = Wire.read();
+  return (high << 8) | Wire.read();
+}
+
+// All gases from one read of the three channels, NAN for a gas whose element did not read
+bool Proc_MultiGasSensor::readGases(float ppm[MULTIGAS_GASES])
+{
+  float logRatio[MULTIGAS_CHANNELS];
+  bool valid = false;
+
+  for (int i = 0; i < MULTIGAS_CHANNELS; i++)
+  {
+    int adc = readRegister(CH_VALUE_NH3 + i);
+    if (adc > 0 && adc < 1023)
+    {
+      float a0 = adcR0[i];
+      logRatio[i] = log(adc / a0 * (1023.0 - a0) / (1023.0 - adc));
+      valid = true;
+    }
+    else
+      logRatio[i] = NAN;
+  }
+
+  // ratio^exponent as exp(exponent * log(ratio)), one log per element
+  for (int g = 0; g < MULTIGAS_GASES; g++)
+    ppm[g] = MICS6814_curves[g].factor * exp(MICS6814_curves[g].exponent * logRatio[MICS6814_curves[g].channel]);
+
+  return valid;
+}
+
+void Proc_MultiGasSensor::run()
 {
 #ifdef DEBUG_SYSLOG
-  syslog.log(LOG_DEBUG, "Proc_MultiGasSensor::service()");
+  syslog.log(LOG_DEBUG, "Proc_MultiGasSensor::run()");
 #endif
 
+  I2CTransaction bus(i2cBus, I2C_MULTIGAS);
+  if (!bus.granted())
+    return;
+
   float nh3, co, no2, c3h8, c4h10, ch4, h2, c2h5oh;
 
   // Get values
-  nh3 = gas.measure_NH3();
-  co = gas.measure_CO();
-  no2 = gas.measure_NO2();
-  c3h8 = gas.measure_C3H8();
-  c4h10 = gas.measure_C4H10();
-  ch4 = gas.measure_CH4();
-  h2 = gas.measure_H2();
-  c2h5oh = gas.measure_C2H5OH();
+  if (batched)
+  {
+    float ppm[MULTIGAS_GASES];
+    if (!readGases(ppm))
+    {
+      bus.fail();
+      return;
+    }
+
+    nh3 = ppm[NH3];
+    co = ppm[CO];
+    no2 = ppm[NO2];
+    c3h8 = ppm[C3H8];
+    c4h10 = ppm[C4H10];
+    ch4 = ppm[CH4];
+    h2 = ppm[H2];
+    c2h5oh = ppm[C2H5OH];
+  }
+  else
+  {
+    nh3 = gas.measure_NH3();
+    co = gas.measure_CO();
+    no2 = gas.measure_NO2();
+    c3h8 = gas.measure_C3H8();
+    c4h10 = gas.measure_C4H10();
+    ch4 = gas.measure_CH4();
+    h2 = gas.measure_H2();
+    c2h5oh = gas.measure_C2H5OH();
+  }
+
+  // Next sample sooner if one of the three sensing elements moves, the other gases derive from them
+  if (nh3 >= 0)
+    observe(rate, avgNH3, nh3, NH3_RESOLUTION);
+  if (co >= 0)
+    observe(rate, avgCO, co, CO_RESOLUTION);
+  if (no2 >= 0)
+    observe(rate, avgNO2, no2, NO2_RESOLUTION);
+  this->setPeriod(rate.next());
 
   // Average
   if (nh3 >= 0)
@@ -700,42 +963,82 @@ float Proc_MultiGasSensor::getNH3()
   return avgNH3.mean();
 }
 
+SensorStats Proc_MultiGasSensor::getNH3Stats()
+{
+  return avgNH3.stats();
+}
+
 float Proc_MultiGasSensor::getCO()
 {
   return avgCO.mean();
 }
 
+SensorStats Proc_MultiGasSensor::getCOStats()
+{
+  return avgCO.stats();
+}
+
 float Proc_MultiGasSensor::getNO2()
 {
   return avgNO2.mean();
 }
 
+SensorStats Proc_MultiGasSensor::getNO2Stats()
+{
+  return avgNO2.stats();
+}
+
 float Proc_MultiGasSensor::getC3H8()
 {
   return avgC3H8.mean();
 }
 
+SensorStats Proc_MultiGasSensor::getC3H8Stats()
+{
+  return avgC3H8.stats();
+}
+
 
 float Proc_MultiGasSensor::getC4H10()
 {
   return avgC4H10.mean();
 }
 
+SensorStats Proc_MultiGasSensor::getC4H10Stats()
+{
+  return avgC4H10.stats();
+}
+
 float Proc_MultiGasSensor::getCH4()
 {
   return avgCH4.mean();
 }
 
+SensorStats Proc_MultiGasSensor::getCH4Stats()
+{
+  return avgCH4.stats();
+}
+
 float Proc_MultiGasSensor::getH2()
 {
   return avgH2.mean();
 }
 
+SensorStats Proc_MultiGasSensor::getH2Stats()
+{
+  return avgH2.stats();
+}
+
 float Proc_MultiGasSensor::getC2H5OH()
 {
   return avgC2H5OH.mean();
 }
 
+SensorStats Proc_MultiGasSensor::getC2H5OHStats()
+{
+  return avgC2H5OH.stats();
+}
+
 
 // END MultiGas Sensor wrapper (Grove - MiCS6814)
 
@@ -746,7 +1049,7 @@ float Proc_MultiGasSensor::getC2H5OH()
 
 String BaseSensor::bytes2hex(unsigned char buf[], int len)
 {
-  char onebyte[2];
+  char onebyte[3];
   String output;
   for (int i = 0; i < len; i++)
   {
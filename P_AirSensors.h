@@ -7,12 +7,17 @@
 
 #include "Arduino.h"
 
-#include <Average.h>                // https://github.com/MajenkoLibraries/Average
+#include "RollingStats.h"
 #include <ProcessScheduler.h>       // https://github.com/wizard97/ArduinoProcessScheduler
 #include <ClosedCube_HDC1080.h>     // https://github.com/closedcube/ClosedCube_HDC1080_Arduino
 #include <Adafruit_BME280.h>        // https://github.com/adafruit/Adafruit_BME280_Library
 #include <SoftwareSerial.h>         // https://github.com/plerup/espsoftwareserial
 
+#include "AdaptivePeriod.h"
+#include "EventRing.h"
+#include "FrameParser.h"
+#include "ServiceMonitor.h"
+
 // -------------------------------------------------------
 // BASE Sensor
 // -------------------------------------------------------
@@ -30,23 +35,26 @@ class BaseSensor
 // -------------------------------------------------------
 
 
-class Proc_ComboTemperatureHumiditySensor: public Process, public BaseSensor
+class Proc_ComboTemperatureHumiditySensor: public MonitoredProcess, public BaseSensor
 {
   public:
     Proc_ComboTemperatureHumiditySensor(Scheduler &manager, ProcPriority pr, unsigned int period, int iterations);
     float getTemperature();
+    SensorStats getTemperatureStats();
     float getHumidity();
+    SensorStats getHumidityStats();
 
 
   protected:
     virtual void setup();
-    virtual void service();
+    virtual void run();
 
   private:
     // Properties
-    Average<float> avgTemperature;
-    Average<float> avgHumidity;
+    RollingStats<float, AVERAGING_SAMPLES> avgTemperature;
+    RollingStats<float, AVERAGING_SAMPLES> avgHumidity;
     ClosedCube_HDC1080 hdc1080;
+    AdaptivePeriod rate;
 
 
     // methods
@@ -58,25 +66,29 @@ class Proc_ComboTemperatureHumiditySensor: public Process, public BaseSensor
 //  Combo Pressure & Umidity Sensor wrapper (BME280)
 // -------------------------------------------------------
 
-class Proc_ComboPressureHumiditySensor: public Process, public BaseSensor
+class Proc_ComboPressureHumiditySensor: public MonitoredProcess, public BaseSensor
 {
   public:
     Proc_ComboPressureHumiditySensor(Scheduler &manager, ProcPriority pr, unsigned int period, int iterations);
     float getPressure();
+    SensorStats getPressureStats();
     float getHumidity();
+    SensorStats getHumidityStats();
     float getTemperature();
+    SensorStats getTemperatureStats();
 
 
   protected:
     virtual void setup();
-    virtual void service();
+    virtual void run();
 
   private:
     // Properties
-    Average<float> avgPressure;
-    Average<float> avgHumidity;
-    Average<float> avgTemperature;
+    RollingStats<float, AVERAGING_SAMPLES> avgPressure;
+    RollingStats<float, AVERAGING_SAMPLES> avgHumidity;
+    RollingStats<float, AVERAGING_SAMPLES> avgTemperature;
     Adafruit_BME280 bme;
+    AdaptivePeriod rate;
 
     // methods
 
@@ -89,22 +101,27 @@ class Proc_ComboPressureHumiditySensor: public Process, public BaseSensor
 // CO2 Sensor wrapper (MH-Z19)
 // -------------------------------------------------------
 
-class Proc_CO2Sensor: public Process, public BaseSensor
+class Proc_CO2Sensor: public MonitoredProcess, public BaseSensor
 {
   public:
     Proc_CO2Sensor(Scheduler &manager, ProcPriority pr, unsigned int period, int iterations);
     float getCO2();
+    SensorStats getCO2Stats();
 
 
   protected:
     virtual void setup();
-    virtual void service();
+    virtual void run();
 
 
   private:
     // Properties
-    Average<float> avgCO2;
+    RollingStats<float, AVERAGING_SAMPLES> avgCO2;
     SoftwareSerial co2;
+    FrameParser parser;
+    bool requestPending = false;
+    unsigned long checksumErrors = 0;
+    AdaptivePeriod rate;
 
     // methods
 
@@ -118,30 +135,36 @@ class Proc_CO2Sensor: public Process, public BaseSensor
 // Particle Sensor wrapper (PMS7003)
 // -------------------------------------------------------
 
-class Proc_ParticleSensor: public Process, public BaseSensor
+class Proc_ParticleSensor: public MonitoredProcess, public BaseSensor
 {
   public:
     Proc_ParticleSensor(Scheduler &manager, ProcPriority pr, unsigned int period, int iterations);
     float getPM01();
+    SensorStats getPM01Stats();
     float getPM2_5();
+    SensorStats getPM2_5Stats();
     float getPM10();
+    SensorStats getPM10Stats();
 
 
   protected:
     virtual void setup();
-    virtual void service();
+    virtual void run();
 
   private:
     // Properties
-    Average<float> avgPM01;
-    Average<float> avgPM2_5;
-    Average<float> avgPM10;
+    RollingStats<float, AVERAGING_SAMPLES> avgPM01;
+    RollingStats<float, AVERAGING_SAMPLES> avgPM2_5;
+    RollingStats<float, AVERAGING_SAMPLES> avgPM10;
+    FrameParser parser;
+    bool requestPending = false;
+    unsigned long checksumErrors = 0;
+    AdaptivePeriod rate;
 
     // methods
-    char verifyChecksum(unsigned char *thebuf, int leng);
-    int extractPM01(unsigned char *thebuf);
-    int extractPM2_5(unsigned char *thebuf);
-    int extractPM10(unsigned char *thebuf);
+    int extractPM01(const unsigned char *thebuf);
+    int extractPM2_5(const unsigned char *thebuf);
+    int extractPM10(const unsigned char *thebuf);
 };
 // END Particle Sensor wrapper (PMS7003)
 
@@ -149,20 +172,24 @@ class Proc_ParticleSensor: public Process, public BaseSensor
 // VOC Sensor wrapper (Grove - Air quality sensor v1.3)
 // -------------------------------------------------------
 
-class Proc_VOCSensor : public Process, public BaseSensor
+#define VOC_AVERAGING_SAMPLES 60
+
+class Proc_VOCSensor : public MonitoredProcess, public BaseSensor
 {
   public:
     Proc_VOCSensor(Scheduler &manager, ProcPriority pr, unsigned int period, int iterations);
     float getVOC();
+    SensorStats getVOCStats();
 
 
   protected:
     virtual void setup();
-    virtual void service();
+    virtual void run();
 
   private:
     // Properties
-    Average<float> avgVOC;
+    RollingStats<float, VOC_AVERAGING_SAMPLES> avgVOC;
+    AdaptivePeriod rate;
 
     // methods
 };
@@ -173,29 +200,44 @@ class Proc_VOCSensor : public Process, public BaseSensor
 // Geiger Sensor process (LND712)
 // -------------------------------------------------------
 
-class Proc_GeigerSensor : public Process, public BaseSensor
+class Proc_GeigerSensor : public MonitoredProcess, public BaseSensor
 {
   public:
     Proc_GeigerSensor(Scheduler &manager, ProcPriority pr, unsigned int period, int iterations);
     // unsigned long getLastCPM();
     float getCPM();
+    SensorStats getCPMStats();
     float getRadiation();
+    const unsigned long *getIntervalHistogram();
+    unsigned long getLostTimestamps();
     static void onTubeEventISR();
     void onTubeEvent();
 
+    // Inter-arrival histogram, in GEIGER_HISTOGRAM_UNIT us: bin 0 counts intervals under 2 units,
+    // bin n intervals in [2^n, 2^(n+1)), the last bin everything longer
+    static const int GEIGER_HISTOGRAM_BINS = 16;
+    static const unsigned long GEIGER_HISTOGRAM_UNIT = 256;
 
   protected:
     virtual void setup();
-    virtual void service();
+    virtual void run();
 
   private:
     // Properties
-    volatile unsigned long counts = 0;  // variable for GM Tube events
+    EventRing<unsigned long, 128> pulses;   // micros() of each GM Tube event, filled by the ISR
+    volatile unsigned long counts = 0;      // GM Tube events since boot (ISR only writes)
+    volatile unsigned long lostTimestamps = 0;  // events counted but not timestamped (ring full)
+    unsigned long seenLost = 0;             // lostTimestamps already accounted for in the histogram
+    unsigned long lastCounts = 0;
+    unsigned long lastPulse = 0;
+    bool hasLastPulse = false;
+    unsigned long lastWindowStart = 0;     // micros()
+    unsigned long intervalHistogram[GEIGER_HISTOGRAM_BINS] = { 0 };
     //float lastCPM = 0 ;                 // variable for CPM
     float radiationValue = 0.0;         // Radiation energy in uSv/h
-    unsigned long lastCountReset = 0;
     static Proc_GeigerSensor * instance;
-    Average<float> avgCPM;
+    RollingStats<float, AVERAGING_SAMPLES> avgCPM;
+    AdaptivePeriod rate;
 };
 // END Geiger Sensor wrapper (LND712)
 
@@ -203,35 +245,60 @@ class Proc_GeigerSensor : public Process, public BaseSensor
 // -------------------------------------------------------
 // MultiGas Sensor process (Grove - MiCS6814)
 // -------------------------------------------------------
-
-class Proc_MultiGasSensor : public Process, public BaseSensor
+//
+// The eight gases are all derived from the three sensing elements, and the
+// library reads the calibration and all three ADC channels again for each
+// of them. With firmware version 2 the process reads the calibration once
+// at setup and the three channels once per sample, then converts every gas
+// from the same three ratios.
+
+#define MULTIGAS_ADDRESS 0x04   // default I2C address of the sensor board
+#define MULTIGAS_CHANNELS 3     // NH3, RED (CO) and OX (NO2) elements
+#define MULTIGAS_GASES 8        // in the library gas order, CO first
+
+class Proc_MultiGasSensor : public MonitoredProcess, public BaseSensor
 {
   public:
     Proc_MultiGasSensor(Scheduler &manager, ProcPriority pr, unsigned int period, int iterations);
     float getNH3();
+    SensorStats getNH3Stats();
     float getCO();
+    SensorStats getCOStats();
     float getNO2();
+    SensorStats getNO2Stats();
     float getC3H8();
+    SensorStats getC3H8Stats();
     float getC4H10();
+    SensorStats getC4H10Stats();
     float getCH4();
+    SensorStats getCH4Stats();
     float getH2();
+    SensorStats getH2Stats();
     float getC2H5OH();
+    SensorStats getC2H5OHStats();
 
 
   protected:
     virtual void setup();
-    virtual void service();
+    virtual void run();
 
   private:
     // Properties
-    Average<float> avgNH3;
-    Average<float> avgCO;
-    Average<float> avgNO2;
-    Average<float> avgC3H8;
-    Average<float> avgC4H10;
-    Average<float> avgCH4;
-    Average<float> avgH2;
-    Average<float> avgC2H5OH;
+    RollingStats<float, AVERAGING_SAMPLES> avgNH3;
+    RollingStats<float, AVERAGING_SAMPLES> avgCO;
+    RollingStats<float, AVERAGING_SAMPLES> avgNO2;
+    RollingStats<float, AVERAGING_SAMPLES> avgC3H8;
+    RollingStats<float, AVERAGING_SAMPLES> avgC4H10;
+    RollingStats<float, AVERAGING_SAMPLES> avgCH4;
+    RollingStats<float, AVERAGING_SAMPLES> avgH2;
+    RollingStats<float, AVERAGING_SAMPLES> avgC2H5OH;
+    uint16_t adcR0[MULTIGAS_CHANNELS];  // factory calibration, ADC counts in clean air
+    bool batched = false;               // firmware version 2, calibration read
+    AdaptivePeriod rate;
+
+    // methods
+    int readRegister(uint8_t cmd, int arg = -1);
+    bool readGases(float ppm[MULTIGAS_GASES]);
 
 };
 // END MultiGas Sensor wrapper (Grove - MiCS6814)
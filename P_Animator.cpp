@@ -0,0 +1,21 @@
+#include "P_Animator.h"
+#include "GlobalDefinitions.h"
+
+// External variables
+extern struct ProcessContainer procPtr;
+
+void Proc_Animator::setup()
+{
+}
+
+void Proc_Animator::run()
+{
+  // Nothing moving is the usual case: off until the next screen update, so the power manager can sleep
+  if (!procPtr.UIManager.isAnimating())
+  {
+    this->disable();
+    return;
+  }
+
+  procPtr.UIManager.animate();
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <ProcessScheduler.h>     // https://github.com/wizard97/ArduinoProcessScheduler
+#include "ServiceMonitor.h"
+
+// -------------------------------------------------------
+// Screen animation
+// -------------------------------------------------------
+//
+// Draws the frames of whatever the current screen set moving in its last
+// update, one frame per run, so the animation never holds up the other
+// processes. The UI manager only refreshes a screen every few seconds and
+// enables this process after each refresh; once nothing moves any more it
+// disables itself until the next one.
+
+class Proc_Animator : public MonitoredProcess
+{
+  public:
+    // Call the Process constructor
+    Proc_Animator(Scheduler &manager, ProcPriority pr, unsigned int period, int iterations)
+      :  MonitoredProcess(manager, pr, period, iterations, "Animate") {}
+
+  protected:
+    virtual void setup();
+    virtual void run();
+};
@@ -0,0 +1,22 @@
+#include "P_Downloader.h"
+#include "GlobalDefinitions.h"
+#include "WebResource.h"
+
+// External variables
+extern struct Configuration config;
+extern WebResource webResource;
+
+void Proc_Downloader::setup()
+{
+}
+
+void Proc_Downloader::run()
+{
+  // Nothing to fetch is the usual case. Look less often then, so the power manager can sleep
+  bool busy = webResource.isBusy() && config.connected;
+  this->setPeriod(busy ? DOWNLOAD_PERIOD : DOWNLOAD_IDLE_PERIOD);
+  if (!busy)
+    return;
+
+  webResource.service(DOWNLOAD_SLICE);
+}
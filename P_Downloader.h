@@ -0,0 +1,27 @@
+#pragma once
+
+#include <ProcessScheduler.h>     // https://github.com/wizard97/ArduinoProcessScheduler
+#include "ServiceMonitor.h"
+
+#define DOWNLOAD_SLICE 20         // (ms) of downloading per run, the UI stays responsive
+
+// -------------------------------------------------------
+// Background downloads
+// -------------------------------------------------------
+//
+// Runs the WebResource queue a slice at a time, so resources are fetched
+// while the screens go on. A screen that needs its files right away calls
+// WebResource::finish() and picks up where this process left off. While
+// the queue is empty it only looks at it every DOWNLOAD_IDLE_PERIOD.
+
+class Proc_Downloader : public MonitoredProcess
+{
+  public:
+    // Call the Process constructor
+    Proc_Downloader(Scheduler &manager, ProcPriority pr, unsigned int period, int iterations)
+      :  MonitoredProcess(manager, pr, period, iterations, "Download") {}
+
+  protected:
+    virtual void setup();
+    virtual void run();
+};
@@ -22,9 +22,8 @@ void Proc_GeoLocation::setup()
 #endif
 }
 
-void Proc_GeoLocation::service()
+void Proc_GeoLocation::run()
 {
-
 #ifdef DEBUG_SYSLOG
   syslog.log(LOG_INFO, "Geolocation Service");
 #endif
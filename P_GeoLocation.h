@@ -1,17 +1,18 @@
 #pragma once
 
 #include <ProcessScheduler.h>     // https://github.com/wizard97/ArduinoProcessScheduler
+#include "ServiceMonitor.h"
 
 #define RETRY_INTERVAL 30000
 #define NORMAL_INTERVAL 3600000
 
 // Process definition
-class Proc_GeoLocation : public Process
+class Proc_GeoLocation : public MonitoredProcess
 {
   public:
     // Call the Process constructor
     Proc_GeoLocation(Scheduler &manager, ProcPriority pr, unsigned int period, int iterations)
-      :  Process(manager, pr, period, iterations) {}
+      :  MonitoredProcess(manager, pr, period, iterations, "GeoLoc") {}
 
     double getLatitude();
     double getLongitude();
@@ -27,7 +28,7 @@ class Proc_GeoLocation : public Process
 
   protected:
     virtual void setup();
-    virtual void service();
+    virtual void run();
 
     double latitude;
     double longitude;
@@ -0,0 +1,237 @@
+#include "P_History.h"
+#include "GlobalDefinitions.h"
+
+#include <Syslog.h>               // https://github.com/arcao/ESP8266_Syslog
+#include <TimeLib.h>              // https://github.com/PaulStoffregen/Time
+
+// External variables
+extern Syslog syslog;
+
+// Prototypes
+void errLog(String msg);
+time_t utcNow();
+
+// Fixed point scale of each channel, range fits 16 bit. A value above the range
+// (e.g. a dead time corrected CPM over 32766) is stored as HISTORY_SATURATED
+static const float channelScale[HISTORY_CHANNELS] =
+{
+  100,    // Temperature      0.01 C
+  100,    // Humidity         0.01 %
+  10,     // Pressure         0.1 hPa
+  1,      // CO2              1 ppm
+  10,     // CO               0.1 ppm
+  1000,   // NO2              0.001 ppm
+  1,      // VOC              raw ADC
+  10,     // PM1.0            0.1 ug/m3
+  10,     // PM2.5            0.1 ug/m3
+  10,     // PM10             0.1 ug/m3
+  1,      // CPM              1 count
+  100     // Radiation        0.01 uSv/h
+};
+
+Proc_History::Proc_History(Scheduler &manager, ProcPriority pr, unsigned int period, int iterations)
+  : MonitoredProcess(manager, pr, period, iterations, "History"),
+    tiers
+{
+  TimeSeries("/hist_5s", 720, HISTORY_SAMPLE_PERIOD / 1000),
+  TimeSeries("/hist_1m", 1440, 60),
+  TimeSeries("/hist_15m", 2976, 900)
+}
+{
+  memset(rollups, 0, sizeof(rollups));
+}
+
+void Proc_History::setup()
+{
+#ifdef DEBUG_SYSLOG
+  syslog.log(LOG_INFO, "History Setup");
+#endif
+}
+
+void Proc_History::run()
+{
+  // Records are time stamped, nothing to do until the clock is set
+  if (timeStatus() == timeNotSet)
+    return;
+
+  // SPIFFS is mounted after the processes are added, open the files on first use
+  if (!valid)
+  {
+    valid = true;
+    for (int i = 0; i < HISTORY_TIERS; i++)
+    {
+      if (!tiers[i].begin())
+      {
+        errLog(F("History - cannot open files"));
+        valid = false;
+      }
+      else if (tiers[i].newestTime() > lastTime)
+        lastTime = tiers[i].newestTime();
+    }
+    if (!valid)
+    {
+      this->disable();
+      return;
+    }
+  }
+
+  // One record per period, the clock may also have been set back
+  uint32_t time = utcNow();
+  if (time <= lastTime)
+    return;
+  lastTime = time;
+
+  float values[HISTORY_CHANNELS];
+  readChannels(values);
+
+  // Raw tier: batched in RAM, one write per full batch
+  HistoryRecord &record = rawBuffer[rawCount++];
+  record.time = time;
+  for (int i = 0; i < HISTORY_CHANNELS; i++)
+    record.values[i] = encode(i, values[i]);
+
+  if (rawCount == HISTORY_RAW_BUFFER)
+    flushRaw();
+
+  accumulate(HISTORY_1MIN, time, values);
+  accumulate(HISTORY_15MIN, time, values);
+}
+
+// Latest sample of every channel
+void Proc_History::readChannels(float *values)
+{
+  for (int i = 0; i < HISTORY_CHANNELS; i++)
+    values[i] = NAN;
+
+  for (const SensorChannel *channel = sensorChannels; channel < sensorChannels + sensorChannelCount; channel++)
+  {
+    if (channel->history != CHANNEL_NONE)
+      values[channel->history] = channel->read().last;
+  }
+}
+
+// Add a sample to the current period of a rollup tier, writing out the previous period when it is over
+void Proc_History::accumulate(HistoryTier tier, uint32_t time, const float *values)
+{
+  Rollup &rollup = rollups[tier - HISTORY_1MIN];
+  uint32_t start = time - time % tiers[tier].period();
+
+  if (rollup.start != start)
+  {
+    if (rollup.start != 0)
+    {
+      HistoryRecord record;
+      record.time = rollup.start;
+      for (int i = 0; i < HISTORY_CHANNELS; i++)
+        record.values[i] = rollup.samples[i] ? encode(i, rollup.sum[i] / rollup.samples[i]) : HISTORY_NO_DATA;
+
+      if (!tiers[tier].append(&record, 1))
+        errLog(F("History - write failed"));
+    }
+
+    memset(&rollup, 0, sizeof(rollup));
+    rollup.start = start;
+  }
+
+  for (int i = 0; i < HISTORY_CHANNELS; i++)
+  {
+    if (!isnan(values[i]))
+    {
+      rollup.sum[i] += values[i];
+      rollup.samples[i]++;
+    }
+  }
+}
+
+void Proc_History::flushRaw()
+{
+  if (rawCount == 0)
+    return;
+
+  if (!tiers[HISTORY_5SEC].append(rawBuffer, rawCount))
+    errLog(F("History - write failed"));
+  rawCount = 0;
+}
+
+int Proc_History::query(uint8_t channel, uint32_t from, uint32_t to, uint32_t *times, float *values, int maxPoints)
+{
+  if (!valid || channel >= HISTORY_CHANNELS || maxPoints <= 0)
+    return 0;
+
+  // Finest tier that reaches back to from. A tier that has not wrapped yet holds all its history
+  int tier = HISTORY_TIERS - 1;
+  for (int i = 0; i < HISTORY_TIERS; i++)
+  {
+    if (tiers[i].count() < tiers[i].capacity() || tiers[i].oldestTime() <= from)
+    {
+      tier = i;
+      break;
+    }
+  }
+
+  // Raw samples still in RAM come after the file ones
+  int pending = 0;
+  if (tier == HISTORY_5SEC)
+  {
+    for (int i = 0; i < rawCount; i++)
+    {
+      if (rawBuffer[i].time >= from && rawBuffer[i].time <= to)
+        pending++;
+    }
+    if (pending > maxPoints)
+      pending = maxPoints;
+  }
+
+  int points = tiers[tier].query(from, to, channel, channelScale[channel], times, values, maxPoints - pending);
+
+  for (int i = 0; tier == HISTORY_5SEC && i < rawCount && points < maxPoints; i++)
+  {
+    if (rawBuffer[i].time >= from && rawBuffer[i].time <= to)
+    {
+      times[points] = rawBuffer[i].time;
+      values[points++] = decode(channel, rawBuffer[i].values[channel]);
+    }
+  }
+
+  return points;
+}
+
+TimeSeries &Proc_History::getTier(HistoryTier tier)
+{
+  return tiers[tier];
+}
+
+bool Proc_History::isValid()
+{
+  return valid;
+}
+
+int16_t Proc_History::encode(uint8_t channel, float value)
+{
+  if (isnan(value))
+    return HISTORY_NO_DATA;
+
+  long scaled = lround(value * channelScale[channel]);
+  if (scaled >= HISTORY_SATURATED)
+    return HISTORY_SATURATED;
+  if (scaled < -32767)
+    scaled = -32767;
+  return scaled;
+}
+
+float Proc_History::decode(uint8_t channel, int16_t value)
+{
+  if (value == HISTORY_NO_DATA)
+    return NAN;
+  if (value == HISTORY_SATURATED)
+    return INFINITY;
+  return value / channelScale[channel];
+}
+
+int Proc_History::decimals(uint8_t channel)
+{
+  int decimals = 0;
+  for (float scale = channelScale[channel]; scale >= 10; scale /= 10)
+    decimals++;
+  return decimals;
+}
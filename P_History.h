@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Arduino.h"
+
+#include <ProcessScheduler.h>     // https://github.com/wizard97/ArduinoProcessScheduler
+#include "ServiceMonitor.h"
+#include "TimeSeries.h"
+
+#define HISTORY_RAW_BUFFER 12     // raw samples kept in RAM between flushes (1 minute)
+
+// Channels recorded, one per value shown on the sensors screen
+enum HistoryChannel
+{
+  HISTORY_TEMPERATURE,
+  HISTORY_HUMIDITY,
+  HISTORY_PRESSURE,
+  HISTORY_CO2,
+  HISTORY_CO,
+  HISTORY_NO2,
+  HISTORY_VOC,
+  HISTORY_PM01,
+  HISTORY_PM2_5,
+  HISTORY_PM10,
+  HISTORY_CPM,
+  HISTORY_RADIATION
+};
+
+// Resolutions, finest first
+enum HistoryTier
+{
+  HISTORY_5SEC,     // 1 hour
+  HISTORY_1MIN,     // 1 day
+  HISTORY_15MIN,    // 31 days
+  HISTORY_TIERS
+};
+
+// -------------------------------------------------------
+// Sensor history
+// -------------------------------------------------------
+//
+// Samples every channel each period into three SPIFFS ring files of
+// decreasing resolution. Raw samples are batched in RAM and written once a
+// minute; the coarser tiers are period means, written once per period.
+// RAM use is fixed: the raw batch plus one accumulator per rollup tier.
+
+class Proc_History : public MonitoredProcess
+{
+  public:
+    // Call the Process constructor
+    Proc_History(Scheduler &manager, ProcPriority pr, unsigned int period, int iterations);
+
+    // Up to maxPoints values of a channel in [from, to], from the finest tier going back to from.
+    // Returns the number of points, times in UTC epoch seconds
+    int query(uint8_t channel, uint32_t from, uint32_t to, uint32_t *times, float *values, int maxPoints);
+
+    TimeSeries &getTier(HistoryTier tier);
+    bool isValid();
+
+    static int16_t encode(uint8_t channel, float value);
+    static float decode(uint8_t channel, int16_t value);
+    static int decimals(uint8_t channel);     // kept by the fixed point scale
+
+  protected:
+    virtual void setup();
+    virtual void run();
+
+  private:
+    // Running sums of one period of a rollup tier
+    struct Rollup
+    {
+      uint32_t start;
+      float sum[HISTORY_CHANNELS];
+      uint16_t samples[HISTORY_CHANNELS];
+    };
+
+    void readChannels(float *values);
+    void accumulate(HistoryTier tier, uint32_t time, const float *values);
+    void flushRaw();
+
+    TimeSeries tiers[HISTORY_TIERS];
+    Rollup rollups[HISTORY_TIERS - 1];  // HISTORY_1MIN onwards
+    HistoryRecord rawBuffer[HISTORY_RAW_BUFFER];
+    uint8_t rawCount = 0;
+    uint32_t lastTime = 0;
+    bool valid = false;
+};
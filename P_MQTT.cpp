@@ -15,20 +15,24 @@
 #include <ESP8266WebServer.h>
 #include "P_AirSensors.h"
 #include "GlobalDefinitions.h"
+#include "Telemetry.h"
 
 #include <Syslog.h>               // https://github.com/arcao/ESP8266_Syslog
 #include <PubSubClient.h>         //https://github.com/knolleary/pubsubclient
 #include <NtpClientLib.h>         // https://github.com/gmag11/NtpClient
 #include <ArduinoJson.h>          //https://github.com/bblanchon/ArduinoJson
+#include <TimeLib.h>              // https://github.com/PaulStoffregen/Time
 // External variables
 extern struct ProcessContainer procPtr;
 extern struct Configuration config;
 extern Syslog syslog;
 extern String systemID;
 extern WiFiClient wifiClient;
+extern I2CBus i2cBus;
 
 // Prototypes
 void errLog(String msg);
+time_t utcNow();
 
 // Tags
 const char PARAM_1[] PROGMEM = "1=";
@@ -39,7 +43,27 @@ const char PARAM_5[] PROGMEM = "&5=";
 const char PARAM_6[] PROGMEM = "&6=";
 const char PARAM_7[] PROGMEM = "&7=";
 const char PARAM_8[] PROGMEM = "&8=";
+const char PARAM_CREATED_AT[] PROGMEM = "&created_at=";
+static const char *const params[MQTT_TEXT_FIELDS] = { PARAM_1, PARAM_2, PARAM_3, PARAM_4, PARAM_5, PARAM_6, PARAM_7, PARAM_8 };
 
+// Append a "&n=" tag, without the '&' when it comes first
+static void appendParam(char *mqttData, const char *param)
+{
+  if (mqttData[0] == 0 && pgm_read_byte(param) == '&')
+    param++;
+  strcat_P(mqttData, param);
+}
+
+// Registry entry of a text payload field, nullptr if the field is not sent
+static const SensorChannel *textChannel(int topic, int field)
+{
+  for (int i = 0; i < sensorChannelCount; i++)
+  {
+    if (sensorChannels[i].text == MQTT_TEXT(topic, field))
+      return &sensorChannels[i];
+  }
+  return nullptr;
+}
 
 // Process Setup
 void Proc_MQTTUpdate::setup()
@@ -51,17 +75,31 @@ void Proc_MQTTUpdate::setup()
   // Set the MQTT broker
   mqttClient.setServer(config.mqtt_server, 1883);
 
+  // The defines above don't reach the library, which is built on its own. Bound the
+  // blocking connect(): TCP connection, then the broker's answer
+  wifiClient.setTimeout(MQTT_SOCKET_TIMEOUT * 1000);
+  mqttClient.setSocketTimeout(MQTT_SOCKET_TIMEOUT);
+  mqttClient.setKeepAlive(MQTT_KEEPALIVE);
+
+  // The default 128 bytes don't hold a ThingSpeak topic with a time stamped record
+  if (!mqttClient.setBufferSize(MQTT_BUFFER_SIZE))
+    errLog(F("MQTT buffer alloc fail"));
+
   mqttClient.loop();
 
 }
 
 // Process Service
-void Proc_MQTTUpdate::service()
+void Proc_MQTTUpdate::run()
 {
 #ifdef DEBUG_SYSLOG
-  syslog.log(LOG_INFO, "Proc_MQTTUpdate::service()");
+  syslog.log(LOG_INFO, "Proc_MQTTUpdate::run()");
 #endif
 
+  // The process polls: wait for the next update, or the retry after a failed connection
+  if ((long) (millis() - nextAttempt) < 0)
+    return;
+
   // Update MQTT  only if WiFi is connected
   if (config.connected)
   {
@@ -73,193 +111,385 @@ void Proc_MQTTUpdate::service()
 
     bool isConnected = mqttReconnect();
 
+    // Process statistics, if a diagnostics topic is configured
+    if (isConnected && config.mqtt_diag_topic[0] && millis() - lastDiagnostics >= MQTT_DIAG_PERIOD)
+      publishDiagnostics();
+
+    // Minutes missed while disconnected go first, live data once caught up. Either takes
+    // the channel's update of the window
+    bool caughtUp = isConnected && backfill();
     if (isConnected)
-    {
+      nextAttempt = millis() + (caughtUp ? MQTT_UPDATE_PERIOD : MQTT_BACKFILL_PERIOD);
 
-      // Reusable buffer
-      char mqttData[100];
+    if (caughtUp)
+    {
 
-      // Create data string - Topic 1
-      strcpy_P(mqttData, PARAM_1);
-      dtostrf(procPtr.ComboTemperatureHumiditySensor.getTemperature(), 2, 2, &mqttData[strlen(mqttData)]);
+      // One packed record, or the three text topics
+      bool delivered = (config.mqttFormat == MQTT_FORMAT_BINARY) ? publishBinary() : publishText();
 
-      strcat_P(mqttData, PARAM_2);
-      dtostrf(procPtr.ComboTemperatureHumiditySensor.getHumidity(), 2, 2, &mqttData[strlen(mqttData)]);
+      // Remember last update
+      sprintf(lastMqttUpdate, "%d/%d/%d %d:%02d.%02d   ", day(), month(), year(), hour(), minute(), second());
 
-      strcat_P(mqttData, PARAM_3);
-      dtostrf(procPtr.ComboPressureHumiditySensor.getPressure(), 2, 2, &mqttData[strlen(mqttData)]);
+      // Samples up to now are delivered
+      if (delivered && timeStatus() != timeNotSet)
+      {
+        sentUntil = utcNow();
+        saveCursor();
+      }
 
-      strcat_P(mqttData, PARAM_4);
-      dtostrf(procPtr.ParticleSensor.getPM01(), 2, 2, &mqttData[strlen(mqttData)]);
+      // Experimental
+      /*
+            if (mqttClient.connected())
+            {
+              // Disconnect from server
+              mqttClient.disconnect();
+            }
+            else
+            {
+              // TEMP log zzzzz
+              syslog.log(LOG_DEBUG, "MQTT not connected, so no need to disconnect");
+            }
+      */
+    }
+  }
+#ifdef DEBUG_SYSLOG
+  syslog.log(LOG_INFO, "END Proc_MQTTUpdate::run()");
+#endif
+}
 
-      strcat_P(mqttData, PARAM_5);
-      dtostrf(procPtr.ParticleSensor.getPM2_5(), 2, 2, &mqttData[strlen(mqttData)]);
 
-      strcat_P(mqttData, PARAM_6);
-      dtostrf(procPtr.ParticleSensor.getPM10(), 2, 2, &mqttData[strlen(mqttData)]);
+// Live values, ThingSpeak style "1=..&2=.." on the three topics
+bool Proc_MQTTUpdate::publishText()
+{
+  // Reusable buffer
+  char mqttData[100];
+  char *topics[MQTT_TEXT_TOPICS] = { config.mqtt_topic1, config.mqtt_topic2, config.mqtt_topic3 };
+  bool delivered = true;
 
-      strcat_P(mqttData, PARAM_7);
-      dtostrf(procPtr.GeigerSensor.getCPM(), 2, 2, &mqttData[strlen(mqttData)]);
+  for (int topic = 1; topic <= MQTT_TEXT_TOPICS; topic++)
+  {
+    mqttData[0] = 0;
+    for (int field = 1; field <= MQTT_TEXT_FIELDS; field++)
+    {
+      const SensorChannel *channel = textChannel(topic, field);
+      if (!channel)
+        continue;
+      // No reading yet (e.g. battery voltage before the first fuel gauge read), leave the field out
+      float value = channel->read().mean;
+      if (isnan(value))
+        continue;
+      appendParam(mqttData, params[field - 1]);
+      dtostrf(value, 2, 2, &mqttData[strlen(mqttData)]);
+    }
 
-      strcat_P(mqttData, PARAM_8);
-      dtostrf(procPtr.GeigerSensor.getRadiation(), 2, 2, &mqttData[strlen(mqttData)]);
+    // Nothing to report on this topic yet
+    if (!mqttData[0])
+      continue;
 
-      // Update topic 1
-      mqttSend(config.mqtt_topic1, mqttData);
+    // Topic 3 is diagnostics, delivery is not tracked
+    bool sent = mqttSend(topics[topic - 1], mqttData);
+    if (topic < MQTT_TEXT_TOPICS)
+      delivered = sent && delivered;
 
 #ifdef DEBUG_SYSLOG
-      syslog.log(LOG_DEBUG, "mqttData1 " + String(mqttData));
+    syslog.log(LOG_DEBUG, "mqttData" + String(topic) + " " + String(mqttData));
 #endif
+  }
 
-      // Create data string - Topic 2
-      strcpy_P(mqttData, PARAM_1);
-      dtostrf(procPtr.MultiGasSensor.getCO(), 2, 2, &mqttData[strlen(mqttData)]);
+  return delivered;
+}
 
-      strcat_P(mqttData, PARAM_2);
-      dtostrf(procPtr.CO2Sensor.getCO2(), 2, 2, &mqttData[strlen(mqttData)]);
+// Live values of every channel in one packed record on topic 1
+bool Proc_MQTTUpdate::publishBinary()
+{
+  TelemetryPacket packet;
+  packet.begin(timeStatus() != timeNotSet ? utcNow() : 0);
 
-      strcat_P(mqttData, PARAM_3);
-      dtostrf(procPtr.MultiGasSensor.getNO2(), 2, 2, &mqttData[strlen(mqttData)]);
+  for (int i = 0; i < sensorChannelCount; i++)
+  {
+    if (sensorChannels[i].telemetry != CHANNEL_NONE)
+      packet.add(sensorChannels[i].telemetry, sensorChannels[i].read().mean);
+  }
 
-      strcat_P(mqttData, PARAM_4);
-      dtostrf(procPtr.VOCSensor.getVOC(), 2, 2, &mqttData[strlen(mqttData)]);
+#ifdef DEBUG_SYSLOG
+  syslog.logf(LOG_DEBUG, "MQTT binary record, %d bytes", packet.size());
+#endif
 
-      strcat_P(mqttData, PARAM_5);
-      dtostrf(procPtr.UIManager.getSoC(), 2, 2, &mqttData[strlen(mqttData)]);
+  return mqttClient.publish(config.mqtt_topic1, packet.data(), packet.size());
+}
 
-      strcat_P(mqttData, PARAM_6);
-      dtostrf(procPtr.UIManager.getVolt(), 2, 2, &mqttData[strlen(mqttData)]);
+// One connection attempt per service. The attempt itself blocks: PubSubClient::connect()
+// waits up to MQTT_SOCKET_TIMEOUT for the TCP connection and as long again for the
+// broker's answer. While the broker is unreachable the attempts are spaced by nextAttempt:
+// exponential backoff with jitter
+bool Proc_MQTTUpdate::mqttReconnect()
+{
+  // If already connected, exit
+  if (mqttClient.connected())
+    return true;
 
-      strcat_P(mqttData, PARAM_7);
-      dtostrf(procPtr.ComboPressureHumiditySensor.getTemperature(), 2, 2, &mqttData[strlen(mqttData)]);
+  // Leave the CPU to the user, retry on the next poll
+  if (procPtr.UIManager.eventPending())
+    return false;
 
-      strcat_P(mqttData, PARAM_8);
-      dtostrf(WiFi.RSSI(), 2, 2, &mqttData[strlen(mqttData)]);
+#ifdef DEBUG_SYSLOG
+  syslog.logf(LOG_DEBUG, "MQTT connection, attempt %d", connectFailures + 1);
+#endif
 
-      // Update topic 2
-      mqttSend(config.mqtt_topic2, mqttData);
+  // Note: to avoid thingspeak occasional lockout
+  String randomID = systemID + String(random(999999));
 
+  // Connect to the MQTT broker
+  if (mqttClient.connect(randomID.c_str(), "username", "password"))
+  {
+    if (connectFailures > 0)
+      errLog(String(F("MQTT retries:")) + String(connectFailures + 1));
 
-#ifdef DEBUG_SYSLOG
-      syslog.log(LOG_DEBUG, "mqttData2 " + String(mqttData));
-#endif
+    connectFailures = 0;
+    return true;
+  }
 
-      // Create data string - Topic 3 (DEBUG)
-      strcpy_P(mqttData, PARAM_1);
-      dtostrf(millis() / (60000L), 2, 2, &mqttData[strlen(mqttData)]);
+  // Log the first failure only, retries are counted on reconnection
+  if (connectFailures == 0)
+    errLog(String(F("MQTT fail,err ")) + String(mqttClient.state()));
 
-      strcat_P(mqttData, PARAM_2);
-      dtostrf(ESP.getFreeHeap(), 2, 2, &mqttData[strlen(mqttData)]);
+  if (connectFailures < 255)
+    connectFailures++;
 
-      strcat_P(mqttData, PARAM_3);
-      dtostrf(procPtr.ComboPressureHumiditySensor.getHumidity(), 2, 2, &mqttData[strlen(mqttData)]);
+  // Base delay doubles per failure up to the cap, half of it randomised so stations don't retry in step
+  unsigned long backoff = MQTT_BACKOFF_MAX;
+  if (connectFailures <= 16 && ((unsigned long) MQTT_BACKOFF_MIN << (connectFailures - 1)) < MQTT_BACKOFF_MAX)
+    backoff = (unsigned long) MQTT_BACKOFF_MIN << (connectFailures - 1);
+  nextAttempt = millis() + backoff / 2 + random(backoff / 2 + 1);
 
-      strcat_P(mqttData, PARAM_4);
-      dtostrf(procPtr.UIManager.getSoC(), 2, 2, &mqttData[strlen(mqttData)]);
+  return false;
+}
+
+// One message per process on <diagnostics topic>/<process>, counters since boot:
+// services, average and longest service time (us), longest lateness (ms), overruns
+void Proc_MQTTUpdate::publishDiagnostics()
+{
+  char mqttTopic[80];
+  char mqttData[96];
+
+  for (ServiceMonitor *monitor = ServiceMonitor::getFirst(); monitor; monitor = monitor->getNext())
+  {
+    const ServiceStats &stats = monitor->getStats();
+    snprintf(mqttTopic, sizeof(mqttTopic), "%s/%s", config.mqtt_diag_topic, monitor->getName());
+    snprintf(mqttData, sizeof(mqttData), "runs=%lu&avg=%lu&max=%lu&late=%lu&over=%lu",
+             (unsigned long) stats.runs, (unsigned long) monitor->getAverageMicros(), (unsigned long) stats.maxMicros,
+             (unsigned long) stats.maxLateness, (unsigned long) stats.overruns);
+    mqttSend(mqttTopic, mqttData);
+  }
 
-      strcat_P(mqttData, PARAM_5);
-      dtostrf(procPtr.UIManager.getNativeSoC(), 2, 2, &mqttData[strlen(mqttData)]);
+  // Then one per I2C device on <diagnostics topic>/i2c/<device>: transactions, errors, timeouts,
+  // skipped while backing off, average and longest transaction time (us)
+  for (int i = 0; i < I2C_DEVICE_COUNT; i++)
+  {
+    const I2CDeviceStats &stats = i2cBus.getStats(i);
+    snprintf(mqttTopic, sizeof(mqttTopic), "%s/i2c/%s", config.mqtt_diag_topic, I2CBus::devices[i].name);
+    snprintf(mqttData, sizeof(mqttData), "n=%lu&err=%lu&tmo=%lu&skip=%lu&avg=%lu&max=%lu",
+             (unsigned long) stats.transactions, (unsigned long) stats.errors, (unsigned long) stats.timeouts,
+             (unsigned long) stats.skipped, (unsigned long) (stats.transactions ? stats.totalMicros / stats.transactions : 0),
+             (unsigned long) stats.maxMicros);
+    mqttSend(mqttTopic, mqttData);
+  }
 
-      mqttSend(config.mqtt_topic3, mqttData);
+  // Geiger tube on <diagnostics topic>/geiger: pulses not timestamped (ring full), then the
+  // inter-arrival histogram bins, see Proc_GeigerSensor
+  char histogram[16 + Proc_GeigerSensor::GEIGER_HISTOGRAM_BINS * 11];
+  const unsigned long *bins = procPtr.GeigerSensor.getIntervalHistogram();
+  int length = snprintf(histogram, sizeof(histogram), "lost=%lu&bins=", procPtr.GeigerSensor.getLostTimestamps());
+  for (int i = 0; i < Proc_GeigerSensor::GEIGER_HISTOGRAM_BINS; i++)
+    length += snprintf(histogram + length, sizeof(histogram) - length, i ? ",%lu" : "%lu", bins[i]);
+  snprintf(mqttTopic, sizeof(mqttTopic), "%s/geiger", config.mqtt_diag_topic);
+  mqttSend(mqttTopic, histogram);
+
+  lastDiagnostics = millis();
+}
 
+int Proc_MQTTUpdate::mqttSend(char *mqttTopic, char *mqttData)
+{
 #ifdef DEBUG_SYSLOG
-      syslog.log(LOG_DEBUG, "mqttData3 " + String(mqttData));
+  syslog.log(LOG_DEBUG, String(F("Updating MQTT with ")) + String(mqttData));
 #endif
 
-      // Remember last update
-      sprintf(lastMqttUpdate, "%d/%d/%d %d:%02d.%02d   ", day(), month(), year(), hour(), minute(), second());
+  // Publish data to ThingSpeak
+  int rc = mqttClient.publish(mqttTopic, mqttData);
 
-      // Experimental
-      /*
-            if (mqttClient.connected())
-            {
-              // Disconnect from server
-              mqttClient.disconnect();
-            }
-            else
-            {
-              // TEMP log zzzzz
-              syslog.log(LOG_DEBUG, "MQTT not connected, so no need to disconnect");
-            }
-      */
-    }
-  }
 #ifdef DEBUG_SYSLOG
-  syslog.log(LOG_INFO, "END Proc_MQTTUpdate::service()");
+  syslog.logf(LOG_DEBUG, "MQTT outcome =  % d ", rc);
 #endif
-}
 
+  return rc;
+}
 
-bool Proc_MQTTUpdate::mqttReconnect()
+// Send the oldest history minute not delivered yet, one per MQTT_BACKFILL_PERIOD:
+// ThingSpeak drops faster updates to a channel without telling. Returns true when
+// there was nothing left to send
+bool Proc_MQTTUpdate::backfill()
 {
-  // If already connected, exit
-  if (mqttClient.connected())
+  if (!procPtr.History.isValid())
+    return true;
+
+  if (!cursorLoaded)
+    loadCursor();
+
+  TimeSeries &minutes = procPtr.History.getTier(HISTORY_1MIN);
+  int index = minutes.find(sentUntil + 1);
+
+  HistoryRecord record;
+  if (minutes.read(index, &record, 1) < 1)
     return true;
-  else
+
+  // On failure retry the same record next time, so nothing is skipped
+  if (!publishRecord(record))
   {
-    for (int attempt = 1; attempt < 5; attempt++)
+    if (mqttClient.connected() && stalledAt != record.time)
     {
+      stalledAt = record.time;
+      errLog(F("MQTT backfill - record refused"));
+    }
+    return false;
+  }
+
+  backfilled++;
+  sentUntil = record.time;
+  saveCursor();
+
 #ifdef DEBUG_SYSLOG
-      syslog.logf(LOG_DEBUG, "MQTT connection, attempt %d", attempt);
+  syslog.logf(LOG_DEBUG, "MQTT backfill: %d left", getBacklog());
 #endif
 
-      // Note: to avoid thingspeak occasional lockout
-      String randomID = systemID + String(random(999999));
+  return false;
+}
 
-      // Connect to the MQTT broker
-      if (mqttClient.connect(randomID.c_str(), "username", "password"))
-      {
-        if (attempt > 1)
-          errLog(String(F("MQTT retries:")) + String(attempt));
+// Same fields as the live topics where the history has them, time stamped (UTC)
+bool Proc_MQTTUpdate::publishRecord(const HistoryRecord &record)
+{
+  char mqttData[128];
+  char createdAt[24];
 
-        return true;
-      }
-      else
-      {
+  if (config.mqttFormat == MQTT_FORMAT_BINARY)
+  {
+    TelemetryPacket packet;
+    packet.begin(record.time);
+    for (int i = 0; i < sensorChannelCount; i++)
+    {
+      const SensorChannel &channel = sensorChannels[i];
+      if (channel.telemetry != CHANNEL_NONE && channel.history != CHANNEL_NONE)
+        packet.add(channel.telemetry, Proc_History::decode(channel.history, record.values[channel.history]));
+    }
+    return mqttClient.publish(config.mqtt_topic1, packet.data(), packet.size());
+  }
 
-#ifdef DEBUG_SYSLOG
-        errLog(String(F("MQTT fail,err ")) + String(mqttClient.state()));
-#endif
-        // Wait a bit and retry (2000 ms)
-        for (int wait = 1 ; wait < 40; wait++)
-        {
-          // Wait before retrying
-          // unless a userEvent needs to be serviced
-          if (!procPtr.UIManager.eventPending())
-          {
-            delay(50);
-          }
-          else
-          {
-            // Cannot update MQTT as UserEvent is pending...
-            // ...so, force scheduling so to retry asap
-            errLog(F("MQTT connect - giving up as user event pending"));
-
-            this->force();
-            return false;
-          }
-        }
+  time_t utc = record.time;
+  sprintf(createdAt, "%04d-%02d-%02dT%02d:%02d:%02dZ", year(utc), month(utc), day(utc), hour(utc), minute(utc), second(utc));
+
+  char *topics[MQTT_TEXT_TOPICS] = { config.mqtt_topic1, config.mqtt_topic2, config.mqtt_topic3 };
+
+  for (int topic = 1; topic <= MQTT_TEXT_TOPICS; topic++)
+  {
+    bool recorded = false;
+    mqttData[0] = 0;
+    for (int field = 1; field <= MQTT_TEXT_FIELDS; field++)
+    {
+      const SensorChannel *channel = textChannel(topic, field);
+      if (!channel || channel->history == CHANNEL_NONE)
+        continue;
+      recorded = true;
+      float value = Proc_History::decode(channel->history, record.values[channel->history]);
+
+      // Not recorded, or above the stored range: leave it out rather than send the limit
+      if (isnan(value) || isinf(value))
+        continue;
+      appendParam(mqttData, params[field - 1]);
+      dtostrf(value, 1, Proc_History::decimals(channel->history), &mqttData[strlen(mqttData)]);
+    }
+
+    // Nothing of this topic is recorded
+    if (!recorded)
+      continue;
+
+    appendParam(mqttData, PARAM_CREATED_AT);
+    strcat(mqttData, createdAt);
+
+    if (!mqttSend(topics[topic - 1], mqttData))
+      return false;
+  }
+
+  return true;
+}
+
+// The cursor is appended to one of two small logs, so no page is rewritten on every
+// update. When the log in use is full the other one is restarted: the newest cursor
+// stays in the full one until the restarted log holds a newer one, so a reset at any
+// point never loses it. The newest entry of the two wins at load
+static const char *const cursorLogs[2] = { "/mqtt_sent0", "/mqtt_sent1" };
+
+void Proc_MQTTUpdate::loadCursor()
+{
+  cursorLoaded = true;
+
+  // Single log of older firmware, in local time
+  SPIFFS.remove(F("/mqtt_sent"));
+
+  for (uint8_t i = 0; i < 2; i++)
+  {
+    fs::File file = SPIFFS.open(cursorLogs[i], "r");
+    if (!file)
+      continue;
+
+    uint32_t cursor = 0;
+    size_t size = file.size() - file.size() % sizeof(cursor);
+    if (size >= sizeof(cursor))
+    {
+      file.seek(size - sizeof(cursor), fs::SeekSet);
+      if (file.read((uint8_t *) &cursor, sizeof(cursor)) == sizeof(cursor) && cursor > sentUntil)
+      {
+        sentUntil = cursor;
+        cursorLog = i;
       }
     }
+    file.close();
+  }
+}
 
-    // All attempts were exausted, giving up..
-    errLog(String(F("MQTT giveup,err ")) + String(mqttClient.state()));
-    return false;
+void Proc_MQTTUpdate::saveCursor()
+{
+  fs::File file = SPIFFS.open(cursorLogs[cursorLog], "a");
+  if (file && file.size() >= MQTT_CURSOR_LOG_SIZE)
+  {
+    file.close();
+    cursorLog ^= 1;
+    file = SPIFFS.open(cursorLogs[cursorLog], "w");
   }
+  if (!file)
+    return;
+
+  file.write((const uint8_t *) &sentUntil, sizeof(sentUntil));
+  file.close();
 }
 
-int Proc_MQTTUpdate::mqttSend(char *mqttTopic, char *mqttData)
+unsigned long Proc_MQTTUpdate::getBackfilled()
 {
-#ifdef DEBUG_SYSLOG
-  syslog.log(LOG_DEBUG, String(F("Updating MQTT with ")) + String(mqttData));
-#endif
+  return backfilled;
+}
 
-  // Publish data to ThingSpeak
-  int rc = mqttClient.publish(mqttTopic, mqttData);
+// History minutes not delivered yet
+int Proc_MQTTUpdate::getBacklog()
+{
+  if (!procPtr.History.isValid())
+    return 0;
 
-#ifdef DEBUG_SYSLOG
-  syslog.logf(LOG_DEBUG, "MQTT outcome =  % d ", rc);
-#endif
+  TimeSeries &minutes = procPtr.History.getTier(HISTORY_1MIN);
+  return minutes.count() - minutes.find(sentUntil + 1);
+}
+
+// Consecutive failed connection attempts, 0 when connected
+int Proc_MQTTUpdate::getConnectFailures()
+{
+  return connectFailures;
 }
 
 char* Proc_MQTTUpdate::getLastMqttUpdate()
@@ -4,27 +4,55 @@
 #include <PubSubClient.h>         //https://github.com/knolleary/pubsubclient
 #include <ProcessScheduler.h>     // https://github.com/wizard97/ArduinoProcessScheduler
 #include <ESP8266HTTPClient.h>
+#include "TimeSeries.h"
+#include "ServiceMonitor.h"
+
+#define MQTT_BACKFILL_PERIOD 15000    // (ms) between history records while catching up: ThingSpeak takes one update per channel per 15 s
+#define MQTT_CURSOR_LOG_SIZE 256      // (bytes) appends switch to the other cursor log when this big
+#define MQTT_BACKOFF_MIN 2000         // (ms) first reconnection delay
+#define MQTT_BACKOFF_MAX 300000       // (ms) reconnection delay cap
+#define MQTT_BUFFER_SIZE 256          // (bytes) packet buffer: a 63 char topic and a time stamped record
 
 extern WiFiClient wifiClient;
 
 // Process definition
-class Proc_MQTTUpdate : public Process
+class Proc_MQTTUpdate : public MonitoredProcess
 {
   public:
     Proc_MQTTUpdate(Scheduler &manager, ProcPriority pr, unsigned int period, int iterations)
-      :  mqttClient (wifiClient), Process(manager, pr, period, iterations) {}
+      :  MonitoredProcess(manager, pr, period, iterations, "MQTT"), mqttClient (wifiClient) {}
 
     char* getLastMqttUpdate();
+    unsigned long getBackfilled();
+    int getBacklog();
+    int getConnectFailures();
 
   protected:
     virtual void setup();
-    virtual void service();
+    virtual void run();
 
   private:
     PubSubClient mqttClient;
     bool mqttReconnect();
     int mqttSend(char *mqttTopic, char *mqttData);
+    bool publishText();
+    bool publishBinary();
+    void publishDiagnostics();
+    bool backfill();
+    bool publishRecord(const HistoryRecord &record);
+    void loadCursor();
+    void saveCursor();
     char lastMqttUpdate[25];
+    uint8_t connectFailures = 0;
+    unsigned long nextAttempt = 0;    // (millis) no connection attempt or update before
+    unsigned long lastDiagnostics = 0;
+
+    // Outbox: the history minute tier, sent up to this sample time (UTC)
+    uint32_t sentUntil = 0;
+    bool cursorLoaded = false;
+    uint8_t cursorLog = 0;            // cursor log appended to, of the two
+    unsigned long backfilled = 0;
+    uint32_t stalledAt = 0;           // record the outbox is stuck on, logged once
 };
 
 
@@ -6,6 +6,7 @@
 #include "ArialRoundedMTBold_14.h"
 #include "ArialRoundedMTBold_36.h"
 #include "ScreenLowbatt.h"
+#include "Widgets.h"
 
 #include <TFT_eSPI.h>             // https://github.com/Bodmer/TFT_eSPI
 #include <NtpClientLib.h>         // https://github.com/gmag11/NtpClient
@@ -20,6 +21,8 @@ extern TFT_eSPI LCD;
 extern struct Configuration config;
 extern struct ProcessContainer procPtr;
 extern GfxUi ui;
+extern PowerManager power;
+extern I2CBus i2cBus;
 
 // Prototypes
 void errLog(String msg);
@@ -28,7 +31,7 @@ Proc_UIManager * Proc_UIManager::instance = nullptr;
 
 
 Proc_UIManager::Proc_UIManager(Scheduler &manager, ProcPriority pr, unsigned int period, int iterations)
-  :  Process(manager, pr, period, iterations), avgSOC(AVERAGING_WINDOW) {}
+  :  MonitoredProcess(manager, pr, period, iterations, "UI") {}
 
 
 void Proc_UIManager::setup()
@@ -68,6 +71,12 @@ void Proc_UIManager::setup()
 
   // Refresh screen for first time
   currentScreen->update();
+  if (currentScreen->getWidgets())
+    currentScreen->getWidgets()->flush();
+  animating = true;
+  if (!procPtr.Animator.isEnabled())
+    ServiceMonitor::restart(&procPtr.Animator);
+  procPtr.Animator.enable();
 
   // Set screen refresh interval appropriate for current screen
   this->setPeriod(currentScreen->getRefreshPeriod());
@@ -80,31 +89,45 @@ void Proc_UIManager::setup()
   eventTime = millis();
 }
 
-
-void Proc_UIManager::service()
+// The boot progress bar is drawn after setup(): start again from a clean screen
+void Proc_UIManager::onEnable()
 {
+  currentScreen->deactivate();
+  LCD.fillScreen(TFT_BLACK);
+  currentScreen->activate();
+
+  // Forget previous screen update, so to force immediate refresh
+  currentScreen->lastUpdate = 0;
+
+  // Force redraw of top bar if required
+  if (!currentScreen->isFullScreen())
+    drawBar(true);
+}
 
+void Proc_UIManager::run()
+{
 #ifdef DEBUG_SYSLOG
-  syslog.log(LOG_INFO, F("Proc_DisplayUpdate::service()"));
+  syslog.log(LOG_INFO, F("Proc_DisplayUpdate::run()"));
 #endif
 
+  // Retried whenever the bus lets the sensor be tried again
   if (!initSuccess)
-  {
-    errLog(F("Gesture sensor was not initialised - retrying"));
-
     initSuccess = initGesture();
-  }
 
   long starttime = millis();
 
+  // Last good reading if the gauge does not answer, NAN if it never did
+  float volt = getVolt();
+
   // Calculate state of charge (linear approximation on voltage)
-  float SoC = 100 / (VOLT_HIGH - VOLT_LOW) * (getVolt() - VOLT_LOW);
-  avgSOC.push(SoC > 100 ? 100 : SoC); // 3.6v = 100 %; 3v = 0 %
+  float SoC = 100 / (VOLT_HIGH - VOLT_LOW) * (volt - VOLT_LOW);
+  if (!isnan(SoC))
+    avgSOC.push(SoC > 100 ? 100 : SoC); // 3.6v = 100 %; 3v = 0 %
 
 
   // Handle low battery condition
   // If battery depleted, force LOWBAT screen and move on
-  if (getVolt() <= VOLT_LOW)
+  if (volt <= VOLT_LOW)
   {
     // Was already at the lowbatt screen?
     if ( currentScreenID != LOWBATT_SCREEN)
@@ -131,24 +154,15 @@ void Proc_UIManager::service()
       // Set screen refresh interval appropriate for current screen
       this->setPeriod(currentScreen->getRefreshPeriod());
 
-      // Switch off processes
-      // TODO: now hardcoded... make it generic and implement global stopProcesses
-      procPtr.ComboTemperatureHumiditySensor.disable();
-      procPtr.ComboPressureHumiditySensor.disable();
-      procPtr.ParticleSensor.disable();
-      procPtr.CO2Sensor.disable();
-      procPtr.VOCSensor.disable();
-      procPtr.MultiGasSensor.disable();
-      procPtr.MQTTUpdate.disable();
-      procPtr.GeigerSensor.disable();
-      procPtr.GeoLocation.disable();
+      // Switch off sensors and network, the UI and the history keep going
+      power.suspend(POWER_SENSOR);
 
     }
     // Already in lowbatt screen, nothing to do
   }
 
   // If in LOWBATT mode and battery is recharging, reset
-  else if (getVolt() > VOLT_HIGH &&  currentScreenID == LOWBATT_SCREEN)
+  else if (volt > VOLT_HIGH &&  currentScreenID == LOWBATT_SCREEN)
   {
     syslog.log(LOG_INFO, F("BATTERY HIGH - RESTARTING SYSTEM") );
     delay(1000);
@@ -208,7 +222,9 @@ void Proc_UIManager::service()
 #ifdef DEBUG_SERIAL
           Serial.println("++++ Spurious event!");
 #endif
-          gestureSensor.cancelGesture();
+          I2CTransaction bus(i2cBus, I2C_GESTURE);
+          if (bus.granted())
+            gestureSensor.cancelGesture();
           eventFlag = false;
         }
       }
@@ -381,15 +397,37 @@ void Proc_UIManager::service()
       // refresh screen
       currentScreen->lastUpdate = millis();
       currentScreen->update();
+
+      // Push only the widgets that changed
+      WidgetGroup *widgets = currentScreen->getWidgets();
+      if (widgets)
+        widgets->flush();
+
+      // Anything the update set moving is drawn by the Animator process
+      animating = true;
+      if (!procPtr.Animator.isEnabled())
+        ServiceMonitor::restart(&procPtr.Animator);
+      procPtr.Animator.enable();
     }
   }
 
 #ifdef DEBUG_SYSLOG
-  syslog.log(LOG_INFO, F("END Proc_DisplayUpdate::service()"));
+  syslog.log(LOG_INFO, F("END Proc_DisplayUpdate::run()"));
 #endif
 
 }
 
+bool Proc_UIManager::isAnimating()
+{
+  return animating;
+}
+
+// One frame, none while the display is off: the next update starts over from where the screen stopped
+void Proc_UIManager::animate()
+{
+  animating = isDisplayOn && currentScreen->animate();
+}
+
 String Proc_UIManager:: getCurrentScreenName()
 {
   return currentScreen->getScreenName();
@@ -412,8 +450,9 @@ void Proc_UIManager::onGesture()
     // Remember event
     eventFlag = true;
 
-    // Force scheduling
+    // Force scheduling, now rather than after the current sleep
     this->force();
+    power.wake();
 
     // Remember last user event
     eventTime = millis();
@@ -447,7 +486,8 @@ int Proc_UIManager::getUserEvent()
   syslog.log(LOG_DEBUG, F("Reading event..."));
 #endif
 
-  int gesture = gestureSensor.readGesture() ;
+  I2CTransaction bus(i2cBus, I2C_GESTURE);
+  int gesture = bus.granted() ? gestureSensor.readGesture() : GES_NONE;
 
   // NOTE: Gesture have been remaped to accommodate for the sensor positioning in the case!!
   switch (gesture)
@@ -532,6 +572,7 @@ void Proc_UIManager::drawBar(bool forceDraw)
 {
 
   String lineBuffer;
+  bool forceSeparator = false;
 
   // ********* Date display
 
@@ -588,6 +629,9 @@ void Proc_UIManager::drawBar(bool forceDraw)
     topBar.locationLine = lineBuffer;
     LCD.setTextPadding(LCD.textWidth(F("                          ")));  // String width + margin
     LCD.drawString(lineBuffer, 120, 63); // was 65
+
+    // The padding may overwrite the separator
+    forceSeparator = true;
   }
 
 #ifdef DEBUG_SYSLOG
@@ -630,11 +674,12 @@ void Proc_UIManager::drawBar(bool forceDraw)
 
 
   // ************ Draw battery gauge
-  drawBatteryGauge(5, 17, getSoC(), 30, forceDraw);
+  drawBatteryGauge(getSoC(), 30, forceDraw);
 
 
   // Draw separator between upper bar and application screen
-  ui.drawSeparator(64);
+  if (forceDraw || forceSeparator)
+    ui.drawSeparator(64);
 
   LCD.setTextPadding(0);
 
@@ -731,32 +776,19 @@ void Proc_UIManager::drawWifiGauge(int topX, int topY, int dBm, bool forceDraw)
   }
 }
 
-void Proc_UIManager::drawBatteryGauge(int topX, int topY, int batLevel, int redLevel, bool forceDraw)
+void Proc_UIManager::drawBatteryGauge(int batLevel, int redLevel, bool forceDraw)
 {
-  // Draw it only if it changed, unless forced
-  if (batLevel != topBar.batLevel || forceDraw)
+  // Outline only when the bar is redrawn, then the fill has to go out again
+  if (forceDraw)
   {
-    // Remember last printed value
-    topBar.batLevel = batLevel;
-
-    // Draw it
-    int batHeight = 24;
-    int batWidth = 10;
-    int tipHeight = 2;
-    int tipWidth = 4;
-
-    // Draw battery outline
-    LCD.fillRect(topX + batWidth / 2 - tipWidth / 2, topY, tipWidth, tipHeight, TFT_WHITE); // tip
-    LCD.drawRect(topX, topY + tipHeight, batWidth, batHeight, TFT_WHITE); // battery body
-
-    // Decide fill color
-    int batfillColor = batLevel > 30 ? TFT_GREEN : TFT_RED;
-    int batFillHeight = batLevel * (batHeight - 2) / 100;
-
-    // Fill battery + complement
-    LCD.fillRect(topX + 1, topY + batHeight + tipHeight - batFillHeight - 1, batWidth - 2, batFillHeight , batfillColor); // Fill
-    LCD.fillRect(topX + 1, topY + tipHeight + 1, batWidth - 2, batHeight - batFillHeight - 2, TFT_BLACK);                 // Complement
+    LCD.fillRect(BATTERY_X + BATTERY_WIDTH / 2 - BATTERY_TIP_WIDTH / 2, BATTERY_Y, BATTERY_TIP_WIDTH, BATTERY_TIP_HEIGHT, TFT_WHITE); // tip
+    LCD.drawRect(BATTERY_X, BATTERY_Y + BATTERY_TIP_HEIGHT, BATTERY_WIDTH, BATTERY_HEIGHT, TFT_WHITE); // battery body
+    topBar.battery.invalidate();
   }
+
+  // Fill + complement, repainted only if the level or its colour changed
+  topBar.battery.setLevel(batLevel, batLevel > redLevel ? TFT_GREEN : TFT_RED);
+  topBar.battery.flush();
 }
 
 
@@ -798,6 +830,7 @@ bool Proc_UIManager::initDisplay()
     pinMode(BACKLIGHT_PIN, OUTPUT);
     displayInitialized = true;
   }
+  return displayInitialized;
 }
 
 
@@ -807,8 +840,11 @@ bool Proc_UIManager::initDisplay()
 
 void Proc_UIManager::batterySetup()
 {
-  batteryMonitor.reset();
-  batteryMonitor.quickStart();
+  {
+    I2CTransaction bus(i2cBus, I2C_FUEL_GAUGE);
+    batteryMonitor.reset();
+    batteryMonitor.quickStart();
+  }
   delay(1000);
 }
 
@@ -863,17 +899,33 @@ String Proc_UIManager::printDigits(int digits)
   return buffer + digits;
 }
 
+// Last good values while the gauge does not answer: it reads all zeros or all ones, though 0 % is a valid SoC
 float Proc_UIManager::getVolt()
 {
-  return batteryMonitor.getVCell();
+  I2CTransaction bus(i2cBus, I2C_FUEL_GAUGE);
+  if (bus.granted())
+  {
+    float volt = batteryMonitor.getVCell();
+    if (volt > 0 && volt < 5.1)
+      lastVolt = volt;
+    else
+      bus.fail();
+  }
+  return lastVolt;
 }
 
 float Proc_UIManager::getNativeSoC()
 {
-  float SoC = batteryMonitor.getSoC();
-  if (SoC > 100)
-    SoC = 100;
-  return SoC;
+  I2CTransaction bus(i2cBus, I2C_FUEL_GAUGE);
+  if (bus.granted())
+  {
+    float SoC = batteryMonitor.getSoC();
+    if (SoC < 255)
+      lastSoC = SoC > 100 ? 100 : SoC;
+    else
+      bus.fail();
+  }
+  return lastSoC;
 }
 
 
@@ -887,10 +939,22 @@ bool Proc_UIManager::initGesture()
 {
   for (int i = 0; i < 3; i++)
   {
-    // Gesture sensor initialization
-    gestureSensor = PAJ7620U();
+    uint8_t error;
+    {
+      I2CTransaction bus(i2cBus, I2C_GESTURE);
+
+      // Failing sensor, not to be tried again yet
+      if (!bus.granted())
+        return false;
+
+      // Gesture sensor initialization
+      gestureSensor = PAJ7620U();
+
+      error = gestureSensor.begin();
+      if (error)
+        bus.fail();
+    }
 
-    uint8_t error = gestureSensor.begin();
     if (!error)
     {
       syslog.log(LOG_DEBUG, F("PAJ7620U initialization successful"));
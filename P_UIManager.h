@@ -1,25 +1,37 @@
 #pragma once
 
 #include <ProcessScheduler.h>
+#include "ServiceMonitor.h"
 #include "ScreenFactory.h"
 #include "GfxUi.h"      // Additional UI functions
 
 #include <libpaj7620.h>           // https://github.com/MarcFinns/Gesture_PAJ7620
 #include <MAX17043.h>             // https://github.com/lucadentella/ArduinoLib_MAX17043
-#include <Average.h>              // https://github.com/MajenkoLibraries/Average
+#include "RollingStats.h"
+#include "Widgets.h"
+
+// Top bar battery gauge, tip included
+#define BATTERY_X 5
+#define BATTERY_Y 17
+#define BATTERY_WIDTH 10
+#define BATTERY_HEIGHT 24
+#define BATTERY_TIP_WIDTH 4
+#define BATTERY_TIP_HEIGHT 2
 
 struct TopBar
 {
   String dateLine;
   String timeLine;
   String locationLine;
-  int batLevel = 0;
   int dBm = 0;
+
+  // Inside the battery outline
+  GaugeWidget battery { BATTERY_X + 1, BATTERY_Y + BATTERY_TIP_HEIGHT + 1, BATTERY_WIDTH - 2, BATTERY_HEIGHT - 2, true };
 };
 
 
 // UI Process definition
-class Proc_UIManager : public Process
+class Proc_UIManager : public MonitoredProcess
 {
   public:
     Proc_UIManager(Scheduler &manager, ProcPriority pr, unsigned int period, int iterations);
@@ -32,6 +44,10 @@ class Proc_UIManager : public Process
     bool isDisplayOn = false;
     String getCurrentScreenName();
 
+    // Frames of what the last screen update set moving
+    bool isAnimating();
+    void animate();
+
     // Battery gauge
     float getVolt();
     float getSoC();
@@ -42,7 +58,8 @@ class Proc_UIManager : public Process
 
   protected:
     virtual void setup();
-    virtual void service();
+    virtual void run();
+    virtual void onEnable();
 
   private:
     // properties
@@ -55,12 +72,15 @@ class Proc_UIManager : public Process
     //long lastUpdate = 0;
     PAJ7620U gestureSensor;
     MAX17043 batteryMonitor;
-    Average<float> avgSOC;
+    RollingStats<float, AVERAGING_SAMPLES> avgSOC;
+    float lastVolt = NAN;             // last good fuel gauge readings
+    float lastSoC = NAN;
 
     bool displayInitialized;
     static Proc_UIManager * instance;
     TopBar topBar;
     bool initSuccess = false;
+    bool animating = false;
 
     // methods
     int getUserEvent();
@@ -68,7 +88,7 @@ class Proc_UIManager : public Process
     void initScreen();
     void drawBar(bool forceDraw = false);
     void drawSeparator(uint16_t y);
-    void drawBatteryGauge(int topX, int topY, int level, int redLevel, bool forceDraw);
+    void drawBatteryGauge(int level, int redLevel, bool forceDraw);
     void drawWifiGauge(int topX, int topY, int rssi, bool forceDraw);
 
     bool initGesture();
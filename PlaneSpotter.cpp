@@ -36,6 +36,11 @@ PlaneSpotter::PlaneSpotter(TFT_eSPI* tft, GeoMap* geoMap) {
   geoMap_ = geoMap;
 
 }
+void PlaneSpotter::setBackground(MapBackground *background)
+{
+  background_ = background;
+}
+
 /*
   void PlaneSpotter::copyProgmemToSpiffs(const uint8_t *data, unsigned int length, String filename) {
   fs::File f = SPIFFS.open(filename, "w+");
@@ -49,7 +54,7 @@ PlaneSpotter::PlaneSpotter(TFT_eSPI* tft, GeoMap* geoMap) {
 
 */
 
-void PlaneSpotter::drawAircraftHistory(Aircraft aircraft, AircraftHistory history)
+void PlaneSpotter::drawAircraftHistory(const Aircraft &aircraft, const AircraftHistory &history)
 {
 #ifdef DEBUG_SYSLOG 
   syslog.log(LOG_INFO, F("PlaneSpotter::drawAircraftHistory"));
@@ -67,6 +72,11 @@ void PlaneSpotter::drawAircraftHistory(Aircraft aircraft, AircraftHistory histor
 
     CoordinatesPixel p2 = geoMap_->convertToPixel(lastCoordinates);
     uint16_t color = heightPalette_[min(position.altitude / 4000, 9)];
+    if (background_)
+    {
+      background_->markLine(p1.x, p1.y, p2.x, p2.y);
+      background_->markLine(p1.x + 1, p1.y + 1, p2.x + 1, p2.y + 1);
+    }
     tft_->drawLine(p1.x, p1.y, p2.x, p2.y, color);
     tft_->drawLine(p1.x + 1, p1.y + 1, p2.x + 1, p2.y + 1, color);
 
@@ -78,7 +88,7 @@ void PlaneSpotter::drawAircraftHistory(Aircraft aircraft, AircraftHistory histor
 
 }
 
-void PlaneSpotter::drawPlane(Aircraft aircraft, bool isSpecial)
+void PlaneSpotter::drawPlane(const Aircraft &aircraft, bool isSpecial)
 {
 #ifdef DEBUG_SYSLOG 
   syslog.log(LOG_INFO, F("PlaneSpotter::drawPlane"));
@@ -94,6 +104,14 @@ void PlaneSpotter::drawPlane(Aircraft aircraft, bool isSpecial)
   tft_->setTextPadding(0);
   tft_->setTextColor(TFT_BLACK, TFT_LIGHTGREY);
   tft_->setTextDatum(BC_DATUM);
+  if (background_)
+  {
+    // Label (drawString moves it back on screen at the edges), then the plane within its largest radius
+    int labelWidth = tft_->textWidth(aircraft.call, GFXFONT);
+    int labelX = constrain(p.x + 8 - labelWidth / 2, 0, tft_->width() - labelWidth);
+    background_->mark(labelX - 2, p.y + 13 - tft_->fontHeight(GFXFONT), labelX + labelWidth + 2, p.y + 17);
+    background_->mark(p.x - 11, p.y - 11, p.x + 11, p.y + 11);
+  }
   //tft_->drawString(aircraft.call, p.x + 8, p.y - 5, GFXFONT );
   tft_->drawString(aircraft.call, p.x + 8, p.y + 15, GFXFONT );
 
@@ -121,7 +139,7 @@ void PlaneSpotter::drawPlane(Aircraft aircraft, bool isSpecial)
 #endif
 }
 
-void PlaneSpotter::drawInfoBox(Aircraft closestAircraft)
+void PlaneSpotter::drawInfoBox(const Aircraft &closestAircraft)
 {
 #ifdef DEBUG_SYSLOG 
   syslog.log(LOG_INFO, F("PlaneSpotter::drawInfoBox"));
@@ -137,7 +155,7 @@ void PlaneSpotter::drawInfoBox(Aircraft closestAircraft)
   // tft_->fillRect(0, tft_->height() - 20, tft_->width(), 20, TFT_BLACK);
 
 
-  if (closestAircraft.call != "")
+  if (closestAircraft.call[0])
   {
     tft_->setFreeFont(&Dialog_plain_9);
 
@@ -178,7 +196,7 @@ void PlaneSpotter::drawInfoBox(Aircraft closestAircraft)
         tft_->setTextPadding(xwidth);
         tft_->drawString("Hdg: " + String(closestAircraft.heading, 0), right - xwidth, line2, GFXFONT );
     */
-    if (closestAircraft.fromShort != "" && closestAircraft.toShort != "")
+    if (closestAircraft.fromShort[0] && closestAircraft.toShort[0])
     {
       // Use print stream so the line wraps (tft_->print does not work, kludge is to get the String returned so we can use the print class!)
       tft_->setFreeFont(&Dialog_plain_9);
@@ -186,7 +204,7 @@ void PlaneSpotter::drawInfoBox(Aircraft closestAircraft)
       tft_->setTextColor(TFT_GREEN, TFT_BLACK);
       tft_->setTextDatum(BL_DATUM);
       tft_->setTextWrap(1);
-      tft_->print("From: " + closestAircraft.fromShort + "=>" + closestAircraft.toShort);
+      tft_->print(String(F("From: ")) + closestAircraft.fromShort + "=>" + closestAircraft.toShort);
     }
   }
 
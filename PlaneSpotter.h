@@ -35,6 +35,7 @@
 
 #include "AdsbExchangeClient.h"
 #include "GeoMap.h"
+#include "MapBackground.h"
 
 #include <JPEGDecoder.h>          // https://github.com/Bodmer/JPEGDecoder
 #include <TFT_eSPI.h>             // https://github.com/Bodmer/TFT_eSPI
@@ -46,13 +47,17 @@ enum TextAlignment {
 class PlaneSpotter {
   public:
     PlaneSpotter(TFT_eSPI* tft, GeoMap* geoMap);
-    void drawPlane(Aircraft aircraft, bool isSpecial);
-    void drawInfoBox(Aircraft closestAircraft);
-    void drawAircraftHistory(Aircraft aircraft, AircraftHistory history);
+    void drawPlane(const Aircraft &aircraft, bool isSpecial);
+    void drawInfoBox(const Aircraft &closestAircraft);
+    void drawAircraftHistory(const Aircraft &aircraft, const AircraftHistory &history);
+
+    // Where to mark what the planes and trails cover, so it can be restored
+    void setBackground(MapBackground *background);
 
   private:
     TFT_eSPI* tft_;
     GeoMap* geoMap_;
+    MapBackground* background_ = nullptr;
     // Shape of the plane
     // The points are defined as degree on a circle, the first array are the degrees,
     // the second the radius of the circle
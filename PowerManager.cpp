@@ -0,0 +1,135 @@
+#include "PowerManager.h"
+#include "GlobalDefinitions.h"
+#include "ESP8266WiFi.h"
+
+#include <limits.h>
+#include <Syslog.h>               // https://github.com/arcao/ESP8266_Syslog
+
+// External variables
+extern Syslog syslog;
+
+void PowerManager::begin(uint8_t mode)
+{
+  this->mode = mode;
+
+  switch (mode)
+  {
+    case POWER_MODE_MODEM_SLEEP:
+      WiFi.setSleepMode(WIFI_MODEM_SLEEP);
+      break;
+
+    default:
+      WiFi.setSleepMode(WIFI_NONE_SLEEP);
+      break;
+  }
+
+#ifdef DEBUG_SYSLOG
+  syslog.logf(LOG_INFO, "Power mode %d", mode);
+#endif
+}
+
+uint8_t PowerManager::getMode()
+{
+  return mode;
+}
+
+uint8_t PowerManager::modeFromName(const char *name)
+{
+  if (name && strcmp(name, "active") == 0)
+    return POWER_MODE_ACTIVE;
+  return POWER_MODE_MODEM_SLEEP;
+}
+
+const char *PowerManager::modeName(uint8_t mode)
+{
+  switch (mode)
+  {
+    case POWER_MODE_ACTIVE: return "active";
+    default: return "modem";
+  }
+}
+
+// Time to the earliest enabled process, negative if one is overdue
+long PowerManager::untilNextDeadline()
+{
+  uint32_t now = millis();
+  long next = LONG_MAX;
+
+  for (int i = 0; i < processCount; i++)
+  {
+    Process *process = processTable[i].process;
+    if (process->isEnabled())
+      next = min(next, (long) (int32_t) (process->getScheduledTS() - now));
+  }
+  return next;
+}
+
+void PowerManager::idle()
+{
+  if (mode == POWER_MODE_ACTIVE)
+    return;
+
+  long wait = untilNextDeadline();
+  if (wait < POWER_MIN_SLEEP)
+    return;
+
+  wakeRequested = false;
+  sleeps++;
+  unsigned long start = micros();
+
+  while (wait > 0 && !wakeRequested)
+  {
+    long slice = min(wait, (long) POWER_SLEEP_SLICE);
+    delay(slice);
+    wait -= slice;
+  }
+
+  if (wakeRequested)
+    earlyWakes++;
+  sleepMicros += micros() - start;
+}
+
+void ICACHE_RAM_ATTR PowerManager::wake()
+{
+  wakeRequested = true;
+}
+
+void PowerManager::suspend(uint8_t powerClass)
+{
+  for (int i = 0; i < processCount; i++)
+  {
+    if (processTable[i].powerClass >= powerClass && processTable[i].process->isEnabled())
+    {
+      processTable[i].process->disable();
+      suspended |= 1UL << i;
+    }
+  }
+}
+
+void PowerManager::resume()
+{
+  for (int i = 0; i < processCount; i++)
+  {
+    if (suspended & (1UL << i))
+    {
+      ServiceMonitor::restart(processTable[i].process);
+      processTable[i].process->enable();
+    }
+  }
+  suspended = 0;
+}
+
+uint64_t PowerManager::getSleepMicros()
+{
+  return sleepMicros;
+}
+
+unsigned long PowerManager::getSleeps()
+{
+  return sleeps;
+}
+
+unsigned long PowerManager::getEarlyWakes()
+{
+  return earlyWakes;
+}
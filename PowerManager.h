@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Arduino.h"
+
+#define POWER_MIN_SLEEP 5             // (ms) shorter idle times are spent spinning
+#define POWER_SLEEP_SLICE 50          // (ms) longest single delay, bounds the wake up latency
+
+// How the idle time between process runs is spent
+enum PowerMode
+{
+  POWER_MODE_ACTIVE,                  // spin the scheduler, WiFi always on
+  POWER_MODE_MODEM_SLEEP              // idle in delay(), WiFi modem off between beacons
+};
+
+// -------------------------------------------------------
+// Power manager
+// -------------------------------------------------------
+//
+// Called from loop() after each scheduler pass. Works out when the next
+// enabled process is due, from the scheduled time of each entry of
+// processTable, and idles until then instead of spinning, so the SDK can
+// put the modem to sleep. The idle time is a few delay() slices: a user
+// gesture forces the UI process, so its interrupt calls wake() and the
+// next scheduler pass runs at the end of the current slice. The CPU stays
+// up, so the Geiger and gesture edge interrupts keep firing.
+//
+// suspend() and resume() switch whole power classes off and on again,
+// e.g. everything that samples or needs WiFi when the battery is low.
+
+class PowerManager
+{
+  public:
+    void begin(uint8_t mode);
+    uint8_t getMode();
+
+    // "active" or "modem" as in the configuration, modem sleep if unknown
+    static uint8_t modeFromName(const char *name);
+    static const char *modeName(uint8_t mode);
+
+    // Sleep until the next process is due, or wake() is called
+    void idle();
+    void wake();
+
+    // Disable every enabled process of powerClass and above, resume() enables them again
+    void suspend(uint8_t powerClass);
+    void resume();
+
+    // Since boot
+    uint64_t getSleepMicros();
+    unsigned long getSleeps();
+    unsigned long getEarlyWakes();
+
+  private:
+    long untilNextDeadline();
+
+    uint8_t mode = POWER_MODE_ACTIVE;
+    volatile bool wakeRequested = false;
+    uint32_t suspended = 0;           // processTable entries disabled by suspend(), a bit each
+
+    uint64_t sleepMicros = 0;
+    unsigned long sleeps = 0;
+    unsigned long earlyWakes = 0;
+};
@@ -0,0 +1,225 @@
+#pragma once
+
+#include "Arduino.h"
+
+// -------------------------------------------------------
+// Rolling statistics over the last N samples
+// -------------------------------------------------------
+//
+// Replaces Average<float>: every query is O(1) instead of a loop over the window.
+//  - mean / variance: sliding Welford update on each push. The running sums are
+//    recomputed from the window once per turnover (every N pushes) so float
+//    rounding cannot build up
+//  - min / max: monotonic wedges of window slots, amortized O(1) per push
+//  - jitter: spread of the changes between successive samples, kept the same
+//    way as the variance. A steady trend changes every sample by about the
+//    same amount and adds nothing, so it measures the noise of a drifting signal
+// Storage is fixed size, no heap.
+//
+// Windows count samples, not time: with adaptive sampling periods of 2 to 30 s
+// a window of AVERAGING_SAMPLES spans 24 s to 6 minutes, shorter while the
+// signal moves.
+
+#define AVERAGING_SAMPLES 12        // 1 minute at the former fixed 5 s sampling period
+
+// Snapshot of a window, cheap to pass around
+struct SensorStats
+{
+  float last;
+  float mean;
+  float stddev;
+  float minimum;
+  float maximum;
+};
+
+template <typename T, uint16_t N>
+class RollingStats
+{
+    static_assert(N >= 1 && N <= 255, "RollingStats window must be 1..255 samples");
+
+  public:
+    void push(T value)
+    {
+      float x = value;
+
+      if (_count > 0)
+      {
+        float step = x - (float) last();
+        _stepSum += step;
+        _stepSquares += step * step;
+      }
+
+      if (_count == N)
+      {
+        // Window full: replace the oldest sample, keeping the count
+        float old = _values[_next];
+        float oldMean = _mean;
+        _mean += (x - old) / N;
+        _m2 += (x - old) * (x - _mean + old - oldMean);
+
+        // So does the change from the oldest sample to the next one
+        float step = (float) _values[(_next + 1) % N] - (float) _values[_next];
+        _stepSum -= step;
+        _stepSquares -= step * step;
+
+        // Oldest sample leaves the wedges too
+        _maxWedge.expire(_next);
+        _minWedge.expire(_next);
+      }
+      else
+      {
+        _count++;
+        float delta = x - _mean;
+        _mean += delta / _count;
+        _m2 += delta * (x - _mean);
+      }
+
+      _values[_next] = value;
+
+      // Drop the samples that can no longer be the max (min) of any window
+      while (_maxWedge.size > 0 && _values[_maxWedge.back()] <= value)
+        _maxWedge.popBack();
+      _maxWedge.pushBack(_next);
+
+      while (_minWedge.size > 0 && _values[_minWedge.back()] >= value)
+        _minWedge.popBack();
+      _minWedge.pushBack(_next);
+
+      if (++_next == N)
+      {
+        _next = 0;
+        reanchor();
+      }
+    }
+
+    float mean() const
+    {
+      return _count ? _mean : 0;
+    }
+
+    // Sample variance
+    float variance() const
+    {
+      return (_count > 1 && _m2 > 0) ? _m2 / (_count - 1) : 0;
+    }
+
+    float stddev() const
+    {
+      return sqrt(variance());
+    }
+
+    // Standard deviation of the changes between successive samples
+    float jitter() const
+    {
+      uint16_t steps = _count > 0 ? _count - 1 : 0;
+      if (steps < 2)
+        return 0;
+
+      float variance = (_stepSquares - _stepSum * _stepSum / steps) / (steps - 1);
+      return variance > 0 ? sqrt(variance) : 0;
+    }
+
+    T minimum() const
+    {
+      return _count ? _values[_minWedge.front()] : T();
+    }
+
+    T maximum() const
+    {
+      return _count ? _values[_maxWedge.front()] : T();
+    }
+
+    // Most recent sample
+    T last() const
+    {
+      return _count ? _values[(_next + N - 1) % N] : T();
+    }
+
+    SensorStats stats() const
+    {
+      // No sample yet: last is NAN
+      SensorStats s = { _count ? (float) last() : NAN, mean(), stddev(), (float) minimum(), (float) maximum() };
+      return s;
+    }
+
+    uint16_t getCount() const
+    {
+      return _count;
+    }
+
+    uint16_t size() const
+    {
+      return N;
+    }
+
+    void clear()
+    {
+      _count = 0;
+      _next = 0;
+      _mean = 0;
+      _m2 = 0;
+      _stepSum = 0;
+      _stepSquares = 0;
+      _maxWedge.size = 0;
+      _minWedge.size = 0;
+    }
+
+  private:
+    // Deque of window slots, values along it are monotonic
+    struct Wedge
+    {
+      uint8_t slots[N];
+      uint8_t head = 0;
+      uint8_t size = 0;
+
+      uint8_t front() const { return slots[head]; }
+      uint8_t back() const { return slots[(head + size - 1) % N]; }
+      void popBack() { size--; }
+      void pushBack(uint8_t slot) { slots[(head + size++) % N] = slot; }
+
+      // Slot is about to be overwritten: if it is still here it is the oldest entry
+      void expire(uint8_t slot)
+      {
+        if (size > 0 && slots[head] == slot)
+        {
+          head = (head + 1) % N;
+          size--;
+        }
+      }
+    };
+
+    // Exact two pass recomputation, once per window turnover
+    void reanchor()
+    {
+      float sum = 0;
+      for (uint16_t i = 0; i < _count; i++)
+        sum += _values[i];
+      _mean = sum / _count;
+
+      float m2 = 0;
+      for (uint16_t i = 0; i < _count; i++)
+        m2 += (_values[i] - _mean) * (_values[i] - _mean);
+      _m2 = m2;
+
+      // Called as the window wraps: slots 0 .. _count - 1 are in time order
+      float stepSum = 0, stepSquares = 0;
+      for (uint16_t i = 1; i < _count; i++)
+      {
+        float step = (float) _values[i] - (float) _values[i - 1];
+        stepSum += step;
+        stepSquares += step * step;
+      }
+      _stepSum = stepSum;
+      _stepSquares = stepSquares;
+    }
+
+    T _values[N];
+    uint16_t _count = 0;
+    uint16_t _next = 0;
+    float _mean = 0;
+    float _m2 = 0;
+    float _stepSum = 0;                 // sum of the changes between successive samples
+    float _stepSquares = 0;             // and of their squares
+    Wedge _maxWedge;
+    Wedge _minWedge;
+};
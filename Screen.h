@@ -1,6 +1,8 @@
 #pragma once
 #include "Arduino.h"
 
+class WidgetGroup;
+
 // Screen Handler definition
 class Screen
 {
@@ -16,6 +18,8 @@ class Screen
     virtual bool getRefreshWithScreenOff() = 0;
     virtual String getScreenName() = 0;
     virtual bool isFullScreen() = 0;
+    virtual WidgetGroup *getWidgets() { return nullptr; }   // retained content, flushed by the UI manager after update()
+    virtual bool animate() { return false; }                // one frame of what update() set moving, true while more are due
     long lastUpdate = 0;
 };
 
@@ -16,6 +16,16 @@ extern struct Configuration config;
 extern String systemID;
 extern RingBufCPP<String, 18> lastErrors;
 
+ScreenErrLog::ScreenErrLog()
+{
+  int height = pgm_read_byte(&Dialog_plain_9.yAdvance);
+  for (int i = 0; i < ERRLOG_LINES; i++)
+  {
+    lines[i] = TextWidget(0, 100 + i * height, &Dialog_plain_9, L_BASELINE);
+    widgets.add(lines[i]);
+  }
+}
+
 void ScreenErrLog::activate()
 {
 #ifdef DEBUG_SYSLOG
@@ -29,6 +39,8 @@ void ScreenErrLog::activate()
 
   LCD.setTextDatum(TC_DATUM);
   LCD.drawString(F("Last error events"), 120, 68, GFXFF);
+
+  widgets.invalidate();
 }
 
 void ScreenErrLog::update()
@@ -37,24 +49,42 @@ void ScreenErrLog::update()
   syslog.log(LOG_INFO, F("ScreenErrLog::update()"));
 #endif
 
-  LCD.setTextDatum(TL_DATUM);
-  LCD.setTextColor(TFT_WHITE, TFT_BLACK);
+  // Newest first, wrapped at the screen edge; lines only go out again when the log moved
   LCD.setFreeFont(&Dialog_plain_9);
-  LCD.setTextWrap(true);
-  LCD.setCursor(0, 100);
+  int line = 0;
+  for (int i = lastErrors.numElements() - 1; i >= 0 && line < ERRLOG_LINES; i--)
+  {
+    String msg = *lastErrors.peek(i);
+    unsigned int start = 0;
+    do
+    {
+      unsigned int length = fitLine(msg, start);
+      lines[line++].setText(msg.substring(start, start + length));
+      start += length;
+    } while (start < msg.length() && line < ERRLOG_LINES);
+  }
 
-  // Clear print area
-  LCD.fillRect(0, 80, 240, 240, TFT_BLACK);
+  while (line < ERRLOG_LINES)
+    lines[line++].setText("");
+}
 
-  // Loop through all existing elements (if any)
-  for ( int x = lastErrors.numElements(); x > 0; x--)
-  {
-    // Retrieve element
-    String msg = *lastErrors.peek(x - 1);
+// Characters of msg from start that fit in one line, at least one so a line always moves on
+unsigned int ScreenErrLog::fitLine(const String &msg, unsigned int start)
+{
+  // Most messages fit whole
+  if (LCD.textWidth(start ? msg.substring(start) : msg, GFXFF) <= ERRLOG_WIDTH)
+    return msg.length() - start;
 
-    // Print it
-    LCD.println(msg);
+  int width = 0;
+  unsigned int end = start;
+  while (end < msg.length())
+  {
+    width += LCD.textWidth(String(msg[end]), GFXFF);
+    if (width > ERRLOG_WIDTH && end > start)
+      break;
+    end++;
   }
+  return end - start;
 }
 
 void ScreenErrLog::deactivate()
@@ -89,3 +119,8 @@ bool ScreenErrLog::getRefreshWithScreenOff()
 {
   return false;
 }
+
+WidgetGroup *ScreenErrLog::getWidgets()
+{
+  return &widgets;
+}
@@ -1,13 +1,17 @@
 #pragma once
 
 #include "Screen.h"
+#include "Widgets.h"
+
+#define ERRLOG_LINES 18
+#define ERRLOG_WIDTH 240          // (px) longer messages wrap onto the next line
 
 
 // Screen Handler definition
 class ScreenErrLog: public Screen
 {
   public:
-    ScreenErrLog() {}
+    ScreenErrLog();
     virtual ~ScreenErrLog() {}
     virtual void activate();
     virtual void update();
@@ -17,6 +21,14 @@ class ScreenErrLog: public Screen
     virtual String getScreenName();
     virtual bool isFullScreen();
     virtual bool getRefreshWithScreenOff();
+    virtual WidgetGroup *getWidgets();
+
+  private:
+    unsigned int fitLine(const String &msg, unsigned int start);
+
+    // Logged errors, newest on top, wrapped over as many lines as they need
+    WidgetGroup widgets;
+    TextWidget lines[ERRLOG_LINES];
 };
 
 
@@ -81,4 +81,9 @@ bool ScreenGeiger::getRefreshWithScreenOff()
   return true;
 }
 
+bool ScreenGeiger::animate()
+{
+  return analogMeter.animate();
+}
+
 
@@ -18,6 +18,7 @@ class ScreenGeiger: public Screen
     virtual String getScreenName();
     virtual bool isFullScreen();
     virtual bool getRefreshWithScreenOff();
+    virtual bool animate();
 
   private:
     AnalogMeter analogMeter;
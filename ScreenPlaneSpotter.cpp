@@ -1,5 +1,5 @@
 
-#include "ScreenplaneSpotter.h"
+#include "ScreenPlaneSpotter.h"
 #include <ESP8266WiFi.h>
 #include "Free_Fonts.h"
 #include "ArialRoundedMTBold_14.h"
@@ -22,6 +22,9 @@ bool isTurbo();
 
 const String QUERY_STRING = "fAltL=1500&trFmt=sa";
 
+// Kept while other screens are shown
+static int mapZoom = MAP_ZOOM;
+
 void ScreenPlaneSpotter::activate()
 {
 #ifdef DEBUG_SYSLOG
@@ -42,6 +45,10 @@ void ScreenPlaneSpotter::activate()
     return;
   }
 
+  // Aircraft tracked, kept while other screens are shown. On the heap, only if the screen is used
+  if (!config.adsbClient)
+    config.adsbClient = new AdsbExchangeClient();
+
   // Create GeoMap object
   //geoMap = new GeoMap(MapProvider::Google, GOOGLE_API_KEY, MAP_WIDTH, MAP_HEIGHT);
 
@@ -49,8 +56,8 @@ void ScreenPlaneSpotter::activate()
   mapCenter.lat = procPtr.GeoLocation.getLatitude();
   mapCenter.lon = procPtr.GeoLocation.getLongitude();
 
-  // Draw Planespotter Splash Screen but only if map is not loaded yet
-  if (!geoMap.setMap(mapCenter, MAP_ZOOM))
+  // Draw Planespotter Splash Screen but only if map tiles are missing
+  if (!geoMap.setMap(mapCenter, mapZoom))
   {
     //  TURBO mode
     setTurbo(true);
@@ -70,18 +77,11 @@ void ScreenPlaneSpotter::activate()
     LCD.setTextDatum(TC_DATUM);
     LCD.setTextColor(TFT_ORANGE, TFT_BLACK);
     LCD.drawString(F("Loading map..."), 120, 280, 1 );
-
-    geoMap.downloadMap();
   }
 
   // planeSpotter = new PlaneSpotter(&LCD, &geoMap);
 
-  // NOTE: clipping on top by 15 pixels, not to dirty the upper bar...
-  northWestBound = geoMap.convertToCoordinates({0, 15});
-  southEastBound = geoMap.convertToCoordinates({MAP_WIDTH, MAP_HEIGHT - 15});
-
-  // Draw map
-  ui.drawJpeg(geoMap.getMapName(), 0, TOP_BAR_HEIGHT);
+  loadMap();
 
   LCD.fillRect(0, geoMap.getMapHeight() + TOP_BAR_HEIGHT, LCD.width(), LCD.height() - geoMap.getMapHeight() - TOP_BAR_HEIGHT, TFT_BLACK);
 
@@ -89,6 +89,18 @@ void ScreenPlaneSpotter::activate()
 
 }
 
+// Fetch the tiles still missing, then draw the map from its cached background
+void ScreenPlaneSpotter::loadMap()
+{
+  geoMap.downloadMap();
+
+  // NOTE: clipping on top by 15 pixels, not to dirty the upper bar...
+  northWestBound = geoMap.convertToCoordinates({0, 15});
+  southEastBound = geoMap.convertToCoordinates({MAP_WIDTH, MAP_HEIGHT - 15});
+
+  background.load(&geoMap);
+}
+
 void ScreenPlaneSpotter::update()
 {
 
@@ -102,57 +114,57 @@ void ScreenPlaneSpotter::update()
   if ( !config.connected || !isInitialised)
   return;
 
-  //local variable for test
-  AdsbExchangeClient * adsbClient;
+  AdsbExchangeClient &adsbClient = *config.adsbClient;
 
-#ifdef DEBUG_SYSLOG
-  syslog.log(LOG_DEBUG, "1- START UPDATING ADSB = " + String(ESP.getFreeHeap()) + " bytes");
-#endif
-
-    adsbClient = new AdsbExchangeClient();
+  // Download the list only every ADSB_FETCH_PERIOD, it is merged into the aircraft already tracked
+  if (millis() - lastFetchMillis >= ADSB_FETCH_PERIOD)
+  {
+    lastFetchMillis = millis();
 
 #ifdef DEBUG_SYSLOG
-    syslog.log(LOG_DEBUG, "2 - AFTER INSTANCIATING ADSBCLIENT = " + String(ESP.getFreeHeap()) + " bytes");
+    syslog.log(LOG_DEBUG, "1- START UPDATING ADSB = " + String(ESP.getFreeHeap()) + " bytes");
 #endif
 
-    adsbClient->updateVisibleAircraft(QUERY_STRING +
-                                      "&lat=" +
-                                      String(mapCenter.lat, 6) +
-                                      "&lng=" + String(mapCenter.lon, 6) +
-                                      "&fNBnd=" + String(northWestBound.lat, 9) +
-                                      "&fWBnd=" +
-                                      String(northWestBound.lon, 9) +
-                                      "&fSBnd=" +
-                                      String(southEastBound.lat, 9) +
-                                      "&fEBnd=" +
-                                      String(southEastBound.lon, 9));
+    adsbClient.updateVisibleAircraft(QUERY_STRING +
+                                     "&lat=" +
+                                     String(mapCenter.lat, 6) +
+                                     "&lng=" + String(mapCenter.lon, 6) +
+                                     "&fNBnd=" + String(northWestBound.lat, 9) +
+                                     "&fWBnd=" +
+                                     String(northWestBound.lon, 9) +
+                                     "&fSBnd=" +
+                                     String(southEastBound.lat, 9) +
+                                     "&fEBnd=" +
+                                     String(southEastBound.lon, 9));
 
 #ifdef DEBUG_SYSLOG
-    syslog.log(LOG_DEBUG, "3 - AFTER CALL TO ADSBCLIENT = " + String(ESP.getFreeHeap()) + " bytes");
+    syslog.log(LOG_DEBUG, "2 - AFTER CALL TO ADSBCLIENT = " + String(ESP.getFreeHeap()) + " bytes");
 #endif
+  }
 
-    Aircraft closestAircraft = adsbClient->getClosestAircraft(mapCenter.lat, mapCenter.lon);
+  // In between, aircraft move along their last track
+  adsbClient.extrapolate();
+  int closest = adsbClient.getClosestAircraft(mapCenter.lat, mapCenter.lon);
 
     // Before refreshing display, check if a userEvent is pending and skip in case
     if ( !procPtr.UIManager.eventPending())
     {
-      // Draw map
-      ui.drawJpeg(geoMap.getMapName(), 0, TOP_BAR_HEIGHT);
+      // Put the map back where the planes were
+      background.restore();
 
       // Get aircrafts data
-      for (int i = 0; i < adsbClient->getNumberOfAircrafts(); i++)
+      for (int i = 0; i < adsbClient.getNumberOfAircrafts(); i++)
       {
-        Aircraft aircraft = adsbClient->getAircraft(i);
-        AircraftHistory history = adsbClient->getAircraftHistory(i);
-        planeSpotter.drawAircraftHistory(aircraft, history);
-        planeSpotter.drawPlane(aircraft, aircraft.call == closestAircraft.call);
+        const Aircraft &aircraft = adsbClient.getAircraft(i);
+        planeSpotter.drawAircraftHistory(aircraft, adsbClient.getAircraftHistory(i));
+        planeSpotter.drawPlane(aircraft, i == closest);
       }
 
       // Draf info of closest aircraft
-      if (adsbClient->getNumberOfAircrafts())
+      if (closest >= 0)
       {
         // YES - print infobox of the closes
-        planeSpotter.drawInfoBox(closestAircraft);
+        planeSpotter.drawInfoBox(adsbClient.getAircraft(closest));
       }
       else
       {
@@ -173,14 +185,7 @@ void ScreenPlaneSpotter::update()
     }
 
 #ifdef DEBUG_SYSLOG
-  syslog.log(LOG_DEBUG, "4 - AFTER DRAWING = " + String(ESP.getFreeHeap()) + " bytes");
-#endif
-
-  // Free up memory
-  delete adsbClient;
-
-#ifdef DEBUG_SYSLOG
-  syslog.log(LOG_DEBUG, "5 - AFTER CLEANUP = " + String(ESP.getFreeHeap()) + " bytes");
+  syslog.log(LOG_DEBUG, "3 - AFTER DRAWING = " + String(ESP.getFreeHeap()) + " bytes");
 
   syslog.log(LOG_DEBUG, "Rendering took (mS) " + String(millis() - startMillis));
 #endif
@@ -201,7 +206,28 @@ void ScreenPlaneSpotter::deactivate()
 
 bool ScreenPlaneSpotter::onUserEvent(int event)
 {
-  return false;
+  if (!isInitialised || (event != GES_UP && event != GES_DOWN))
+    return false;
+
+  // Zoom in or out around the same center, tiles seen before come from the cache
+  int zoom = constrain(mapZoom + (event == GES_UP ? 1 : -1), MAP_MIN_ZOOM, MAP_MAX_ZOOM);
+  if (zoom == mapZoom)
+    return true;
+  mapZoom = zoom;
+
+  if (!geoMap.setMap(mapCenter, mapZoom))
+  {
+    LCD.fillRect(0, geoMap.getMapHeight() + TOP_BAR_HEIGHT, LCD.width(), LCD.height() - geoMap.getMapHeight() - TOP_BAR_HEIGHT, TFT_BLACK);
+    LCD.setTextDatum(TC_DATUM);
+    LCD.setTextColor(TFT_ORANGE, TFT_BLACK);
+    LCD.drawString(F("Loading map..."), 120, 280, 1 );
+  }
+  loadMap();
+
+  // New bounds, so new aircraft list right away
+  lastFetchMillis = millis() - ADSB_FETCH_PERIOD;
+  update();
+  return true;
 }
 
 long ScreenPlaneSpotter::getRefreshPeriod()
@@ -4,6 +4,7 @@
 #include "AdsbExchangeClient.h"
 #include "GeoMap.h"
 #include "PlaneSpotter.h"
+#include "MapBackground.h"
 
 extern TFT_eSPI LCD;
 
@@ -12,8 +13,11 @@ class ScreenPlaneSpotter: public Screen
 {
   public:
     // Call the Process constructor
-    ScreenPlaneSpotter(): geoMap(MapProvider::Google, GOOGLE_API_KEY, MAP_WIDTH, MAP_HEIGHT),
-      planeSpotter(&LCD, &geoMap) {};
+    ScreenPlaneSpotter(): geoMap(MAP_PROVIDER, MAP_WIDTH, MAP_HEIGHT),
+      planeSpotter(&LCD, &geoMap), background(&LCD, 0, TOP_BAR_HEIGHT, MAP_WIDTH, MAP_HEIGHT)
+    {
+      planeSpotter.setBackground(&background);
+    };
     virtual ~ScreenPlaneSpotter() {};
     virtual void activate();
     virtual void update();
@@ -26,12 +30,16 @@ class ScreenPlaneSpotter: public Screen
     bool isInitialised = false;
 
   private:
+    void loadMap();
+
     //PlaneSpotter* planeSpotter;
     //AdsbExchangeClient* adsbClient;
     // GeoMap* geoMap;
 
     GeoMap geoMap;
     PlaneSpotter planeSpotter;
+    MapBackground background;
+    long lastFetchMillis = -ADSB_FETCH_PERIOD;
     Coordinates mapCenter;
     Coordinates northWestBound;
     Coordinates southEastBound;
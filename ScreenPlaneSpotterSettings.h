@@ -36,6 +36,13 @@ See more at https://blog.squix.org
 #define GFXFONT 1
 
 #define MAP_ZOOM 10 //11
+#define MAP_MIN_ZOOM 6
+#define MAP_MAX_ZOOM 13
+#define MAP_PROVIDER MapProvider::ArcGisStreet
+
+#define TILE_CACHE_BUDGET 400000 // (bytes) of SPIFFS for map tiles, the least recently used go first
+
+#define ADSB_FETCH_PERIOD 10000 // (ms) between aircraft list downloads, positions are extrapolated in between
 #define MAP_WIDTH 240//320
 #define MAP_HEIGHT 210 //180 // was 200
 
@@ -3,7 +3,7 @@
 #include "GlobalDefinitions.h"
 #include "P_AirSensors.h"
 #include "Free_Fonts.h"
-#include "Artwork.h"
+#include "artwork.h"
 
 #include <Syslog.h>               // https://github.com/arcao/ESP8266_Syslog
 #include <TFT_eSPI.h>             // https://github.com/Bodmer/TFT_eSPI
@@ -15,6 +15,27 @@ extern TFT_eSPI LCD;
 extern GfxUi ui;
 extern struct ProcessContainer procPtr;
 
+// Row top, leaving half a line at the separators before CO2, PM01 and CPM
+static int rowY(int row)
+{
+  int height = pgm_read_byte(&Dialog_plain_15.yAdvance);
+  int separators = (row >= 3) + (row >= 7) + (row >= 10);
+  return 75 + row * height + separators * height / 2;
+}
+
+ScreenSensors::ScreenSensors()
+{
+  for (int row = 0; row < SENSOR_ROWS; row++)
+  {
+    values[row] = TextWidget(75, rowY(row), &Dialog_plain_15, TL_DATUM);
+    spreads[row] = TextWidget(238, rowY(row) + 2, &Dialog_plain_12, TR_DATUM, TFT_DARKGREY);
+    widgets.add(values[row]);
+    widgets.add(spreads[row]);
+    lastValue[row] = -1;
+    lastColor[row] = TFT_WHITE;
+  }
+}
+
 void ScreenSensors::activate()
 {
 #ifdef DEBUG_SYSLOG 
@@ -27,53 +48,21 @@ void ScreenSensors::activate()
   // LCD.setFreeFont(FM9);                 // Select the font
   //LCD.setFreeFont(FSSB9);
   LCD.setFreeFont(&Dialog_plain_15);
-  int xpos = 5;
-  int ypos = 75;
-
-  LCD.drawString(F("Temp"), xpos, ypos);
-
-  ypos +=  LCD.fontHeight(GFXFF);
-  LCD.drawString(F("Humid"), xpos, ypos, GFXFF);
-
-  ypos +=  LCD.fontHeight(GFXFF);
-  LCD.drawString(F("Press"), xpos, ypos, GFXFF);
-
-  ypos +=  LCD.fontHeight(GFXFF);
-  ui.drawSeparator(ypos);
-  ypos +=  LCD.fontHeight(GFXFF) / 2;
-
-  LCD.drawString(F("CO2"), xpos, ypos, GFXFF);
-
-  ypos +=  LCD.fontHeight(GFXFF);
-  LCD.drawString(F("CO"), xpos, ypos, GFXFF);
 
-  ypos +=  LCD.fontHeight(GFXFF);
-  LCD.drawString(F("NO2"), xpos, ypos, GFXFF);
+  for (int i = 0; i < sensorChannelCount; i++)
+  {
+    if (sensorChannels[i].row != CHANNEL_NONE)
+      LCD.drawString(sensorChannels[i].label, 5, rowY(sensorChannels[i].row), GFXFF);
+  }
 
-  ypos +=  LCD.fontHeight(GFXFF);
-  LCD.drawString(F("VOC"), xpos, ypos, GFXFF);
-
-  ypos +=  LCD.fontHeight(GFXFF);
-  ui.drawSeparator(ypos);
-  ypos +=  LCD.fontHeight(GFXFF) / 2;
-
-  LCD.drawString(F("PM01"), xpos, ypos, GFXFF);
-
-  ypos +=  LCD.fontHeight(GFXFF);
-  LCD.drawString(F("PM2.5"), xpos, ypos, GFXFF);
-
-  ypos +=  LCD.fontHeight(GFXFF);
-  LCD.drawString(F("PM10"), xpos, ypos, GFXFF);
-
-  ypos +=  LCD.fontHeight(GFXFF);
-  ui.drawSeparator(ypos);
-  ypos +=  LCD.fontHeight(GFXFF) / 2;
-
-  LCD.drawString(F("CPM"), xpos, ypos, GFXFF);
-
-  ypos +=  LCD.fontHeight(GFXFF);
-  LCD.drawString(F("Rad"), xpos, ypos, GFXFF);
+  // Before CO2, PM01 and CPM
+  int height = pgm_read_byte(&Dialog_plain_15.yAdvance);
+  ui.drawSeparator(rowY(3) - height / 2);
+  ui.drawSeparator(rowY(7) - height / 2);
+  ui.drawSeparator(rowY(10) - height / 2);
 
+  // Screen was cleared, values have to go out again
+  widgets.invalidate();
 }
 
 void ScreenSensors::update()
@@ -82,98 +71,44 @@ void ScreenSensors::update()
   syslog.log(LOG_INFO, F("ScreenSensors::update()"));
 #endif
 
-  LCD.setTextDatum(TL_DATUM);
-  LCD.setTextColor(TFT_WHITE, TFT_BLACK);
-  //  LCD.setFreeFont(FM9);                 // Select the font
-  //LCD.setFreeFont(FSS9);
-  LCD.setFreeFont(&Dialog_plain_15);
-
-  float currValue;
-
-  int xpos = 75;
-  int ypos = 75;
-
-  // TEMPERATURE
-  printWithTrend(lastTemperatureColor, lastTemperature, procPtr.ComboTemperatureHumiditySensor.getTemperature(), F(" C  "), 1 , xpos, ypos);
-
-  // HUMIDITY
-  ypos +=  LCD.fontHeight(GFXFF);
-  printWithTrend(lastHumidityColor, lastHumidity, procPtr.ComboTemperatureHumiditySensor.getHumidity() , F(" % "), 1, xpos, ypos);
-
-  // PRESSURE
-  ypos +=  LCD.fontHeight(GFXFF);
-  printWithTrend(lastPressureColor, lastPressure, procPtr.ComboPressureHumiditySensor.getPressure() , F(" hPa "), 1, xpos, ypos);
-
-  ypos +=  LCD.fontHeight(GFXFF);
-  ui.drawSeparator(ypos);
-  ypos +=  LCD.fontHeight(GFXFF) / 2;
-
-  // CO2
-  printWithTrend(lastCO2Color, lastCO2, procPtr.CO2Sensor.getCO2() , F(" ppm  "), 0,  xpos, ypos);
-
-  // CO
-  ypos +=  LCD.fontHeight(GFXFF);
-  printWithTrend(lastCOColor, lastCO , procPtr.MultiGasSensor.getCO() , F(" ppm   "), 2,  xpos, ypos);
-
-  // NO2
-  ypos +=  LCD.fontHeight(GFXFF);
-  printWithTrend(lastNO2Color, lastNO2 , procPtr.MultiGasSensor.getNO2() , F(" ppm  "), 2,  xpos, ypos);
-
-  // VOC
-  ypos +=  LCD.fontHeight(GFXFF);
-  printWithTrend(lastVOCColor, lastVOC , procPtr.VOCSensor.getVOC() , F("   "), 0,  xpos, ypos);
-
-  ypos +=  LCD.fontHeight(GFXFF);
-  ui.drawSeparator(ypos);
-  ypos +=  LCD.fontHeight(GFXFF) / 2;
-
-  // PM01
-  printWithTrend(lastPM01Color, lastPM01 , procPtr.ParticleSensor.getPM01(), F(" ug/m3   "), 0,  xpos, ypos);
-
-  // PM25
-  ypos +=  LCD.fontHeight(GFXFF);
-  printWithTrend(lastPM2_5Color, lastPM2_5 , procPtr.ParticleSensor.getPM2_5() , F(" ug/m3   "), 0,  xpos, ypos);
-
-  // PM10
-  ypos +=  LCD.fontHeight(GFXFF);
-  printWithTrend(lastPM10Color, lastPM10 , procPtr.ParticleSensor.getPM10() , F(" ug/m3   "), 0,  xpos, ypos);
-
-  ypos +=  LCD.fontHeight(GFXFF);
-  ui.drawSeparator(ypos);
-  ypos +=  LCD.fontHeight(GFXFF) / 2;
-
-  // CPM
-  printWithTrend(lastCPMColor, lastCPM , procPtr.GeigerSensor.getCPM() , F(" Counts        "), 0,  xpos, ypos);
-
-  // RADIATION
-  ypos +=  LCD.fontHeight(GFXFF);
-  printWithTrend(lastRadiationColor, lastRadiation , procPtr.GeigerSensor.getRadiation() , F(" uSv/h     "), 2,  xpos, ypos);
+  // Only set values here, the UI manager pushes the rows that changed
+  for (int i = 0; i < sensorChannelCount; i++)
+  {
+    const SensorChannel &channel = sensorChannels[i];
+    if (channel.row != CHANNEL_NONE)
+      printWithTrend(channel.read(), channel.units, channel.decimals, channel.row);
+  }
 }
 
 
 
-void ScreenSensors::printWithTrend(int &lastColor, float &lastValue, float newValue, String suffix, int decimals, int xpos, int ypos)
+void ScreenSensors::printWithTrend(float newValue, String suffix, int decimals, int row)
 {
   // Decide new color
-  if (lastValue != -1)
-    if (newValue < lastValue)
-      lastColor = TFT_GREEN;
-    else if (newValue > lastValue)
-      lastColor = TFT_RED;
+  if (lastValue[row] != -1)
+    if (newValue < lastValue[row])
+      lastColor[row] = TFT_GREEN;
+    else if (newValue > lastValue[row])
+      lastColor[row] = TFT_RED;
 
   // NOTE: If value constant, dont change color (show past trent)
 
-  // Set color
-  LCD.setTextColor(lastColor, TFT_BLACK);
-
-  // Print value
-  LCD.drawString(" " + String(newValue, decimals) + suffix, xpos, ypos, GFXFF);
+  values[row].setColor(lastColor[row]);
+  values[row].setText(" " + String(newValue, decimals) + suffix);
 
   // Remember last value
-  lastValue = newValue;
+  lastValue[row] = newValue;
 
 }
 
+// Mean with trend, plus the spread over the averaging window (standard deviation) right aligned in grey
+void ScreenSensors::printWithTrend(SensorStats stats, String suffix, int decimals, int row)
+{
+  printWithTrend(stats.mean, suffix, decimals, row);
+  if (!isnan(stats.stddev))
+    spreads[row].setText(String(F("+/-")) + String(stats.stddev, decimals));
+}
+
 void ScreenSensors::deactivate()
 {
 #ifdef DEBUG_SYSLOG 
@@ -206,3 +141,8 @@ bool ScreenSensors::getRefreshWithScreenOff()
 {
   return false;
 }
+
+WidgetGroup *ScreenSensors::getWidgets()
+{
+  return &widgets;
+}
@@ -171,6 +171,9 @@ void  ScreenSetup::startHotspot()
   WiFiManagerParameter custom_mqtt_topic2("topic2", "MQTT Topic2", config.mqtt_topic2, 64);
   WiFiManagerParameter custom_mqtt_topic3("topic3", "MQTT Topic3", config.mqtt_topic3, 64);
   WiFiManagerParameter custom_syslog_server("syslog", "Syslog server", config.syslog_server, 20);
+  WiFiManagerParameter custom_mqtt_diag_topic("diag", "MQTT diagnostics topic (optional)", config.mqtt_diag_topic, 64);
+  WiFiManagerParameter custom_mqtt_format("format", "MQTT format (text/binary)", config.mqttFormat == MQTT_FORMAT_BINARY ? "binary" : "text", 8);
+  WiFiManagerParameter custom_power_mode("power", "Power mode (active/modem)", PowerManager::modeName(config.powerMode), 8);
 
   //Local intialization
   WiFiManager wifiManager;
@@ -187,6 +190,9 @@ void  ScreenSetup::startHotspot()
   wifiManager.addParameter(&custom_mqtt_topic2);
   wifiManager.addParameter(&custom_mqtt_topic3);
   wifiManager.addParameter(&custom_syslog_server);
+  wifiManager.addParameter(&custom_mqtt_format);
+  wifiManager.addParameter(&custom_power_mode);
+  wifiManager.addParameter(&custom_mqtt_diag_topic);
 
   // Goes into a blocking loop awaiting configuration
   wifiManager.setConfigPortalTimeout(300);
@@ -198,6 +204,9 @@ void  ScreenSetup::startHotspot()
   strcpy(config.mqtt_topic2, custom_mqtt_topic2.getValue());
   strcpy(config.mqtt_topic3, custom_mqtt_topic3.getValue());
   strcpy(config.syslog_server, custom_syslog_server.getValue());
+  config.mqttFormat = (strcmp(custom_mqtt_format.getValue(), "binary") == 0) ? MQTT_FORMAT_BINARY : MQTT_FORMAT_TEXT;
+  config.powerMode = PowerManager::modeFromName(custom_power_mode.getValue());
+  strcpy(config.mqtt_diag_topic, custom_mqtt_diag_topic.getValue());
 
   //save the custom parameters to FS
   if (shouldSaveConfig)
@@ -209,6 +218,9 @@ void  ScreenSetup::startHotspot()
     json[F("mqtt_topic2")] = config.mqtt_topic2;
     json[F("mqtt_topic3")] = config.mqtt_topic3;
     json[F("syslog_server")] = config.syslog_server;
+    json[F("mqtt_format")] = (config.mqttFormat == MQTT_FORMAT_BINARY) ? "binary" : "text";
+    json[F("power_mode")] = PowerManager::modeName(config.powerMode);
+    json[F("mqtt_diag_topic")] = config.mqtt_diag_topic;
 
     fs::File configFile = SPIFFS.open(F("/config.json"), "w");
     if (configFile)
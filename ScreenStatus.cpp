@@ -3,6 +3,7 @@
 #include "ESP8266WiFi.h"
 #include "GlobalDefinitions.h"
 #include "P_AirSensors.h"
+#include "ServiceMonitor.h"
 #include "Free_Fonts.h"
 #include "artwork.h"
 
@@ -15,6 +16,7 @@ extern TFT_eSPI LCD;
 extern struct ProcessContainer procPtr;
 extern struct Configuration config;
 extern String systemID;
+extern ServiceMonitor loopMonitor;
 
 void ScreenStatus::activate()
 {
@@ -24,6 +26,17 @@ void ScreenStatus::activate()
 
   LCD.fillScreen(TFT_BLACK);
 
+  drawLabels();
+}
+
+void ScreenStatus::drawLabels()
+{
+  if (showProcesses)
+  {
+    drawProcessLabels();
+    return;
+  }
+
   LCD.setTextColor(TFT_YELLOW, TFT_BLACK);
   LCD.setFreeFont(&Dialog_plain_13);
 
@@ -92,6 +105,12 @@ void ScreenStatus::update()
   syslog.log(LOG_INFO, F("ScreenStatus::update()"));
 #endif
 
+  if (showProcesses)
+  {
+    updateProcesses();
+    return;
+  }
+
   LCD.setTextDatum(TL_DATUM);
   LCD.setTextColor(TFT_WHITE, TFT_BLACK);
   //LCD.setFreeFont(FM9);                 // Select the font
@@ -150,6 +169,90 @@ void ScreenStatus::update()
   LCD.drawString(String(procPtr.MQTTUpdate.getLastMqttUpdate()), xpos, ypos, GFXFF);
 }
 
+// Process page columns, right aligned
+#define COL_RUNS 95
+#define COL_AVG 133
+#define COL_MAX 171
+#define COL_LATE 209
+#define COL_OVER 240
+#define ROW_SPACING 14
+
+// Counts in 4 characters, mostly
+static String shortCount(uint32_t count)
+{
+  if (count < 10000)
+    return String(count);
+  if (count < 1000000)
+    return String(count / 1000) + "k";
+  return String(count / 1000000) + "M";
+}
+
+void ScreenStatus::drawProcessLabels()
+{
+  LCD.setTextColor(TFT_YELLOW, TFT_BLACK);
+  LCD.setFreeFont(&Dialog_plain_13);
+
+  LCD.setTextDatum(TC_DATUM);
+  LCD.drawString(F("Process service times"), 120, 68, GFXFF);
+
+  LCD.setFreeFont(&Dialog_plain_9);
+  int ypos = 90;
+
+  LCD.setTextDatum(TL_DATUM);
+  LCD.drawString(F("(ms)"), 0, ypos, GFXFF);
+
+  LCD.setTextDatum(TR_DATUM);
+  LCD.drawString(F("Runs"), COL_RUNS, ypos, GFXFF);
+  LCD.drawString(F("Avg"), COL_AVG, ypos, GFXFF);
+  LCD.drawString(F("Max"), COL_MAX, ypos, GFXFF);
+  LCD.drawString(F("Late"), COL_LATE, ypos, GFXFF);
+  LCD.drawString(F("Ovr"), COL_OVER, ypos, GFXFF);
+
+  // Names do not change
+  LCD.setTextDatum(TL_DATUM);
+  for (ServiceMonitor *monitor = ServiceMonitor::getFirst(); monitor; monitor = monitor->getNext())
+  {
+    ypos += ROW_SPACING;
+    LCD.drawString(monitor->getName(), 0, ypos, GFXFF);
+  }
+}
+
+void ScreenStatus::updateProcesses()
+{
+  LCD.setTextColor(TFT_WHITE, TFT_BLACK);
+  LCD.setFreeFont(&Dialog_plain_9);
+  LCD.setTextDatum(TR_DATUM);
+
+  int ypos = 90;
+  for (ServiceMonitor *monitor = ServiceMonitor::getFirst(); monitor; monitor = monitor->getNext())
+  {
+    ypos += ROW_SPACING;
+    const ServiceStats &stats = monitor->getStats();
+
+    // Processes that ever missed their period stand out
+    LCD.setTextColor(stats.overruns ? TFT_RED : TFT_WHITE, TFT_BLACK);
+
+    uint32_t average = monitor->getAverageMicros();
+
+    LCD.setTextPadding(LCD.textWidth(F("0000")));
+    LCD.drawString(shortCount(stats.runs), COL_RUNS, ypos, GFXFF);
+    LCD.drawString(average < 100000 ? String(average / 1000.0, 1) : shortCount(average / 1000), COL_AVG, ypos, GFXFF);
+    LCD.drawString(shortCount(stats.maxMicros / 1000), COL_MAX, ypos, GFXFF);
+    LCD.drawString(shortCount(stats.maxLateness), COL_LATE, ypos, GFXFF);
+    LCD.setTextPadding(LCD.textWidth(F("00")));
+    LCD.drawString(shortCount(stats.overruns), COL_OVER, ypos, GFXFF);
+  }
+
+  // The loop monitor covers every pass, so its load is the CPU use of all processes together
+  ypos += 2 * ROW_SPACING;
+  LCD.setTextColor(TFT_DARKGREY, TFT_BLACK);
+  LCD.setTextDatum(TL_DATUM);
+  LCD.setTextPadding(LCD.textWidth(F("Scheduler load 100.0 %   ")));
+  LCD.drawString(String(F("Scheduler load ")) + String(loopMonitor.getLoad(), 1) + F(" %"), 0, ypos, GFXFF);
+
+  LCD.setTextPadding(0);
+}
+
 void ScreenStatus::deactivate()
 {
 #ifdef DEBUG_SYSLOG
@@ -160,6 +263,16 @@ void ScreenStatus::deactivate()
 
 bool ScreenStatus::onUserEvent(int event)
 {
+  if (event == GES_UP || event == GES_DOWN)
+  {
+    // Switch page and redraw it straight away, leaving the top bar alone
+    showProcesses = !showProcesses;
+    LCD.fillRect(0, 66, LCD.width(), LCD.height() - 66, TFT_BLACK);
+    drawLabels();
+    update();
+    return true;
+  }
+
   return false;
 }
 
@@ -18,6 +18,14 @@ class ScreenStatus: public Screen
     virtual String getScreenName();
     virtual bool isFullScreen();
     virtual bool getRefreshWithScreenOff();
+
+  private:
+    void drawLabels();
+    void drawProcessLabels();
+    void updateProcesses();
+
+    // Second page, toggled by up/down gestures: service time of each process
+    bool showProcesses = false;
 };
 
 
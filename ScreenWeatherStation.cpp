@@ -46,8 +46,9 @@
 
 // Download helper
 #include "WebResource.h"
+#include "AssetBundle.h"
 
-#include <syslog.h>               // https://github.com/arcao/ESP8266_Syslog
+#include <Syslog.h>               // https://github.com/arcao/ESP8266_Syslog
 #include <TFT_eSPI.h>             // https://github.com/Bodmer/TFT_eSPI
 
 // External variables
@@ -57,6 +58,7 @@ extern GfxUi ui;
 extern struct Configuration config;
 extern struct ProcessContainer procPtr;
 extern WebResource webResource;
+extern AssetBundle assets;
 
 // Prototypes
 void errLog(String msg);
@@ -171,27 +173,28 @@ void ScreenWeatherStation::update()
   updateData();
 }
 
-// callback called during download of files. Updates progress bar
-void ScreenWeatherStation::downloadCallback(String filename, int16_t bytesDownloaded, int16_t bytesTotal)
+// Called as each file of the queue is done. Updates progress bar
+static void downloadCallback(String filename, bool ok, uint16_t done, uint16_t total)
 {
-
   LCD.setTextDatum(BC_DATUM);
   LCD.setTextColor(TFT_ORANGE, TFT_BLACK);
   LCD.setTextPadding(240);
+  LCD.drawString(filename, 120, 220);
 
-  int percentage = 100 * bytesDownloaded / bytesTotal;
-  if (percentage == 0) {
-    LCD.drawString(filename, 120, 220);
-  }
-  if (percentage % 5 == 0) {
-    LCD.setTextDatum(TC_DATUM);
-    LCD.setTextPadding(LCD.textWidth(F(" 888% ")));
-    LCD.drawString(String(percentage) + F("%"), 120, 245);
-    ui.drawProgressBar(10, 225, 240 - 20, 15, percentage, TFT_WHITE, TFT_BLUE);
-  }
+  int percentage = total ? 100 * done / total : 100;
+  LCD.setTextDatum(TC_DATUM);
+  LCD.setTextPadding(LCD.textWidth(F(" 888% ")));
+  LCD.drawString(String(percentage) + F("%"), 120, 245);
+  ui.drawProgressBar(10, 225, 240 - 20, 15, percentage, TFT_WHITE, TFT_BLUE);
 }
 
-// Download the bitmaps
+// Called as each bitmap is packed
+static void packCallback(String filename, uint16_t done, uint16_t total)
+{
+  downloadCallback(filename, true, done, total);
+}
+
+// Download the bitmaps, or wait for the rest of them if the background download has started
 void ScreenWeatherStation::downloadResources()
 {
   // LCD.fillScreen(TFT_BLACK);
@@ -201,24 +204,25 @@ void ScreenWeatherStation::downloadResources()
   LCD.drawString(" ", 120, 240);  // Clear line
   LCD.drawString(" ", 120, 260);  // Clear line
 
-  char id[5];
-
-  // Download WU graphic jpeg first and display it, then the Earth view
-  webResource.downloadFile(F("http://i.imgur.com/njl1pMj.jpg"), F("/WU.jpg"), _downloadCallback);
-  if (SPIFFS.exists(F("/WU.jpg")) == true) ui.drawJpeg("/WU.jpg", 0, 10);
+  bool hadSplash = SPIFFS.exists(F("/WU.jpg"));
 
-  webResource.downloadFile(F("http://i.imgur.com/v4eTLCC.jpg"), F("/Earth.jpg"), _downloadCallback);
-  if (SPIFFS.exists(F("/Earth.jpg")) == true) ui.drawJpeg("/Earth.jpg", 0, 320 - 56);
+  queueResources();
+  webResource.finish(downloadCallback);
+  packResources();
 
-  // Download resources
-
-  char urlBuffer[100];
-  char fileNameBuffer[100];
-
-  for (int i = 0; i < 19; i++)
+  // Draw WU graphic jpeg and the Earth view, if they just arrived
+  if (!hadSplash)
   {
-    sprintf(id, "%02d", i);
+    if (SPIFFS.exists(F("/WU.jpg")) == true) ui.drawJpeg("/WU.jpg", 0, 10);
+    if (SPIFFS.exists(F("/Earth.jpg")) == true) ui.drawJpeg("/Earth.jpg", 0, 320 - 56);
+  }
+}
 
+// URL and file name of the i-th bitmap: icons, mini icons, moon phases
+static void getBitmapResource(int i, char *urlBuffer, char *fileNameBuffer)
+{
+  if (i < 19)
+  {
     // Prepare URL
     strcpy_P(urlBuffer, URL1);
     strcat_P(urlBuffer, wundergroundIcons[i]);
@@ -227,14 +231,10 @@ void ScreenWeatherStation::downloadResources()
     // Prepare filename
     strcpy_P(fileNameBuffer, wundergroundIcons[i]);
     strcat_P(fileNameBuffer, FILETYPE);
-
-    // Download resource
-    webResource.downloadFile(urlBuffer, fileNameBuffer, _downloadCallback);
   }
-
-  for (int i = 0; i < 19; i++)
+  else if (i < 38)
   {
-    sprintf(id, "%02d", i);
+    i -= 19;
 
     // Prepare URL
     strcpy_P(urlBuffer, URL2);
@@ -245,14 +245,10 @@ void ScreenWeatherStation::downloadResources()
     strcpy_P(fileNameBuffer, MINI);
     strcat_P(fileNameBuffer, wundergroundIcons[i]);
     strcat_P(fileNameBuffer, FILETYPE);
-
-    // Download resource
-    webResource.downloadFile(urlBuffer, fileNameBuffer, _downloadCallback);
-
   }
-
-  for (int i = 0; i < 24; i++)
+  else
   {
+    i -= 38;
 
     // Prepare URL
     strcpy_P(urlBuffer, URL3);
@@ -263,12 +259,43 @@ void ScreenWeatherStation::downloadResources()
     strcpy_P(fileNameBuffer, MOON);
     dtostrf(i, 1, 0, &fileNameBuffer[strlen(fileNameBuffer)]);
     strcat_P(fileNameBuffer, FILETYPE);
+  }
+}
+
+// Queue what is missing for the background download, WU graphic and Earth view first
+void ScreenWeatherStation::queueResources()
+{
+  webResource.enqueue(F("http://i.imgur.com/njl1pMj.jpg"), F("/WU.jpg"));
+  webResource.enqueue(F("http://i.imgur.com/v4eTLCC.jpg"), F("/Earth.jpg"));
+
+  char urlBuffer[100];
+  char fileNameBuffer[100];
 
-    // Download resource
-    webResource.downloadFile(urlBuffer, fileNameBuffer, _downloadCallback);
+  for (int i = 0; i < BITMAP_RESOURCES; i++)
+  {
+    getBitmapResource(i, urlBuffer, fileNameBuffer);
+    if (!assets.contains(fileNameBuffer))
+      webResource.enqueue(urlBuffer, fileNameBuffer);
+  }
+}
+
+// Move the bitmaps just downloaded into the asset bundle
+void ScreenWeatherStation::packResources()
+{
+  char urlBuffer[100];
+  char fileNameBuffer[100];
+  String *names = new String[BITMAP_RESOURCES];
 
-    // webResource.downloadFile("http://www.squix.org/blog/moonphase_L" + String(i) + ".bmp", "/moon" + String(i) + ".bmp", _downloadCallback);
+  for (int i = 0; i < BITMAP_RESOURCES; i++)
+  {
+    getBitmapResource(i, urlBuffer, fileNameBuffer);
+    names[i] = fileNameBuffer;
   }
+
+  LCD.drawString(F("Packing icons..."), 120, 220);
+  assets.pack(names, BITMAP_RESOURCES, packCallback);
+
+  delete[] names;
 }
 
 // Update the internet based information and update screen
@@ -4,6 +4,8 @@
 #include "WebResource.h"  // Download helper
 #include "WundergroundClient.h"
 
+#define BITMAP_RESOURCES (19 + 19 + 24)   // icons, mini icons, moon phases
+
 // Screen Handler definition
 class ScreenWeatherStation: public Screen
 {
@@ -20,11 +22,12 @@ class ScreenWeatherStation: public Screen
     virtual bool isFullScreen();
     virtual bool getRefreshWithScreenOff();
 
+    // Icons and images missing from SPIFFS, to the download queue
+    static void queueResources();
 
   private:
-    void downloadCallback(String filename, int16_t bytesDownloaded, int16_t bytesTotal);
-    ProgressCallback _downloadCallback;
     void downloadResources();
+    void packResources();
     void updateData();
     void drawProgress(uint8_t percentage, String text);
     void drawCurrentWeather();
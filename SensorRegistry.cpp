@@ -0,0 +1,102 @@
+#include "SensorRegistry.h"
+#include "GlobalDefinitions.h"
+#include "Telemetry.h"
+#include "ESP8266WiFi.h"
+
+// External variables
+extern struct ProcessContainer procPtr;
+
+SensorStats valueStats(float value)
+{
+  return { value, value, NAN, value, value };
+}
+
+// Scheduler order
+const ProcessEntry processTable[] =
+{
+  { &procPtr.UIManager, POWER_UI },
+  { &procPtr.MQTTUpdate, POWER_NETWORK },
+  { &procPtr.GeoLocation, POWER_NETWORK },
+  { &procPtr.ComboTemperatureHumiditySensor, POWER_SENSOR },
+  { &procPtr.ComboPressureHumiditySensor, POWER_SENSOR },
+  { &procPtr.CO2Sensor, POWER_SENSOR },
+  { &procPtr.ParticleSensor, POWER_SENSOR },
+  { &procPtr.VOCSensor, POWER_SENSOR },
+  { &procPtr.MultiGasSensor, POWER_SENSOR },
+  { &procPtr.GeigerSensor, POWER_SENSOR },
+  { &procPtr.History, POWER_STORAGE },
+  { &procPtr.Downloader, POWER_NETWORK },
+  { &procPtr.Animator, POWER_UI }
+};
+
+const int processCount = sizeof(processTable) / sizeof(processTable[0]);
+
+// Binary record channels first, in TelemetryChannel order
+const SensorChannel sensorChannels[] =
+{
+  // telemetry, text, history, row, label, units, decimals, source, read
+  { TELEMETRY_TEMPERATURE, MQTT_TEXT(1, 1), HISTORY_TEMPERATURE, 0, "Temp", " C", 1, &procPtr.ComboTemperatureHumiditySensor,
+    []() { return procPtr.ComboTemperatureHumiditySensor.getTemperatureStats(); } },
+  { TELEMETRY_HUMIDITY, MQTT_TEXT(1, 2), HISTORY_HUMIDITY, 1, "Humid", " %", 1, &procPtr.ComboTemperatureHumiditySensor,
+    []() { return procPtr.ComboTemperatureHumiditySensor.getHumidityStats(); } },
+  { TELEMETRY_PRESSURE, MQTT_TEXT(1, 3), HISTORY_PRESSURE, 2, "Press", " hPa", 1, &procPtr.ComboPressureHumiditySensor,
+    []() { return procPtr.ComboPressureHumiditySensor.getPressureStats(); } },
+  { TELEMETRY_PM01, MQTT_TEXT(1, 4), HISTORY_PM01, 7, "PM01", " ug/m3", 0, &procPtr.ParticleSensor,
+    []() { return procPtr.ParticleSensor.getPM01Stats(); } },
+  { TELEMETRY_PM2_5, MQTT_TEXT(1, 5), HISTORY_PM2_5, 8, "PM2.5", " ug/m3", 0, &procPtr.ParticleSensor,
+    []() { return procPtr.ParticleSensor.getPM2_5Stats(); } },
+  { TELEMETRY_PM10, MQTT_TEXT(1, 6), HISTORY_PM10, 9, "PM10", " ug/m3", 0, &procPtr.ParticleSensor,
+    []() { return procPtr.ParticleSensor.getPM10Stats(); } },
+  { TELEMETRY_CPM, MQTT_TEXT(1, 7), HISTORY_CPM, 10, "CPM", " Counts", 0, &procPtr.GeigerSensor,
+    []() { return procPtr.GeigerSensor.getCPMStats(); } },
+  { TELEMETRY_RADIATION, MQTT_TEXT(1, 8), HISTORY_RADIATION, 11, "Rad", " uSv/h", 2, &procPtr.GeigerSensor,
+    []() { return valueStats(procPtr.GeigerSensor.getRadiation()); } },
+  { TELEMETRY_CO, MQTT_TEXT(2, 1), HISTORY_CO, 4, "CO", " ppm", 2, &procPtr.MultiGasSensor,
+    []() { return procPtr.MultiGasSensor.getCOStats(); } },
+  { TELEMETRY_CO2, MQTT_TEXT(2, 2), HISTORY_CO2, 3, "CO2", " ppm", 0, &procPtr.CO2Sensor,
+    []() { return procPtr.CO2Sensor.getCO2Stats(); } },
+  { TELEMETRY_NO2, MQTT_TEXT(2, 3), HISTORY_NO2, 5, "NO2", " ppm", 2, &procPtr.MultiGasSensor,
+    []() { return procPtr.MultiGasSensor.getNO2Stats(); } },
+  { TELEMETRY_VOC, MQTT_TEXT(2, 4), HISTORY_VOC, 6, "VOC", "", 0, &procPtr.VOCSensor,
+    []() { return procPtr.VOCSensor.getVOCStats(); } },
+  { TELEMETRY_NH3, 0, CHANNEL_NONE, CHANNEL_NONE, "NH3", " ppm", 1, &procPtr.MultiGasSensor,
+    []() { return procPtr.MultiGasSensor.getNH3Stats(); } },
+  { TELEMETRY_C3H8, 0, CHANNEL_NONE, CHANNEL_NONE, "C3H8", " ppm", 0, &procPtr.MultiGasSensor,
+    []() { return procPtr.MultiGasSensor.getC3H8Stats(); } },
+  { TELEMETRY_C4H10, 0, CHANNEL_NONE, CHANNEL_NONE, "C4H10", " ppm", 0, &procPtr.MultiGasSensor,
+    []() { return procPtr.MultiGasSensor.getC4H10Stats(); } },
+  { TELEMETRY_CH4, 0, CHANNEL_NONE, CHANNEL_NONE, "CH4", " ppm", 0, &procPtr.MultiGasSensor,
+    []() { return procPtr.MultiGasSensor.getCH4Stats(); } },
+  { TELEMETRY_H2, 0, CHANNEL_NONE, CHANNEL_NONE, "H2", " ppm", 0, &procPtr.MultiGasSensor,
+    []() { return procPtr.MultiGasSensor.getH2Stats(); } },
+  { TELEMETRY_C2H5OH, 0, CHANNEL_NONE, CHANNEL_NONE, "C2H5OH", " ppm", 1, &procPtr.MultiGasSensor,
+    []() { return procPtr.MultiGasSensor.getC2H5OHStats(); } },
+  { TELEMETRY_SOC, MQTT_TEXT(2, 5), CHANNEL_NONE, CHANNEL_NONE, "Batt", " %", 0, nullptr,
+    []() { return valueStats(procPtr.UIManager.getSoC()); } },
+  { TELEMETRY_VOLT, MQTT_TEXT(2, 6), CHANNEL_NONE, CHANNEL_NONE, "Volt", " V", 2, nullptr,
+    []() { return valueStats(procPtr.UIManager.getVolt()); } },
+  { TELEMETRY_BME_TEMPERATURE, MQTT_TEXT(2, 7), CHANNEL_NONE, CHANNEL_NONE, "BME temp", " C", 1, &procPtr.ComboPressureHumiditySensor,
+    []() { return procPtr.ComboPressureHumiditySensor.getTemperatureStats(); } },
+  { TELEMETRY_RSSI, MQTT_TEXT(2, 8), CHANNEL_NONE, CHANNEL_NONE, "RSSI", " dBm", 0, nullptr,
+    []() { return valueStats(WiFi.RSSI()); } },
+  { TELEMETRY_FREE_HEAP, MQTT_TEXT(3, 2), CHANNEL_NONE, CHANNEL_NONE, "Heap", " bytes", 0, nullptr,
+    []() { return valueStats(ESP.getFreeHeap()); } },
+  { TELEMETRY_UPTIME, MQTT_TEXT(3, 1), CHANNEL_NONE, CHANNEL_NONE, "Uptime", " min", 0, nullptr,
+    []() { return valueStats(millis() / 60000L); } },
+  { TELEMETRY_CO2_STDDEV, MQTT_TEXT(3, 6), CHANNEL_NONE, CHANNEL_NONE, "CO2 sd", " ppm", 1, &procPtr.CO2Sensor,
+    []() { return valueStats(procPtr.CO2Sensor.getCO2Stats().stddev); } },
+  { TELEMETRY_PM2_5_STDDEV, MQTT_TEXT(3, 7), CHANNEL_NONE, CHANNEL_NONE, "PM2.5 sd", " ug/m3", 1, &procPtr.ParticleSensor,
+    []() { return valueStats(procPtr.ParticleSensor.getPM2_5Stats().stddev); } },
+  { TELEMETRY_CPM_STDDEV, MQTT_TEXT(3, 8), CHANNEL_NONE, CHANNEL_NONE, "CPM sd", " Counts", 1, &procPtr.GeigerSensor,
+    []() { return valueStats(procPtr.GeigerSensor.getCPMStats().stddev); } },
+
+  // Text payloads only
+  { CHANNEL_NONE, MQTT_TEXT(3, 3), CHANNEL_NONE, CHANNEL_NONE, "BME humid", " %", 1, &procPtr.ComboPressureHumiditySensor,
+    []() { return procPtr.ComboPressureHumiditySensor.getHumidityStats(); } },
+  { CHANNEL_NONE, MQTT_TEXT(3, 4), CHANNEL_NONE, CHANNEL_NONE, "Batt", " %", 0, nullptr,
+    []() { return valueStats(procPtr.UIManager.getSoC()); } },
+  { CHANNEL_NONE, MQTT_TEXT(3, 5), CHANNEL_NONE, CHANNEL_NONE, "Batt gauge", " %", 0, nullptr,
+    []() { return valueStats(procPtr.UIManager.getNativeSoC()); } }
+};
+
+const int sensorChannelCount = sizeof(sensorChannels) / sizeof(sensorChannels[0]);
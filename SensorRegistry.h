@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Arduino.h"
+#include "RollingStats.h"
+#include "ServiceMonitor.h"
+
+#define CHANNEL_NONE -1
+
+// Place of a value in the "1=..&2=.." text payloads: topic 1..3, field 1..8
+#define MQTT_TEXT(topic, field) ((topic) << 4 | (field))
+#define MQTT_TEXT_TOPICS 3
+#define MQTT_TEXT_FIELDS 8
+
+// -------------------------------------------------------
+// Sensor registry
+// -------------------------------------------------------
+//
+// Two tables, defined in SensorRegistry.cpp, that everything generic walks
+// instead of naming each process and value.
+//
+// processTable lists every process once, in the order it is added to the
+// scheduler, with its power class. Entries are MonitoredProcesses, so every
+// process added is timed. Period and priority are the ones it is
+// built with, from getPeriod() and getPriority().
+//
+// sensorChannels lists every published or displayed value: where it goes
+// in the binary telemetry record, in the text payloads, in the history and
+// on the Sensors screen, how it is labelled, and how to read it. Channels
+// in the binary record come first, in record order. A new channel is one
+// entry here.
+
+// What a process needs to run, lowest first
+enum PowerClass
+{
+  POWER_UI,           // display, touch and animation
+  POWER_STORAGE,      // writes to SPIFFS, keeps history going on battery
+  POWER_SENSOR,       // samples a sensor
+  POWER_NETWORK       // needs WiFi
+};
+
+struct ProcessEntry
+{
+  MonitoredProcess *process;
+  uint8_t powerClass;
+};
+
+struct SensorChannel
+{
+  int8_t telemetry;           // TelemetryChannel, or CHANNEL_NONE
+  uint8_t text;               // MQTT_TEXT(topic, field), or 0
+  int8_t history;             // HistoryChannel, or CHANNEL_NONE
+  int8_t row;                 // on the Sensors screen, or CHANNEL_NONE
+  const char *label;          // on the Sensors screen
+  const char *units;
+  uint8_t decimals;           // on the Sensors screen
+  Process *source;            // sampling it, nullptr for system values
+  SensorStats (*read)();      // over the averaging window, stddev NAN if it has none
+};
+
+extern const ProcessEntry processTable[];
+extern const int processCount;
+
+extern const SensorChannel sensorChannels[];
+extern const int sensorChannelCount;
+
+// Stats of a value without an averaging window
+SensorStats valueStats(float value);
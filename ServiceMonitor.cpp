@@ -0,0 +1,103 @@
+#include "ServiceMonitor.h"
+
+ServiceMonitor *ServiceMonitor::_first = nullptr;
+
+ServiceMonitor::ServiceMonitor(const char *name, Process *process)
+{
+  _name = name;
+  _process = process;
+
+  // Append, so reports follow declaration order
+  ServiceMonitor **link = &_first;
+  while (*link)
+    link = &(*link)->_next;
+  *link = this;
+}
+
+void ServiceMonitor::begin()
+{
+  uint32_t now = millis();
+
+  // Forced runs come early, only late starts count
+  if (_stats.runs > 0 && _lastPeriod > 0)
+  {
+    int32_t lateness = (int32_t) (now - (_lastStart + _lastPeriod));
+    if (lateness > 0)
+    {
+      _stats.totalLateness += lateness;
+      if ((uint32_t) lateness > _stats.maxLateness)
+        _stats.maxLateness = lateness;
+    }
+  }
+
+  _lastStart = now;
+  _startPeriod = _process ? _process->getPeriod() : 0;
+  _startMicros = micros();
+}
+
+void ServiceMonitor::end()
+{
+  uint32_t elapsed = micros() - _startMicros;
+
+  _stats.runs++;
+  _stats.totalMicros += elapsed;
+  _stats.lastMicros = elapsed;
+  if (elapsed > _stats.maxMicros)
+    _stats.maxMicros = elapsed;
+
+  // The service may have changed its own period, and the scheduler may apply it
+  // from this run or the next one: the next run is due by the longer of the two
+  uint32_t period = _process ? _process->getPeriod() : 0;
+  _lastPeriod = max(period, _startPeriod);
+  if (period > 0 && elapsed / 1000 >= period)
+    _stats.overruns++;
+
+  // Disabled itself: no next run is due
+  if (_process && !_process->isEnabled())
+    _lastPeriod = 0;
+}
+
+void ServiceMonitor::restart()
+{
+  _lastPeriod = 0;
+}
+
+void ServiceMonitor::restart(Process *process)
+{
+  for (ServiceMonitor *monitor = _first; monitor; monitor = monitor->_next)
+  {
+    if (monitor->_process == process)
+      monitor->restart();
+  }
+}
+
+const char *ServiceMonitor::getName()
+{
+  return _name;
+}
+
+const ServiceStats &ServiceMonitor::getStats()
+{
+  return _stats;
+}
+
+uint32_t ServiceMonitor::getAverageMicros()
+{
+  return _stats.runs ? _stats.totalMicros / _stats.runs : 0;
+}
+
+float ServiceMonitor::getLoad()
+{
+  uint32_t window = millis();
+  return window ? _stats.totalMicros / (10.0 * window) : 0;
+}
+
+ServiceMonitor *ServiceMonitor::getNext()
+{
+  return _next;
+}
+
+ServiceMonitor *ServiceMonitor::getFirst()
+{
+  return _first;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Arduino.h"
+#include <ProcessScheduler.h>     // https://github.com/wizard97/ArduinoProcessScheduler
+
+// -------------------------------------------------------
+// Service time instrumentation
+// -------------------------------------------------------
+//
+// One monitor per process, built into MonitoredProcess: the scheduler's
+// call of service() is timed there, around the process's own run(), so no
+// process can miss it. Code outside the scheduler (the loop itself) times
+// a scope with a ServiceProbe. Costs two micros() calls and a few
+// additions per run.
+// Lateness is how much later than its period a run started; an overrun
+// is a run that took longer than the period itself. A disabled process
+// is not due at all: the run after it is enabled again is not scored.
+// Monitors link themselves into one list, walked by the reports.
+
+struct ServiceStats
+{
+  uint32_t runs;
+  uint64_t totalMicros;
+  uint32_t maxMicros;
+  uint32_t lastMicros;
+  uint32_t totalLateness;   // (ms)
+  uint32_t maxLateness;     // (ms)
+  uint32_t overruns;
+};
+
+class ServiceMonitor
+{
+  public:
+    // process may be null for code that is not a process (the loop itself)
+    ServiceMonitor(const char *name, Process *process = nullptr);
+    ServiceMonitor(const ServiceMonitor &) = delete;
+    ServiceMonitor &operator=(const ServiceMonitor &) = delete;
+
+    void begin();
+    void end();
+
+    // The next run is not scored for lateness
+    void restart();
+
+    // restart() the monitor of process, call when enabling it again
+    static void restart(Process *process);
+
+    const char *getName();
+    const ServiceStats &getStats();
+    uint32_t getAverageMicros();
+
+    // Share of the time since boot spent in this service (%)
+    float getLoad();
+
+    ServiceMonitor *getNext();
+    static ServiceMonitor *getFirst();
+
+  private:
+    const char *_name;
+    Process *_process;
+    ServiceStats _stats = {};
+    uint32_t _startMicros = 0;
+    uint32_t _lastStart = 0;      // (ms)
+    uint32_t _lastPeriod = 0;     // (ms) period the next run is due by
+    uint32_t _startPeriod = 0;    // (ms) period when the run started
+    ServiceMonitor *_next = nullptr;
+
+    static ServiceMonitor *_first;
+};
+
+// Times the enclosing scope
+class ServiceProbe
+{
+  public:
+    ServiceProbe(ServiceMonitor &monitor) : _monitor(monitor) { _monitor.begin(); }
+    ~ServiceProbe() { _monitor.end(); }
+
+  private:
+    ServiceMonitor &_monitor;
+};
+
+// Base of every process: the scheduler calls service(), which times run()
+class MonitoredProcess : public Process
+{
+  public:
+    MonitoredProcess(Scheduler &manager, ProcPriority pr, unsigned int period, int iterations, const char *name)
+      : Process(manager, pr, period, iterations), monitor(name, this) {}
+
+  protected:
+    virtual void service() final
+    {
+      ServiceProbe probe(monitor);
+      run();
+    }
+
+    // One run of the process
+    virtual void run() = 0;
+
+    ServiceMonitor monitor;
+};
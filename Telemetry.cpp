@@ -0,0 +1,98 @@
+#include "Telemetry.h"
+
+static_assert(TELEMETRY_CHANNELS <= 32, "Telemetry presence mask is 32 bit");
+
+// Schema 2: fixed point scale and name of each channel
+static const float telemetryScale[TELEMETRY_CHANNELS] =
+{
+  100,      // Temperature          0.01 C
+  100,      // Humidity             0.01 %
+  10,       // Pressure             0.1 hPa
+  10,       // PM1.0                0.1 ug/m3
+  10,       // PM2.5                0.1 ug/m3
+  10,       // PM10                 0.1 ug/m3
+  1,        // CPM                  1 count
+  100,      // Radiation            0.01 uSv/h
+  10,       // CO                   0.1 ppm
+  1,        // CO2                  1 ppm
+  1000,     // NO2                  0.001 ppm
+  1,        // VOC                  raw ADC
+  10,       // NH3                  0.1 ppm
+  1,        // C3H8                 1 ppm
+  1,        // C4H10                1 ppm
+  1,        // CH4                  1 ppm
+  1,        // H2                   1 ppm
+  10,       // C2H5OH               0.1 ppm
+  10,       // Battery charge       0.1 %
+  1000,     // Battery voltage      1 mV
+  100,      // BME280 temperature   0.01 C
+  1,        // WiFi RSSI            1 dBm
+  0.1,      // Free heap            10 bytes
+  1.0 / 60, // Uptime               1 hour (value in minutes)
+  10,       // CO2 std deviation    0.1 ppm
+  10,       // PM2.5 std deviation  0.1 ug/m3
+  10        // CPM std deviation    0.1 count
+};
+
+static const char *const telemetryName[TELEMETRY_CHANNELS] =
+{
+  "temperature", "humidity", "pressure", "pm01", "pm2_5", "pm10", "cpm", "radiation",
+  "co", "co2", "no2", "voc", "nh3", "c3h8", "c4h10", "ch4", "h2", "c2h5oh",
+  "soc", "volt", "bme_temperature", "rssi", "free_heap", "uptime",
+  "co2_stddev", "pm2_5_stddev", "cpm_stddev"
+};
+
+void TelemetryPacket::begin(uint32_t time)
+{
+  _buffer[0] = TELEMETRY_SCHEMA;
+  _buffer[1] = TELEMETRY_CHANNELS;
+  for (int i = 0; i < 4; i++)
+  {
+    _buffer[2 + i] = time >> (8 * i);
+    _buffer[6 + i] = 0;
+  }
+  _size = TELEMETRY_HEADER_SIZE;
+  _mask = 0;
+  _lastChannel = -1;
+}
+
+void TelemetryPacket::add(uint8_t channel, float value)
+{
+  if (channel >= TELEMETRY_CHANNELS || (int) channel <= _lastChannel || isnan(value))
+    return;
+
+  // Out of range values (e.g. a CPM over 32766) are marked, not passed off as the limit
+  long scaled = isinf(value) ? (value > 0 ? TELEMETRY_SATURATED : -TELEMETRY_SATURATED - 1) : lround(value * telemetryScale[channel]);
+  if (scaled > TELEMETRY_SATURATED)
+    scaled = TELEMETRY_SATURATED;
+  if (scaled < -TELEMETRY_SATURATED - 1)
+    scaled = -TELEMETRY_SATURATED - 1;
+
+  _buffer[_size++] = scaled & 0xFF;
+  _buffer[_size++] = (scaled >> 8) & 0xFF;
+
+  _mask |= 1UL << channel;
+  for (int i = 0; i < 4; i++)
+    _buffer[6 + i] = _mask >> (8 * i);
+  _lastChannel = channel;
+}
+
+const uint8_t *TelemetryPacket::data()
+{
+  return _buffer;
+}
+
+int TelemetryPacket::size()
+{
+  return _size;
+}
+
+float TelemetryPacket::channelScale(uint8_t channel)
+{
+  return channel < TELEMETRY_CHANNELS ? telemetryScale[channel] : 1;
+}
+
+const char *TelemetryPacket::channelName(uint8_t channel)
+{
+  return channel < TELEMETRY_CHANNELS ? telemetryName[channel] : "";
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Arduino.h"
+
+// -------------------------------------------------------
+// Packed binary telemetry record
+// -------------------------------------------------------
+//
+// Alternative to the "1=..&2=.." text payloads: every channel in one
+// message, built in a single pass straight into the output buffer.
+// Layout (little endian), schema version TELEMETRY_SCHEMA:
+//
+//   0   uint8   schema version
+//   1   uint8   number of channels defined by the schema
+//   2   uint32  sample time, UTC epoch seconds (0 = clock not set)
+//   6   uint32  presence mask, bit n set = channel n follows
+//   10  int16   value of each present channel, in channel order,
+//               fixed point: value * scale of the channel,
+//               TELEMETRY_SATURATED above the range of the channel
+//               and -TELEMETRY_SATURATED - 1 below it
+//
+// Channels are only ever appended to a schema; a change of meaning or
+// scale bumps the version. Schema 2 added the saturation codes.
+
+#define TELEMETRY_SCHEMA 2
+#define TELEMETRY_SATURATED 32767
+#define TELEMETRY_HEADER_SIZE 10
+#define TELEMETRY_MAX_SIZE (TELEMETRY_HEADER_SIZE + 2 * TELEMETRY_CHANNELS)
+
+enum TelemetryChannel
+{
+  TELEMETRY_TEMPERATURE,
+  TELEMETRY_HUMIDITY,
+  TELEMETRY_PRESSURE,
+  TELEMETRY_PM01,
+  TELEMETRY_PM2_5,
+  TELEMETRY_PM10,
+  TELEMETRY_CPM,
+  TELEMETRY_RADIATION,
+  TELEMETRY_CO,
+  TELEMETRY_CO2,
+  TELEMETRY_NO2,
+  TELEMETRY_VOC,
+  TELEMETRY_NH3,
+  TELEMETRY_C3H8,
+  TELEMETRY_C4H10,
+  TELEMETRY_CH4,
+  TELEMETRY_H2,
+  TELEMETRY_C2H5OH,
+  TELEMETRY_SOC,
+  TELEMETRY_VOLT,
+  TELEMETRY_BME_TEMPERATURE,
+  TELEMETRY_RSSI,
+  TELEMETRY_FREE_HEAP,
+  TELEMETRY_UPTIME,
+  TELEMETRY_CO2_STDDEV,
+  TELEMETRY_PM2_5_STDDEV,
+  TELEMETRY_CPM_STDDEV,
+  TELEMETRY_CHANNELS
+};
+
+class TelemetryPacket
+{
+  public:
+    // Start a record
+    void begin(uint32_t time);
+
+    // Channels go in increasing order, NAN (missing) values are left out
+    void add(uint8_t channel, float value);
+
+    const uint8_t *data();
+    int size();
+
+    // Schema, shared with decoders
+    static float channelScale(uint8_t channel);
+    static const char *channelName(uint8_t channel);
+
+  private:
+    uint8_t _buffer[TELEMETRY_MAX_SIZE];
+    int _size = 0;
+    uint32_t _mask = 0;
+    int _lastChannel = -1;
+};
@@ -0,0 +1,218 @@
+#include "TileCache.h"
+#include <Syslog.h>               // https://github.com/arcao/ESP8266_Syslog
+
+// External variables
+extern Syslog syslog;
+
+#define TILE_CACHE_MAGIC 0x54494C31   // "TIL1"
+
+struct TileCacheHeader
+{
+  uint32_t magic;
+  uint32_t clock;
+  uint32_t count;
+};
+
+TileCache::TileCache(uint32_t budget)
+{
+  _budget = budget;
+}
+
+String TileCache::getTileName(int zoom, uint32_t x, uint32_t y)
+{
+  return "/tile" + String(zoom) + "_" + String(x) + "_" + String(y) + ".jpg";
+}
+
+bool TileCache::touch(int zoom, uint32_t x, uint32_t y)
+{
+  load();
+
+  int i = find(zoom, x, y);
+  if (i < 0)
+    return false;
+
+  // Removed behind our back
+  if (!SPIFFS.exists(getTileName(zoom, x, y)))
+  {
+    _used -= _entries[i].size;
+    _entries[i] = _entries[--_count];
+    _dirty = true;
+    return false;
+  }
+
+  _entries[i].lastUse = ++_clock;
+  _dirty = true;
+  return true;
+}
+
+void TileCache::add(int zoom, uint32_t x, uint32_t y)
+{
+  load();
+
+  String name = getTileName(zoom, x, y);
+  fs::File file = SPIFFS.open(name, "r");
+  uint32_t size = file ? file.size() : 0;
+  if (file)
+    file.close();
+
+  // Failed download
+  if (size == 0)
+  {
+    SPIFFS.remove(name);
+    return;
+  }
+
+  int i = find(zoom, x, y);
+  if (i >= 0)
+    _used -= _entries[i].size;
+  else
+  {
+    if (_count == TILE_CACHE_MAX_TILES)
+      evictOldest();
+    i = _count++;
+    _entries[i].zoom = zoom;
+    _entries[i].x = x;
+    _entries[i].y = y;
+  }
+  _entries[i].size = size;
+  _entries[i].lastUse = ++_clock;
+  _used += size;
+  _dirty = true;
+
+  // The new tile is the most recent, it goes last
+  while (_used > _budget && _count > 1)
+    evictOldest();
+}
+
+void TileCache::save()
+{
+  if (!_dirty)
+    return;
+
+  fs::File file = SPIFFS.open(F(TILE_CACHE_INDEX), "w");
+  if (!file)
+    return;
+
+  TileCacheHeader header = {TILE_CACHE_MAGIC, _clock, (uint32_t) _count};
+  file.write((uint8_t *) &header, sizeof(header));
+  file.write((uint8_t *) _entries, _count * sizeof(TileCacheEntry));
+  file.close();
+  _dirty = false;
+}
+
+uint32_t TileCache::getUsedBytes()
+{
+  load();
+  return _used;
+}
+
+int TileCache::getTileCount()
+{
+  load();
+  return _count;
+}
+
+// Index as saved, then reconciled with the tile files actually there
+void TileCache::load()
+{
+  if (_loaded)
+    return;
+  _loaded = true;
+
+  fs::File file = SPIFFS.open(F(TILE_CACHE_INDEX), "r");
+  if (file)
+  {
+    TileCacheHeader header;
+    if (file.read((uint8_t *) &header, sizeof(header)) == sizeof(header) && header.magic == TILE_CACHE_MAGIC
+        && header.count <= TILE_CACHE_MAX_TILES
+        && file.read((uint8_t *) _entries, header.count * sizeof(TileCacheEntry)) == header.count * sizeof(TileCacheEntry))
+    {
+      _clock = header.clock;
+      _count = header.count;
+    }
+    file.close();
+  }
+
+  bool found[TILE_CACHE_MAX_TILES] = {};
+  int indexed = _count;
+  fs::Dir dir = SPIFFS.openDir(F("/tile"));
+  while (dir.next())
+  {
+    String name = dir.fileName();
+    int zoom;
+    unsigned long x, y;
+    if (sscanf(name.c_str(), "/tile%d_%lu_%lu.jpg", &zoom, &x, &y) != 3)
+      continue;
+
+    int i = find(zoom, x, y);
+    if (i < 0)
+    {
+      // Not in the index: adopt it as the oldest, or drop it if there is no room
+      if (_count == TILE_CACHE_MAX_TILES)
+      {
+        SPIFFS.remove(name);
+        continue;
+      }
+      i = _count++;
+      _entries[i].zoom = zoom;
+      _entries[i].x = x;
+      _entries[i].y = y;
+      _entries[i].lastUse = 0;
+      _dirty = true;
+    }
+    _entries[i].size = dir.fileSize();
+    if (i < indexed)
+      found[i] = true;
+  }
+
+  // Forget indexed tiles without a file, keeping the order of the rest
+  int kept = 0;
+  for (int i = 0; i < _count; i++)
+  {
+    if (i < indexed && !found[i])
+    {
+      _dirty = true;
+      continue;
+    }
+    _entries[kept++] = _entries[i];
+  }
+  _count = kept;
+
+  _used = 0;
+  for (int i = 0; i < _count; i++)
+    _used += _entries[i].size;
+
+  // The budget may have shrunk
+  while (_used > _budget && _count > 0)
+    evictOldest();
+
+#ifdef DEBUG_SYSLOG
+  syslog.logf(LOG_DEBUG, "Tile cache: %d tiles, %u bytes", _count, _used);
+#endif
+}
+
+int TileCache::find(int zoom, uint32_t x, uint32_t y)
+{
+  for (int i = 0; i < _count; i++)
+  {
+    if (_entries[i].x == x && _entries[i].y == y && _entries[i].zoom == zoom)
+      return i;
+  }
+  return -1;
+}
+
+void TileCache::evictOldest()
+{
+  int i = 0;
+  for (int j = 1; j < _count; j++)
+  {
+    if (_entries[j].lastUse < _entries[i].lastUse)
+      i = j;
+  }
+
+  TileCacheEntry &entry = _entries[i];
+  SPIFFS.remove(getTileName(entry.zoom, entry.x, entry.y));
+  _used -= entry.size;
+  _entries[i] = _entries[--_count];
+  _dirty = true;
+}
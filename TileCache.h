@@ -0,0 +1,61 @@
+#pragma once
+
+#define FS_NO_GLOBALS
+#include <FS.h>
+#include "Arduino.h"
+
+#define TILE_CACHE_INDEX "/tiles.idx"
+#define TILE_CACHE_MAX_TILES 48     // index entries, 20 bytes of RAM each
+
+// -------------------------------------------------------
+// Persistent map tile cache
+// -------------------------------------------------------
+//
+// Map tiles are kept in SPIFFS as /tile<zoom>_<x>_<y>.jpg across reboots.
+// An index file records the size of each tile and when it was last used,
+// as a use counter. Adding a tile evicts the least recently used ones
+// until the tiles fit the byte budget again. The index is checked against
+// the directory when it is loaded, so tiles written before a reset are
+// adopted (as the oldest) and tiles gone missing are forgotten.
+
+struct TileCacheEntry
+{
+  uint32_t x;
+  uint32_t y;
+  uint32_t size;
+  uint32_t lastUse;
+  uint8_t zoom;
+};
+
+class TileCache
+{
+  public:
+    TileCache(uint32_t budget);
+
+    static String getTileName(int zoom, uint32_t x, uint32_t y);
+
+    // True if the tile is cached, it then becomes the most recently used
+    bool touch(int zoom, uint32_t x, uint32_t y);
+
+    // Tile just written to its file: account for it, evicting others over the budget
+    void add(int zoom, uint32_t x, uint32_t y);
+
+    // Write the index back if anything changed
+    void save();
+
+    uint32_t getUsedBytes();
+    int getTileCount();
+
+  private:
+    void load();
+    int find(int zoom, uint32_t x, uint32_t y);
+    void evictOldest();
+
+    uint32_t _budget;
+    uint32_t _used = 0;
+    uint32_t _clock = 0;
+    bool _loaded = false;
+    bool _dirty = false;
+    int _count = 0;
+    TileCacheEntry _entries[TILE_CACHE_MAX_TILES];
+};
@@ -0,0 +1,361 @@
+#include "TimeSeries.h"
+
+#include <Syslog.h>               // https://github.com/arcao/ESP8266_Syslog
+
+// External variables
+extern Syslog syslog;
+
+// File header, written once
+#define TIMESERIES_MAGIC 0x32535441     // "ATS2", UTC timestamps (ATS1 files held local time)
+#define TIMESERIES_HEADER_SIZE 16
+
+struct TimeSeriesHeader
+{
+  uint32_t magic;
+  uint16_t recordSize;
+  uint16_t capacity;
+  uint32_t period;
+  uint8_t channels;
+  uint8_t reserved[3];
+};
+
+static_assert(sizeof(TimeSeriesHeader) == TIMESERIES_HEADER_SIZE, "TimeSeries header layout");
+
+TimeSeries::TimeSeries(const char *fileName, uint16_t capacity, uint32_t period)
+{
+  _fileName = fileName;
+  _capacity = capacity;
+  _period = period;
+}
+
+bool TimeSeries::begin()
+{
+  _valid = false;
+  _count = 0;
+  _oldest = 0;
+
+  fs::File file = SPIFFS.open(_fileName, "r");
+  if (!file)
+    return create();
+
+  // Layout changed (or file damaged): start over
+  TimeSeriesHeader header;
+  if (file.read((uint8_t *) &header, sizeof(header)) != sizeof(header) ||
+      header.magic != TIMESERIES_MAGIC || header.recordSize != sizeof(HistoryRecord) ||
+      header.capacity != _capacity || header.period != _period || header.channels != HISTORY_CHANNELS)
+  {
+    file.close();
+    return create();
+  }
+
+  // Records are appended until the file is full, then wrap. A torn last record is ignored
+  uint32_t records = (file.size() - TIMESERIES_HEADER_SIZE) / sizeof(HistoryRecord);
+  _count = records > _capacity ? _capacity : records;
+
+  if (_count == _capacity && readTime(file, 0) > readTime(file, _capacity - 1))
+  {
+    // Wrapped: times increase up to the newest record then drop. Binary search for the drop
+    uint32_t first = readTime(file, 0);
+    uint16_t lo = 1;
+    uint16_t hi = _capacity - 1;
+    while (lo < hi)
+    {
+      uint16_t mid = lo + (hi - lo) / 2;
+      if (readTime(file, mid) >= first)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    _oldest = lo;
+  }
+
+  if (_count > 0)
+  {
+    _oldestTime = readTime(file, _oldest);
+    _newestTime = readTime(file, physicalSlot(_count - 1));
+  }
+
+  file.close();
+  _valid = true;
+
+#ifdef DEBUG_SYSLOG
+  syslog.logf(LOG_DEBUG, "TimeSeries %s: %d records", _fileName.c_str(), _count);
+#endif
+
+  return true;
+}
+
+bool TimeSeries::create()
+{
+  SPIFFS.remove(_fileName);
+  fs::File file = SPIFFS.open(_fileName, "w");
+  if (!file)
+    return false;
+
+  TimeSeriesHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic = TIMESERIES_MAGIC;
+  header.recordSize = sizeof(HistoryRecord);
+  header.capacity = _capacity;
+  header.period = _period;
+  header.channels = HISTORY_CHANNELS;
+  file.write((const uint8_t *) &header, sizeof(header));
+  file.close();
+
+  _count = 0;
+  _oldest = 0;
+  _oldestTime = 0;
+  _newestTime = 0;
+  _valid = true;
+  return true;
+}
+
+bool TimeSeries::append(const HistoryRecord *records, int count)
+{
+  if (!_valid)
+    return false;
+
+  // Timestamps must keep increasing (binary searches rely on it)
+  while (count > 0 && _count > 0 && records[0].time <= _newestTime)
+  {
+    records++;
+    count--;
+  }
+
+  // Keep the part of the batch that is in order
+  for (int i = 1; i < count; i++)
+  {
+    if (records[i].time <= records[i - 1].time)
+    {
+      count = i;
+      break;
+    }
+  }
+
+  if (count == 0)
+    return true;
+
+  fs::File file = SPIFFS.open(_fileName, "r+");
+  if (!file)
+    return false;
+
+  while (count > 0)
+  {
+    // Next free slot while growing, the oldest one once full
+    uint16_t slot = (_count < _capacity) ? _count : _oldest;
+
+    // Contiguous run up to the end of the ring
+    int run = _capacity - slot;
+    if (run > count)
+      run = count;
+
+    file.seek(slotOffset(slot), fs::SeekSet);
+    file.write((const uint8_t *) records, run * sizeof(HistoryRecord));
+
+    if (_count < _capacity)
+    {
+      if (_count == 0)
+        _oldestTime = records[0].time;
+      _count += run;
+    }
+    else
+      _oldest = (_oldest + run) % _capacity;
+
+    _newestTime = records[run - 1].time;
+    records += run;
+    count -= run;
+  }
+
+  if (_count == _capacity)
+    _oldestTime = readTime(file, _oldest);
+
+  file.close();
+  return true;
+}
+
+uint16_t TimeSeries::count()
+{
+  return _count;
+}
+
+uint16_t TimeSeries::capacity()
+{
+  return _capacity;
+}
+
+uint32_t TimeSeries::period()
+{
+  return _period;
+}
+
+uint32_t TimeSeries::oldestTime()
+{
+  return _oldestTime;
+}
+
+uint32_t TimeSeries::newestTime()
+{
+  return _newestTime;
+}
+
+int TimeSeries::find(uint32_t time)
+{
+  if (_count == 0 || time > _newestTime)
+    return _count;
+  if (time <= _oldestTime)
+    return 0;
+
+  fs::File file = SPIFFS.open(_fileName, "r");
+  if (!file)
+    return _count;
+
+  int lo = 0;
+  int hi = _count - 1;
+  while (lo < hi)
+  {
+    int mid = lo + (hi - lo) / 2;
+    if (readTime(file, physicalSlot(mid)) < time)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  file.close();
+  return lo;
+}
+
+// Logical indexes [first, last) of the records in [from, to]
+bool TimeSeries::range(uint32_t from, uint32_t to, int &first, int &last)
+{
+  if (from > to)
+    return false;
+
+  first = find(from);
+  last = (to >= _newestTime) ? _count : find(to + 1);
+  return last > first;
+}
+
+int TimeSeries::query(uint32_t from, uint32_t to, HistoryRecord *out, int maxRecords)
+{
+  int first, last;
+  if (maxRecords <= 0 || !range(from, to, first, last))
+    return 0;
+  int available = last - first;
+
+  // Everything fits: bulk read
+  if (available <= maxRecords)
+    return read(first, out, available);
+
+  fs::File file = SPIFFS.open(_fileName, "r");
+  if (!file)
+    return 0;
+
+  // Decimate: evenly spaced records across the range
+  int copied = 0;
+  for (int i = 0; i < maxRecords; i++)
+  {
+    int index = (maxRecords > 1) ? first + (int) ((uint32_t) i * (available - 1) / (maxRecords - 1)) : first;
+    file.seek(slotOffset(physicalSlot(index)), fs::SeekSet);
+    file.read((uint8_t *) &out[copied++], sizeof(HistoryRecord));
+  }
+
+  file.close();
+  return copied;
+}
+
+int TimeSeries::query(uint32_t from, uint32_t to, uint8_t channel, float scale, uint32_t *times, float *values, int maxPoints)
+{
+  int first, last;
+  if (maxPoints <= 0 || channel >= HISTORY_CHANNELS || !range(from, to, first, last))
+    return 0;
+  int available = last - first;
+
+  fs::File file = SPIFFS.open(_fileName, "r");
+  if (!file)
+    return 0;
+
+  // One record at a time, so the caller needs no record buffer
+  int points = (available < maxPoints) ? available : maxPoints;
+  int previous = -2;
+  HistoryRecord record;
+  for (int i = 0; i < points; i++)
+  {
+    int index = (points < available && points > 1) ? first + (int) ((uint32_t) i * (available - 1) / (points - 1)) : first + i;
+
+    // Sequential records need no seek (except across the ring wrap)
+    uint16_t slot = physicalSlot(index);
+    if (index != previous + 1 || slot == 0)
+      file.seek(slotOffset(slot), fs::SeekSet);
+    previous = index;
+
+    if (file.read((uint8_t *) &record, sizeof(record)) != sizeof(record))
+    {
+      points = i;
+      break;
+    }
+
+    times[i] = record.time;
+    if (record.values[channel] == HISTORY_NO_DATA)
+      values[i] = NAN;
+    else if (record.values[channel] == HISTORY_SATURATED)
+      values[i] = INFINITY;
+    else
+      values[i] = record.values[channel] / scale;
+  }
+
+  file.close();
+  return points;
+}
+
+bool TimeSeries::read(int index, HistoryRecord &record)
+{
+  return read(index, &record, 1) == 1;
+}
+
+int TimeSeries::read(int index, HistoryRecord *records, int count)
+{
+  if (index < 0 || count <= 0 || index >= _count)
+    return 0;
+  if (count > _count - index)
+    count = _count - index;
+
+  fs::File file = SPIFFS.open(_fileName, "r");
+  if (!file)
+    return 0;
+
+  // At most two reads, split at the ring wrap
+  int copied = 0;
+  while (copied < count)
+  {
+    uint16_t slot = physicalSlot(index + copied);
+    int run = _capacity - slot;
+    if (run > count - copied)
+      run = count - copied;
+
+    file.seek(slotOffset(slot), fs::SeekSet);
+    if (file.read((uint8_t *) &records[copied], run * sizeof(HistoryRecord)) != run * sizeof(HistoryRecord))
+      break;
+    copied += run;
+  }
+
+  file.close();
+  return copied;
+}
+
+uint32_t TimeSeries::slotOffset(uint16_t slot)
+{
+  return TIMESERIES_HEADER_SIZE + (uint32_t) slot * sizeof(HistoryRecord);
+}
+
+uint16_t TimeSeries::physicalSlot(int index)
+{
+  return (_oldest + index) % _capacity;
+}
+
+uint32_t TimeSeries::readTime(fs::File &file, uint16_t slot)
+{
+  uint32_t time = 0;
+  file.seek(slotOffset(slot), fs::SeekSet);
+  file.read((uint8_t *) &time, sizeof(time));
+  return time;
+}
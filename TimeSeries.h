@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Arduino.h"
+#include <FS.h>
+
+#define HISTORY_CHANNELS 12
+#define HISTORY_NO_DATA -32768    // value slot not filled (sensor missing, NaN)
+#define HISTORY_SATURATED 32767   // value above the 16 bit range of the channel, reads as +INFINITY
+
+// One sample of every channel, values scaled to 16 bit (see Proc_History)
+struct HistoryRecord
+{
+  uint32_t time;                      // UTC epoch seconds, start of the period for rollups
+  int16_t values[HISTORY_CHANNELS];
+};
+
+// -------------------------------------------------------
+// Time series ring file
+// -------------------------------------------------------
+//
+// Fixed capacity ring of HistoryRecords in one SPIFFS file, oldest record
+// overwritten first. Wear aware:
+//  - the header is written once, at creation. The write position is not
+//    stored anywhere but recovered at begin() from the record timestamps
+//    (binary search for the wrap point), so appends never rewrite metadata
+//  - callers hand in batches, each batch is at most two writes (ring wrap)
+//  - the file never grows past its capacity
+// Timestamps are strictly increasing, so lookups by time are binary
+// searches: O(log n) small reads.
+
+class TimeSeries
+{
+  public:
+    TimeSeries(const char *fileName, uint16_t capacity, uint32_t period);
+
+    // Open or create the file and find the oldest record
+    bool begin();
+
+    // Append records in time order, older or duplicate timestamps are dropped
+    bool append(const HistoryRecord *records, int count);
+
+    uint16_t count();
+    uint16_t capacity();
+    uint32_t period();
+    uint32_t oldestTime();
+    uint32_t newestTime();
+
+    // Logical index (0 = oldest) of the first record at or after time, count() if none
+    int find(uint32_t time);
+
+    // Copy up to maxRecords records in [from, to] into out, evenly spread if there are more.
+    // Returns the number copied
+    int query(uint32_t from, uint32_t to, HistoryRecord *out, int maxRecords);
+
+    // Same for a single channel, values divided by scale (NAN where missing)
+    int query(uint32_t from, uint32_t to, uint8_t channel, float scale, uint32_t *times, float *values, int maxPoints);
+
+    bool read(int index, HistoryRecord &record);
+
+    // Up to count consecutive records from a logical index. Returns the number read
+    int read(int index, HistoryRecord *records, int count);
+
+  private:
+    bool range(uint32_t from, uint32_t to, int &first, int &last);
+    uint32_t slotOffset(uint16_t slot);
+    uint16_t physicalSlot(int index);
+    uint32_t readTime(fs::File &file, uint16_t slot);
+    bool create();
+
+    String _fileName;
+    uint16_t _capacity;
+    uint32_t _period;
+    uint16_t _count = 0;
+    uint16_t _oldest = 0;   // physical slot of the oldest record
+    uint32_t _oldestTime = 0;
+    uint32_t _newestTime = 0;
+    bool _valid = false;
+};
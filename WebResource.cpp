@@ -19,13 +19,26 @@
 */
 
 #include "WebResource.h"
-#include <FS.h>
 #include <Syslog.h>               // https://github.com/arcao/ESP8266_Syslog
 
 // External variables
 extern Syslog syslog;
 
-WebResource::WebResource() {
+// Prototypes
+void errLog(String msg);
+
+// "http://host:port/path" -> "host:port" and "/path"
+static bool splitUrl(const String &url, String &authority, String &path)
+{
+  if (!url.startsWith(F("http://")))
+    return false;
+  int slash = url.indexOf('/', 7);
+  authority = slash < 0 ? url.substring(7) : url.substring(7, slash);
+  path = slash < 0 ? String(F("/")) : url.substring(slash);
+  return authority.length() > 0;
+}
+
+WebResource::WebResource() : _response(_client, WEB_TIMEOUT, _responseBuffer) {
 
 }
 
@@ -36,189 +49,400 @@ void WebResource::downloadFile(String url, String filename)
 
 void WebResource::downloadFile(String url, String filename, ProgressCallback progressCallback)
 {
+  enqueue(url, filename, true);
+  finish(nullptr, progressCallback, true);
+}
 
+bool WebResource::enqueue(String url, String fileName, bool urgent)
+{
   // Download only if file is not there yet
-  if (SPIFFS.exists(filename) == true)
+  if (SPIFFS.exists(fileName))
   {
-#ifdef DEBUG_SYSLOG 
-    syslog.logf(LOG_DEBUG, "File already exists in SPIFFS. Skipping download of %s\n", filename.c_str());
+#ifdef DEBUG_SYSLOG
+    syslog.logf(LOG_DEBUG, "File already exists in SPIFFS. Skipping download of %s\n", fileName.c_str());
 #endif
-    return;
+    return true;
   }
-  else
+
+  for (int i = 0; i < _count; i++)
   {
-    syslog.logf(LOG_INFO, "File does not exist in SPIFFS. Downloading %s and saving as %s\n", url.c_str(), filename.c_str());
+    if (_jobs[(_head + i) % WEB_QUEUE_SIZE].fileName == fileName)
+      return true;
   }
 
-  //---------------------
-#ifdef DEBUG_SYSLOG 
-  syslog.log(LOG_DEBUG, F("[HTTP] begin...\n"));
-#endif
+  if (_count == WEB_QUEUE_SIZE)
+    return false;
 
-  HTTPClient http;
+  if (_count == 0)
+  {
+    _done = 0;
+    _total = 0;
+  }
 
-  // configure server and url
-  http.begin(url);
+  // Urgent: behind the requests already sent and the other urgent files
+  int at = _count;
+  if (urgent)
+  {
+    at = _sent;
+    while (at < _count && _jobs[(_head + at) % WEB_QUEUE_SIZE].urgent)
+      at++;
+    for (int i = _count; i > at; i--)
+      _jobs[(_head + i) % WEB_QUEUE_SIZE] = _jobs[(_head + i - 1) % WEB_QUEUE_SIZE];
+  }
 
-#ifdef DEBUG_SYSLOG 
-  syslog.log(LOG_DEBUG, F("[HTTP] GET..."));
-#endif
+  Job &job = _jobs[(_head + at) % WEB_QUEUE_SIZE];
+  job.url = url;
+  job.fileName = fileName;
+  job.retries = 0;
+  job.urgent = urgent;
+  _count++;
+  _total++;
 
-  // start connection and send HTTP header
-  int httpCode = http.GET();
-  if (httpCode > 0) {
-    SPIFFS.remove(filename);
-    fs::File f = SPIFFS.open(filename, "w+");
-    if (!f)
-    {
-#ifdef DEBUG_SYSLOG 
-      syslog.log(LOG_DEBUG, F("file open failed"));
+#ifdef DEBUG_SYSLOG
+  syslog.logf(LOG_DEBUG, "Queued %s as %s\n", url.c_str(), fileName.c_str());
 #endif
-      return;
-    }
-    // HTTP header has been sent and Server response header has been handled
+  return true;
+}
 
-#ifdef DEBUG_SYSLOG 
-    syslog.logf(LOG_DEBUG, "[HTTP] GET... code: %d\n", httpCode);
-#endif
+bool WebResource::service(unsigned long budget)
+{
+  unsigned long start = millis();
+  while (_count > 0 && millis() - start < budget)
+  {
+    if (!step())
+      break;
+  }
 
-    // file found at server
-    if (httpCode == HTTP_CODE_OK) {
+  // Nothing left: no connection held open, no buffer kept
+  if (_count == 0)
+  {
+    if (_client.connected())
+      _client.stop();
+    delete[] _writeBuffer;
+    _writeBuffer = nullptr;
+  }
 
-      // get lenght of document (is -1 when Server sends no Content-Length header)
-      int total = http.getSize();
-      int len = total;
-      if (progressCallback != nullptr)
-        progressCallback(filename, 0, total);
+  return _count > 0;
+}
 
-      // create buffer for read
-      uint8_t buff[128] = { 0 };
+void WebResource::finish(QueueCallback queueCallback, ProgressCallback progressCallback, bool urgentOnly)
+{
+  QueueCallback previous = _queueCallback;
+  if (queueCallback)
+    _queueCallback = queueCallback;
+  _progressCallback = progressCallback;
+
+  // One more try now. Offline, every file would try to connect 1 + WEB_RETRIES times while the UI waits
+  _unreachable = false;
+  unsigned long start = millis();
+  while (!_unreachable && millis() - start < WEB_FINISH_TIMEOUT && (!urgentOnly || hasUrgent()) && service(WEB_TIMEOUT))
+    delay(1);
+
+  _queueCallback = previous;
+  _progressCallback = nullptr;
+}
 
-      // get tcp stream
-      WiFiClient * stream = http.getStreamPtr();
+void WebResource::setQueueCallback(QueueCallback queueCallback)
+{
+  _queueCallback = queueCallback;
+}
 
-      // read all data from server
-      while (http.connected() && (len > 0 || len == -1)) {
-        // get available data size
-        size_t size = stream->available();
+bool WebResource::hasUrgent()
+{
+  for (int i = 0; i < _count; i++)
+  {
+    if (_jobs[(_head + i) % WEB_QUEUE_SIZE].urgent)
+      return true;
+  }
+  return false;
+}
 
-        if (size) {
-          // read up to 128 byte
-          int c = stream->readBytes(buff, ((size > sizeof(buff)) ? sizeof(buff) : size));
+bool WebResource::isBusy()
+{
+  return _count > 0;
+}
 
-          // write it to 
-          f.write(buff, c);
+uint16_t WebResource::getDone()
+{
+  return _done;
+}
 
-          if (len > 0) {
-            len -= c;
-          }
-          if (progressCallback != nullptr)
-            progressCallback(filename, total - len, total);
-        }
-        delay(1);
-      }
+uint16_t WebResource::getTotal()
+{
+  return _total;
+}
 
-#ifdef DEBUG_SYSLOG 
-      syslog.log(LOG_DEBUG, "[HTTP] connection closed or file end.");
-#endif
+// One move of the transfer. False when it has to wait for the network
+bool WebResource::step()
+{
+  Job &job = _jobs[_head];
+
+  // Connection gone (or never there): whatever was in flight is asked again, the first file
+  // pays for it with a retry even if the server closed before answering
+  if (!_client.connected() && !_response.isReady())
+  {
+    if (_inBody || _sent > 0)
+    {
+      _sent = 0;
+      complete(false, true);
+      return true;
     }
-    f.close();
-  } else
+    if (_unreachable && millis() - _failedAt < WEB_CONNECT_BACKOFF)
+      return false;
+    if (!connect(job.url))
+    {
+      _unreachable = true;
+      _failedAt = millis();
+
+      // Nothing was transferred: the file waits its turn again without using up a retry,
+      // so an outage of any length leaves the queue as it was
+      requeue();
+      return false;
+    }
+    _unreachable = false;
+  }
+
+  // Keep the pipeline full with the next files from the same host
+  String authority, path;
+  while (_sent < WEB_PIPELINE_DEPTH && _sent < _count)
   {
-#ifdef DEBUG_SYSLOG 
-    syslog.logf(LOG_DEBUG, "[HTTP] GET... failed, error: %s\n", http.errorToString(httpCode).c_str());
-#endif
+    Job &next = _jobs[(_head + _sent) % WEB_QUEUE_SIZE];
+    if (!splitUrl(next.url, authority, path) || authority != _host)
+      break;
+    request(path);
+    _sent++;
+  }
+
+  // Same host no more: drop the connection once its answers are in
+  if (_sent == 0)
+  {
+    _client.stop();
+    _response.clear();
+    return true;
+  }
+
+  if (!_response.isReady())
+  {
+    if (millis() - _lastActivity < WEB_TIMEOUT)
+      return false;
+
+    // No status line either: charged to the first file all the same, or a silent server is asked forever
+    errLog(F("Download timed out"));
+    _client.stop();
+    _response.clear();
+    _sent = 0;
+    complete(false, true);
+    return true;
+  }
+  _lastActivity = millis();
+
+  if (!_inBody)
+  {
+    if (!_response.begin())
+    {
+      _client.stop();
+      _response.clear();
+      _sent = 0;
+      complete(false, true);
+      return true;
+    }
+
+    _inBody = true;
+    _received = 0;
+    _buffered = 0;
+    _writeFailed = false;
+    if (_response.getStatus() == 200)
+    {
+      SPIFFS.remove(F(WEB_TEMP_FILE));
+      _file = SPIFFS.open(F(WEB_TEMP_FILE), "w");
+      if (_file && !_writeBuffer)
+        _writeBuffer = new uint8_t[WEB_WRITE_BUFFER];
+      if (_file && !_writeBuffer)
+      {
+        _file.close();
+        _writeFailed = true;
+      }
+    }
+    if (_progressCallback)
+      _progressCallback(job.fileName, 0, getContentLength());
   }
 
-  http.end();
+  const uint8_t *data;
+  int count = _response.read(data);
+  if (count > 0)
+  {
+    write(data, count);
+    _received += count;
+    if (_progressCallback)
+      _progressCallback(job.fileName, _received, getContentLength());
+    return true;
+  }
+
+  // End of the body: the next response follows on the same connection, unless the server closes it
+  bool ok = _response.isComplete() && _response.getStatus() == 200;
+  bool keepAlive = _response.isComplete() && _response.isKeepAlive();
+  bool retry = !_response.isComplete();
+  if (!ok && _response.getStatus() != 200 && _response.getStatus() != 0)
+    errLog(String(F("HTTP ")) + String(_response.getStatus()) + F(" for ") + job.fileName);
+  complete(ok, retry);
+
+  if (keepAlive)
+    _response.next();
+  else
+  {
+    _client.stop();
+    _response.clear();
+    _sent = 0;
+  }
+  return true;
 }
 
-/*
-  HTTPClient http;
+bool WebResource::connect(const String &url)
+{
+  String path;
+  _sent = 0;
+  _response.clear();
+  if (!splitUrl(url, _host, path))
+    return false;
+
+  String host = _host;
+  uint16_t port = 80;
+  int colon = _host.indexOf(':');
+  if (colon >= 0)
+  {
+    host = _host.substring(0, colon);
+    port = _host.substring(colon + 1).toInt();
+  }
+
+#ifdef DEBUG_SYSLOG
+  syslog.logf(LOG_DEBUG, "[HTTP] connecting to %s\n", _host.c_str());
+#endif
 
-  #ifdef DEBUG_SYSLOG 
-  syslog.log(LOG_DEBUG, F("[HTTP] begin...\n"));
-  #endif
+  _lastActivity = millis();
+  if (!_client.connect(host.c_str(), port))
+  {
+    // Once per outage, the queue keeps trying until the host is back
+    if (!_unreachable)
+      errLog(String(F("Can't connect to ")) + host);
+    return false;
+  }
+  return true;
+}
 
-  // configure server and url
-  http.begin(url);
+// One request in one write, the server reads it as soon as it arrives
+void WebResource::request(const String &path)
+{
+  String host = _host;
+  int colon = host.indexOf(':');
+  if (colon >= 0)
+    host.remove(colon);
 
-  #ifdef DEBUG_SYSLOG 
-  syslog.log(LOG_DEBUG, F("[HTTP] GET..."));
-  #endif
-  // start connection and send HTTP header
-  int httpCode = http.GET();
+  String request = String(F("GET ")) + path + F(" HTTP/1.1\r\nHost: ") + host + F("\r\nConnection: keep-alive\r\n\r\n");
+  _client.write((const uint8_t *) request.c_str(), request.length());
+}
 
-  syslog.log(LOG_DEBUG, F("STEP 1"));
+// Gather body bytes into whole blocks, SPIFFS writes small pieces slowly
+void WebResource::write(const uint8_t *data, int count)
+{
+  if (!_file)
+    return;
 
-  if (httpCode > 0)
+  while (count > 0)
   {
-    syslog.log(LOG_DEBUG, F("STEP 2"));
-    // SPIFFS.remove(filename);
-    syslog.log(LOG_DEBUG, F("STEP 3"));
-    //-----------------------------------------------------------------
-    fs::File f = SPIFFS.open(filename, "w+");
-    syslog.log(LOG_DEBUG, F("STEP 4"));
-    if (!f)
+    int n = min(count, WEB_WRITE_BUFFER - _buffered);
+    memcpy(_writeBuffer + _buffered, data, n);
+    _buffered += n;
+    data += n;
+    count -= n;
+
+    if (_buffered == WEB_WRITE_BUFFER)
     {
-      syslog.log(LOG_DEBUG, F("STEP 5"));
-  #ifdef DEBUG_SYSLOG 
-      syslog.log(LOG_DEBUG, F("file open failed"));
-  #endif
-      return;
+      if (_file.write(_writeBuffer, _buffered) != _buffered)
+        _writeFailed = true;
+      _buffered = 0;
     }
-    // HTTP header has been send and Server response header has been handled
-
-  #ifdef DEBUG_SYSLOG 
-    syslog.logf(LOG_DEBUG, "[HTTP] GET... code: %d\n", httpCode);
-  #endif
-
-    // file found at server
-    if (httpCode == HTTP_CODE_OK) {
-
-      // get length of document (is -1 when Server sends no Content-Length header)
-      int total = http.getSize();
-      int len = total;
-      progressCallback(filename, 0, total);
-      // create buffer for read
-      uint8_t buff[128] = { 0 };
-
-      // get tcp stream
-      WiFiClient * stream = http.getStreamPtr();
-
-      // read all data from server
-      while (http.connected() && (len > 0 || len == -1)) {
-        // get available data size
-        size_t size = stream->available();
-
-        if (size) {
-          // read up to 128 byte
-          int c = stream->readBytes(buff, ((size > sizeof(buff)) ? sizeof(buff) : size));
-
-          // write it to 
-          f.write(buff, c);
-
-          if (len > 0) {
-            len -= c;
-          }
-          progressCallback(filename, total - len, total);
-        }
-        delay(1);
-      }
+  }
+}
 
-  #ifdef DEBUG_SYSLOG 
-      syslog.log(LOG_DEBUG, "[HTTP] connection closed or file end.");
-  #endif
+// First file of the queue is over: keep it under its name, or try it again later, or give up on it
+void WebResource::complete(bool ok, bool retry)
+{
+  Job &job = _jobs[_head];
 
-    }
-    f.close();
-  } else {
+  if (_file)
+  {
+    if (_buffered && _file.write(_writeBuffer, _buffered) != _buffered)
+      _writeFailed = true;
+    _file.close();
+  }
+  _buffered = 0;
+  _inBody = false;
+  if (_sent > 0)
+    _sent--;
 
-  #ifdef DEBUG_SYSLOG 
-    syslog.logf(LOG_DEBUG, "[HTTP] GET... failed, error: %s\n", http.errorToString(httpCode).c_str());
-  #endif
+  if (ok && !_writeFailed)
+  {
+    SPIFFS.remove(job.fileName);
+    ok = SPIFFS.rename(F(WEB_TEMP_FILE), job.fileName);
+  }
+  else
+  {
+    SPIFFS.remove(F(WEB_TEMP_FILE));
+    ok = false;
   }
 
-  http.end();
+  // Broken transfer: once more at the end of the queue
+  if (!ok && retry && !_writeFailed && job.retries < WEB_RETRIES)
+  {
+    requeue().retries++;
+    return;
   }
-*/
+
+  _head = (_head + 1) % WEB_QUEUE_SIZE;
+  _count--;
+
+  _done++;
+  if (!ok)
+    errLog(String(F("Can't download ")) + job.fileName);
+#ifdef DEBUG_SYSLOG
+  else
+    syslog.logf(LOG_DEBUG, "Downloaded %s, %u bytes\n", job.fileName.c_str(), _received);
+#endif
+
+  String fileName = job.fileName;
+  clearJob(job);
+  if (_queueCallback)
+    _queueCallback(fileName, ok, _done, _total);
+}
+
+// First file of the queue to the end of it, behind the requests already sent
+WebResource::Job &WebResource::requeue()
+{
+  Job &job = _jobs[_head];
+  _head = (_head + 1) % WEB_QUEUE_SIZE;
+
+  Job &again = _jobs[(_head + _count - 1) % WEB_QUEUE_SIZE];
+  if (&again != &job)
+  {
+    again.url = job.url;
+    again.fileName = job.fileName;
+    again.urgent = job.urgent;
+    again.retries = job.retries;
+    clearJob(job);
+  }
+  return again;
+}
+
+// Give the heap back
+void WebResource::clearJob(Job &job)
+{
+  job.url = String();
+  job.fileName = String();
+}
+
+// Of the response being read, 0 if not given
+uint32_t WebResource::getContentLength()
+{
+  long length = _response.getContentLength();
+  return length > 0 ? length : 0;
+}
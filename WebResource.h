@@ -22,23 +22,117 @@ See more at http://blog.squix.ch
 #include <ESP8266WiFi.h>
 #include <ESP8266WiFiMulti.h>
 #include <ESP8266HTTPClient.h>
+#include <WiFiClient.h>
+#define FS_NO_GLOBALS
+#include <FS.h>
+#include "HttpResponse.h"
 
 #ifndef _WEBRESOURCE_H
 #define _WEBRESOURCE_H
 
+#define WEB_QUEUE_SIZE 68         // files waiting: 62 weather bitmaps, 2 splash images, 4 map tiles at most
+#define WEB_PIPELINE_DEPTH 4      // requests sent ahead of the response being read
+#define WEB_WRITE_BUFFER 1024     // (bytes) SPIFFS writes are gathered up to this, on the heap while the queue is busy
+#define WEB_RETRIES 2             // after a broken transfer, not a failed connect
+#define WEB_TIMEOUT 10000         // (ms) without a byte before the connection is dropped
+#define WEB_CONNECT_BACKOFF 60000 // (ms) after a failed connect, before service() tries another
+#define WEB_FINISH_TIMEOUT 120000 // (ms) longest finish() waits, what is left stays queued
+#define WEB_TEMP_FILE "/dl.tmp"   // file being received, renamed once complete
+
+// bytesTotal 0 if the server did not tell the length
 typedef void (*ProgressCallback)(String fileName, uint32_t bytesDownloaded, uint32_t bytesTotal);
 
+// One queued file done, written or given up (ok false); done of total since the queue was last empty
+typedef void (*QueueCallback)(String fileName, bool ok, uint16_t done, uint16_t total);
+
+// -------------------------------------------------------
+// Download queue
+// -------------------------------------------------------
+//
+// Files are queued and fetched in order by service(), which a background
+// process calls with a time budget. Consecutive files from the same host
+// share one HTTP/1.1 keep-alive connection, with up to WEB_PIPELINE_DEPTH
+// requests sent ahead so the server never waits for the next one. Bodies
+// are read in bulk and written to SPIFFS in WEB_WRITE_BUFFER blocks; a
+// file only takes its name once complete, so a broken transfer never
+// leaves a truncated file that would be taken as downloaded.
+//
+// A failed connect can block for seconds: after one, service() leaves the
+// network alone for WEB_CONNECT_BACKOFF and finish() returns. The file goes
+// to the end of the queue without using a retry, so nothing is given up
+// while a host can't be reached. A response abandoned before its end,
+// status line included, counts as a try of the first file, so WEB_RETRIES
+// bounds a server that accepts and never answers. finish() gives up after
+// WEB_FINISH_TIMEOUT in any case.
+
 class WebResource {
   public:
     WebResource();
+
+    // Queue the file ahead of the others and wait for it
     void downloadFile(String url, String filename, ProgressCallback progressCallback);
     void downloadFile(String url, String filename);
 
+    // Unless the file exists or is queued already. Urgent files go ahead of the others.
+    // False if the queue is full
+    bool enqueue(String url, String fileName, bool urgent = false);
+
+    // Queued work for up to budget ms, returns early when waiting for the network. True while files are left
+    bool service(unsigned long budget);
+
+    // Everything queued (or just the urgent files), now. Stops waiting at the first host that can't
+    // be reached or after WEB_FINISH_TIMEOUT, what is left stays queued for service()
+    void finish(QueueCallback queueCallback = nullptr, ProgressCallback progressCallback = nullptr, bool urgentOnly = false);
+
+    void setQueueCallback(QueueCallback queueCallback);
+    bool isBusy();
+    uint16_t getDone();
+    uint16_t getTotal();
 
   private:
+    struct Job
+    {
+      String url;
+      String fileName;
+      uint8_t retries;
+      bool urgent;
+    };
+
+    bool step();
+    bool hasUrgent();
+    bool connect(const String &url);
+    void request(const String &url);
+    void write(const uint8_t *data, int count);
+    void complete(bool ok, bool retry);
+    Job &requeue();
+    void clearJob(Job &job);
+    uint32_t getContentLength();
+
     ESP8266WiFiMulti _wifiMulti;
 
+    Job _jobs[WEB_QUEUE_SIZE];
+    uint8_t _head = 0;
+    uint8_t _count = 0;
+    uint16_t _done = 0;
+    uint16_t _total = 0;
+    QueueCallback _queueCallback = nullptr;
+    ProgressCallback _progressCallback = nullptr;
+
+    // Connection and the response being read
+    WiFiClient _client;
+    String _host;             // "host:port" connected to
+    uint8_t _sent = 0;        // requests out for the first _sent jobs
+    bool _inBody = false;
+    unsigned long _lastActivity = 0;
+    bool _unreachable = false;  // the last connect failed
+    unsigned long _failedAt = 0;
+    fs::File _file;
+    bool _writeFailed = false;
+    uint32_t _received = 0;
+    uint16_t _buffered = 0;
+    uint8_t _responseBuffer[HTTP_BUFFER_SIZE];
+    uint8_t *_writeBuffer = nullptr;
+    HttpResponse _response;
 };
 
 #endif
-
@@ -0,0 +1,154 @@
+#include "Widgets.h"
+#include "Free_Fonts.h"
+
+// External variables
+extern TFT_eSPI LCD;
+
+// -------------------------------------------------------
+// Widget
+// -------------------------------------------------------
+
+void Widget::invalidate()
+{
+  _dirty = true;
+}
+
+bool Widget::isDirty()
+{
+  return _dirty;
+}
+
+void Widget::flush()
+{
+  if (_dirty)
+  {
+    draw();
+    _dirty = false;
+  }
+}
+
+// -------------------------------------------------------
+// Group
+// -------------------------------------------------------
+
+void WidgetGroup::add(Widget &child)
+{
+  child._next = nullptr;
+  if (_last)
+    _last->_next = &child;
+  else
+    _first = &child;
+  _last = &child;
+}
+
+void WidgetGroup::invalidate()
+{
+  for (Widget *child = _first; child; child = child->_next)
+    child->invalidate();
+}
+
+bool WidgetGroup::isDirty()
+{
+  for (Widget *child = _first; child; child = child->_next)
+  {
+    if (child->isDirty())
+      return true;
+  }
+  return false;
+}
+
+void WidgetGroup::flush()
+{
+  for (Widget *child = _first; child; child = child->_next)
+    child->flush();
+}
+
+// -------------------------------------------------------
+// Text
+// -------------------------------------------------------
+
+TextWidget::TextWidget(int16_t x, int16_t y, const GFXfont *font, uint8_t datum, uint16_t color, uint16_t background)
+{
+  _x = x;
+  _y = y;
+  _font = font;
+  _datum = datum;
+  _color = color;
+  _background = background;
+}
+
+void TextWidget::setText(const String &text)
+{
+  if (text != _text)
+  {
+    _text = text;
+    _dirty = true;
+  }
+}
+
+void TextWidget::setColor(uint16_t color)
+{
+  if (color != _color)
+  {
+    _color = color;
+    _dirty = true;
+  }
+}
+
+void TextWidget::draw()
+{
+  LCD.setFreeFont(_font);
+  LCD.setTextDatum(_datum);
+  LCD.setTextColor(_color, _background);
+
+  // Padding to the previous width erases the tail of a longer previous text
+  LCD.setTextPadding(_drawnWidth);
+  int16_t width = LCD.drawString(_text, _x, _y, GFXFF);
+  LCD.setTextPadding(0);
+
+  _drawnWidth = width;
+}
+
+// -------------------------------------------------------
+// Gauge
+// -------------------------------------------------------
+
+GaugeWidget::GaugeWidget(int16_t x, int16_t y, int16_t width, int16_t height, bool vertical, uint16_t background)
+{
+  _x = x;
+  _y = y;
+  _width = width;
+  _height = height;
+  _vertical = vertical;
+  _background = background;
+}
+
+void GaugeWidget::setLevel(int level, uint16_t color)
+{
+  level = constrain(level, 0, 100);
+  if (level != _level || color != _color)
+  {
+    _level = level;
+    _color = color;
+    _dirty = true;
+  }
+}
+
+void GaugeWidget::draw()
+{
+  if (_level < 0)
+    return;
+
+  if (_vertical)
+  {
+    int16_t fill = _level * _height / 100;
+    LCD.fillRect(_x, _y + _height - fill, _width, fill, _color);
+    LCD.fillRect(_x, _y, _width, _height - fill, _background);
+  }
+  else
+  {
+    int16_t fill = _level * _width / 100;
+    LCD.fillRect(_x, _y, fill, _height, _color);
+    LCD.fillRect(_x + fill, _y, _width - fill, _height, _background);
+  }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Arduino.h"
+#include <TFT_eSPI.h>             // https://github.com/Bodmer/TFT_eSPI
+
+// -------------------------------------------------------
+// Retained mode widgets
+// -------------------------------------------------------
+//
+// Screens keep their dynamic content in widget nodes and only set values in
+// update(). A node marks itself dirty when a value actually changes;
+// flush() repaints the dirty nodes and nothing else, so a refresh where
+// nothing changed sends no pixels to the panel.
+// Static decoration (labels, separators) is still drawn once in activate().
+
+class Widget
+{
+  public:
+    virtual ~Widget() {}
+
+    // Repaint at the next flush, e.g. after the screen was cleared
+    virtual void invalidate();
+    virtual bool isDirty();
+
+    // Repaint if dirty
+    virtual void flush();
+
+  protected:
+    virtual void draw() = 0;
+    bool _dirty = true;
+
+  private:
+    Widget *_next = nullptr;
+    friend class WidgetGroup;
+};
+
+// Node holding other nodes, painted in the order they were added
+class WidgetGroup : public Widget
+{
+  public:
+    void add(Widget &child);
+    virtual void invalidate();
+    virtual bool isDirty();
+    virtual void flush();
+
+  protected:
+    virtual void draw() {}
+
+  private:
+    Widget *_first = nullptr;
+    Widget *_last = nullptr;
+};
+
+// Single line of text. A shorter text clears what is left of the previous one
+class TextWidget : public Widget
+{
+  public:
+    TextWidget() : TextWidget(0, 0, nullptr, TL_DATUM) {}
+    TextWidget(int16_t x, int16_t y, const GFXfont *font, uint8_t datum, uint16_t color = TFT_WHITE, uint16_t background = TFT_BLACK);
+    void setText(const String &text);
+    void setColor(uint16_t color);
+
+  protected:
+    virtual void draw();
+
+  private:
+    int16_t _x, _y;
+    const GFXfont *_font;
+    uint8_t _datum;
+    uint16_t _color, _background;
+    String _text;
+    int16_t _drawnWidth = 0;
+};
+
+// Level bar, 0..100 %, filling left to right or bottom to top
+class GaugeWidget : public Widget
+{
+  public:
+    GaugeWidget(int16_t x, int16_t y, int16_t width, int16_t height, bool vertical, uint16_t background = TFT_BLACK);
+    void setLevel(int level, uint16_t color);
+
+  protected:
+    virtual void draw();
+
+  private:
+    int16_t _x, _y, _width, _height;
+    bool _vertical;
+    uint16_t _background;
+    int _level = -1;
+    uint16_t _color = TFT_GREEN;
+};
@@ -27,6 +27,8 @@
 #include <WiFiClient.h>
 #include <Arduino.h>
 #include "WundergroundClient.h"
+#include "HttpResponse.h"
+#include "JsonKeys.h"
 
 #include <Syslog.h>               // https://github.com/arcao/ESP8266_Syslog
 
@@ -36,6 +38,18 @@ extern Syslog syslog;
 bool usePM = false; // Set to true if you want to use AM/PM time disaply
 bool isPM = false; // JJG added ///////////
 
+// Same order as WundergroundClient::Key
+static constexpr const char *keyNames[] = {
+  "geolookup", "txt_forecast", "simpleforecast", "current_observation", "alerts",
+  "percentIlluminated", "ageOfMoon", "phaseofMoon", "sunrise", "sunset", "moonrise",
+  "moonset", "hour", "minute", "wind_mph", "wind_dir", "temp_f", "temp_c", "icon",
+  "weather", "period", "title", "fahrenheit", "celsius", "high", "low", "location",
+  "country", "country_name", "city", "tz_short", "tz_long"
+};
+static constexpr JsonKeyTable<sizeof(keyNames) / sizeof(keyNames[0]), 6> keys(keyNames);
+static_assert(keys.isPerfect(), "Wunderground key table has collisions, give it more bits");
+static_assert(sizeof(keyNames) / sizeof(keyNames[0]) == WundergroundClient::KEY_TZ_LONG, "Wunderground key names and ids differ");
+
 WundergroundClient::WundergroundClient(bool _isMetric) {
   isMetric = _isMetric;
 }
@@ -125,46 +139,24 @@ bool WundergroundClient::doUpdate(String url)
   client.print(url);
   client.print(F(" HTTP/1.1\r\nHost: api.wunderground.com\r\nConnection: close\r\n\r\n"));
 
-  int retryCounter = 0;
-  while (!client.available())
+  HttpResponse response(client);
+  if (!response.begin() || response.getStatus() != 200)
   {
-    delay(1000);
-    retryCounter++;
-    if (retryCounter > 10)
-    {
 #ifdef DEBUG_SYSLOG 
-      syslog.log(LOG_DEBUG, "Too many retries, giving up");
+    syslog.log(LOG_DEBUG, "No valid response, giving up");
 #endif
-      return false;
-    }
-  }
-
-  int pos = 0;
-  bool isBody = false;
-  char c;
-
-  int size = 0;
-  client.setNoDelay(false);
-  while (client.connected()) {
-    while ((size = client.available()) > 0) {
-      c = client.read();
-      //response +=c;
-      if (c == '{' || c == '[') {
-        isBody = true;
-      }
-      if (isBody)
-      {
-        parser.parse(c);
-      }
-    }
+    client.stop();
+    return false;
   }
+
+  bool complete = response.parse(parser);
   client.stop();
 
 #ifdef DEBUG_SYSLOG 
   syslog.log(LOG_DEBUG, "Job done");
 #endif
 
-  return true;
+  return complete;
 }
 
 
@@ -182,11 +174,7 @@ void WundergroundClient::key(String key)
   syslog.log(LOG_DEBUG, "KEY =  " + key);
 #endif
 
-
-  currentKey = String(key);
-
-  // #ifdef DEBUG_SERIAL Serial.println("Key = " + currentKey);
-
+  currentKey = (Key) keys.lookup(key.c_str());
 
   //	Restructured following logic to accomodate the multiple types of JSON returns based on the API.  This was necessary since several
   //	keys are reused between various types of API calls, resulting in confusing returns in the original function.  Various bools
@@ -194,51 +182,69 @@ void WundergroundClient::key(String key)
   //	forecast API that contains detailed text for the forecast period; the simple forecast (simpleforecast), the second section of the
   //	10-day forecast API that contains such data as forecast highs/lows, conditions, precipitation / probabilities; the current
   //	observations (current_observation), from the observations API call; or alerts (alerts), for the future) weather alerts API call.
-
-  //    Added by MarcFinns 15 Feb 2017
-  if (currentKey == F("geolookup"))
+  switch (currentKey)
   {
-    isGeolookup = true;
-    isForecast = false;
-    isCurrentObservation = false; // fowlerk
-    isSimpleForecast = false;   // fowlerk
-    /*
-      isAlerts = false;       // fowlerk
-    */
-  }
-
-
-  //		Added by fowlerk...18-Dec-2016
-  if (currentKey == F("txt_forecast")) {
-    isForecast = true;
-    isGeolookup = false;
-    isCurrentObservation = false;	// fowlerk
-    isSimpleForecast = false;		// fowlerk
-    //   isAlerts = false;				// fowlerk
-  }
-  if (currentKey == F("simpleforecast")) {
-    isSimpleForecast = true;
-    isGeolookup = false;
-    isCurrentObservation = false;	// fowlerk
-    isForecast = false;				// fowlerk
-    //   isAlerts = false;				// fowlerk
-  }
-  //  Added by fowlerk...
-  if (currentKey == F("current_observation")) {
-    isCurrentObservation = true;
-    isGeolookup = false;
-    isSimpleForecast = false;
-    isForecast = false;
-    //   isAlerts = false;
-  }
-  if (currentKey == F("alerts")) {
-    isCurrentObservation = false;
-    isGeolookup = false;
-    isSimpleForecast = false;
-    isForecast = false;
-    //    isAlerts = true;
+    //    Added by MarcFinns 15 Feb 2017
+    case KEY_GEOLOOKUP:
+      isGeolookup = true;
+      isForecast = false;
+      isCurrentObservation = false;
+      isSimpleForecast = false;
+      break;
+
+    //		Added by fowlerk...18-Dec-2016
+    case KEY_TXT_FORECAST:
+      isForecast = true;
+      isGeolookup = false;
+      isCurrentObservation = false;
+      isSimpleForecast = false;
+      break;
+
+    case KEY_SIMPLEFORECAST:
+      isSimpleForecast = true;
+      isGeolookup = false;
+      isCurrentObservation = false;
+      isForecast = false;
+      break;
+
+    case KEY_CURRENT_OBSERVATION:
+      isCurrentObservation = true;
+      isGeolookup = false;
+      isSimpleForecast = false;
+      isForecast = false;
+      break;
+
+    case KEY_ALERTS:
+      isCurrentObservation = false;
+      isGeolookup = false;
+      isSimpleForecast = false;
+      isForecast = false;
+      break;
+
+    default:
+      break;
+  }
+}
+
+// Hour key of a sunrise/sunset/moonrise/moonset object: "hh", 12 hour clock if usePM
+static void setHour(char *time, const char *value, bool twelveHour)
+{
+  int hour = atoi(value);
+  if (twelveHour)
+  {
+    isPM = usePM && hour > 12;
+    if (isPM)
+      hour -= 12;
   }
-  // end fowlerk add
+  snprintf(time, WU_SHORT_SIZE, "%2d", hour);
+}
+
+// Minute key, appended to the hour as ":mm" plus am/pm
+static void addMinute(char *time, const char *value, bool twelveHour)
+{
+  size_t length = strlen(time);
+  const char *suffix = twelveHour && usePM ? (isPM ? "pm" : "am") : "";
+  snprintf(time + length, WU_SHORT_SIZE - length, ":%02d%s", atoi(value), suffix);
 }
 
 void WundergroundClient::value(String value)
@@ -247,347 +253,131 @@ void WundergroundClient::value(String value)
   syslog.log(LOG_DEBUG, "VALUE =  " + value);
 #endif
 
-  /*
-    if (currentKey == F("local_epoch"))
-    {
-    localEpoc = value.toInt();
-    localMillisAtUpdate = millis();
-    }
-  */
-  // JJG added ... //////////////////////// search for keys /////////////////////////
-  if (currentKey == F("percentIlluminated"))
-  {
-    moonPctIlum = value;
-  }
+  const char *text = value.c_str();
 
-  if (currentKey == F("ageOfMoon"))
-  {
-    moonAge = value;
-  }
+  // The detailed forecast period has only one forecast per day with low/high for both
+  // night and day, starting at index 1.
+  int dailyForecastPeriod = (currentForecastPeriod - 1) * 2;
 
-  if (currentKey == F("phaseofMoon"))
+  switch (currentKey)
   {
-    moonPhase = value;
-  }
-
-  if (currentParent == F("sunrise")) {      // Has a Parent key and 2 sub-keys
-    if (currentKey == F("hour")) {
-      int tempHour = value.toInt();    // do this to concert to 12 hour time (make it a function!)
-      if (usePM && tempHour > 12) {
-        tempHour -= 12;
-        isPM = true;
-      }
-      else isPM = false;
-      char tempHourBuff[3] = "";						// fowlerk add for formatting, 12/22/16
-      sprintf(tempHourBuff, "%2d", tempHour);			// fowlerk add for formatting, 12/22/16
-      sunriseTime = String(tempHourBuff);				// fowlerk add for formatting, 12/22/16
-      //sunriseTime = value;
-    }
-    if (currentKey == F("minute")) {
-      char tempMinBuff[3] = "";						// fowlerk add for formatting, 12/22/16
-      sprintf(tempMinBuff, "%02d", value.toInt());	// fowlerk add for formatting, 12/22/16
-      sunriseTime += ":" + String(tempMinBuff);		// fowlerk add for formatting, 12/22/16
-      if (isPM) sunriseTime += "pm";
-      else if (usePM) sunriseTime += "am";
-    }
-  }
-
-
-  if (currentParent == F("sunset")) {      // Has a Parent key and 2 sub-keys
-    if (currentKey == F("hour")) {
-      int tempHour = value.toInt();   // do this to concert to 12 hour time (make it a function!)
-      if (usePM && tempHour > 12) {
-        tempHour -= 12;
-        isPM = true;
+    // JJG added ... //////////////////////// search for keys /////////////////////////
+    case KEY_PERCENT_ILLUMINATED:
+      copyJsonValue(moonPctIlum, WU_SHORT_SIZE, text);
+      break;
+
+    case KEY_AGE_OF_MOON:
+      copyJsonValue(moonAge, WU_SHORT_SIZE, text);
+      break;
+
+    case KEY_PHASE_OF_MOON:
+      copyJsonValue(moonPhase, WU_NAME_SIZE, text);
+      break;
+
+    // Sunrise, sunset, moonrise and moonset have a parent key and 2 sub-keys
+    case KEY_HOUR:
+      if (currentParent == KEY_SUNRISE)
+        setHour(sunriseTime, text, true);
+      else if (currentParent == KEY_SUNSET)
+        setHour(sunsetTime, text, true);
+      else if (currentParent == KEY_MOONRISE)
+        setHour(moonriseTime, text, true);
+      else if (currentParent == KEY_MOONSET)      // Not used
+        setHour(moonsetTime, text, false);
+      break;
+
+    case KEY_MINUTE:
+      if (currentParent == KEY_SUNRISE)
+        addMinute(sunriseTime, text, true);
+      else if (currentParent == KEY_SUNSET)
+        addMinute(sunsetTime, text, true);
+      else if (currentParent == KEY_MOONRISE)
+        addMinute(moonriseTime, text, true);
+      else if (currentParent == KEY_MOONSET)
+        addMinute(moonsetTime, text, false);
+      break;
+
+    case KEY_WIND_MPH:
+      copyJsonValue(windSpeed, WU_SHORT_SIZE, text);
+      break;
+
+    case KEY_WIND_DIR:
+      copyJsonValue(windDir, WU_NAME_SIZE, text);
+      break;
+    // end JJG add  ////////////////////////////////////////////////////////////////////
+
+    case KEY_TEMP_F:
+      if (!isMetric)
+        copyJsonValue(currentTemp, WU_SHORT_SIZE, text);
+      break;
+
+    case KEY_TEMP_C:
+      if (isMetric)
+        copyJsonValue(currentTemp, WU_SHORT_SIZE, text);
+      break;
+
+    case KEY_ICON:
+      if (isForecast && !isSimpleForecast &&  currentForecastPeriod < MAX_FORECAST_PERIODS) {
+        copyJsonValue(forecastIcon[currentForecastPeriod], WU_NAME_SIZE, text);
       }
-      else isPM = false;
-      char tempHourBuff[3] = "";						// fowlerk add for formatting, 12/22/16
-      sprintf(tempHourBuff, "%2d", tempHour);			// fowlerk add for formatting, 12/22/16
-      sunsetTime = String(tempHourBuff);				// fowlerk add for formatting, 12/22/16
-      // sunsetTime = value;
-    }
-    if (currentKey == F("minute")) {
-      char tempMinBuff[3] = "";						// fowlerk add for formatting, 12/22/16
-      sprintf(tempMinBuff, "%02d", value.toInt());	// fowlerk add for formatting, 12/22/16
-      sunsetTime += ":" + String(tempMinBuff);		// fowlerk add for formatting, 12/22/16
-      if (isPM) sunsetTime += "pm";
-      else if (usePM) sunsetTime += "am";
-    }
-  }
-
-  if (currentParent == F("moonrise")) {      // Has a Parent key and 2 sub-keys
-    if (currentKey == F("hour")) {
-      int tempHour = value.toInt();   // do this to concert to 12 hour time (make it a function!)
-      if (usePM && tempHour > 12) {
-        tempHour -= 12;
-        isPM = true;
+      if (isCurrentObservation && !(isForecast || isSimpleForecast)) {		// Added by fowlerk
+        copyJsonValue(weatherIcon, WU_NAME_SIZE, text);
       }
-      else isPM = false;
-      char tempHourBuff[3] = "";						// fowlerk add for formatting, 12/22/16
-      sprintf(tempHourBuff, "%2d", tempHour);			// fowlerk add for formatting, 12/22/16
-      moonriseTime = String(tempHourBuff);			// fowlerk add for formatting, 12/22/16
-      // moonriseTime = value;
-    }
-    if (currentKey == F("minute")) {
-      char tempMinBuff[3] = "";						// fowlerk add for formatting, 12/22/16
-      sprintf(tempMinBuff, "%02d", value.toInt());	// fowlerk add for formatting, 12/22/16
-      moonriseTime += ":" + String(tempMinBuff);		// fowlerk add for formatting, 12/22/16
-      if (isPM) moonriseTime += "pm";
-      else if (usePM) moonriseTime += "am";
-    }
-  }
-
-  if (currentParent == F("moonset")) {      // Not used - has a Parent key and 2 sub-keys
-    if (currentKey == F("hour")) {
-      char tempHourBuff[3] = "";						// fowlerk add for formatting, 12/22/16
-      sprintf(tempHourBuff, "%2d", value.toInt());	// fowlerk add for formatting, 12/22/16
-      moonsetTime = String(tempHourBuff);				// fowlerk add for formatting, 12/22/16
-    }
-    if (currentKey == F("minute")) {
-      char tempMinBuff[3] = "";						// fowlerk add for formatting, 12/22/16
-      sprintf(tempMinBuff, "%02d", value.toInt());	// fowlerk add for formatting, 12/22/16
-      moonsetTime += ":" + String(tempMinBuff);		// fowlerk add for formatting, 12/22/16
-    }
-  }
-
-  if (currentKey == F("wind_mph")) {
-    windSpeed = value;
-  }
-
-  if (currentKey == F("wind_dir")) {
-    windDir = value;
-  }
-
-  // end JJG add  ////////////////////////////////////////////////////////////////////
-  /*
-    if (currentKey == F("observation_time_rfc822")) {
-      date = value.substring(0, 16);
-    }
-
-    // Begin add, fowlerk...04-Dec-2016
-    if (currentKey == F("observation_time")) {
-      observationTime = value;
-    }
-    // end add, fowlerk
-  */
-  if (currentKey == F("temp_f") && !isMetric) {
-    currentTemp = value;
-  }
-  if (currentKey == F("temp_c") && isMetric) {
-    currentTemp = value;
-  }
-  if (currentKey == F("icon")) {
-    if (isForecast && !isSimpleForecast &&  currentForecastPeriod < MAX_FORECAST_PERIODS) {
-      // #ifdef DEBUG_SERIAL Serial.println(String(currentForecastPeriod) + ": " + value + ":" + currentParent);
-      forecastIcon[currentForecastPeriod] = value;
-    }
-    // if (!isForecast) {													// Removed by fowlerk
-    if (isCurrentObservation && !(isForecast || isSimpleForecast)) {		// Added by fowlerk
-      weatherIcon = value;
-    }
-  }
-  if (currentKey == F("weather")) {
-    weatherText = value;
-  }
-
-  /*
-    if (currentKey == F("relative_humidity")) {
-    humidity = value;
-    }
-    if (currentKey == F("pressure_mb") && isMetric) {
-    pressure = value + "mb";
-    }
-    if (currentKey == F("pressure_in") && !isMetric) {
-    pressure = value + "in";
-    }
-    // fowlerk added...
-    if (currentKey == F("feelslike_f") && !isMetric) {
-    feelslike = value;
-    }
-
-    if (currentKey == F("feelslike_c") && isMetric) {
-    feelslike = value;
-    }
-
-    if (currentKey == F("UV")) {
-      UV = value;
-    }
-    // Active alerts...added 18-Dec-2016
-    if (currentKey == F("type") && isAlerts) {
-      activeAlertsCnt++;
-      currentAlert++;
-      activeAlerts[currentAlert - 1] = value;
-      // #ifdef DEBUG_SERIAL Serial.print("Alert type processed, value:  "); // #ifdef DEBUG_SERIAL Serial.println(activeAlerts[currentAlert - 1]);
-    }
-
-    if (currentKey == F("description") && isAlerts && isAlertUS) {
-      activeAlertsText[currentAlert - 1] = value;
-      // #ifdef DEBUG_SERIAL Serial.print("Alert description processed, value:  "); // #ifdef DEBUG_SERIAL Serial.println(activeAlertsText[currentAlert - 1]);
-    }
-    if (currentKey == F("wtype_meteoalarm_name") && isAlerts && isAlertEU) {
-      activeAlertsText[currentAlert - 1] = value;
-      // #ifdef DEBUG_SERIAL Serial.print("Alert description processed, value:  "); // #ifdef DEBUG_SERIAL Serial.println(activeAlertsText[currentAlert - 1]);
-    }
-    if (currentKey == F("message") && isAlerts) {
-      activeAlertsMessage[currentAlert - 1] = value;
-      // #ifdef DEBUG_SERIAL Serial.print("Alert msg length:  "); // #ifdef DEBUG_SERIAL Serial.println(activeAlertsMessage[currentAlert - 1].length());
-      if (activeAlertsMessage[currentAlert - 1].length() >= 511) {
-        activeAlertsMessageTrunc[currentAlert - 1] = true;
-      } else {
-        activeAlertsMessageTrunc[currentAlert - 1] = false;
+      break;
+
+    case KEY_WEATHER:
+      copyJsonValue(weatherText, WU_TEXT_SIZE, text);
+      break;
+
+    case KEY_PERIOD:
+      currentForecastPeriod = atoi(text);
+      break;
+
+    // The keyword title is used in both the current observation and the 10-day forecast,
+    // only the forecast one is the day of week of the current forecast day.
+    case KEY_TITLE:
+      if (isForecast && currentForecastPeriod < MAX_FORECAST_PERIODS) {
+        copyJsonValue(forecastTitle[currentForecastPeriod], WU_NAME_SIZE, text);
       }
-      // #ifdef DEBUG_SERIAL Serial.print("Alert message processed, value:  "); // #ifdef DEBUG_SERIAL Serial.println(activeAlertsMessage[currentAlert - 1]);
-    }
-    if (currentKey == ("date") && isAlerts) {
-      activeAlertsStart[currentAlert - 1] = value;
-      // Check last char for a "/"; the returned value sometimes includes this; if so, strip it (47 is a "/" char)
-      if (activeAlertsStart[currentAlert - 1].charAt(activeAlertsStart[currentAlert - 1].length() - 1) == 47) {
-        // #ifdef DEBUG_SERIAL Serial.println("...last char is a slash...");
-        activeAlertsStart[currentAlert - 1] = activeAlertsStart[currentAlert - 1].substring(0, (activeAlertsStart[currentAlert - 1].length() - 1));
+      break;
+
+    case KEY_FAHRENHEIT:
+    case KEY_CELSIUS:
+      if ((currentKey == KEY_CELSIUS) == isMetric && dailyForecastPeriod >= 0 && dailyForecastPeriod < MAX_FORECAST_PERIODS) {
+        if (currentParent == KEY_HIGH) {
+          copyJsonValue(forecastHighTemp[dailyForecastPeriod], WU_SHORT_SIZE, text);
+        }
+        if (currentParent == KEY_LOW) {
+          copyJsonValue(forecastLowTemp[dailyForecastPeriod], WU_SHORT_SIZE, text);
+        }
       }
-      // For meteoalarms, the start field is returned with the UTC=0 by default (not used?)
-      if (isAlertEU && activeAlertsStart[currentAlert - 1] == F("1970-01-01 00:00:00 GMT")) {
-        activeAlertsStart[currentAlert - 1] = F("<Not specified>");
+      break;
+
+    // MarcFinns mods
+    case KEY_COUNTRY:
+    case KEY_COUNTRY_NAME:
+    case KEY_CITY:
+    case KEY_TZ_SHORT:
+    case KEY_TZ_LONG:
+      if (isGeolookup && currentParent == KEY_LOCATION)
+      {
+        if (currentKey == KEY_COUNTRY)
+          copyJsonValue(country, WU_SHORT_SIZE, text);
+        else if (currentKey == KEY_COUNTRY_NAME)
+          copyJsonValue(country_name, WU_TEXT_SIZE, text);
+        else if (currentKey == KEY_CITY)
+          copyJsonValue(city, WU_TEXT_SIZE, text);
+        else if (currentKey == KEY_TZ_SHORT)
+          copyJsonValue(tz_short, WU_SHORT_SIZE, text);
+        else
+          copyJsonValue(tz_long, WU_TEXT_SIZE, text);
       }
-      // #ifdef DEBUG_SERIAL Serial.print("Alert start processed, value:  "); // #ifdef DEBUG_SERIAL Serial.println(activeAlertsStart[currentAlert - 1]);
-    }
-    if (currentKey == F("expires") && isAlerts) {
-      activeAlertsEnd[currentAlert - 1] = value;
-      // #ifdef DEBUG_SERIAL Serial.print("Alert expiration processed, value:  "); // #ifdef DEBUG_SERIAL Serial.println(activeAlertsEnd[currentAlert - 1]);
-    }
-    if (currentKey == F("phenomena") && isAlerts) {
-      activeAlertsPhenomena[currentAlert - 1] = value;
-      // #ifdef DEBUG_SERIAL Serial.print("Alert phenomena processed, value:  "); // #ifdef DEBUG_SERIAL Serial.println(activeAlertsPhenomena[currentAlert - 1]);
-    }
-    if (currentKey == F("significance") && isAlerts && isAlertUS) {
-      activeAlertsSignificance[currentAlert - 1] = value;
-      // #ifdef DEBUG_SERIAL Serial.print("Alert significance processed, value:  "); // #ifdef DEBUG_SERIAL Serial.println(activeAlertsSignificance[currentAlert - 1]);
-    }
-    // Map meteoalarm level to the field for significance for consistency (used for European alerts)
-    if (currentKey == F("level_meteoalarm") && isAlerts && isAlertEU) {
-      activeAlertsSignificance[currentAlert - 1] = value;
-      // #ifdef DEBUG_SERIAL Serial.print("Meteo alert significance processed, value:  "); // #ifdef DEBUG_SERIAL Serial.println(activeAlertsSignificance[currentAlert - 1]);
-    }
-    // For meteoalarms only (European alerts); attribution must be displayed according to the T&C's of use
-    if (currentKey == F("attribution") && isAlerts) {
-      activeAlertsAttribution[currentAlert - 1] = value;
-      // Remove some of the markup in the attribution
-      activeAlertsAttribution[currentAlert - 1].replace(" <a href='", " ");
-      activeAlertsAttribution[currentAlert - 1].replace("</a>", "");
-      activeAlertsAttribution[currentAlert - 1].replace("/'>", " ");
-    }
-
-    // end fowlerk add
-
-    if (currentKey == F("dewpoint_f") && !isMetric) {
-      dewPoint = value;
-    }
-    if (currentKey == F("dewpoint_c") && isMetric) {
-      dewPoint = value;
-    }
-    if (currentKey == F("precip_today_metric") && isMetric) {
-      precipitationToday = value + "mm";
-    }
-    if (currentKey == F("precip_today_in") && !isMetric) {
-      precipitationToday = value + "in";
-    }
-  */
-  if (currentKey == F("period")) {
-    currentForecastPeriod = value.toInt();
-  }
-  // Modified below line to add check to ensure we are processing the 10-day forecast
-  // before setting the forecastTitle (day of week of the current forecast day).
-  // (The keyword title is used in both the current observation and the 10-day forecast.)
-  //		Modified by fowlerk
-  // if (currentKey == "title" && currentForecastPeriod < MAX_FORECAST_PERIODS) {				// Removed, fowlerk
-  if (currentKey == F("title") && isForecast && currentForecastPeriod < MAX_FORECAST_PERIODS) {
-    // #ifdef DEBUG_SERIAL Serial.println(String(currentForecastPeriod) + ": " + value);
-    forecastTitle[currentForecastPeriod] = value;
-  }
-
-  /*
-    // Added forecastText key following...fowlerk, 12/3/16
-    if (currentKey == F("fcttext") && isForecast && !isMetric && currentForecastPeriod < MAX_FORECAST_PERIODS) {
-      forecastText[currentForecastPeriod] = value;
-    }
-    // Added option for metric forecast following...fowlerk, 12/22/16
-    if (currentKey == F("fcttext_metric") && isForecast && isMetric && currentForecastPeriod < MAX_FORECAST_PERIODS) {
-      forecastText[currentForecastPeriod] = value;
-    }
-    // end fowlerk add, 12/3/16
-
-        // Added PoP (probability of precipitation) key following...fowlerk, 12/22/16
-        if (currentKey == F("pop") && isForecast && currentForecastPeriod < MAX_FORECAST_PERIODS) {
-          PoP[currentForecastPeriod] = value;
-        }
-        // end fowlerk add, 12/22/16
-  */
-  // The detailed forecast period has only one forecast per day with low/high for both
-  // night and day, starting at index 1.
-  int dailyForecastPeriod = (currentForecastPeriod - 1) * 2;
+      break;
+    // end MarcFinns mods
 
-  if (currentKey == F("fahrenheit") && !isMetric && dailyForecastPeriod < MAX_FORECAST_PERIODS) {
-
-    if (currentParent == F("high")) {
-      forecastHighTemp[dailyForecastPeriod] = value;
-    }
-    if (currentParent == F("low")) {
-      forecastLowTemp[dailyForecastPeriod] = value;
-    }
-  }
-  if (currentKey == F("celsius") && isMetric && dailyForecastPeriod < MAX_FORECAST_PERIODS) {
-
-    if (currentParent == F("high")) {
-      // #ifdef DEBUG_SERIAL Serial.println(String(currentForecastPeriod) + ": " + value);
-      forecastHighTemp[dailyForecastPeriod] = value;
-    }
-    if (currentParent == F("low")) {
-      forecastLowTemp[dailyForecastPeriod] = value;
-    }
-  }
-
-  /*
-    // fowlerk added...to pull month/day from the forecast period
-    if (currentKey == F("month") && isSimpleForecast && currentForecastPeriod < MAX_FORECAST_PERIODS)
-    {
-    //	Added by fowlerk to handle transition from txtforecast to simpleforecast, as
-    //	the key "period" doesn't appear until after some of the key values needed and is
-    //	used as an array index.
-    if (isSimpleForecast && currentForecastPeriod == 19)
-    {
-      currentForecastPeriod = 0;
-    }
-    forecastMonth[currentForecastPeriod] = value;
-    }
-
-
-    if (currentKey == F("day") && isSimpleForecast && currentForecastPeriod < MAX_FORECAST_PERIODS)  {
-    //	Added by fowlerk to handle transition from txtforecast to simpleforecast, as
-    //	the key "period" doesn't appear until after some of the key values needed and is
-    //	used as an array index.
-    if (isSimpleForecast && currentForecastPeriod == 19) {
-      currentForecastPeriod = 0;
-    }
-    forecastDay[currentForecastPeriod] = value;
-    }
-    // end fowlerk add
-  */
-
-  // MarcFinns mods
-  if (isGeolookup && currentParent == F("location" ))
-  {
-    if (currentKey == F("country"))
-      country = value;
-    else if (currentKey == F("country_name"))
-      country_name = value;
-    else if (currentKey == F("city"))
-      city = value;
-    else if (currentKey == F("tz_short"))
-      tz_short = value;
-    else if (currentKey == F("tz_long"))
-      tz_long = value;
+    default:
+      break;
   }
-  // end MarcFinns mods
 }
 
 void WundergroundClient::endArray() {
@@ -599,7 +389,7 @@ void WundergroundClient::startObject()
 {
   // #ifdef DEBUG_SERIAL Serial.println("start object. " + currentKey);
 #ifdef DEBUG_SYSLOG 
-  syslog.log(LOG_DEBUG, "start object =  " + currentKey);
+  syslog.log(LOG_DEBUG, "start object =  " + String(currentKey));
 #endif
 
   currentParent = currentKey;
@@ -608,7 +398,7 @@ void WundergroundClient::startObject()
 void WundergroundClient::endObject()
 {
   // #ifdef DEBUG_SERIAL Serial.println("end object. " + currentParent);
-  currentParent = "";
+  currentParent = KEY_OTHER;
 }
 
 void WundergroundClient::endDocument()
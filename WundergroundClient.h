@@ -31,31 +31,45 @@
 // Changed to 20 to support max 10-day forecast returned from 'forecast10day' API (fowlerk)
 
 #define MAX_WEATHER_ALERTS 3  	 // The maximum number of concurrent weather alerts supported by the library
+#define WU_SHORT_SIZE 8         // temperatures, times, wind speed, moon age
+#define WU_NAME_SIZE 24         // icons, titles, moon phase, wind direction
+#define WU_TEXT_SIZE 48         // weather text, places, time zone
 
 class WundergroundClient: public JsonListener
 {
+  public:
+    // Keys used from the responses, in the order of the key table
+    enum Key : uint8_t
+    {
+      KEY_OTHER, KEY_GEOLOOKUP, KEY_TXT_FORECAST, KEY_SIMPLEFORECAST, KEY_CURRENT_OBSERVATION, KEY_ALERTS,
+      KEY_PERCENT_ILLUMINATED, KEY_AGE_OF_MOON, KEY_PHASE_OF_MOON, KEY_SUNRISE, KEY_SUNSET, KEY_MOONRISE,
+      KEY_MOONSET, KEY_HOUR, KEY_MINUTE, KEY_WIND_MPH, KEY_WIND_DIR, KEY_TEMP_F, KEY_TEMP_C, KEY_ICON,
+      KEY_WEATHER, KEY_PERIOD, KEY_TITLE, KEY_FAHRENHEIT, KEY_CELSIUS, KEY_HIGH, KEY_LOW, KEY_LOCATION,
+      KEY_COUNTRY, KEY_COUNTRY_NAME, KEY_CITY, KEY_TZ_SHORT, KEY_TZ_LONG
+    };
+
   private:
-    String currentKey;
-    String currentParent = "";
+    Key currentKey = KEY_OTHER;
+    Key currentParent = KEY_OTHER;
     long localEpoc = 0;
     int gmtOffset = 1;
     // long localMillisAtUpdate;
     String date = "-";
     bool isMetric = true;
-    String currentTemp;
+    char currentTemp[WU_SHORT_SIZE] = "";
     // JJG added ... ////////////////////////////////// define returns /////////////////////////////////
-    String moonPctIlum;  // not used
-    String moonAge;      // make this a long?
-    String moonPhase;
-    String sunriseTime;
-    String sunsetTime;
-    String moonriseTime;
-    String moonsetTime;
-    String windSpeed;
-    String windDir;
+    char moonPctIlum[WU_SHORT_SIZE] = "";  // not used
+    char moonAge[WU_SHORT_SIZE] = "";      // make this a long?
+    char moonPhase[WU_NAME_SIZE] = "";
+    char sunriseTime[WU_SHORT_SIZE] = "";
+    char sunsetTime[WU_SHORT_SIZE] = "";
+    char moonriseTime[WU_SHORT_SIZE] = "";
+    char moonsetTime[WU_SHORT_SIZE] = "";
+    char windSpeed[WU_SHORT_SIZE] = "";
+    char windDir[WU_NAME_SIZE] = "";
     // end JJG add ////////////////////////////////////////////////////////////////////////////////////
-    String weatherIcon;
-    String weatherText;
+    char weatherIcon[WU_NAME_SIZE] = "";
+    char weatherText[WU_TEXT_SIZE] = "";
 
     //String humidity;
     //String pressure;
@@ -70,11 +84,11 @@ class WundergroundClient: public JsonListener
     // end fowlerk add
 
     // MarcFinns additions...
-    String country;
-    String city;
-    String country_name;
-    String tz_short;
-    String tz_long;
+    char country[WU_SHORT_SIZE] = "";
+    char city[WU_TEXT_SIZE] = "";
+    char country_name[WU_TEXT_SIZE] = "";
+    char tz_short[WU_SHORT_SIZE] = "";
+    char tz_long[WU_TEXT_SIZE] = "";
     ////
 
     bool doUpdate(String url);
@@ -90,11 +104,11 @@ class WundergroundClient: public JsonListener
       bool isAlertUS = false;				// Added by fowlerk
       bool isAlertEU = false;				// Added by fowlerk
     */
-    int currentForecastPeriod;
-    String forecastIcon [MAX_FORECAST_PERIODS];
-    String forecastTitle [MAX_FORECAST_PERIODS];
-    String forecastLowTemp [MAX_FORECAST_PERIODS];
-    String forecastHighTemp [MAX_FORECAST_PERIODS];
+    int currentForecastPeriod = 0;
+    char forecastIcon [MAX_FORECAST_PERIODS][WU_NAME_SIZE] = {};
+    char forecastTitle [MAX_FORECAST_PERIODS][WU_NAME_SIZE] = {};
+    char forecastLowTemp [MAX_FORECAST_PERIODS][WU_SHORT_SIZE] = {};
+    char forecastHighTemp [MAX_FORECAST_PERIODS][WU_SHORT_SIZE] = {};
 
     // MarcFinns streamlining
     /*
@@ -56,7 +56,6 @@
 #include <Wire.h>
 
 #include <Syslog.h>               // https://github.com/arcao/ESP8266_Syslog
-#include <Average.h>              // https://github.com/MajenkoLibraries/Average
 #include <PubSubClient.h>         // https://github.com/knolleary/pubsubclient
 #include <ProcessScheduler.h>     // https://github.com/wizard97/ArduinoProcessScheduler
 #include <NtpClientLib.h>         // https://github.com/gmag11/NtpClient
@@ -67,6 +66,7 @@
 // Project includes
 #include "GlobalDefinitions.h"
 #include "ScreenFactory.h"
+#include "AssetBundle.h"
 
 // Screens
 #include "ScreenSensors.h"
@@ -78,7 +78,7 @@
 #include "ScreenErrLog.h"
 
 // Graphics & fonts
-#include "Artwork.h"
+#include "artwork.h"
 #include "ArialRoundedMTBold_14.h"
 #include "ArialRoundedMTBold_36.h"
 #include "Free_Fonts.h"
@@ -107,6 +107,9 @@ TFT_eSPI LCD = TFT_eSPI();
 // Global UI management
 GfxUi ui(&LCD);
 
+// Packed icons and moon phases
+AssetBundle assets(&LCD);
+
 WiFiClient wifiClient;
 
 // UDP instance to send and receive packets over UDP
@@ -131,65 +134,23 @@ ScreenCreatorImpl<ScreenWeatherStation> creator6;
 // Global Scheduler object
 Scheduler sched;
 
+// Time taken by each scheduler pass
+ServiceMonitor loopMonitor("Loop");
+
+// Idles between process runs
+PowerManager power;
+
+// Hands the sensor bus to one device at a time
+I2CBus i2cBus;
+
 // Last errors list 
 RingBufCPP<String, 18> lastErrors;
 
 // Configuration container structure
 Configuration config;
 
-//  Processes container structure
-ProcessContainer procPtr =
-{
-  Proc_ComboTemperatureHumiditySensor(sched,
-  MEDIUM_PRIORITY,
-  SLOW_SAMPLE_PERIOD,
-  RUNTIME_FOREVER),
-
-  Proc_ComboPressureHumiditySensor(sched,
-  MEDIUM_PRIORITY,
-  SLOW_SAMPLE_PERIOD,
-  RUNTIME_FOREVER),
-
-  Proc_CO2Sensor(sched,
-  MEDIUM_PRIORITY,
-  SLOW_SAMPLE_PERIOD,
-  RUNTIME_FOREVER),
-
-  Proc_ParticleSensor(sched,
-  MEDIUM_PRIORITY,
-  SLOW_SAMPLE_PERIOD,
-  RUNTIME_FOREVER),
-
-  Proc_VOCSensor(sched,
-  MEDIUM_PRIORITY,
-  SLOW_SAMPLE_PERIOD,
-  RUNTIME_FOREVER),
-
-  Proc_MultiGasSensor(sched,
-  MEDIUM_PRIORITY,
-  SLOW_SAMPLE_PERIOD,
-  RUNTIME_FOREVER),
-
-  Proc_GeigerSensor(sched,
-  MEDIUM_PRIORITY,
-  FAST_SAMPLE_PERIOD,
-  RUNTIME_FOREVER),
-
-  Proc_UIManager(sched,
-  HIGH_PRIORITY,
-  SLOW_SAMPLE_PERIOD,
-  RUNTIME_FOREVER),
-
-  Proc_MQTTUpdate(sched,
-  MEDIUM_PRIORITY,
-  MQTT_UPDATE_PERIOD,
-  RUNTIME_FOREVER),
-
-  Proc_GeoLocation(sched,
-  MEDIUM_PRIORITY,
-  GEOLOC_RETRY_PERIOD,
-  RUNTIME_FOREVER)
-};
+//  Processes container structure, see ProcessContainer for priorities and periods
+ProcessContainer procPtr(sched);
 
 
 void setup()
@@ -292,7 +253,7 @@ void setup()
   /////////////////////////////////////////////////////
 
   // Initialise I2C bus
-  Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN);
+  i2cBus.begin(I2C_SDA_PIN, I2C_SCL_PIN);
 
   // Add process objects to scheduler
   addProcesses();
@@ -388,9 +349,16 @@ void setup()
   // Start processes
   startProcesses();
 
+  // Idle between process runs from now on
+  power.begin(config.powerMode);
+
+  // Weather icons download in the background from now on, if not there yet
+  ScreenWeatherStation::queueResources();
+
   delay(500);
 
-  // Cleanup old maps from SPIFFS, if present
+  // Cleanup maps of the old one-file-per-view format from SPIFFS, if present.
+  // Map tiles and the map background are kept across reboots
 #ifdef DEBUG_SYSLOG
   syslog.log(LOG_DEBUG, "SPIFFS dir listing:");
 #endif
@@ -399,7 +367,7 @@ void setup()
   while (dir.next())
   {
     fileName = dir.fileName();
-    if (fileName.startsWith(F("/map")))
+    if (fileName.startsWith(F("/map")) && fileName != MAP_BACKGROUND_FILE)
     {
 #ifdef DEBUG_SYSLOG
       syslog.log(LOG_DEBUG, " FOUND " + fileName);
@@ -424,8 +392,14 @@ void loop()
   // Handle OTA
   ArduinoOTA.handle();
 
-  // Invoke scheduler
-  sched.run();
+  // Invoke scheduler, timing the whole pass
+  {
+    ServiceProbe probe(loopMonitor);
+    sched.run();
+  }
+
+  // Sleep until the next process is due
+  power.idle();
 
   // Feed the WatchDog
   ESP.wdtFeed();
@@ -586,16 +560,8 @@ void addProcesses()
 {
 
   // Add processes to the scheduler
-  procPtr.UIManager.add();
-  procPtr.MQTTUpdate.add();
-  procPtr.GeoLocation.add();
-  procPtr.ComboTemperatureHumiditySensor.add();
-  procPtr.ComboPressureHumiditySensor.add();
-  procPtr.CO2Sensor.add();
-  procPtr.ParticleSensor.add();
-  procPtr.VOCSensor.add();
-  procPtr.MultiGasSensor.add();
-  procPtr.GeigerSensor.add();
+  for (int i = 0; i < processCount; i++)
+    processTable[i].process->add();
 
 }
 
@@ -603,16 +569,8 @@ void addProcesses()
 void startProcesses()
 {
   // Enable processes
-  procPtr.ComboTemperatureHumiditySensor.enable();
-  procPtr.UIManager.enable();
-  procPtr.ComboPressureHumiditySensor.enable();
-  procPtr.ParticleSensor.enable();
-  procPtr.CO2Sensor.enable();
-  procPtr.VOCSensor.enable();
-  procPtr.MultiGasSensor.enable();
-  procPtr.MQTTUpdate.enable();
-  procPtr.GeigerSensor.enable();
-  procPtr.GeoLocation.enable();
+  for (int i = 0; i < processCount; i++)
+    processTable[i].process->enable();
 }
 
 // Retrieve previously saved configuration from SPIFFS
@@ -652,6 +610,18 @@ bool retrieveConfig()
           strcpy(config.mqtt_topic2, json[F("mqtt_topic2")]);
           strcpy(config.mqtt_topic3, json[F("mqtt_topic3")]);
           strcpy(config.syslog_server, json[F("syslog_server")]);
+
+          // Optional, configurations saved by older versions have no format
+          const char *mqttFormat = json[F("mqtt_format")];
+          config.mqttFormat = (mqttFormat && strcmp(mqttFormat, "binary") == 0) ? MQTT_FORMAT_BINARY : MQTT_FORMAT_TEXT;
+
+          // Optional, idles in modem sleep when not set
+          const char *powerMode = json[F("power_mode")];
+          config.powerMode = PowerManager::modeFromName(powerMode);
+
+          // Optional too, no diagnostics when empty
+          const char *mqttDiagTopic = json[F("mqtt_diag_topic")];
+          strcpy(config.mqtt_diag_topic, mqttDiagTopic ? mqttDiagTopic : "");
           return true;
 
         }
@@ -686,6 +656,9 @@ bool retrieveConfig()
 #endif
     return false;
   }
+
+  // Configuration file could not be opened
+  return false;
 }
 
 
@@ -771,6 +744,13 @@ bool isTurbo()
   return turbo;
 }
 
+// UTC from the clock, which NTP keeps in local time: the offset in force now, so
+// timestamps taken as things happen stay right across DST changes
+time_t utcNow()
+{
+  return now() - (NTP.getTimeZone() + (NTP.isSummerTime() ? 1 : 0)) * 3600L;
+}
+
 // Log error on both syslog and error screen, managing a circular buffer
 void errLog(String msg)
 {
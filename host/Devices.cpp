@@ -0,0 +1,351 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - sensor and peripheral models           */
+/*                                                      */
+/********************************************************/
+
+#include "Devices.h"
+#include "HostSim.h"
+
+#include <SoftwareSerial.h>
+
+#include <cmath>
+
+namespace host
+{
+  Environment environment;
+  std::mt19937 rng(1506852000);
+  double uartNoise = 0;
+  double sensorNoise = 0;
+
+  HDC1080 hdc1080;
+  BME280 bme280;
+  MAX17043 fuelGauge;
+  PAJ7620 gestureSensor;
+  MultiGas multiGas;
+
+  // -------------------------------------------------------
+  // Environment
+  // -------------------------------------------------------
+
+  static double hours()
+  {
+    return micros64() / 3600e6;
+  }
+
+  // Daily cycle plus a faster ripple, phase shifted per quantity
+  static double wave(double phase, double fastPeriodMinutes = 7)
+  {
+    double h = hours();
+    return sin(2 * M_PI * (h / 24 + phase)) + 0.2 * sin(2 * M_PI * (h * 60 / fastPeriodMinutes + phase));
+  }
+
+  // Gaussian reading noise of a part, sigma at --sensor-noise 1
+  static double noise(double sigma)
+  {
+    if (sensorNoise <= 0)
+      return 0;
+    std::normal_distribution<double> normal(0, sigma * sensorNoise);
+    return normal(rng);
+  }
+
+  // Minutes since the last event of a train, -1 before the first or without transients
+  static double sinceEvent(bool enabled, double everyMinutes, double firstMinutes)
+  {
+    double minutes = hours() * 60 - firstMinutes;
+    return (!enabled || minutes < 0) ? -1 : fmod(minutes, everyMinutes);
+  }
+
+  double Environment::co2SpikeAge() const
+  {
+    double since = sinceEvent(transients, 20, 10);
+    return since < 0 ? -1 : since * 60;
+  }
+
+  double Environment::co2Spike() const
+  {
+    double since = sinceEvent(transients, 20, 10);
+    return since < 0 ? 0 : 800 * exp(-since / 4);
+  }
+
+  static double pmEvent(bool enabled)
+  {
+    double since = sinceEvent(enabled, 30, 15);
+    return since < 0 ? 1 : 1 + 3 * exp(-since / 3);
+  }
+
+  double Environment::temperature() const { return 22.5 + 1.5 * wave(0.0); }
+  double Environment::humidity() const { return 45 + 8 * wave(0.3); }
+  double Environment::pressure() const { return 97100 + 150 * wave(0.6, 31); }
+  double Environment::co2() const { return 650 + 180 * wave(0.1, 13) + co2Spike(); }
+  double Environment::pm(int size) const { return (size == 1 ? 6 : size == 2 ? 9 : 14) * (1.3 + wave(0.2, 5)) * pmEvent(transients); }
+  int Environment::voc() const { return 90 + (int) (20 * wave(0.4, 3)); }
+  double Environment::gasRatio(int channel) const { return (channel == 1 ? 0.95 : 1.0) + 0.08 * wave(0.15 * channel, 11); }
+  double Environment::batteryVolts() const { return 3.95 - 0.02 * hours(); }
+
+  // -------------------------------------------------------
+  // Register devices
+  // -------------------------------------------------------
+
+  void RegisterDevice::receive(const uint8_t *data, size_t len)
+  {
+    if (len == 0)
+      return;
+    _pointer = data[0];
+    if (len > 1)
+      writeRegister(_pointer, data + 1, len - 1);
+  }
+
+  size_t RegisterDevice::request(uint8_t *data, size_t len)
+  {
+    uint32_t value = readRegister(_pointer, len);
+    for (size_t i = 0; i < len; i++)
+      data[i] = value >> (8 * (len - 1 - i));
+    return len;
+  }
+
+  uint32_t HDC1080::readRegister(uint8_t reg, size_t len)
+  {
+    (void) len;
+    switch (reg)
+    {
+      case 0x00: return (uint32_t) ((environment.temperature() + noise(0.02) + 40) / 165 * 65536);
+      case 0x01: return (uint32_t) ((environment.humidity() + noise(0.2)) / 100 * 65536);
+      case 0xFE: return 0x5449;
+      case 0xFF: return 0x1050;
+    }
+    return 0;
+  }
+
+  // Compensated values, see the Adafruit_BME280 shim for the scaling
+  uint32_t BME280::readRegister(uint8_t reg, size_t len)
+  {
+    (void) len;
+    switch (reg)
+    {
+      case 0xD0: return 0x60;
+      case 0xFA: return (uint32_t) ((environment.temperature() + noise(0.01)) * 100 + 0.3 * 100);
+      case 0xF7: return (uint32_t) ((environment.pressure() + noise(2)) * 128);
+      case 0xFD: return (uint32_t) ((environment.humidity() + noise(0.1) - 2) * 512);
+    }
+    return 0;
+  }
+
+  uint32_t MAX17043::readRegister(uint8_t reg, size_t len)
+  {
+    (void) len;
+    double volts = environment.batteryVolts();
+    switch (reg)
+    {
+      case 0x02: return ((uint32_t) (volts / 0.00125)) << 4;
+      case 0x04:
+      {
+        double soc = std::max(0.0, std::min(100.0, (volts - 3.2) / (4.2 - 3.2) * 100));
+        return (uint32_t) (soc * 256);
+      }
+      case 0x08: return 0x0003;
+    }
+    return 0;
+  }
+
+  uint32_t PAJ7620::readRegister(uint8_t reg, size_t len)
+  {
+    (void) len;
+    switch (reg)
+    {
+      case 0x00: return 0x20;
+      case 0x01: return 0x76;
+      case 0x43:
+      {
+        uint8_t flags = _flags;
+        _flags = 0;
+        return flags;
+      }
+    }
+    return 0;
+  }
+
+  // -------------------------------------------------------
+  // Multichannel gas sensor
+  // -------------------------------------------------------
+
+  // Factory R0 calibration ADC values for NH3, CO, NO2
+  static const uint16_t gasR0[3] = { 880, 760, 310 };
+
+  // ADC reading giving the wanted Rs/R0, inverting ratio = An/A0 * (1023 - A0)/(1023 - An)
+  static uint16_t gasADC(int channel)
+  {
+    double a0 = gasR0[channel];
+    double r = environment.gasRatio(channel) + noise(0.005);
+    return (uint16_t) lround(1023 * r * a0 / ((1023 - a0) + r * a0));
+  }
+
+  void MultiGas::receive(const uint8_t *data, size_t len)
+  {
+    if (len == 0)
+      return;
+
+    switch (data[0])
+    {
+      case 1:
+      case 2:
+      case 3:
+        _reply = gasADC(data[0] - 1);
+        break;
+      case 6:
+        if (len > 1)
+        {
+          if (data[1] == 0)
+            _reply = 1126;
+          else if (data[1] >= 8 && data[1] <= 12)
+            _reply = gasR0[(data[1] - 8) / 2];
+        }
+        break;
+      case 10:
+        ledSwitches++;
+        break;
+    }
+  }
+
+  size_t MultiGas::request(uint8_t *data, size_t len)
+  {
+    if (len > 0)
+      data[0] = _reply >> 8;
+    if (len > 1)
+      data[1] = _reply & 0xFF;
+    return std::min(len, (size_t) 2);
+  }
+
+  // -------------------------------------------------------
+  // UART sensors
+  // -------------------------------------------------------
+
+  // Line noise: with probability uartNoise a reply gets leading garbage, a flipped bit,
+  // or is cut short
+  static void transmit(const uint8_t *frame, size_t size, std::deque<uint8_t> &reply)
+  {
+    std::uniform_real_distribution<double> chance(0, 1);
+    std::vector<uint8_t> bytes(frame, frame + size);
+
+    if (chance(rng) < uartNoise)
+    {
+      switch (rng() % 3)
+      {
+        case 0:
+          bytes.insert(bytes.begin(), rng() % 12 + 1, (uint8_t) rng());
+          break;
+        case 1:
+          bytes[rng() % size] ^= 1 << (rng() % 8);
+          break;
+        case 2:
+          bytes.resize(rng() % size);
+          break;
+      }
+    }
+    reply.insert(reply.end(), bytes.begin(), bytes.end());
+  }
+
+  void pms7003(const uint8_t *data, size_t len, std::deque<uint8_t> &reply)
+  {
+    if (len < 7 || data[0] != 0x42 || data[1] != 0x4D)
+      return;
+
+    uint8_t frame[32] = { 0x42, 0x4D };
+    size_t size;
+
+    if (data[2] == 0xE2)
+    {
+      // Passive read: 13 data words + reserved + checksum
+      size = 32;
+      frame[3] = 28;
+      uint16_t words[13];
+      words[0] = lround(max(environment.pm(1) + noise(1.5), 0.0));
+      words[1] = lround(max(environment.pm(2) + noise(2), 0.0));
+      words[2] = lround(max(environment.pm(10) + noise(3), 0.0));
+      words[3] = words[0];
+      words[4] = words[1];
+      words[5] = words[2];
+      for (int i = 6; i < 13; i++)
+        words[i] = 100 * (13 - i);
+      for (int i = 0; i < 13; i++)
+      {
+        frame[4 + 2 * i] = words[i] >> 8;
+        frame[5 + 2 * i] = words[i] & 0xFF;
+      }
+    }
+    else
+    {
+      // Mode change acknowledge
+      size = 8;
+      frame[3] = 4;
+      frame[4] = data[2];
+      frame[5] = data[4];
+    }
+
+    uint16_t sum = 0;
+    for (size_t i = 0; i < size - 2; i++)
+      sum += frame[i];
+    frame[size - 2] = sum >> 8;
+    frame[size - 1] = sum & 0xFF;
+    transmit(frame, size, reply);
+  }
+
+  void mhz19(const uint8_t *data, size_t len, std::deque<uint8_t> &reply)
+  {
+    if (len < 9 || data[0] != 0xFF || data[2] != 0x86)
+      return;
+
+    uint16_t ppm = lround(environment.co2() + noise(10));
+    uint8_t frame[9] = { 0xFF, 0x86, (uint8_t) (ppm >> 8), (uint8_t) (ppm & 0xFF), (uint8_t) (environment.temperature() + 40), 0, 0, 0, 0 };
+    uint8_t sum = 0;
+    for (int i = 1; i < 8; i++)
+      sum += frame[i];
+    frame[8] = 0xFF - sum + 1;
+    transmit(frame, 9, reply);
+  }
+
+  // -------------------------------------------------------
+  // Wiring
+  // -------------------------------------------------------
+
+  void installDevices(double geigerCPM, double gestureEverySeconds)
+  {
+    Wire.attachDevice(0x40, &hdc1080);
+    Wire.attachDevice(0x76, &bme280);
+    Wire.attachDevice(0x36, &fuelGauge);
+    Wire.attachDevice(0x73, &gestureSensor);
+    Wire.attachDevice(0x04, &multiGas);
+
+    // Sensor answers ~10ms after the request
+    Serial.attachPeer(pms7003, 10000);
+    SoftwareSerial::hostPeer = mhz19;
+    SoftwareSerial::hostPeerLatency = 5000;
+
+    // VOC sensor on the ADC
+    setAnalogSource(A0, [] { return environment.voc() + (int) (rng() % 5) + (int) lround(noise(5)); });
+
+    // Geiger tube: Poisson process seen through the LND712 dead time. The tube is blind
+    // for 90us after each registered event, so the next one comes 90us + Exp(rate) later
+    if (geigerCPM > 0)
+    {
+      double rate = geigerCPM / 60e6;
+      addPulseSource(15, [rate]
+      {
+        std::exponential_distribution<double> interval(rate);
+        return (uint64_t) (90 + interval(rng));
+      });
+    }
+
+    // Gesture sensor: swipe at a fixed interval to cycle through the screens.
+    // The sensor sits rotated in the case, a raw DOWN is remapped to RIGHT (next screen)
+    if (gestureEverySeconds > 0)
+    {
+      uint64_t every = gestureEverySeconds * 1e6;
+      addPulseSource(10, [every]
+      {
+        gestureSensor.latch(0x08);
+        return every;
+      });
+    }
+  }
+}
@@ -0,0 +1,130 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - sensor and peripheral models           */
+/*                                                      */
+/*  Each model answers the same bus traffic as the real */
+/*  part (I2C registers, UART frames, interrupt pins),  */
+/*  with readings taken from a slowly drifting          */
+/*  synthetic environment.                              */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include <deque>
+#include <random>
+#include <vector>
+
+namespace host
+{
+  // Synthetic environment, all values drift with the virtual clock
+  struct Environment
+  {
+    double temperature() const;    // degC
+    double humidity() const;       // %RH
+    double pressure() const;       // Pa
+    double co2() const;            // ppm
+    double pm(int size) const;     // ug/m3 for PM1.0 / PM2.5 / PM10 (size 1, 2, 10)
+    int voc() const;               // raw ADC
+    double gasRatio(int channel) const;   // MiCS6814 Rs/R0 for channels NH3, CO, NO2
+    double batteryVolts() const;
+
+    // With transients: a CO2 spike every 20 min (breath at the inlet) and a PM event every 30 min (cooking)
+    bool transients = false;
+    double co2SpikeAge() const;    // s since the last CO2 spike started, -1 before the first
+    double co2Spike() const;       // ppm on top of the background
+  };
+
+  extern Environment environment;
+  extern std::mt19937 rng;
+  extern double uartNoise;   // probability of a corrupted UART reply
+  extern double sensorNoise; // reading noise, times the typical noise of each part
+
+  // -------------------------------------------------------
+  // I2C parts
+  // -------------------------------------------------------
+
+  // Register pointer + big endian register file read
+  class RegisterDevice : public HostI2CDevice
+  {
+    public:
+      void receive(const uint8_t *data, size_t len) override;
+      size_t request(uint8_t *data, size_t len) override;
+      bool present() override { return enabled; }
+
+      bool enabled = true;
+
+    protected:
+      // Value of register reg, len bytes big endian
+      virtual uint32_t readRegister(uint8_t reg, size_t len) = 0;
+      virtual void writeRegister(uint8_t reg, const uint8_t *data, size_t len) { (void) reg; (void) data; (void) len; }
+
+      uint8_t _pointer = 0;
+  };
+
+  class HDC1080 : public RegisterDevice
+  {
+    protected:
+      uint32_t readRegister(uint8_t reg, size_t len) override;
+  };
+
+  class BME280 : public RegisterDevice
+  {
+    protected:
+      uint32_t readRegister(uint8_t reg, size_t len) override;
+  };
+
+  class MAX17043 : public RegisterDevice
+  {
+    protected:
+      uint32_t readRegister(uint8_t reg, size_t len) override;
+  };
+
+  // Gestures are latched into the flag register by the interrupt source
+  class PAJ7620 : public RegisterDevice
+  {
+    public:
+      void latch(uint8_t flags) { _flags = flags; }
+
+    protected:
+      uint32_t readRegister(uint8_t reg, size_t len) override;
+
+    private:
+      uint8_t _flags = 0;
+  };
+
+  // Grove multichannel gas sensor, firmware version 2 command set
+  class MultiGas : public HostI2CDevice
+  {
+    public:
+      void receive(const uint8_t *data, size_t len) override;
+      size_t request(uint8_t *data, size_t len) override;
+
+      unsigned long ledSwitches = 0;
+
+    private:
+      uint16_t _reply = 0;
+  };
+
+  // -------------------------------------------------------
+  // UART parts
+  // -------------------------------------------------------
+
+  // PMS7003 in passive mode on the hardware UART
+  void pms7003(const uint8_t *data, size_t len, std::deque<uint8_t> &reply);
+
+  // MH-Z19 on the software UART
+  void mhz19(const uint8_t *data, size_t len, std::deque<uint8_t> &reply);
+
+  // Attach every model to its bus / pin
+  void installDevices(double geigerCPM, double gestureEverySeconds);
+
+  extern HDC1080 hdc1080;
+  extern BME280 bme280;
+  extern MAX17043 fuelGauge;
+  extern PAJ7620 gestureSensor;
+  extern MultiGas multiGas;
+}
@@ -0,0 +1,282 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - canned web services                    */
+/*                                                      */
+/*  Answers the requests the firmware makes to          */
+/*  Wunderground, ADS-B Exchange and the image hosts    */
+/*  with plausible, deterministic content.              */
+/*                                                      */
+/********************************************************/
+
+#include "Servers.h"
+#include "HostSim.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace host
+{
+  unsigned long httpRequests = 0;
+
+  static std::string ok(const std::string &type, const std::string &body)
+  {
+    char header[160];
+    snprintf(header, sizeof(header), "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n", type.c_str(), body.size());
+    return header + body;
+  }
+
+  static std::string notFound()
+  {
+    return "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+  }
+
+  // Value of a query string parameter
+  static std::string query(const std::string &path, const std::string &name)
+  {
+    size_t pos = path.find(name + "=");
+    if (pos == std::string::npos)
+      return "";
+    pos += name.size() + 1;
+    size_t end = path.find_first_of("& ", pos);
+    return path.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+  }
+
+  // -------------------------------------------------------
+  // Images
+  // -------------------------------------------------------
+
+  // Baseline JPEG with a valid SOF0 header, enough for the decoder stand-in
+  static std::string jpeg(int width, int height)
+  {
+    std::string data = { '\xFF', '\xD8', '\xFF', '\xC0', 0, 17, 8,
+                         (char) (height >> 8), (char) height, (char) (width >> 8), (char) width, 3,
+                         1, 0x22, 0, 2, 0x11, 1, 3, 0x11, 1 };
+    // Pseudo entropy coded data, ~1 byte per 4 pixels like a real photo
+    for (int i = 0; i < width * height / 4; i++)
+      data += (char) ((i * 131 + width) & 0x7F);
+    data += "\xFF\xD9";
+    return data;
+  }
+
+  // 24 bit bottom-up BMP
+  static std::string bmp(int width, int height, unsigned seed)
+  {
+    uint32_t rowSize = (width * 3 + 3) & ~3;
+    uint32_t imageSize = rowSize * height;
+    uint32_t fileSize = 54 + imageSize;
+
+    std::string data(fileSize, '\0');
+    auto put16 = [&](size_t at, uint16_t v) { data[at] = v & 0xFF; data[at + 1] = v >> 8; };
+    auto put32 = [&](size_t at, uint32_t v) { put16(at, v & 0xFFFF); put16(at + 2, v >> 16); };
+
+    data[0] = 'B';
+    data[1] = 'M';
+    put32(2, fileSize);
+    put32(10, 54);
+    put32(14, 40);
+    put32(18, width);
+    put32(22, height);
+    put16(26, 1);
+    put16(28, 24);
+    put32(34, imageSize);
+
+    // A filled circle on black, colour from the seed
+    for (int y = 0; y < height; y++)
+      for (int x = 0; x < width; x++)
+      {
+        int dx = x - width / 2, dy = y - height / 2;
+        bool inside = dx * dx + dy * dy < width * height / 5;
+        size_t at = 54 + y * rowSize + x * 3;
+        data[at] = inside ? (char) (seed * 37) : 0;
+        data[at + 1] = inside ? (char) (seed * 91) : 0;
+        data[at + 2] = inside ? (char) (seed * 53 + 128) : 0;
+      }
+    return data;
+  }
+
+  static std::string image(const std::string &path)
+  {
+    unsigned seed = 0;
+    for (char c : path)
+      seed = seed * 31 + c;
+
+    if (path.find(".bmp") != std::string::npos)
+    {
+      if (path.find("/mini/") != std::string::npos)
+        return ok("image/bmp", bmp(50, 50, seed));
+      if (path.find("moonphase") != std::string::npos)
+        return ok("image/bmp", bmp(60, 60, seed));
+      return ok("image/bmp", bmp(100, 100, seed));
+    }
+
+    // Map APIs pass the size, the two splash images are fixed
+    std::string size = query(path, "size");
+    int w = 240, h = 56;
+    if (!size.empty())
+      sscanf(size.c_str(), "%dx%d", &w, &h) == 2 || sscanf(size.c_str(), "%d,%d", &w, &h);
+    else if (path.find("njl1pMj") != std::string::npos)
+      h = 100;
+    else if (path.find("/MapServer/tile/") != std::string::npos)
+      w = h = 256;
+    return ok("image/jpeg", jpeg(w, h));
+  }
+
+  // -------------------------------------------------------
+  // Wunderground
+  // -------------------------------------------------------
+
+  static std::string wunderground(const std::string &path)
+  {
+    if (path.find("/geolookup/") != std::string::npos)
+      return ok("application/json",
+                "{\"response\":{\"version\":\"0.1\"},\"location\":{\"type\":\"INTLCITY\",\"country\":\"CH\","
+                "\"country_iso3166\":\"CH\",\"country_name\":\"Switzerland\",\"city\":\"Zurich\",\"tz_short\":\"CEST\","
+                "\"tz_long\":\"Europe/Zurich\",\"lat\":\"47.37\",\"lon\":\"8.54\"}}");
+
+    if (path.find("/conditions/") != std::string::npos)
+      return ok("application/json",
+                "{\"response\":{\"version\":\"0.1\"},\"current_observation\":{\"display_location\":{\"city\":\"Zurich\"},"
+                "\"observation_time\":\"Last Updated on October 1, 12:00 PM CEST\","
+                "\"observation_time_rfc822\":\"Sun, 01 Oct 2017 12:00:00 +0200\",\"weather\":\"Partly Cloudy\","
+                "\"temp_f\":70.3,\"temp_c\":21.3,\"relative_humidity\":\"48%\",\"wind_dir\":\"WSW\",\"wind_mph\":5.0,"
+                "\"pressure_mb\":\"1017\",\"pressure_in\":\"30.03\",\"dewpoint_f\":50,\"dewpoint_c\":10,"
+                "\"feelslike_f\":\"70\",\"feelslike_c\":\"21\",\"UV\":\"3\",\"precip_today_in\":\"0.00\","
+                "\"precip_today_metric\":\"0\",\"icon\":\"partlycloudy\"}}");
+
+    if (path.find("/forecast/") != std::string::npos)
+    {
+      static const char *icons[] = { "partlycloudy", "clear", "rain", "cloudy", "mostlysunny", "chancerain", "tstorms", "fog" };
+      static const char *days[] = { "Sunday", "Sunday Night", "Monday", "Monday Night", "Tuesday", "Tuesday Night", "Wednesday", "Wednesday Night" };
+
+      std::string body = "{\"response\":{\"version\":\"0.1\"},\"forecast\":{\"txt_forecast\":{\"date\":\"11:00 AM CEST\",\"forecastday\":[";
+      for (int i = 0; i < 8; i++)
+      {
+        char entry[400];
+        snprintf(entry, sizeof(entry), "%s{\"period\":%d,\"icon\":\"%s\",\"title\":\"%s\","
+                 "\"fcttext\":\"Mixed clouds and sun. High %d F.\",\"fcttext_metric\":\"Mixed clouds and sun. High %d C.\",\"pop\":\"%d\"}",
+                 i ? "," : "", i, icons[i], days[i], 68 + i, 20 + i / 2, 10 * i);
+        body += entry;
+      }
+      body += "]},\"simpleforecast\":{\"forecastday\":[";
+      for (int i = 0; i < 4; i++)
+      {
+        char entry[400];
+        snprintf(entry, sizeof(entry), "%s{\"date\":{\"day\":%d,\"month\":10,\"year\":2017,\"weekday\":\"%s\"},\"period\":%d,"
+                 "\"high\":{\"fahrenheit\":\"%d\",\"celsius\":\"%d\"},\"low\":{\"fahrenheit\":\"%d\",\"celsius\":\"%d\"},"
+                 "\"conditions\":\"Partly Cloudy\",\"icon\":\"%s\",\"pop\":%d}",
+                 i ? "," : "", 1 + i, days[2 * i], i + 1, 70 + i, 21 + i / 2, 52 + i, 11 + i / 2, icons[2 * i], 10 * i);
+        body += entry;
+      }
+      body += "]}}}";
+      return ok("application/json", body);
+    }
+
+    if (path.find("/astronomy/") != std::string::npos)
+      return ok("application/json",
+                "{\"response\":{\"version\":\"0.1\"},\"moon_phase\":{\"percentIlluminated\":\"81\",\"ageOfMoon\":\"11\","
+                "\"phaseofMoon\":\"Waxing Gibbous\",\"hemisphere\":\"North\",\"current_time\":{\"hour\":\"12\",\"minute\":\"00\"},"
+                "\"sunrise\":{\"hour\":\"7\",\"minute\":\"24\"},\"sunset\":{\"hour\":\"18\",\"minute\":\"57\"},"
+                "\"moonrise\":{\"hour\":\"16\",\"minute\":\"41\"},\"moonset\":{\"hour\":\"2\",\"minute\":\"05\"}},"
+                "\"sun_phase\":{\"sunrise\":{\"hour\":\"7\",\"minute\":\"24\"},\"sunset\":{\"hour\":\"18\",\"minute\":\"57\"}}}");
+
+    return notFound();
+  }
+
+  // -------------------------------------------------------
+  // ADS-B Exchange
+  // -------------------------------------------------------
+
+  // A few aircraft flying straight lines across the search area
+  static std::string adsb(const std::string &path)
+  {
+    double lat0 = atof(query(path, "lat").c_str());
+    double lon0 = atof(query(path, "lng").c_str());
+    if (lat0 == 0 && lon0 == 0)
+    {
+      lat0 = 47.437691;
+      lon0 = 8.568854;
+    }
+
+    static const char *models[] = { "Airbus A320 214", "Boeing 737 8K5", "Embraer ERJ 190", "Airbus A319 112", "Bombardier CS100", "Airbus A333" };
+    static const char *calls[] = { "SWR12A", "EZY4512", "DLH5KM", "SWR287", "SWR8HV", "EDW21" };
+    static const char *routes[] = { "LSZH Zurich, Switzerland", "LEMD Madrid Barajas, Spain", "EDDF Frankfurt, Germany",
+                                    "EGLL London Heathrow, United Kingdom", "LFPG Paris Charles de Gaulle, France", "KJFK New York JFK, United States" };
+
+    double seconds = micros64() / 1e6;
+    std::string body = "{\"src\":1,\"feeds\":[{\"id\":1,\"name\":\"host\"}],\"srcFeed\":1,\"showSil\":true,\"showFlg\":true,\"showPic\":true,\"flgH\":20,\"flgW\":85,\"acList\":[";
+
+    for (int i = 0; i < 6; i++)
+    {
+      double heading = i * 60 + 15;
+      double speed = 160 + 20 * i;                     // knots
+      double phase = fmod(seconds * speed / 3600 / 60 + i * 0.13, 0.3) - 0.15;   // degrees along track
+      double lat = lat0 + phase * cos(heading * M_PI / 180);
+      double lon = lon0 + phase * sin(heading * M_PI / 180) / cos(lat0 * M_PI / 180);
+      int alt = 3000 + 1500 * i;
+
+      char entry[900];
+      snprintf(entry, sizeof(entry), "%s{\"Id\":%d,\"Rcvr\":1,\"HasSig\":false,\"Icao\":\"4B%04X\",\"Bad\":false,\"Reg\":\"HB-J%c%c\","
+               "\"FSeen\":\"/Date(1506852000000)/\",\"TSecs\":%d,\"CMsgs\":%d,\"Alt\":%d,\"GAlt\":%d,\"AltT\":0,\"Call\":\"%s\","
+               "\"Lat\":%.5f,\"Long\":%.5f,\"PosTime\":1506852000000,\"Mlat\":false,\"Tisb\":false,\"Spd\":%.1f,\"Trak\":%.1f,"
+               "\"TrkH\":false,\"Type\":\"A320\",\"Mdl\":\"%s\",\"Man\":\"Airbus\",\"CNum\":\"%d\",\"From\":\"%s\",\"To\":\"%s\","
+               "\"Op\":\"Swiss International Air Lines\",\"OpIcao\":\"SWR\",\"Sqk\":\"1000\",\"Vsi\":0,\"VsiT\":0,\"Dst\":%.2f,"
+               "\"Brng\":%.1f,\"WTC\":2,\"Species\":1,\"EngType\":3,\"EngMount\":0,\"Mil\":false,\"Cou\":\"Switzerland\","
+               "\"HasPic\":false,\"Interested\":false,\"FlightsCount\":0,\"Gnd\":false,\"SpdTyp\":0,\"CallSus\":false,\"TT\":\"a\","
+               "\"Trt\":2,\"Year\":\"2010\",\"Cos\":[%.5f,%.5f,1506851990000.0,%d,%.5f,%.5f,1506852000000.0,%d]}",
+               i ? "," : "", 4000000 + i, 0x1800 + i, 'A' + i, 'B' + i, 120 + i, 400 + 3 * i, alt, alt, calls[i],
+               lat, lon, speed, heading, models[i], 1000 + i, routes[i % 6], routes[(i + 1) % 6], fabs(phase) * 60 * 1.852,
+               heading, lat - 0.01, lon - 0.01, alt - 100, lat, lon, alt);
+      body += entry;
+    }
+    body += "],\"totalAc\":6,\"lastDv\":\"636425000000000000\",\"shtTrlSec\":65,\"stm\":1506852000000}";
+    return ok("application/json", body);
+  }
+
+  // -------------------------------------------------------
+  // Dispatcher
+  // -------------------------------------------------------
+
+  static bool serve(const std::string &hostName, uint16_t port, const std::string &request, std::string &response)
+  {
+    (void) port;
+    httpRequests++;
+
+    // Request line: METHOD path HTTP/1.1
+    size_t start = request.find(' ');
+    size_t end = request.find(' ', start + 1);
+    if (start == std::string::npos || end == std::string::npos)
+      return false;
+    std::string path = request.substr(start + 1, end - start - 1);
+
+    if (verbose)
+      fprintf(stderr, "[http] %s%s\n", hostName.c_str(), path.c_str());
+
+    if (hostName == "api.wunderground.com")
+      response = wunderground(path);
+    else if (hostName.find("adsbexchange.com") != std::string::npos)
+      response = adsb(path);
+    else if (hostName == "i.imgur.com" || hostName == "www.squix.org" || hostName == "maps.googleapis.com" || hostName == "open.mapquestapi.com"
+             || hostName == "server.arcgisonline.com")
+      response = image(path);
+    else
+      return false;
+
+    // Keep-alive is honoured if the client asked for it
+    std::string lower = request;
+    for (char &c : lower)
+      c = tolower(c);
+    if (lower.find("connection: keep-alive") != std::string::npos)
+    {
+      size_t at = response.find("Connection: close");
+      if (at != std::string::npos)
+        response.replace(at, 17, "Connection: keep-alive");
+    }
+    return true;
+  }
+
+  void installServers()
+  {
+    server = serve;
+  }
+}
@@ -0,0 +1,16 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - canned web services                    */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+namespace host
+{
+  // Requests answered by the canned services
+  extern unsigned long httpRequests;
+
+  // Route host::server to the canned services
+  void installServers();
+}
@@ -0,0 +1,90 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - binary telemetry decoder               */
+/*                                                      */
+/*  Only the schema table comes from the firmware, the  */
+/*  byte layout is parsed independently.                */
+/*                                                      */
+/********************************************************/
+
+#include "TelemetryDecoder.h"
+#include "Telemetry.h"
+
+#include <cmath>
+#include <cstdio>
+
+namespace host
+{
+  static uint32_t readLE32(const uint8_t *p)
+  {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+  }
+
+  bool decodeTelemetry(const uint8_t *payload, size_t length, TelemetryRecord &record, std::string &error)
+  {
+    if (length < 10)
+    {
+      error = "short header";
+      return false;
+    }
+
+    record.schema = payload[0];
+    uint8_t channels = payload[1];
+    record.time = readLE32(payload + 2);
+    record.mask = readLE32(payload + 6);
+
+    if (record.schema != TELEMETRY_SCHEMA)
+    {
+      error = "unknown schema " + std::to_string(record.schema);
+      return false;
+    }
+    if (channels != TELEMETRY_CHANNELS || (channels < 32 && (record.mask >> channels) != 0))
+    {
+      error = "channels outside the schema";
+      return false;
+    }
+
+    size_t expected = 10 + 2 * __builtin_popcount(record.mask);
+    if (length != expected)
+    {
+      error = "length " + std::to_string(length) + ", mask says " + std::to_string(expected);
+      return false;
+    }
+
+    const uint8_t *p = payload + 10;
+    for (int i = 0; i < 32; i++)
+    {
+      record.values[i] = NAN;
+      if (record.mask & (1UL << i))
+      {
+        int16_t raw = (int16_t) (p[0] | (p[1] << 8));
+        if (raw == TELEMETRY_SATURATED)
+          record.values[i] = INFINITY;
+        else if (raw == -TELEMETRY_SATURATED - 1)
+          record.values[i] = -INFINITY;
+        else
+          record.values[i] = raw / TelemetryPacket::channelScale(i);
+        p += 2;
+      }
+    }
+    return true;
+  }
+
+  std::string telemetryToJson(const TelemetryRecord &record)
+  {
+    std::string json = "{\"time\":" + std::to_string(record.time);
+    for (int i = 0; i < TELEMETRY_CHANNELS; i++)
+    {
+      if (!(record.mask & (1UL << i)))
+        continue;
+
+      char value[24];
+      if (isinf(record.values[i]))
+        snprintf(value, sizeof(value), "\"%s\"", record.values[i] > 0 ? "over" : "under");
+      else
+        snprintf(value, sizeof(value), "%g", record.values[i]);
+      json += std::string(",\"") + TelemetryPacket::channelName(i) + "\":" + value;
+    }
+    return json + "}";
+  }
+}
@@ -0,0 +1,31 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - binary telemetry decoder               */
+/*                                                      */
+/*  Checks the packed MQTT records (see Telemetry.h)   */
+/*  the way a consumer would read them.                 */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace host
+{
+  struct TelemetryRecord
+  {
+    uint8_t schema = 0;
+    uint32_t time = 0;
+    uint32_t mask = 0;
+    float values[32] = {};
+  };
+
+  // Parse a packed record. False (and the reason in error) if it is malformed
+  bool decodeTelemetry(const uint8_t *payload, size_t length, TelemetryRecord &record, std::string &error);
+
+  // {"time":...,"temperature":21.93,...}
+  std::string telemetryToJson(const TelemetryRecord &record);
+}
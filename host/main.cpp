@@ -0,0 +1,521 @@
+/********************************************************/
+/*                                                      */
+/*  AtmoScan - host build                               */
+/*                                                      */
+/*  Runs the unmodified sketch on Linux against the     */
+/*  Arduino/ESP8266 stand-ins in host/shim and the      */
+/*  device models in host/Devices.cpp, on a virtual     */
+/*  clock. Meant for profiling (perf, gprof) and for    */
+/*  running the scheduler loop under sanitizers.        */
+/*                                                      */
+/*  Usage: atmoscan [options]                           */
+/*    --seconds N        virtual seconds to run (600)   */
+/*    --realtime         sleep instead of skipping time */
+/*    --offline          no WiFi / web services / MQTT  */
+/*    --cpm N            Geiger background rate (30)    */
+/*    --gesture-every N  next screen every N s (0: off) */
+/*    --transients       CO2 spikes and PM events       */
+/*    --uart-noise P     corrupted UART replies (0..1)  */
+/*    --sensor-noise X   reading noise, X times typical */
+/*    --broker-down A:B  MQTT broker down from A to B s */
+/*    --web-down A:B     web servers down from A to B s */
+/*    --web-stall A:B    web servers silent from A to B */
+/*    --web-hangup A:B   web servers close unanswered   */
+/*    --i2c-fault D:A:B  I2C address D NACKs from A to  */
+/*                       B s, repeatable                */
+/*    --i2c-jam S        a slave holds SDA low at S s   */
+/*    --mqtt-format F    text or binary payloads        */
+/*    --screen N         start screen                   */
+/*    --frames N         dump the LCD every N s (PPM)   */
+/*    --spiffs DIR       SPIFFS directory (spiffs)      */
+/*    --verbose          syslog, HTTP and MQTT traffic  */
+/*    --power-mode M     active or modem sleep          */
+/*    --bench-bmp N      time N draws of each bitmap    */
+/*                       format, then exit              */
+/*                                                      */
+/********************************************************/
+
+#include <ESP8266WiFi.h>
+
+#include "HostSim.h"
+#include "Devices.h"
+#include "Servers.h"
+#include "TelemetryDecoder.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+
+// Prototypes the Arduino IDE generates for the sketch
+void initOTA();
+void onSTADisconnected(WiFiEventStationModeDisconnected event_info);
+void onSTAGotIP(WiFiEventStationModeGotIP ipInfo);
+void initNTP();
+void addProcesses();
+void startProcesses();
+bool retrieveConfig();
+bool wifiConnect();
+void logESPconfig();
+void setTurbo(bool setTurbo);
+bool isTurbo();
+void errLog(String msg);
+
+#include "../__ATMOSCAN_MASTER_V1.2.ino"
+
+// -------------------------------------------------------
+// Options
+// -------------------------------------------------------
+
+struct Options
+{
+  double seconds = 600;
+  double cpm = 30;
+  double gestureEvery = 0;
+  double frames = 0;
+  int screen = -1;
+  std::string spiffs = "spiffs";
+  int mqttFormat = -1;
+  int powerMode = -1;
+  int benchBmp = 0;
+  double i2cJam = -1;
+};
+
+static void usage(const char *name)
+{
+  fprintf(stderr, "usage: %s [--seconds N] [--realtime] [--offline] [--cpm N] [--gesture-every N] [--transients] "
+          "[--uart-noise P] [--sensor-noise X] [--broker-down FROM:TO] [--web-down FROM:TO] [--web-stall FROM:TO] [--web-hangup FROM:TO] [--i2c-fault ADDR:FROM:TO] [--i2c-jam S] [--mqtt-format text|binary] [--power-mode active|modem] [--screen N] [--frames N] "
+          "[--spiffs DIR] [--verbose] [--bench-bmp N]\n", name);
+  exit(2);
+}
+
+static Options parseOptions(int argc, char **argv)
+{
+  Options options;
+  host::online = true;
+
+  for (int i = 1; i < argc; i++)
+  {
+    std::string arg = argv[i];
+    auto value = [&]() -> const char *
+    {
+      if (i + 1 >= argc)
+        usage(argv[0]);
+      return argv[++i];
+    };
+
+    if (arg == "--seconds")
+      options.seconds = atof(value());
+    else if (arg == "--realtime")
+      host::realtime = true;
+    else if (arg == "--offline")
+      host::online = false;
+    else if (arg == "--online")
+      host::online = true;
+    else if (arg == "--cpm")
+      options.cpm = atof(value());
+    else if (arg == "--gesture-every")
+      options.gestureEvery = atof(value());
+    else if (arg == "--transients")
+      host::environment.transients = true;
+    else if (arg == "--uart-noise")
+      host::uartNoise = atof(value());
+    else if (arg == "--sensor-noise")
+      host::sensorNoise = atof(value());
+    else if (arg == "--screen")
+      options.screen = atoi(value());
+    else if (arg == "--frames")
+      options.frames = atof(value());
+    else if (arg == "--spiffs")
+      options.spiffs = value();
+    else if (arg == "--broker-down")
+    {
+      double from = 0, until = 0;
+      if (sscanf(value(), "%lf:%lf", &from, &until) != 2 || until < from)
+        usage(argv[0]);
+      host::brokerDownFrom = from * 1e6;
+      host::brokerDownUntil = until * 1e6;
+    }
+    else if (arg == "--web-down")
+    {
+      double from = 0, until = 0;
+      if (sscanf(value(), "%lf:%lf", &from, &until) != 2 || until < from)
+        usage(argv[0]);
+      host::webDownFrom = from * 1e6;
+      host::webDownUntil = until * 1e6;
+    }
+    else if (arg == "--web-stall" || arg == "--web-hangup")
+    {
+      double from = 0, until = 0;
+      if (sscanf(value(), "%lf:%lf", &from, &until) != 2 || until < from)
+        usage(argv[0]);
+      (arg == "--web-stall" ? host::webStallFrom : host::webHangupFrom) = from * 1e6;
+      (arg == "--web-stall" ? host::webStallUntil : host::webHangupUntil) = until * 1e6;
+    }
+    else if (arg == "--i2c-fault")
+    {
+      unsigned int address = 0;
+      double from = 0, until = 0;
+      if (sscanf(value(), "%i:%lf:%lf", (int *) &address, &from, &until) != 3 || address > 0x7F || until < from)
+        usage(argv[0]);
+      Wire.hostFault(address, from * 1e6, until * 1e6);
+    }
+    else if (arg == "--i2c-jam")
+      options.i2cJam = atof(value());
+    else if (arg == "--mqtt-format")
+    {
+      std::string format = value();
+      if (format != "text" && format != "binary")
+        usage(argv[0]);
+      options.mqttFormat = (format == "binary") ? MQTT_FORMAT_BINARY : MQTT_FORMAT_TEXT;
+    }
+    else if (arg == "--power-mode")
+    {
+      std::string mode = value();
+      if (mode != "active" && mode != "modem")
+        usage(argv[0]);
+      options.powerMode = PowerManager::modeFromName(mode.c_str());
+    }
+    else if (arg == "--verbose")
+      host::verbose = true;
+    else if (arg == "--bench-bmp")
+      options.benchBmp = atoi(value());
+    else
+      usage(argv[0]);
+  }
+  return options;
+}
+
+// -------------------------------------------------------
+// Setup & report
+// -------------------------------------------------------
+
+// Configuration normally written by the WiFiManager portal, with ThingSpeak length topics
+// (channels/<id>/publish/<write key>) so the MQTT packets are as large as on a real station
+static void seedConfig()
+{
+  SPIFFS.begin();
+  if (SPIFFS.exists(F("/config.json")))
+    return;
+
+  fs::File f = SPIFFS.open(F("/config.json"), "w");
+  f.print(F("{\"mqtt_server\":\"broker.local\",\"mqtt_topic1\":\"channels/1234567/publish/0123456789ABCDEF\","
+            "\"mqtt_topic2\":\"channels/1234568/publish/123456789ABCDEF0\",\"mqtt_topic3\":\"channels/1234569/publish/23456789ABCDEF01\","
+            "\"syslog_server\":\"192.168.1.10\",\"mqtt_diag_topic\":\"atmoscan/diag\"}"));
+  f.close();
+}
+
+// ESP8266 supply current (mA) with the station associated, from the datasheet
+#define CURRENT_AWAKE 70.0
+#define CURRENT_MODEM_SLEEP 15.0
+
+// Time from the start of each CO2 spike to the first sample that shows it, and
+// how many samples follow its shape over the first minutes
+#define SPIKE_SEEN_PPM 400
+#define SPIKE_SHAPE_SECONDS 240
+static double spikeLatency = 0;
+static unsigned long spikesSeen = 0;
+static unsigned long spikeSamples = 0;
+
+static void watchSpike()
+{
+  static double lastAge = -1;
+  static bool seen = false;
+  static float lastSample = NAN;
+
+  double age = host::environment.co2SpikeAge();
+  if (age < lastAge)
+    seen = false;
+  lastAge = age;
+
+  float sample = procPtr.CO2Sensor.getCO2Stats().last;
+  if (age >= 0 && age < SPIKE_SHAPE_SECONDS && sample != lastSample)
+    spikeSamples++;
+  lastSample = sample;
+
+  if (age >= 0 && !seen && sample >= host::environment.co2() - host::environment.co2Spike() + SPIKE_SEEN_PPM)
+  {
+    seen = true;
+    spikeLatency += age;
+    spikesSeen++;
+  }
+}
+
+// Binary MQTT records seen by the broker stand-in
+static unsigned long telemetryDecoded = 0;
+static unsigned long telemetryInvalid = 0;
+
+static void report(unsigned long iterations, uint64_t startMicros)
+{
+  double seconds = (host::micros64() - startMicros) / 1e6;
+
+  fprintf(stderr, "\n==== AtmoScan host run: %.1f virtual seconds ====\n", seconds);
+  fprintf(stderr, "loop iterations      %lu\n", iterations);
+  fprintf(stderr, "process services     %lu\n", sched.hostServiced());
+  fprintf(stderr, "time in delay()      %.3f s\n", host::delayedMicros() / 1e6);
+
+  fprintf(stderr, "Service times        runs     avg ms    max ms  max late ms  overruns  load %%\n");
+  for (ServiceMonitor *monitor = ServiceMonitor::getFirst(); monitor; monitor = monitor->getNext())
+  {
+    const ServiceStats &stats = monitor->getStats();
+    fprintf(stderr, "  %-16s %8lu %10.3f %9.1f %12lu %9lu %7.2f\n", monitor->getName(), (unsigned long) stats.runs,
+            monitor->getAverageMicros() / 1000.0, stats.maxMicros / 1000.0, (unsigned long) stats.maxLateness,
+            (unsigned long) stats.overruns, monitor->getLoad());
+  }
+
+  // Energy model: awake at full current, idle time at the sleep current of the mode
+  double asleep = power.getSleepMicros() / 1e6;
+  double idleCurrent = power.getMode() == POWER_MODE_MODEM_SLEEP ? CURRENT_MODEM_SLEEP : CURRENT_AWAKE;
+  double current = (CURRENT_AWAKE * (seconds - asleep) + idleCurrent * asleep) / seconds;
+  fprintf(stderr, "Power                %s, awake %.1f %%, %lu sleeps (%lu woken early), ESP8266 %.1f mA average\n",
+          PowerManager::modeName(power.getMode()), 100 * (seconds - asleep) / seconds, power.getSleeps(),
+          power.getEarlyWakes(), current);
+
+  fprintf(stderr, "Readings             %.1f C, %.1f %%RH, %.0f hPa, CO2 %.0f ppm, PM2.5 %.1f, CO %.2f ppm\n",
+          procPtr.ComboTemperatureHumiditySensor.getTemperature(), procPtr.ComboTemperatureHumiditySensor.getHumidity(),
+          procPtr.ComboPressureHumiditySensor.getPressure(), procPtr.CO2Sensor.getCO2(), procPtr.ParticleSensor.getPM2_5(),
+          procPtr.MultiGasSensor.getCO());
+
+  if (host::environment.transients)
+    fprintf(stderr, "CO2 spikes           %lu seen, %.1f s after they start, %.1f samples in their first %d s on average\n",
+            spikesSeen, spikesSeen ? spikeLatency / spikesSeen : 0.0, spikesSeen ? (double) spikeSamples / spikesSeen : 0.0,
+            SPIKE_SHAPE_SECONDS);
+
+  fprintf(stderr, "I2C bus time         %.3f s\n", Wire.busMicros() / 1e6);
+  for (auto &entry : Wire.counters())
+    fprintf(stderr, "  0x%02X               %lu writes, %lu reads, %lu bytes, %lu NACKs, %lu bus errors\n",
+            entry.first, entry.second.writes, entry.second.reads, entry.second.bytes, entry.second.nacks,
+            entry.second.busErrors);
+
+  fprintf(stderr, "I2C devices          uses   avg ms    max ms  errors  timeouts  skipped   (%lu bus recoveries)\n",
+          i2cBus.getRecoveries());
+  for (int i = 0; i < I2C_DEVICE_COUNT; i++)
+  {
+    const I2CDeviceStats &stats = i2cBus.getStats(i);
+    fprintf(stderr, "  %-16s %7lu %8.3f %9.1f %7lu %9lu %8lu\n", I2CBus::devices[i].name, (unsigned long) stats.transactions,
+            stats.transactions ? stats.totalMicros / 1000.0 / stats.transactions : 0.0, stats.maxMicros / 1000.0,
+            (unsigned long) stats.errors, (unsigned long) stats.timeouts, (unsigned long) stats.skipped);
+  }
+
+  fprintf(stderr, "LCD                  %lu pixels, %lu windows, %lu full screens, %.3f s bus time\n",
+          LCD.counters().pixels, LCD.counters().windows, LCD.counters().fullScreens, LCD.busMicros() / 1e6);
+  fprintf(stderr, "SPIFFS reads         %lu calls, %lu bytes, %.3f s flash time\n", fs::File::reads, fs::File::bytesRead,
+          fs::File::readMicros() / 1e6);
+  fprintf(stderr, "UART PMS7003         %lu bytes out, %lu bytes in\n", Serial.bytesWritten, Serial.bytesRead);
+  fprintf(stderr, "Geiger pulses        %lu, %.1f CPM, %lu not timestamped\n", host::interruptCount(GEIGER_INTERRUPT_PIN),
+          procPtr.GeigerSensor.getCPM(), procPtr.GeigerSensor.getLostTimestamps());
+  fprintf(stderr, "  intervals          ");
+  for (int i = 0; i < Proc_GeigerSensor::GEIGER_HISTOGRAM_BINS; i++)
+    fprintf(stderr, " %lu", procPtr.GeigerSensor.getIntervalHistogram()[i]);
+  fprintf(stderr, "  (log2 bins of %lu us)\n", Proc_GeigerSensor::GEIGER_HISTOGRAM_UNIT);
+  uint32_t historyTimes[60];
+  float historyValues[60];
+  int historyPoints = procPtr.History.query(HISTORY_CO2, utcNow() - 3600, utcNow(), historyTimes, historyValues, 60);
+  fprintf(stderr, "History              %u / %u / %u records (5 s / 1 min / 15 min), last hour CO2 %d points\n",
+          procPtr.History.getTier(HISTORY_5SEC).count(), procPtr.History.getTier(HISTORY_1MIN).count(),
+          procPtr.History.getTier(HISTORY_15MIN).count(), historyPoints);
+  fprintf(stderr, "Gestures             %lu\n", host::interruptCount(GESTURE_INTERRUPT_PIN));
+  fprintf(stderr, "HTTP                 %lu connections, %lu requests, %lu bytes received\n",
+          WiFiClient::connections, WiFiClient::requests, WiFiClient::bytesReceived);
+  fprintf(stderr, "MQTT publishes       %lu, %lu history records backfilled, %d pending\n", PubSubClient::hostPublished,
+          procPtr.MQTTUpdate.getBackfilled(), procPtr.MQTTUpdate.getBacklog());
+  if (config.mqttFormat == MQTT_FORMAT_BINARY)
+    fprintf(stderr, "MQTT binary records  %lu decoded, %lu invalid\n", telemetryDecoded, telemetryInvalid);
+  fprintf(stderr, "Syslog messages      %zu\n", syslog.messages());
+  fprintf(stderr, "Error log entries    %d\n", (int) lastErrors.numElements());
+  for (int i = 0; i < (int) lastErrors.numElements(); i++)
+    fprintf(stderr, "  %s\n", lastErrors.peek(i)->c_str());
+}
+
+// -------------------------------------------------------
+// Bitmap benchmark
+// -------------------------------------------------------
+
+// Bottom-up test card, 24 bit BGR or 16 bit RGB565 with bit fields
+static void writeBenchBmp(const String &name, int width, int height, int depth)
+{
+  uint32_t headerSize = depth == 16 ? 66 : 54;
+  uint32_t rowSize = (width * depth / 8 + 3) & ~3;
+  std::string data(headerSize + rowSize * height, '\0');
+  auto put16 = [&](size_t at, uint16_t v) { data[at] = v & 0xFF; data[at + 1] = v >> 8; };
+  auto put32 = [&](size_t at, uint32_t v) { put16(at, v & 0xFFFF); put16(at + 2, v >> 16); };
+
+  data[0] = 'B';
+  data[1] = 'M';
+  put32(2, data.size());
+  put32(10, headerSize);
+  put32(14, 40);
+  put32(18, width);
+  put32(22, height);
+  put16(26, 1);
+  put16(28, depth);
+  put32(30, depth == 16 ? 3 : 0);
+  put32(34, rowSize * height);
+  if (depth == 16)
+  {
+    put32(54, 0xF800);
+    put32(58, 0x07E0);
+    put32(62, 0x001F);
+  }
+
+  for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+    {
+      uint8_t r = x * 255 / width, g = y * 255 / height, b = (x * y) & 0xFF;
+      size_t at = headerSize + y * rowSize + x * depth / 8;
+      if (depth == 16)
+        put16(at, ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+      else
+      {
+        data[at] = b;
+        data[at + 1] = g;
+        data[at + 2] = r;
+      }
+    }
+
+  fs::File file = SPIFFS.open(name, "w");
+  file.write((const uint8_t *) data.data(), data.size());
+  file.close();
+}
+
+static void benchDraw(const char *label, const String &name, int iterations)
+{
+  uint64_t virtualStart = host::micros64();
+  unsigned long reads = fs::File::reads;
+  unsigned long pixels = LCD.counters().pixels;
+  auto cpuStart = std::chrono::steady_clock::now();
+
+  for (int i = 0; i < iterations; i++)
+    ui.drawBmp(name, 70, 110);
+
+  double cpuSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - cpuStart).count();
+  double virtualSeconds = (host::micros64() - virtualStart) / 1e6;
+  unsigned long drawn = LCD.counters().pixels - pixels;
+  if (drawn == 0)
+  {
+    fprintf(stderr, "  %-20s not drawn\n", label);
+    return;
+  }
+  fprintf(stderr, "  %-20s %10.1f %10.2f %12.0f %14.1f\n", label, (double) (fs::File::reads - reads) / iterations,
+          virtualSeconds * 1000 / iterations, drawn / virtualSeconds, cpuSeconds * 1e9 / drawn);
+}
+
+// Virtual time is the display bus and the flash reads, host time is the conversion work.
+// Runs in a scratch SPIFFS directory: packing the test image rewrites /assets.bin
+static void benchBitmaps(int iterations)
+{
+  char root[] = "/tmp/atmoscan-bench-XXXXXX";
+  if (!mkdtemp(root))
+  {
+    perror("mkdtemp");
+    return;
+  }
+  SPIFFS.setHostRoot(root);
+
+  writeBenchBmp("/bench24.bmp", 100, 100, 24);
+  writeBenchBmp("/bench16.bmp", 100, 100, 16);
+  writeBenchBmp("/benchpack.bmp", 100, 100, 24);
+  String packed = "/benchpack.bmp";
+  assets.pack(&packed, 1);
+
+  fprintf(stderr, "Bitmap draws, 100x100  reads/image   ms/image     pixels/s  host ns/pixel\n");
+  benchDraw("BMP 24 bit", "/bench24.bmp", iterations);
+  benchDraw("BMP 16 bit RGB565", "/bench16.bmp", iterations);
+  benchDraw("Asset bundle", "/benchpack.bmp", iterations);
+
+  fs::Dir dir = SPIFFS.openDir("/");
+  while (dir.next())
+    SPIFFS.remove(dir.fileName());
+  rmdir(root);
+}
+
+int main(int argc, char **argv)
+{
+  Options options = parseOptions(argc, argv);
+
+  SPIFFS.setHostRoot(options.spiffs);
+  seedConfig();
+
+  if (options.benchBmp > 0)
+  {
+    benchBitmaps(options.benchBmp);
+    return 0;
+  }
+
+  host::installDevices(options.cpm, options.gestureEvery);
+  host::installServers();
+
+  // The broker stand-in decodes binary records like a consumer would
+  PubSubClient::hostOnPublish = [](const char *topic, const uint8_t *payload, size_t length)
+  {
+    if (config.mqttFormat == MQTT_FORMAT_BINARY && strcmp(topic, config.mqtt_topic1) == 0)
+    {
+      host::TelemetryRecord record;
+      std::string error;
+      if (host::decodeTelemetry(payload, length, record, error))
+      {
+        telemetryDecoded++;
+        if (host::verbose)
+          fprintf(stderr, "[mqtt] %s (%zu bytes) %s\n", topic, length, host::telemetryToJson(record).c_str());
+      }
+      else
+      {
+        telemetryInvalid++;
+        fprintf(stderr, "[mqtt] %s invalid binary record: %s\n", topic, error.c_str());
+      }
+    }
+    else if (host::verbose)
+      fprintf(stderr, "[mqtt] %s %.*s\n", topic, (int) length, (const char *) payload);
+  };
+
+  if (options.screen >= 0)
+    config.startScreen = options.screen;
+
+  unsigned long iterations = 0;
+  uint64_t start = host::micros64();
+  host::onRestart = [&] { report(iterations, start); };
+
+  setup();
+
+  if (options.mqttFormat >= 0)
+    config.mqttFormat = options.mqttFormat;
+  if (options.powerMode >= 0)
+    power.begin(options.powerMode);
+
+  uint64_t end = host::micros64() + (uint64_t) (options.seconds * 1e6);
+  uint64_t nextFrame = host::micros64();
+  int frame = 0;
+
+  while (host::micros64() < end)
+  {
+    unsigned long serviced = sched.hostServiced();
+    loop();
+    iterations++;
+
+    if (host::environment.transients)
+      watchSpike();
+
+    // Enough clocks owed to need most of a recovery sequence
+    if (options.i2cJam >= 0 && host::micros64() >= options.i2cJam * 1e6)
+    {
+      Wire.hostJam(I2C_RECOVERY_CLOCKS - 2);
+      options.i2cJam = -1;
+    }
+
+    if (options.frames > 0 && host::micros64() >= nextFrame)
+    {
+      char name[64];
+      snprintf(name, sizeof(name), "frame%04d.ppm", frame++);
+      LCD.dumpPPM(name);
+      nextFrame += (uint64_t) (options.frames * 1e6);
+    }
+
+    // Nothing was due: let a millisecond pass like the idle loop on the device
+    if (sched.hostServiced() == serviced)
+      host::advance(1000);
+  }
+
+  report(iterations, start);
+  return 0;
+}
@@ -0,0 +1,61 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - Adafruit BME280 library stand-in       */
+/*                                                      */
+/*  Burst reads of the data registers as in the real    */
+/*  library. The device model reports already           */
+/*  compensated values (temperature in 1/100 degC,      */
+/*  pressure in 1/128 Pa, humidity in 1/512 %RH), so    */
+/*  no calibration table is needed.                     */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+#include "Wire.h"
+
+#define BME280_REGISTER_CHIPID    0xD0
+#define BME280_REGISTER_CONTROL   0xF4
+#define BME280_REGISTER_PRESSUREDATA 0xF7
+#define BME280_REGISTER_TEMPDATA  0xFA
+#define BME280_REGISTER_HUMIDDATA 0xFD
+
+class Adafruit_BME280
+{
+  public:
+    bool begin(uint8_t address = 0x77)
+    {
+      _address = address;
+      Wire.begin();
+      if (read(BME280_REGISTER_CHIPID, 1) != 0x60)
+        return false;
+
+      Wire.beginTransmission(_address);
+      Wire.write(BME280_REGISTER_CONTROL);
+      Wire.write(0x3F);   // Normal mode, x16 oversampling
+      Wire.endTransmission();
+      return true;
+    }
+
+    float readTemperature() { return (int32_t) read(BME280_REGISTER_TEMPDATA, 3) / 100.0f; }
+    float readPressure() { readTemperature(); return read(BME280_REGISTER_PRESSUREDATA, 3) / 128.0f; }
+    float readHumidity() { readTemperature(); return read(BME280_REGISTER_HUMIDDATA, 2) / 512.0f; }
+
+  private:
+    uint32_t read(uint8_t reg, uint8_t len)
+    {
+      Wire.beginTransmission(_address);
+      Wire.write(reg);
+      Wire.endTransmission();
+      if (Wire.requestFrom(_address, (size_t) len) != len)
+        return 0;
+
+      uint32_t value = 0;
+      while (len--)
+        value = (value << 8) | Wire.read();
+      return value;
+    }
+
+    uint8_t _address = 0x77;
+};
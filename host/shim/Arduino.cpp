@@ -0,0 +1,416 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - Arduino / ESP8266 core stand-in        */
+/*                                                      */
+/********************************************************/
+
+#include "Arduino.h"
+#include "HostSim.h"
+#include "Wire.h"
+
+#include <chrono>
+#include <cstdarg>
+#include <map>
+#include <queue>
+#include <random>
+#include <thread>
+
+HardwareSerial Serial;
+EspClass ESP;
+
+// -------------------------------------------------------
+// Virtual clock & interrupts
+// -------------------------------------------------------
+
+namespace host
+{
+  bool realtime = false;
+  bool verbose = false;
+  std::function<void()> onRestart;
+}
+
+static const std::chrono::steady_clock::time_point clockStart = std::chrono::steady_clock::now();
+static uint64_t skippedMicros = 0;
+static uint64_t totalDelayMicros = 0;
+
+// While an ISR runs, micros() reports the edge time rather than the current time
+static bool inISR = false;
+static uint64_t isrMicros = 0;
+static bool interruptsMasked = false;
+
+struct PulseSource
+{
+  uint8_t pin;
+  std::function<uint64_t()> nextInterval;
+  uint64_t due;
+};
+
+struct PendingEdge
+{
+  uint64_t due;
+  size_t source;
+  bool operator > (const PendingEdge &rhs) const { return due > rhs.due; }
+};
+
+static std::vector<PulseSource> pulseSources;
+static std::priority_queue<PendingEdge, std::vector<PendingEdge>, std::greater<PendingEdge>> pendingEdges;
+static std::map<uint8_t, void (*)(void)> isrTable;
+static std::map<uint8_t, unsigned long> isrCounts;
+static std::map<uint8_t, std::function<int()>> analogSources;
+static std::map<uint8_t, uint8_t> pinLevels;
+
+uint64_t host::micros64()
+{
+  if (inISR)
+    return isrMicros;
+
+  uint64_t real = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - clockStart).count();
+  return real + skippedMicros;
+}
+
+void host::advance(uint64_t us)
+{
+  if (realtime)
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+  else
+    skippedMicros += us;
+  pump();
+}
+
+void host::pump()
+{
+  if (inISR || interruptsMasked)
+    return;
+
+  uint64_t now = micros64();
+  while (!pendingEdges.empty() && pendingEdges.top().due <= now)
+  {
+    PendingEdge edge = pendingEdges.top();
+    pendingEdges.pop();
+
+    PulseSource &src = pulseSources[edge.source];
+    auto isr = isrTable.find(src.pin);
+    if (isr != isrTable.end() && isr->second)
+    {
+      inISR = true;
+      isrMicros = edge.due;
+      isr->second();
+      inISR = false;
+      isrCounts[src.pin]++;
+    }
+
+    src.due = edge.due + std::max<uint64_t>(1, src.nextInterval());
+    pendingEdges.push({src.due, edge.source});
+  }
+}
+
+void host::addPulseSource(uint8_t pin, std::function<uint64_t()> nextInterval)
+{
+  uint64_t due = micros64() + nextInterval();
+  pulseSources.push_back({pin, nextInterval, due});
+  pendingEdges.push({due, pulseSources.size() - 1});
+}
+
+void host::setAnalogSource(uint8_t pin, std::function<int()> source)
+{
+  analogSources[pin] = source;
+}
+
+unsigned long host::interruptCount(uint8_t pin)
+{
+  return isrCounts[pin];
+}
+
+uint64_t host::delayedMicros()
+{
+  return totalDelayMicros;
+}
+
+unsigned long millis()
+{
+  return (unsigned long)(host::micros64() / 1000);
+}
+
+unsigned long micros()
+{
+  return (unsigned long) host::micros64();
+}
+
+void delay(unsigned long ms)
+{
+  totalDelayMicros += (uint64_t) ms * 1000;
+  host::advance((uint64_t) ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  totalDelayMicros += us;
+  host::advance(us);
+}
+
+void yield()
+{
+  host::pump();
+}
+
+// An input with its pull-up reads high until something drives it
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  if (mode == INPUT_PULLUP && pinLevels.find(pin) == pinLevels.end())
+    pinLevels[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+  pinLevels[pin] = val;
+  if (val == LOW)
+    Wire.hostClock(pin);
+}
+
+int digitalRead(uint8_t pin)
+{
+  if (Wire.hostHoldsLow(pin))
+    return LOW;
+  auto level = pinLevels.find(pin);
+  return level == pinLevels.end() ? LOW : level->second;
+}
+
+int analogRead(uint8_t pin)
+{
+  auto source = analogSources.find(pin);
+  return source == analogSources.end() ? 0 : constrain(source->second(), 0, 1023);
+}
+
+void analogWrite(uint8_t pin, int val)
+{
+  pinLevels[pin] = val ? HIGH : LOW;
+}
+
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode)
+{
+  (void) mode;
+  isrTable[pin] = isr;
+}
+
+void detachInterrupt(uint8_t pin)
+{
+  isrTable.erase(pin);
+}
+
+void interrupts()
+{
+  interruptsMasked = false;
+}
+
+void noInterrupts()
+{
+  interruptsMasked = true;
+}
+
+// -------------------------------------------------------
+// Misc helpers
+// -------------------------------------------------------
+
+static std::mt19937 rng(1);
+
+long random(long howbig)
+{
+  if (howbig <= 0)
+    return 0;
+  return std::uniform_int_distribution<long>(0, howbig - 1)(rng);
+}
+
+long random(long howsmall, long howbig)
+{
+  if (howsmall >= howbig)
+    return howsmall;
+  return howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed)
+{
+  rng.seed(seed);
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+char *dtostrf(double number, signed char width, unsigned char prec, char *s)
+{
+  sprintf(s, "%*.*f", width, prec, number);
+  return s;
+}
+
+// -------------------------------------------------------
+// Print & Stream
+// -------------------------------------------------------
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+  size_t n = 0;
+  while (size--)
+    n += write(*buffer++);
+  return n;
+}
+
+size_t Print::printf(const char *format, ...)
+{
+  char buf[256];
+  va_list args;
+  va_start(args, format);
+  int len = vsnprintf(buf, sizeof(buf), format, args);
+  va_end(args);
+  if (len < 0)
+    return 0;
+  return write((const uint8_t *) buf, std::min<size_t>(len, sizeof(buf) - 1));
+}
+
+// Same contract as the core: wait up to _timeout ms for each byte
+int Stream::timedRead()
+{
+  unsigned long start = millis();
+  do
+  {
+    int c = read();
+    if (c >= 0)
+      return c;
+    delay(1);
+  }
+  while (millis() - start < _timeout);
+  return -1;
+}
+
+size_t Stream::readBytes(char *buffer, size_t length)
+{
+  size_t count = 0;
+  while (count < length)
+  {
+    int c = timedRead();
+    if (c < 0)
+      break;
+    *buffer++ = (char) c;
+    count++;
+  }
+  return count;
+}
+
+String Stream::readString()
+{
+  String ret;
+  int c;
+  while ((c = timedRead()) >= 0)
+    ret += (char) c;
+  return ret;
+}
+
+String Stream::readStringUntil(char terminator)
+{
+  String ret;
+  int c;
+  while ((c = timedRead()) >= 0 && c != terminator)
+    ret += (char) c;
+  return ret;
+}
+
+bool Stream::find(const char *target)
+{
+  size_t len = strlen(target);
+  size_t index = 0;
+  int c;
+  while ((c = timedRead()) >= 0)
+  {
+    index = (c == target[index]) ? index + 1 : (c == target[0] ? 1 : 0);
+    if (index == len)
+      return true;
+  }
+  return false;
+}
+
+size_t HostUart::write(const uint8_t *buffer, size_t size)
+{
+  bytesWritten += size;
+  if (!_peer)
+  {
+    if (this == &Serial)
+      fwrite(buffer, 1, size, stdout);
+    return size;
+  }
+
+  std::deque<uint8_t> reply;
+  _peer(buffer, size, reply);
+
+  // 10 bits per character, the reply starts once the request is fully out
+  uint64_t charTime = 10000000ULL / _baud;
+  uint64_t arrival = host::micros64() + size * charTime + _latency;
+  if (!_rx.empty())
+    arrival = std::max(arrival, _rx.back().first);
+  for (uint8_t c : reply)
+  {
+    arrival += charTime;
+    _rx.push_back(std::make_pair(arrival, c));
+  }
+  return size;
+}
+
+int HostUart::available()
+{
+  uint64_t now = host::micros64();
+  int count = 0;
+  for (auto &entry : _rx)
+  {
+    if (entry.first > now)
+      break;
+    count++;
+  }
+  return count;
+}
+
+int HostUart::read()
+{
+  if (!available())
+    return -1;
+  int c = _rx.front().second;
+  _rx.pop_front();
+  bytesRead++;
+  return c;
+}
+
+// -------------------------------------------------------
+// ESP
+// -------------------------------------------------------
+
+// Set by system_update_cpu_freq()
+uint8_t hostCpuFreqMHz = 80;
+
+void EspClass::restart()
+{
+  fprintf(stderr, "ESP.restart() requested - exiting\n");
+  if (host::onRestart)
+    host::onRestart();
+  exit(0);
+}
+
+uint32_t EspClass::getFreeHeap()
+{
+  return 28672;
+}
+
+uint8_t EspClass::getCpuFreqMHz()
+{
+  return hostCpuFreqMHz;
+}
+
+extern "C" bool system_update_cpu_freq(uint8_t freq)
+{
+  if (freq != 80 && freq != 160)
+    return false;
+  hostCpuFreqMHz = freq;
+  return true;
+}
+
+extern "C" uint8_t system_get_cpu_freq(void)
+{
+  return hostCpuFreqMHz;
+}
@@ -0,0 +1,247 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - Arduino / ESP8266 core stand-in        */
+/*                                                      */
+/*  Only the subset of the core used by the firmware.   */
+/*  Time is virtual: delay() advances the clock rather  */
+/*  than sleeping (unless --realtime is given), and the */
+/*  simulated pin interrupts fire at clock advances.    */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+// Standard headers go first: the firmware defines min() as a macro in places
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "WString.h"
+
+// -------------------------------------------------------
+// Types & constants
+// -------------------------------------------------------
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef uint16_t word;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x00
+#define OUTPUT       0x01
+#define INPUT_PULLUP 0x02
+#define OUTPUT_OPEN_DRAIN 0x03
+
+#define CHANGE  1
+#define FALLING 2
+#define RISING  3
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define A0 17
+
+#define PI         3.1415926535897932384626433832795
+#define HALF_PI    1.5707963267948966192313216916398
+#define TWO_PI     6.283185307179586476925286766559
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#define radians(deg) ((deg) * DEG_TO_RAD)
+#define degrees(rad) ((rad) * RAD_TO_DEG)
+#define sq(x) ((x) * (x))
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define lowByte(w) ((uint8_t) ((w) & 0xff))
+#define highByte(w) ((uint8_t) ((w) >> 8))
+
+using std::min;
+using std::max;
+using std::isnan;
+using std::isinf;
+
+#define ICACHE_RAM_ATTR
+#define ICACHE_FLASH_ATTR
+
+// -------------------------------------------------------
+// Program memory: flat address space on the host
+// -------------------------------------------------------
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define PGM_P const char *
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_float(addr) (*(const float *)(addr))
+#define pgm_read_ptr(addr) (*(void * const *)(addr))
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strcat_P strcat
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define memcpy_P memcpy
+#define sprintf_P sprintf
+#define snprintf_P snprintf
+
+// -------------------------------------------------------
+// Time, pins & interrupts
+// -------------------------------------------------------
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int val);
+
+#define digitalPinToInterrupt(p) (p)
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode);
+void detachInterrupt(uint8_t pin);
+void interrupts();
+void noInterrupts();
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+char *dtostrf(double number, signed char width, unsigned char prec, char *s);
+
+// -------------------------------------------------------
+// Print & Stream
+// -------------------------------------------------------
+
+class Print
+{
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t write(const char *str) { return str ? write((const uint8_t *) str, strlen(str)) : 0; }
+    size_t write(const char *buffer, size_t size) { return write((const uint8_t *) buffer, size); }
+    virtual void flush() {}
+
+    size_t print(const String &s) { return write(s.c_str()); }
+    size_t print(const char *s) { return write(s); }
+    size_t print(const __FlashStringHelper *s) { return write(reinterpret_cast<const char *>(s)); }
+    size_t print(char c) { return write((uint8_t) c); }
+    size_t print(int n, int base = DEC) { return print(String((long) n, base)); }
+    size_t print(unsigned int n, int base = DEC) { return print(String((unsigned long) n, base)); }
+    size_t print(long n, int base = DEC) { return print(String(n, base)); }
+    size_t print(unsigned long n, int base = DEC) { return print(String(n, base)); }
+    size_t print(double n, int digits = 2) { return print(String(n, digits)); }
+
+    size_t println() { return write("\r\n"); }
+    template <typename T> size_t println(const T &v) { size_t n = print(v); return n + println(); }
+    template <typename T> size_t println(const T &v, int fmt) { size_t n = print(v, fmt); return n + println(); }
+    size_t printf(const char *format, ...) __attribute__ ((format (printf, 2, 3)));
+};
+
+class Stream : public Print
+{
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+    unsigned long getTimeout() const { return _timeout; }
+    size_t readBytes(char *buffer, size_t length);
+    size_t readBytes(uint8_t *buffer, size_t length) { return readBytes((char *) buffer, length); }
+    String readString();
+    String readStringUntil(char terminator);
+    bool find(const char *target);
+
+  protected:
+    int timedRead();
+    unsigned long _timeout = 1000;
+};
+
+// -------------------------------------------------------
+// UART
+// -------------------------------------------------------
+
+// Byte-level UART endpoint. Bytes written by the firmware are handed to the attached
+// device model, which queues its replies for the firmware to read back. Replies arrive
+// after the model's response latency, one character time apart at the configured baud rate.
+class HostUart : public Stream
+{
+  public:
+    typedef std::function<void(const uint8_t *data, size_t len, std::deque<uint8_t> &reply)> Peer;
+
+    void attachPeer(Peer peer, uint32_t latencyMicros = 0) { _peer = peer; _latency = latencyMicros; }
+
+    using Print::write;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override;
+    int available() override;
+    int read() override;
+    int peek() override { return available() ? _rx.front().second : -1; }
+
+    unsigned long bytesWritten = 0;
+    unsigned long bytesRead = 0;
+
+  protected:
+    void setBaud(unsigned long baud) { _baud = baud ? baud : 9600; }
+
+    Peer _peer;
+    uint32_t _latency = 0;
+    unsigned long _baud = 9600;
+    std::deque<std::pair<uint64_t, uint8_t>> _rx;   // arrival time (us), byte
+};
+
+class HardwareSerial : public HostUart
+{
+  public:
+    void begin(unsigned long baud) { setBaud(baud); }
+    void end() {}
+    operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+// -------------------------------------------------------
+// ESP specific
+// -------------------------------------------------------
+
+enum FlashMode_t { FM_QIO = 0x00, FM_QOUT = 0x01, FM_DIO = 0x02, FM_DOUT = 0x03, FM_UNKNOWN = 0xff };
+
+class EspClass
+{
+  public:
+    void wdtFeed() {}
+    void restart();
+    void reset() { restart(); }
+    void eraseConfig() {}
+    uint32_t getFreeHeap();
+    uint32_t getChipId() { return 0x00A7305C; }
+    uint32_t getFlashChipId() { return 0x1640E0; }
+    uint32_t getFlashChipRealSize() { return 4194304; }
+    uint32_t getFlashChipSize() { return 4194304; }
+    uint32_t getFlashChipSpeed() { return 40000000; }
+    FlashMode_t getFlashChipMode() { return FM_DIO; }
+    uint8_t getCpuFreqMHz();
+};
+
+extern EspClass ESP;
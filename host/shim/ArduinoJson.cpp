@@ -0,0 +1,157 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - ArduinoJson (v5) stand-in              */
+/*                                                      */
+/********************************************************/
+
+#include "ArduinoJson.h"
+
+#include <cctype>
+
+JsonObjectSubscript &JsonObjectSubscript::operator = (const char *value)
+{
+  JsonObject::Member *m = _object.find(_key);
+  if (!m)
+  {
+    _object._members.push_back({_key, "", true});
+    m = &_object._members.back();
+  }
+  m->value = value ? value : "";
+  m->quoted = true;
+  return *this;
+}
+
+// Missing keys read as NULL, like the original
+JsonObjectSubscript::operator const char *() const
+{
+  const JsonObject::Member *m = const_cast<const JsonObject &>(_object).find(_key);
+  return m ? m->value.c_str() : NULL;
+}
+
+bool JsonObjectSubscript::success() const
+{
+  return const_cast<const JsonObject &>(_object).find(_key) != nullptr;
+}
+
+const JsonObject::Member *JsonObject::find(const std::string &key) const
+{
+  for (const Member &m : _members)
+  {
+    if (m.key == key)
+      return &m;
+  }
+  return nullptr;
+}
+
+JsonObject::Member *JsonObject::find(const std::string &key)
+{
+  return const_cast<Member *>(const_cast<const JsonObject *>(this)->find(key));
+}
+
+static void skipSpaces(const char *&p)
+{
+  while (*p && isspace((unsigned char) *p))
+    p++;
+}
+
+static bool parseString(const char *&p, std::string &out)
+{
+  if (*p != '"')
+    return false;
+  p++;
+  while (*p && *p != '"')
+  {
+    if (*p == '\\' && p[1])
+      p++;
+    out += *p++;
+  }
+  if (*p != '"')
+    return false;
+  p++;
+  return true;
+}
+
+bool JsonObject::parse(const char *json)
+{
+  _members.clear();
+  _success = false;
+  if (!json)
+    return false;
+
+  const char *p = json;
+  skipSpaces(p);
+  if (*p++ != '{')
+    return false;
+
+  skipSpaces(p);
+  if (*p == '}')
+    return _success = true;
+
+  while (*p)
+  {
+    Member m;
+    skipSpaces(p);
+    if (!parseString(p, m.key))
+      return false;
+    skipSpaces(p);
+    if (*p++ != ':')
+      return false;
+    skipSpaces(p);
+
+    m.quoted = *p == '"';
+    if (m.quoted)
+    {
+      if (!parseString(p, m.value))
+        return false;
+    }
+    else
+    {
+      while (*p && *p != ',' && *p != '}' && !isspace((unsigned char) *p))
+        m.value += *p++;
+      if (m.value.empty())
+        return false;
+    }
+    _members.push_back(m);
+
+    skipSpaces(p);
+    if (*p == ',')
+    {
+      p++;
+      continue;
+    }
+    if (*p == '}')
+      return _success = true;
+    return false;
+  }
+  return false;
+}
+
+std::string JsonObject::serialize() const
+{
+  std::string out = "{";
+  for (const Member &m : _members)
+  {
+    if (out.size() > 1)
+      out += ',';
+    out += '"' + m.key + "\":";
+    out += m.quoted ? '"' + m.value + '"' : m.value;
+  }
+  return out + "}";
+}
+
+size_t JsonObject::printTo(Print &p) const
+{
+  std::string out = serialize();
+  return p.write((const uint8_t *) out.data(), out.size());
+}
+
+size_t JsonObject::printTo(char *buffer, size_t size) const
+{
+  std::string out = serialize();
+  if (size == 0)
+    return 0;
+  size_t n = std::min(out.size(), size - 1);
+  memcpy(buffer, out.data(), n);
+  buffer[n] = 0;
+  return n;
+}
@@ -0,0 +1,94 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - ArduinoJson (v5) stand-in              */
+/*                                                      */
+/*  Flat objects of string / number values only, which  */
+/*  is what the configuration file needs.               */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+
+#include <list>
+
+class JsonObject;
+
+class JsonObjectSubscript
+{
+  public:
+    JsonObjectSubscript(JsonObject &object, const std::string &key) : _object(object), _key(key) {}
+
+    JsonObjectSubscript &operator = (const char *value);
+    JsonObjectSubscript &operator = (const String &value) { return *this = value.c_str(); }
+    JsonObjectSubscript &operator = (long value) { return *this = String(value).c_str(); }
+    JsonObjectSubscript &operator = (int value) { return *this = String(value).c_str(); }
+    JsonObjectSubscript &operator = (double value) { return *this = String(value, 6).c_str(); }
+
+    operator const char *() const;
+    template <typename T> T as() const;
+    bool success() const;
+
+  private:
+    JsonObject &_object;
+    std::string _key;
+};
+
+class JsonObject
+{
+    friend class JsonObjectSubscript;
+
+  public:
+    bool success() const { return _success; }
+
+    JsonObjectSubscript operator [](const char *key) { return JsonObjectSubscript(*this, key); }
+    JsonObjectSubscript operator [](const String &key) { return JsonObjectSubscript(*this, key.str()); }
+    JsonObjectSubscript operator [](const __FlashStringHelper *key) { return JsonObjectSubscript(*this, reinterpret_cast<const char *>(key)); }
+
+    bool containsKey(const char *key) const { return find(key) != nullptr; }
+    size_t printTo(Print &p) const;
+    size_t printTo(char *buffer, size_t size) const;
+
+    // Host only
+    bool parse(const char *json);
+
+  private:
+    struct Member
+    {
+      std::string key;
+      std::string value;
+      bool quoted;
+    };
+
+    const Member *find(const std::string &key) const;
+    Member *find(const std::string &key);
+    std::string serialize() const;
+
+    std::list<Member> _members;
+    bool _success = true;
+};
+
+class DynamicJsonBuffer
+{
+  public:
+    DynamicJsonBuffer(size_t blockSize = 256) { (void) blockSize; }
+
+    JsonObject &createObject() { _objects.emplace_back(); return _objects.back(); }
+    JsonObject &parseObject(const char *json) { JsonObject &o = createObject(); o.parse(json); return o; }
+    JsonObject &parseObject(const String &json) { return parseObject(json.c_str()); }
+
+  private:
+    std::list<JsonObject> _objects;
+};
+
+template <size_t CAPACITY> class StaticJsonBuffer : public DynamicJsonBuffer
+{
+};
+
+template <> inline const char *JsonObjectSubscript::as<const char *>() const { return *this; }
+template <> inline String JsonObjectSubscript::as<String>() const { return String((const char *) *this); }
+template <> inline long JsonObjectSubscript::as<long>() const { return atol(*this); }
+template <> inline int JsonObjectSubscript::as<int>() const { return atoi(*this); }
+template <> inline float JsonObjectSubscript::as<float>() const { return atof(*this); }
+template <> inline double JsonObjectSubscript::as<double>() const { return atof(*this); }
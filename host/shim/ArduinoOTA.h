@@ -0,0 +1,46 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - ArduinoOTA stand-in                    */
+/*                                                      */
+/*  No update ever arrives; handlers are only stored.   */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+
+typedef enum
+{
+  OTA_AUTH_ERROR,
+  OTA_BEGIN_ERROR,
+  OTA_CONNECT_ERROR,
+  OTA_RECEIVE_ERROR,
+  OTA_END_ERROR
+} ota_error_t;
+
+class ArduinoOTAClass
+{
+  public:
+    typedef std::function<void(void)> THandlerFunction;
+    typedef std::function<void(ota_error_t)> THandlerFunction_Error;
+    typedef std::function<void(unsigned int, unsigned int)> THandlerFunction_Progress;
+
+    void setPort(uint16_t port) { (void) port; }
+    void setHostname(const char *hostname) { (void) hostname; }
+    void setPassword(const char *password) { (void) password; }
+    void onStart(THandlerFunction fn) { _startCallback = fn; }
+    void onEnd(THandlerFunction fn) { _endCallback = fn; }
+    void onError(THandlerFunction_Error fn) { _errorCallback = fn; }
+    void onProgress(THandlerFunction_Progress fn) { _progressCallback = fn; }
+    void begin() {}
+    void handle() {}
+
+  private:
+    THandlerFunction _startCallback;
+    THandlerFunction _endCallback;
+    THandlerFunction_Error _errorCallback;
+    THandlerFunction_Progress _progressCallback;
+};
+
+extern ArduinoOTAClass ArduinoOTA;
@@ -0,0 +1,49 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - ClosedCube HDC1080 library stand-in    */
+/*                                                      */
+/*  Same register traffic as the real library: pointer */
+/*  write, conversion wait, 2 byte read.                */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+#include "Wire.h"
+
+class ClosedCube_HDC1080
+{
+  public:
+    void begin(uint8_t address)
+    {
+      _address = address;
+      Wire.begin();
+      Wire.beginTransmission(_address);
+      Wire.write(0x02);   // Configuration: 14 bit temperature and humidity
+      Wire.write(0x00);
+      Wire.write(0x00);
+      Wire.endTransmission();
+    }
+
+    double readTemperature() { return readData(0x00) / 65536.0 * 165.0 - 40.0; }
+    double readHumidity() { return readData(0x01) / 65536.0 * 100.0; }
+    uint16_t readManufacturerId() { return readData(0xFE); }
+    uint16_t readDeviceId() { return readData(0xFF); }
+
+  private:
+    uint16_t readData(uint8_t pointer)
+    {
+      Wire.beginTransmission(_address);
+      Wire.write(pointer);
+      Wire.endTransmission();
+
+      delay(9);
+      if (Wire.requestFrom(_address, (size_t) 2) != 2)
+        return 0;
+      uint16_t msb = Wire.read();
+      return (msb << 8) | Wire.read();
+    }
+
+    uint8_t _address = 0x40;
+};
@@ -0,0 +1,101 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - ESP8266HTTPClient stand-in             */
+/*                                                      */
+/********************************************************/
+
+#include "ESP8266HTTPClient.h"
+
+bool HTTPClient::begin(const String &url)
+{
+  String rest = url;
+  int scheme = rest.indexOf(F("://"));
+  if (scheme >= 0)
+    rest = rest.substring(scheme + 3);
+
+  int slash = rest.indexOf('/');
+  String hostPort = slash >= 0 ? rest.substring(0, slash) : rest;
+  _uri = slash >= 0 ? rest.substring(slash) : String(F("/"));
+
+  int colon = hostPort.indexOf(':');
+  if (colon >= 0)
+  {
+    _host = hostPort.substring(0, colon);
+    _port = hostPort.substring(colon + 1).toInt();
+  }
+  else
+  {
+    _host = hostPort;
+    _port = 80;
+  }
+  return _host.length() > 0;
+}
+
+// Sends the request and consumes the response header, leaving the body in the stream
+int HTTPClient::GET()
+{
+  _size = -1;
+  if (!_client.connected() && !_client.connect(_host.c_str(), _port))
+    return HTTPC_ERROR_CONNECTION_REFUSED;
+
+  String request = String(F("GET ")) + _uri + F(" HTTP/1.1\r\nHost: ") + _host + F("\r\nUser-Agent: ") + _userAgent +
+                   F("\r\nConnection: ") + (_reuse ? F("keep-alive") : F("close")) + F("\r\n") + _headers + F("\r\n");
+  _client.print(request);
+
+  _client.setTimeout(5000);
+  String status = _client.readStringUntil('\n');
+  if (!status.startsWith(F("HTTP/1.")))
+    return HTTPC_ERROR_NO_HTTP_SERVER;
+  int code = status.substring(9, 12).toInt();
+
+  while (_client.connected())
+  {
+    String line = _client.readStringUntil('\n');
+    line.trim();
+    if (line.length() == 0)
+      break;
+    String lower = line;
+    lower.toLowerCase();
+    if (lower.startsWith(F("content-length:")))
+      _size = line.substring(15).toInt();
+  }
+  return code;
+}
+
+String HTTPClient::getString()
+{
+  String body;
+  int len = _size;
+  while (_client.connected() && (len > 0 || len == -1))
+  {
+    int c = _client.read();
+    if (c < 0)
+    {
+      delay(1);
+      continue;
+    }
+    body += (char) c;
+    if (len > 0)
+      len--;
+  }
+  return body;
+}
+
+String HTTPClient::errorToString(int error)
+{
+  switch (error)
+  {
+    case HTTPC_ERROR_CONNECTION_REFUSED:
+      return F("connection refused");
+    case HTTPC_ERROR_SEND_HEADER_FAILED:
+      return F("send header failed");
+    case HTTPC_ERROR_CONNECTION_LOST:
+      return F("connection lost");
+    case HTTPC_ERROR_NO_HTTP_SERVER:
+      return F("no HTTP server");
+    case HTTPC_ERROR_READ_TIMEOUT:
+      return F("read Timeout");
+    default:
+      return String();
+  }
+}
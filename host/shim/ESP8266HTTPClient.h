@@ -0,0 +1,56 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - ESP8266HTTPClient stand-in             */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+#include "WiFiClient.h"
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED (-2)
+#define HTTPC_ERROR_CONNECTION_LOST    (-5)
+#define HTTPC_ERROR_NO_HTTP_SERVER     (-7)
+#define HTTPC_ERROR_READ_TIMEOUT       (-11)
+
+typedef enum
+{
+  HTTP_CODE_OK = 200,
+  HTTP_CODE_MOVED_PERMANENTLY = 301,
+  HTTP_CODE_FOUND = 302,
+  HTTP_CODE_NOT_MODIFIED = 304,
+  HTTP_CODE_BAD_REQUEST = 400,
+  HTTP_CODE_NOT_FOUND = 404,
+  HTTP_CODE_INTERNAL_SERVER_ERROR = 500
+} t_http_codes;
+
+class HTTPClient
+{
+  public:
+    bool begin(const String &url);
+    bool begin(const String &host, uint16_t port, const String &uri) { _host = host; _port = port; _uri = uri; return true; }
+    void end() { _client.stop(); }
+    void setReuse(bool reuse) { _reuse = reuse; }
+    void setUserAgent(const String &userAgent) { _userAgent = userAgent; }
+    void addHeader(const String &name, const String &value) { _headers += name + F(": ") + value + F("\r\n"); }
+
+    int GET();
+    int getSize() { return _size; }
+    bool connected() { return _client.connected(); }
+    WiFiClient &getStream() { return _client; }
+    WiFiClient *getStreamPtr() { return &_client; }
+    String getString();
+    static String errorToString(int error);
+
+  private:
+    WiFiClient _client;
+    String _host;
+    uint16_t _port = 80;
+    String _uri;
+    String _headers;
+    String _userAgent = F("ESP8266HTTPClient");
+    bool _reuse = false;
+    int _size = -1;
+};
@@ -0,0 +1,18 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - ESP8266WebServer stand-in              */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "ESP8266WiFi.h"
+
+class ESP8266WebServer
+{
+  public:
+    ESP8266WebServer(int port = 80) { (void) port; }
+    void begin() {}
+    void handleClient() {}
+    void stop() {}
+};
@@ -0,0 +1,268 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - ESP8266WiFi stand-in                   */
+/*                                                      */
+/********************************************************/
+
+#include "ESP8266WiFi.h"
+#include "HostSim.h"
+
+ESP8266WiFiClass WiFi;
+
+namespace host
+{
+  bool online = false;
+  std::function<bool(const std::string &host, uint16_t port, const std::string &request, std::string &response)> server;
+  uint64_t networkLatency = 40000;
+  uint64_t networkBandwidth = 150000;
+  uint64_t webDownFrom = 0;
+  uint64_t webDownUntil = 0;
+  uint64_t webStallFrom = 0;
+  uint64_t webStallUntil = 0;
+  uint64_t webHangupFrom = 0;
+  uint64_t webHangupUntil = 0;
+}
+
+// Connect attempts to an unreachable server give up after this (us), as on the ESP8266
+#define HOST_CONNECT_TIMEOUT 5000000
+
+// -------------------------------------------------------
+// Station
+// -------------------------------------------------------
+
+bool ESP8266WiFiClass::mode(WiFiMode_t m)
+{
+  _mode = m;
+  if (m == WIFI_OFF)
+    hostSetLink(false);
+  return true;
+}
+
+wl_status_t ESP8266WiFiClass::begin()
+{
+  hostSetLink(host::online && _mode != WIFI_OFF);
+  return status();
+}
+
+wl_status_t ESP8266WiFiClass::begin(const char *ssid, const char *passphrase)
+{
+  (void) ssid;
+  (void) passphrase;
+  return begin();
+}
+
+bool ESP8266WiFiClass::disconnect(bool wifioff)
+{
+  hostSetLink(false);
+  if (wifioff)
+    _mode = WIFI_OFF;
+  return true;
+}
+
+wl_status_t ESP8266WiFiClass::status()
+{
+  return _associated ? WL_CONNECTED : WL_DISCONNECTED;
+}
+
+WiFiEventHandler ESP8266WiFiClass::onStationModeGotIP(std::function<void(const WiFiEventStationModeGotIP &)> f)
+{
+  WiFiEventHandler handler = std::make_shared<WiFiEventHandlerOpaque>();
+  handler->fire = [f]()
+  {
+    WiFiEventStationModeGotIP event;
+    event.ip = IPAddress(192, 168, 1, 66);
+    event.mask = IPAddress(255, 255, 255, 0);
+    event.gw = IPAddress(192, 168, 1, 1);
+    f(event);
+  };
+  _gotIP.push_back(handler);
+  return handler;
+}
+
+WiFiEventHandler ESP8266WiFiClass::onStationModeDisconnected(std::function<void(const WiFiEventStationModeDisconnected &)> f)
+{
+  WiFiEventHandler handler = std::make_shared<WiFiEventHandlerOpaque>();
+  handler->fire = [f]()
+  {
+    WiFiEventStationModeDisconnected event;
+    event.ssid = F("HOSTNET");
+    memset(event.bssid, 0, sizeof(event.bssid));
+    event.reason = 8;
+    f(event);
+  };
+  _disconnected.push_back(handler);
+  return handler;
+}
+
+void ESP8266WiFiClass::hostSetLink(bool up)
+{
+  if (up == _associated)
+    return;
+
+  _associated = up;
+  for (auto &weak : up ? _gotIP : _disconnected)
+  {
+    if (auto handler = weak.lock())
+      handler->fire();
+  }
+}
+
+// -------------------------------------------------------
+// Client
+// -------------------------------------------------------
+
+unsigned long WiFiClient::connections = 0;
+unsigned long WiFiClient::requests = 0;
+unsigned long WiFiClient::bytesReceived = 0;
+
+int WiFiClient::connect(const char *host, uint16_t port)
+{
+  stop();
+
+  if (!host::online || WiFi.status() != WL_CONNECTED)
+    return 0;
+
+  uint64_t now = host::micros64();
+  if (now >= host::webDownFrom && now < host::webDownUntil)
+  {
+    host::advance(HOST_CONNECT_TIMEOUT);
+    return 0;
+  }
+
+  // TCP handshake
+  host::advance(host::networkLatency / 2);
+
+  _open = true;
+  _peerClosed = false;
+  _host = host;
+  _port = port;
+  connections++;
+  return 1;
+}
+
+uint8_t WiFiClient::connected()
+{
+  if (!_open)
+    return 0;
+  return !_peerClosed || _responseIndex < _response.size();
+}
+
+void WiFiClient::stop()
+{
+  _open = false;
+  _peerClosed = false;
+  _request.clear();
+  _response.clear();
+  _responseIndex = 0;
+  _streamBase = 0;
+  _streamStart = 0;
+}
+
+size_t WiFiClient::write(const uint8_t *buf, size_t size)
+{
+  if (!_open || _peerClosed)
+    return 0;
+
+  _request.append((const char *) buf, size);
+  serveRequest();
+  return size;
+}
+
+// Answer every complete request in the outgoing stream, in order (pipelining)
+void WiFiClient::serveRequest()
+{
+  size_t end;
+  while ((end = _request.find("\r\n\r\n")) != std::string::npos)
+  {
+    std::string request = _request.substr(0, end + 4);
+    _request.erase(0, end + 4);
+    requests++;
+
+    uint64_t at = host::micros64();
+    if (at >= host::webStallFrom && at < host::webStallUntil)
+      continue;
+    if (at >= host::webHangupFrom && at < host::webHangupUntil)
+    {
+      _peerClosed = true;
+      return;
+    }
+
+    std::string response;
+    if (!host::server || !host::server(_host.str(), _port, request, response))
+    {
+      _peerClosed = true;
+      return;
+    }
+
+    // Drop what was already consumed, then queue the new response. It starts streaming
+    // after half a round trip, or right behind the previous one if that is still arriving.
+    // The stream is re-anchored at the bytes arrived so far, so dropping consumed bytes
+    // does not make the ones still in flight arrive early.
+    uint64_t now = host::micros64();
+    size_t ready = arrived();
+    bool idle = ready >= _response.size();
+    _response.erase(0, _responseIndex);
+    ready -= _responseIndex;
+    _responseIndex = 0;
+    if (idle)
+    {
+      _streamBase = _response.size();
+      _streamStart = now + host::networkLatency / 2;
+    }
+    else
+    {
+      _streamBase = ready;
+      if (now > _streamStart)
+        _streamStart = now;
+    }
+    _response += response;
+
+    String lower(request);
+    lower.toLowerCase();
+    if (lower.indexOf(F("connection: keep-alive")) < 0)
+      _peerClosed = true;
+  }
+}
+
+// Bytes of the response buffer that reached the device so far
+size_t WiFiClient::arrived() const
+{
+  uint64_t now = host::micros64();
+  if (now < _streamStart)
+    return std::min(_streamBase, _response.size());
+  uint64_t bytes = (now - _streamStart) * host::networkBandwidth / 1000000;
+  return std::min<uint64_t>(_streamBase + bytes, _response.size());
+}
+
+int WiFiClient::available()
+{
+  if (!_open)
+    return 0;
+  size_t ready = arrived();
+  return ready > _responseIndex ? (int) (ready - _responseIndex) : 0;
+}
+
+int WiFiClient::read()
+{
+  if (available() <= 0)
+    return -1;
+  bytesReceived++;
+  return (uint8_t) _response[_responseIndex++];
+}
+
+int WiFiClient::read(uint8_t *buf, size_t size)
+{
+  int ready = available();
+  if (ready <= 0)
+    return 0;
+  size = std::min(size, (size_t) ready);
+  memcpy(buf, _response.data() + _responseIndex, size);
+  _responseIndex += size;
+  bytesReceived += size;
+  return size;
+}
+
+int WiFiClient::peek()
+{
+  return available() > 0 ? (uint8_t) _response[_responseIndex] : -1;
+}
@@ -0,0 +1,100 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - ESP8266WiFi stand-in                   */
+/*                                                      */
+/*  The station associates only with --online.          */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+#include "IPAddress.h"
+#include "WiFiClient.h"
+#include "WiFiUdp.h"
+
+typedef enum
+{
+  WL_NO_SHIELD = 255,
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_SCAN_COMPLETED = 2,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum WiFiMode
+{
+  WIFI_OFF = 0,
+  WIFI_STA = 1,
+  WIFI_AP = 2,
+  WIFI_AP_STA = 3
+} WiFiMode_t;
+
+typedef enum WiFiSleepType
+{
+  WIFI_NONE_SLEEP = 0,
+  WIFI_LIGHT_SLEEP = 1,
+  WIFI_MODEM_SLEEP = 2
+} WiFiSleepType_t;
+
+struct WiFiEventStationModeGotIP
+{
+  IPAddress ip;
+  IPAddress mask;
+  IPAddress gw;
+};
+
+struct WiFiEventStationModeDisconnected
+{
+  String ssid;
+  uint8_t bssid[6];
+  uint8_t reason;
+};
+
+struct WiFiEventHandlerOpaque
+{
+  std::function<void()> fire;
+};
+
+typedef std::shared_ptr<WiFiEventHandlerOpaque> WiFiEventHandler;
+
+class ESP8266WiFiClass
+{
+  public:
+    bool mode(WiFiMode_t m);
+    WiFiMode_t getMode() { return _mode; }
+    wl_status_t begin();
+    wl_status_t begin(const char *ssid, const char *passphrase = NULL);
+    bool disconnect(bool wifioff = false);
+    bool hostname(const String &name) { _hostname = name; return true; }
+    String hostname() { return _hostname; }
+    wl_status_t status();
+    bool isConnected() { return status() == WL_CONNECTED; }
+    bool setSleepMode(WiFiSleepType_t type) { _sleepType = type; return true; }
+    WiFiSleepType_t getSleepMode() { return _sleepType; }
+
+    String macAddress() { return F("5C:CF:7F:A7:30:5C"); }
+    String SSID() { return status() == WL_CONNECTED ? String(F("HOSTNET")) : String(); }
+    IPAddress localIP() { return status() == WL_CONNECTED ? IPAddress(192, 168, 1, 66) : IPAddress(); }
+    int32_t RSSI() { return status() == WL_CONNECTED ? -67 : 31; }
+
+    WiFiEventHandler onStationModeGotIP(std::function<void(const WiFiEventStationModeGotIP &)> f);
+    WiFiEventHandler onStationModeDisconnected(std::function<void(const WiFiEventStationModeDisconnected &)> f);
+
+    // Host only: drop or restore the link, firing the station events
+    void hostSetLink(bool up);
+
+  private:
+    WiFiMode_t _mode = WIFI_STA;
+    WiFiSleepType_t _sleepType = WIFI_MODEM_SLEEP;
+    bool _associated = false;
+    String _hostname;
+    std::vector<std::weak_ptr<WiFiEventHandlerOpaque>> _gotIP;
+    std::vector<std::weak_ptr<WiFiEventHandlerOpaque>> _disconnected;
+    std::function<void(const WiFiEventStationModeGotIP &)> _gotIPCallback;
+};
+
+extern ESP8266WiFiClass WiFi;
@@ -0,0 +1,16 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - ESP8266WiFiMulti stand-in              */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "ESP8266WiFi.h"
+
+class ESP8266WiFiMulti
+{
+  public:
+    bool addAP(const char *ssid, const char *passphrase = NULL) { (void) ssid; (void) passphrase; return true; }
+    wl_status_t run() { return WiFi.status(); }
+};
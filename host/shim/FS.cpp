@@ -0,0 +1,243 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - SPIFFS stand-in                        */
+/*                                                      */
+/********************************************************/
+
+#include "FS.h"
+#include "HostSim.h"
+
+#include <filesystem>
+
+namespace stdfs = std::filesystem;
+
+fs::FS SPIFFS;
+
+// Same as an ESP-12E 4M flash with 3M SPIFFS
+#define HOST_SPIFFS_SIZE (3 * 1024 * 1024 - 16 * 1024)
+
+// SPIFFS on the ESP8266 flash: each read call looks up its page (~25 us),
+// then the data comes at ~650 KB/s
+#define READ_CALL_NANOS 25000
+#define READ_BYTE_NANOS 1500
+
+namespace fs
+{
+  // -------------------------------------------------------
+  // File
+  // -------------------------------------------------------
+
+  unsigned long File::reads = 0;
+  unsigned long File::bytesRead = 0;
+  static uint64_t readNanos = 0;
+  static uint64_t readNanosCharged = 0;
+
+  static void chargeRead(size_t bytes)
+  {
+    File::reads++;
+    File::bytesRead += bytes;
+    readNanos += READ_CALL_NANOS + (uint64_t) bytes * READ_BYTE_NANOS;
+
+    uint64_t us = (readNanos - readNanosCharged) / 1000;
+    if (us)
+    {
+      readNanosCharged += us * 1000;
+      host::advance(us);
+    }
+  }
+
+  uint64_t File::readMicros()
+  {
+    return readNanos / 1000;
+  }
+
+  size_t File::write(const uint8_t *buf, size_t size)
+  {
+    if (!_fp)
+      return 0;
+    return fwrite(buf, 1, size, _fp.get());
+  }
+
+  int File::available()
+  {
+    if (!_fp)
+      return 0;
+    return size() - position();
+  }
+
+  int File::read()
+  {
+    if (!_fp)
+      return -1;
+    int c = fgetc(_fp.get());
+    chargeRead(c == EOF ? 0 : 1);
+    return c;
+  }
+
+  int File::peek()
+  {
+    if (!_fp)
+      return -1;
+    int c = fgetc(_fp.get());
+    if (c != EOF)
+      ungetc(c, _fp.get());
+    return c;
+  }
+
+  void File::flush()
+  {
+    if (_fp)
+      fflush(_fp.get());
+  }
+
+  size_t File::read(uint8_t *buf, size_t size)
+  {
+    if (!_fp)
+      return 0;
+    size_t n = fread(buf, 1, size, _fp.get());
+    chargeRead(n);
+    return n;
+  }
+
+  bool File::seek(uint32_t pos, SeekMode mode)
+  {
+    if (!_fp)
+      return false;
+    int whence = mode == SeekSet ? SEEK_SET : (mode == SeekCur ? SEEK_CUR : SEEK_END);
+    return fseek(_fp.get(), pos, whence) == 0;
+  }
+
+  size_t File::position() const
+  {
+    if (!_fp)
+      return 0;
+    return ftell(_fp.get());
+  }
+
+  size_t File::size() const
+  {
+    if (!_fp)
+      return 0;
+    long pos = ftell(_fp.get());
+    fseek(_fp.get(), 0, SEEK_END);
+    long len = ftell(_fp.get());
+    fseek(_fp.get(), pos, SEEK_SET);
+    return len;
+  }
+
+  // -------------------------------------------------------
+  // Dir
+  // -------------------------------------------------------
+
+  size_t Dir::fileSize() const
+  {
+    std::error_code ec;
+    auto len = stdfs::file_size(SPIFFS.hostPath(fileName()), ec);
+    return ec ? 0 : len;
+  }
+
+  File Dir::openFile(const char *mode) const
+  {
+    return SPIFFS.open(fileName(), mode);
+  }
+
+  // -------------------------------------------------------
+  // FS
+  // -------------------------------------------------------
+
+  std::string FS::hostPath(const String &path) const
+  {
+    std::string name = path.str();
+    if (!name.empty() && name[0] == '/')
+      name = name.substr(1);
+    return (stdfs::path(_root) / name).string();
+  }
+
+  bool FS::begin()
+  {
+    std::error_code ec;
+    stdfs::create_directories(_root, ec);
+    return stdfs::is_directory(_root, ec);
+  }
+
+  bool FS::format()
+  {
+    std::error_code ec;
+    for (auto &entry : stdfs::directory_iterator(_root, ec))
+      stdfs::remove_all(entry.path(), ec);
+    return !ec;
+  }
+
+  bool FS::info(FSInfo &info)
+  {
+    size_t used = 0;
+    std::error_code ec;
+    for (auto &entry : stdfs::recursive_directory_iterator(_root, ec))
+    {
+      if (entry.is_regular_file())
+        used += entry.file_size();
+    }
+
+    info.totalBytes = HOST_SPIFFS_SIZE;
+    info.usedBytes = used;
+    info.blockSize = 8192;
+    info.pageSize = 256;
+    info.maxOpenFiles = 5;
+    info.maxPathLength = 32;
+    return true;
+  }
+
+  File FS::open(const String &path, const char *mode)
+  {
+    std::string full = hostPath(path);
+
+    // Writing creates the file, and SPIFFS names may contain '/'
+    if (mode[0] != 'r')
+    {
+      std::error_code ec;
+      stdfs::create_directories(stdfs::path(full).parent_path(), ec);
+    }
+
+    FILE *fp = fopen(full.c_str(), mode);
+    if (!fp)
+      return File();
+    return File(std::shared_ptr<FILE>(fp, fclose), path);
+  }
+
+  bool FS::exists(const String &path)
+  {
+    std::error_code ec;
+    return stdfs::is_regular_file(hostPath(path), ec);
+  }
+
+  bool FS::remove(const String &path)
+  {
+    std::error_code ec;
+    return stdfs::remove(hostPath(path), ec);
+  }
+
+  bool FS::rename(const String &pathFrom, const String &pathTo)
+  {
+    std::error_code ec;
+    stdfs::create_directories(stdfs::path(hostPath(pathTo)).parent_path(), ec);
+    stdfs::rename(hostPath(pathFrom), hostPath(pathTo), ec);
+    return !ec;
+  }
+
+  Dir FS::openDir(const String &path)
+  {
+    std::vector<String> names;
+    std::error_code ec;
+    for (auto &entry : stdfs::recursive_directory_iterator(_root, ec))
+    {
+      if (!entry.is_regular_file())
+        continue;
+
+      String name = String("/") + stdfs::relative(entry.path(), _root).generic_string();
+      if (name.startsWith(path))
+        names.push_back(name);
+    }
+    std::sort(names.begin(), names.end());
+    return Dir(names);
+  }
+}
@@ -0,0 +1,127 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - SPIFFS stand-in                        */
+/*                                                      */
+/*  Files live in a host directory (--spiffs). SPIFFS   */
+/*  has a flat namespace, so openDir() lists every file */
+/*  whose name starts with the given prefix.            */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fs
+{
+  enum SeekMode
+  {
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+  };
+
+  struct FSInfo
+  {
+    size_t totalBytes;
+    size_t usedBytes;
+    size_t blockSize;
+    size_t pageSize;
+    size_t maxOpenFiles;
+    size_t maxPathLength;
+  };
+
+  class File : public Stream
+  {
+    public:
+      File() {}
+      File(std::shared_ptr<FILE> fp, const String &name) : _fp(fp), _name(name) {}
+
+      // Print
+      size_t write(uint8_t c) override { return write(&c, 1); }
+      size_t write(const uint8_t *buf, size_t size) override;
+      using Print::write;
+
+      // Stream
+      int available() override;
+      int read() override;
+      int peek() override;
+      void flush() override;
+
+      size_t read(uint8_t *buf, size_t size);
+      size_t readBytes(char *buffer, size_t length) { return read((uint8_t *) buffer, length); }
+      size_t readBytes(uint8_t *buffer, size_t length) { return read(buffer, length); }
+      bool seek(uint32_t pos, SeekMode mode);
+      bool seek(uint32_t pos) { return seek(pos, SeekSet); }
+      size_t position() const;
+      size_t size() const;
+      void close() { _fp.reset(); }
+      operator bool() const { return (bool) _fp; }
+      const char *name() const { return _name.c_str(); }
+
+      // Host only: read calls and bytes over all files, and the flash time they cost
+      static unsigned long reads;
+      static unsigned long bytesRead;
+      static uint64_t readMicros();
+
+    private:
+      std::shared_ptr<FILE> _fp;
+      String _name;
+  };
+
+  class Dir
+  {
+    public:
+      Dir() {}
+      Dir(const std::vector<String> &names) : _names(names) {}
+
+      bool next() { return ++_index < (int) _names.size(); }
+      String fileName() const { return _names[_index]; }
+      size_t fileSize() const;
+      File openFile(const char *mode) const;
+
+    private:
+      std::vector<String> _names;
+      int _index = -1;
+  };
+
+  class FS
+  {
+    public:
+      bool begin();
+      void end() {}
+      bool format();
+      bool info(FSInfo &info);
+
+      File open(const String &path, const char *mode);
+      bool exists(const String &path);
+      bool remove(const String &path);
+      bool rename(const String &pathFrom, const String &pathTo);
+      Dir openDir(const String &path);
+
+      // Host only: directory backing the file system
+      void setHostRoot(const std::string &root) { _root = root; }
+      std::string hostPath(const String &path) const;
+
+    private:
+      std::string _root = "spiffs";
+  };
+}
+
+#ifndef FS_NO_GLOBALS
+using fs::FS;
+using fs::File;
+using fs::Dir;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
+using fs::FSInfo;
+#endif
+
+extern fs::FS SPIFFS;
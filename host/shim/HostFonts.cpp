@@ -0,0 +1,42 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - fonts                                  */
+/*                                                      */
+/*  The Adafruit free fonts and the numbered TFT_eSPI   */
+/*  fonts live in the library, not in the sketch. They  */
+/*  are mapped here onto the project fonts of similar   */
+/*  size, keeping the original line heights so the     */
+/*  screen layouts come out the same.                   */
+/*                                                      */
+/********************************************************/
+
+#include "TFT_eSPI.h"
+
+#include "artwork.h"
+#include "ArialRoundedMTBold_14.h"
+#include "ArialRoundedMTBold_36.h"
+
+// Free fonts used by the screens (see Free_Fonts.h)
+const GFXfont FreeSans9pt7b = { (uint8_t *) Dialog_plain_15Bitmaps, (GFXglyph *) Dialog_plain_15Glyphs, 0x20, 0x7D, 22 };
+const GFXfont FreeSansBold9pt7b = { (uint8_t *) ArialRoundedMTBold_14Bitmaps, (GFXglyph *) ArialRoundedMTBold_14Glyphs, 0x20, 0x7D, 22 };
+const GFXfont FreeSansBold12pt7b = { (uint8_t *) ArialRoundedMTBold_14Bitmaps, (GFXglyph *) ArialRoundedMTBold_14Glyphs, 0x20, 0x7D, 29 };
+const GFXfont FreeMono9pt7b = { (uint8_t *) Dialog_plain_13Bitmaps, (GFXglyph *) Dialog_plain_13Glyphs, 0x20, 0x7D, 18 };
+
+// Numbered fonts: 1 GLCD 8px, 2 16px, 4 26px, 6/7/8 large digits
+static const GFXfont font1 = { (uint8_t *) Dialog_plain_9Bitmaps, (GFXglyph *) Dialog_plain_9Glyphs, 0x20, 0x7D, 8 };
+static const GFXfont font2 = { (uint8_t *) Dialog_plain_12Bitmaps, (GFXglyph *) Dialog_plain_12Glyphs, 0x20, 0x7D, 16 };
+static const GFXfont font4 = { (uint8_t *) Dialog_plain_15Bitmaps, (GFXglyph *) Dialog_plain_15Glyphs, 0x20, 0x7D, 26 };
+static const GFXfont font6 = { (uint8_t *) ArialRoundedMTBold_36Bitmaps, (GFXglyph *) ArialRoundedMTBold_36Glyphs, 0x20, 0x7D, 48 };
+
+const GFXfont *hostNumberedFont(uint8_t font)
+{
+  switch (font)
+  {
+    case 2: return &font2;
+    case 4: return &font4;
+    case 6:
+    case 7:
+    case 8: return &font6;
+    default: return &font1;
+  }
+}
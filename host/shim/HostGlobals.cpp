@@ -0,0 +1,14 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - library singletons                     */
+/*                                                      */
+/********************************************************/
+
+#include "ArduinoOTA.h"
+#include "SPI.h"
+#include "SoftwareSerial.h"
+
+ArduinoOTAClass ArduinoOTA;
+SPIClass SPI;
+HostUart::Peer SoftwareSerial::hostPeer;
+uint32_t SoftwareSerial::hostPeerLatency = 0;
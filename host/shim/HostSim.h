@@ -0,0 +1,75 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - simulation hooks                       */
+/*                                                      */
+/*  Used by host/main.cpp and the device models to     */
+/*  drive the virtual clock and the pin interrupts.     */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace host
+{
+  // Sleep for real in delay() instead of advancing the virtual clock
+  extern bool realtime;
+
+  // Extra diagnostics on stderr (syslog, MQTT publishes...)
+  extern bool verbose;
+
+  // Current virtual time in microseconds
+  uint64_t micros64();
+
+  // Advance the virtual clock without sleeping, then fire due interrupts
+  void advance(uint64_t us);
+
+  // Fire the interrupts that became due
+  void pump();
+
+  // Register an interrupt source on a pin: nextInterval() returns the time to the next edge (us)
+  void addPulseSource(uint8_t pin, std::function<uint64_t()> nextInterval);
+
+  // Value returned by analogRead() on a pin
+  void setAnalogSource(uint8_t pin, std::function<int()> source);
+
+  // Number of interrupts delivered so far, per pin
+  unsigned long interruptCount(uint8_t pin);
+
+  // Total time spent in delay() / delayMicroseconds(), in microseconds
+  uint64_t delayedMicros();
+
+  // Called on ESP.restart() before the process exits
+  extern std::function<void()> onRestart;
+
+  // Network reachable: WiFi associates and the canned servers answer
+  extern bool online;
+
+  // Canned server reachable from WiFiClient: given host, port and the raw request,
+  // fills in the raw HTTP response. Returns false if nothing listens there.
+  extern std::function<bool(const std::string &host, uint16_t port, const std::string &request, std::string &response)> server;
+
+  // MQTT broker unresponsive (CONNECT unanswered, link dropped) in [from, until) virtual us
+  extern uint64_t brokerDownFrom;
+  extern uint64_t brokerDownUntil;
+
+  // Web servers unreachable in [from, until) virtual us: WiFi stays up, connects time out
+  extern uint64_t webDownFrom;
+  extern uint64_t webDownUntil;
+
+  // Web servers accept connections in [from, until) virtual us, then stay silent (stall)
+  // or close without answering (hangup)
+  extern uint64_t webStallFrom;
+  extern uint64_t webStallUntil;
+  extern uint64_t webHangupFrom;
+  extern uint64_t webHangupUntil;
+
+  // Round trip time charged to the virtual clock per request (us)
+  extern uint64_t networkLatency;
+
+  // Throughput of the WiFi link once a response streams in (bytes/s)
+  extern uint64_t networkBandwidth;
+}
@@ -0,0 +1,42 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - IPAddress stand-in                     */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+
+class IPAddress
+{
+  public:
+    IPAddress() {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _address{a, b, c, d} {}
+    IPAddress(uint32_t address) { memcpy(_address, &address, 4); }
+
+    operator uint32_t() const { uint32_t a; memcpy(&a, _address, 4); return a; }
+    uint8_t operator [](int index) const { return _address[index]; }
+
+    String toString() const
+    {
+      char buf[16];
+      snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _address[0], _address[1], _address[2], _address[3]);
+      return String(buf);
+    }
+
+    bool fromString(const String &address)
+    {
+      unsigned a, b, c, d;
+      if (sscanf(address.c_str(), "%u.%u.%u.%u", &a, &b, &c, &d) != 4)
+        return false;
+      _address[0] = a;
+      _address[1] = b;
+      _address[2] = c;
+      _address[3] = d;
+      return true;
+    }
+
+  private:
+    uint8_t _address[4] = {0, 0, 0, 0};
+};
@@ -0,0 +1,115 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - JPEGDecoder stand-in                   */
+/*                                                      */
+/********************************************************/
+
+#include "JPEGDecoder.h"
+#include "HostSim.h"
+
+JPEGDecoder JpegDec;
+
+#define DECODE_NANOS_PER_PIXEL 2000
+
+bool JPEGDecoder::decodeFsFile(const String &filename)
+{
+  fs::File file = SPIFFS.open(filename, "r");
+  if (!file)
+    return false;
+
+  std::vector<uint8_t> data(file.size());
+  data.resize(file.read(data.data(), data.size()));
+  file.close();
+  return start(data);
+}
+
+bool JPEGDecoder::decodeArray(const uint8_t array[], uint32_t length)
+{
+  return start(std::vector<uint8_t>(array, array + length));
+}
+
+// Walk the markers up to the first SOF0/SOF1/SOF2
+bool JPEGDecoder::start(const std::vector<uint8_t> &data)
+{
+  _active = false;
+  if (data.size() < 4 || data[0] != 0xFF || data[1] != 0xD8)
+    return false;
+
+  size_t i = 2;
+  while (i + 9 < data.size())
+  {
+    if (data[i] != 0xFF)
+      return false;
+
+    uint8_t marker = data[i + 1];
+    uint16_t length = (data[i + 2] << 8) | data[i + 3];
+    if (marker >= 0xC0 && marker <= 0xC2)
+    {
+      height = (data[i + 5] << 8) | data[i + 6];
+      width = (data[i + 7] << 8) | data[i + 8];
+      comps = data[i + 9];
+      break;
+    }
+    i += 2 + length;
+  }
+  if (!width || !height)
+    return false;
+
+  _seed = 2166136261u;
+  for (uint8_t b : data)
+    _seed = (_seed ^ b) * 16777619u;
+
+  MCUSPerRow = (width + MCUWidth - 1) / MCUWidth;
+  MCUSPerCol = (height + MCUHeight - 1) / MCUHeight;
+  scanType = comps == 1 ? 0 : 4;
+  MCUx = MCUy = 0;
+  _next = 0;
+  _active = true;
+  return true;
+}
+
+// Smooth colour gradient seeded by the file hash
+int JPEGDecoder::nextMCU(bool swapped)
+{
+  if (!_active || _next >= MCUSPerRow * MCUSPerCol)
+  {
+    _active = false;
+    return 0;
+  }
+
+  MCUx = _next % MCUSPerRow;
+  MCUy = _next / MCUSPerRow;
+  _next++;
+
+  for (int y = 0; y < MCUHeight; y++)
+    for (int x = 0; x < MCUWidth; x++)
+    {
+      int px = MCUx * MCUWidth + x;
+      int py = MCUy * MCUHeight + y;
+      uint8_t r = (uint8_t) ((_seed & 0xFF) + px);
+      uint8_t g = (uint8_t) (((_seed >> 8) & 0xFF) + py);
+      uint8_t b = (uint8_t) (((_seed >> 16) & 0xFF) + px + py);
+      uint16_t c = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+      _mcu[y * MCUWidth + x] = swapped ? (uint16_t) ((c >> 8) | (c << 8)) : c;
+    }
+
+  pImage = _mcu;
+  _decodedPixels += MCUWidth * MCUHeight;
+  host::advance(MCUWidth * MCUHeight * DECODE_NANOS_PER_PIXEL / 1000);
+  return 1;
+}
+
+int JPEGDecoder::read()
+{
+  return nextMCU(false);
+}
+
+int JPEGDecoder::readSwappedBytes()
+{
+  return nextMCU(true);
+}
+
+void JPEGDecoder::abort()
+{
+  _active = false;
+}
@@ -0,0 +1,57 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - JPEGDecoder stand-in                   */
+/*                                                      */
+/*  Reads the frame size from the SOF marker and hands  */
+/*  out 16x16 MCUs of a placeholder image derived from  */
+/*  the file contents. Decoding time is charged to the  */
+/*  virtual clock at the rate measured on the ESP8266   */
+/*  (about 2us per pixel at 160MHz).                    */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+#include "FS.h"
+
+#include <vector>
+
+class JPEGDecoder
+{
+  public:
+    bool decodeFsFile(const String &filename);
+    bool decodeFile(const String &filename) { return decodeFsFile(filename); }
+    bool decodeArray(const uint8_t array[], uint32_t length);
+
+    int read();
+    int readSwappedBytes();
+    void abort();
+
+    uint16_t *pImage = NULL;
+    int width = 0;
+    int height = 0;
+    int comps = 0;
+    int MCUSPerRow = 0;
+    int MCUSPerCol = 0;
+    int scanType = 0;
+    int MCUWidth = 16;
+    int MCUHeight = 16;
+    int MCUx = 0;
+    int MCUy = 0;
+
+    // Host only
+    unsigned long decodedPixels() const { return _decodedPixels; }
+
+  private:
+    bool start(const std::vector<uint8_t> &data);
+    int nextMCU(bool swapped);
+
+    uint16_t _mcu[16 * 16];
+    uint32_t _seed = 0;
+    int _next = 0;
+    bool _active = false;
+    unsigned long _decodedPixels = 0;
+};
+
+extern JPEGDecoder JpegDec;
@@ -0,0 +1,24 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - json-streaming-parser stand-in         */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+
+class JsonListener
+{
+  public:
+    virtual ~JsonListener() {}
+    virtual void whitespace(char c) = 0;
+    virtual void startDocument() = 0;
+    virtual void key(String key) = 0;
+    virtual void value(String value) = 0;
+    virtual void endArray() = 0;
+    virtual void endObject() = 0;
+    virtual void endDocument() = 0;
+    virtual void startArray() = 0;
+    virtual void startObject() = 0;
+};
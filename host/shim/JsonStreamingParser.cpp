@@ -0,0 +1,194 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - json-streaming-parser stand-in         */
+/*                                                      */
+/********************************************************/
+
+#include "JsonStreamingParser.h"
+
+void JsonStreamingParser::reset()
+{
+  _state = STATE_START_DOCUMENT;
+  _stackPos = 0;
+  _bufferPos = 0;
+  _escape = false;
+}
+
+void JsonStreamingParser::parse(char c)
+{
+  if (!_listener)
+    return;
+
+  bool isSpace = c == ' ' || c == '\t' || c == '\n' || c == '\r';
+  if (isSpace && _state != STATE_IN_STRING)
+  {
+    if (_state == STATE_IN_SCALAR)
+      endScalar();
+    _listener->whitespace(c);
+    return;
+  }
+
+  switch (_state)
+  {
+    case STATE_IN_STRING:
+      if (_escape)
+      {
+        buffer(c == 'n' ? '\n' : c == 't' ? '\t' : c == 'r' ? '\r' : c);
+        _escape = false;
+      }
+      else if (c == '\\')
+        _escape = true;
+      else if (c == '"')
+        endString();
+      else
+        buffer(c);
+      break;
+
+    case STATE_IN_SCALAR:
+      if (c == ',' || c == '}' || c == ']')
+      {
+        endScalar();
+        parse(c);
+      }
+      else
+        buffer(c);
+      break;
+
+    case STATE_START_DOCUMENT:
+      _listener->startDocument();
+      if (c == '[' || c == '{')
+        startValue(c);
+      break;
+
+    case STATE_IN_ARRAY:
+      if (c == ']')
+      {
+        _stackPos--;
+        _listener->endArray();
+        endValue();
+      }
+      else
+        startValue(c);
+      break;
+
+    case STATE_IN_OBJECT:
+      if (c == '}')
+      {
+        _stackPos--;
+        _listener->endObject();
+        endValue();
+      }
+      else if (c == '"')
+      {
+        _stack[_stackPos++] = STACK_KEY;
+        _state = STATE_IN_STRING;
+      }
+      break;
+
+    case STATE_END_KEY:
+      if (c == ':')
+        _state = STATE_AFTER_KEY;
+      break;
+
+    case STATE_AFTER_KEY:
+      startValue(c);
+      break;
+
+    case STATE_AFTER_VALUE:
+    {
+      Container within = _stackPos > 0 ? _stack[_stackPos - 1] : STACK_OBJECT;
+      if (within == STACK_OBJECT)
+      {
+        if (c == '}')
+        {
+          _stackPos--;
+          _listener->endObject();
+          endValue();
+        }
+        else if (c == ',')
+          _state = STATE_IN_OBJECT;
+      }
+      else
+      {
+        if (c == ']')
+        {
+          _stackPos--;
+          _listener->endArray();
+          endValue();
+        }
+        else if (c == ',')
+          _state = STATE_IN_ARRAY;
+      }
+      break;
+    }
+
+    case STATE_DONE:
+      break;
+  }
+}
+
+void JsonStreamingParser::startValue(char c)
+{
+  if (_stackPos >= JSON_STACK_SIZE - 1)
+    return;
+
+  if (c == '[')
+  {
+    _stack[_stackPos++] = STACK_ARRAY;
+    _state = STATE_IN_ARRAY;
+    _listener->startArray();
+  }
+  else if (c == '{')
+  {
+    _stack[_stackPos++] = STACK_OBJECT;
+    _state = STATE_IN_OBJECT;
+    _listener->startObject();
+  }
+  else if (c == '"')
+  {
+    _stack[_stackPos++] = STACK_STRING;
+    _state = STATE_IN_STRING;
+  }
+  else
+  {
+    _state = STATE_IN_SCALAR;
+    buffer(c);
+  }
+}
+
+void JsonStreamingParser::endValue()
+{
+  if (_stackPos == 0)
+  {
+    _state = STATE_DONE;
+    _listener->endDocument();
+  }
+  else
+    _state = STATE_AFTER_VALUE;
+}
+
+void JsonStreamingParser::endString()
+{
+  Container popped = _stack[--_stackPos];
+  _buffer[_bufferPos] = 0;
+  _bufferPos = 0;
+
+  if (popped == STACK_KEY)
+  {
+    _listener->key(String(_buffer));
+    _state = STATE_END_KEY;
+  }
+  else
+  {
+    _listener->value(String(_buffer));
+    endValue();
+  }
+}
+
+void JsonStreamingParser::endScalar()
+{
+  _buffer[_bufferPos] = 0;
+  _bufferPos = 0;
+  _listener->value(String(_buffer));
+  endValue();
+}
@@ -0,0 +1,62 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - json-streaming-parser stand-in         */
+/*                                                      */
+/*  Character-at-a-time SAX parser with the same        */
+/*  callbacks as the original: scalars are delivered to */
+/*  value() as text, strings without their quotes.      */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+#include "JsonListener.h"
+
+#define JSON_STACK_SIZE 20
+#define JSON_BUFFER_MAX_LENGTH 512
+
+class JsonStreamingParser
+{
+  public:
+    JsonStreamingParser() { reset(); }
+    void setListener(JsonListener *listener) { _listener = listener; }
+    void parse(char c);
+    void reset();
+
+  private:
+    enum State
+    {
+      STATE_START_DOCUMENT,
+      STATE_DONE,
+      STATE_IN_ARRAY,
+      STATE_IN_OBJECT,
+      STATE_END_KEY,
+      STATE_AFTER_KEY,
+      STATE_IN_STRING,
+      STATE_AFTER_VALUE,
+      STATE_IN_SCALAR
+    };
+
+    enum Container
+    {
+      STACK_OBJECT,
+      STACK_ARRAY,
+      STACK_KEY,
+      STACK_STRING
+    };
+
+    void startValue(char c);
+    void endValue();
+    void endString();
+    void endScalar();
+    void buffer(char c) { if (_bufferPos < JSON_BUFFER_MAX_LENGTH - 1) _buffer[_bufferPos++] = c; }
+
+    JsonListener *_listener = nullptr;
+    State _state;
+    Container _stack[JSON_STACK_SIZE];
+    int _stackPos;
+    char _buffer[JSON_BUFFER_MAX_LENGTH];
+    int _bufferPos;
+    bool _escape;
+};
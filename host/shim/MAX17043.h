@@ -0,0 +1,45 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - MAX17043 fuel gauge library stand-in   */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+#include "Wire.h"
+
+#define MAX17043_ADDRESS 0x36
+
+class MAX17043
+{
+  public:
+    void reset() { writeRegister(0xFE, 0x54, 0x00); }
+    void quickStart() { writeRegister(0x06, 0x40, 0x00); }
+
+    // 12 bit ADC, 1.25mV per LSB
+    float getVCell() { return (readRegister(0x02) >> 4) * 0.00125f; }
+    float getSoC() { uint16_t soc = readRegister(0x04); return (soc >> 8) + (soc & 0xFF) / 256.0f; }
+    int getVersion() { return readRegister(0x08); }
+
+  private:
+    void writeRegister(uint8_t reg, uint8_t msb, uint8_t lsb)
+    {
+      Wire.beginTransmission(MAX17043_ADDRESS);
+      Wire.write(reg);
+      Wire.write(msb);
+      Wire.write(lsb);
+      Wire.endTransmission();
+    }
+
+    uint16_t readRegister(uint8_t reg)
+    {
+      Wire.beginTransmission(MAX17043_ADDRESS);
+      Wire.write(reg);
+      Wire.endTransmission(false);
+      if (Wire.requestFrom(MAX17043_ADDRESS, 2) != 2)
+        return 0;
+      uint16_t msb = Wire.read();
+      return (msb << 8) | Wire.read();
+    }
+};
@@ -0,0 +1,111 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - Grove Multichannel Gas (MiCS6814)      */
+/*  library stand-in                                    */
+/*                                                      */
+/********************************************************/
+
+#include "MutichannelGasSensor.h"
+
+MutichannelGasSensor gas;
+
+void MutichannelGasSensor::begin(int address)
+{
+  i2cAddress = address;
+  Wire.begin();
+  version = getVersion();
+}
+
+unsigned char MutichannelGasSensor::getVersion()
+{
+  // Version 2 firmware answers 1126 when the EEPROM was set at the factory
+  return get_addr_dta(CMD_READ_EEPROM, ADDR_IS_SET) == 1126 ? 2 : 1;
+}
+
+void MutichannelGasSensor::powerOn()
+{
+  dta_test[0] = CMD_CONTROL_PWR;
+  dta_test[1] = 1;
+  write_i2c(dta_test, 2);
+}
+
+void MutichannelGasSensor::powerOff()
+{
+  dta_test[0] = CMD_CONTROL_PWR;
+  dta_test[1] = 0;
+  write_i2c(dta_test, 2);
+}
+
+void MutichannelGasSensor::write_i2c(unsigned char *dta, unsigned char dta_len)
+{
+  Wire.beginTransmission(i2cAddress);
+  for (int i = 0; i < dta_len; i++)
+    Wire.write(dta[i]);
+  Wire.endTransmission();
+}
+
+unsigned int MutichannelGasSensor::get_addr_dta(unsigned char addr_reg)
+{
+  Wire.beginTransmission(i2cAddress);
+  Wire.write(addr_reg);
+  Wire.endTransmission();
+
+  Wire.requestFrom((int) i2cAddress, 2);
+  unsigned int dta = 0;
+  unsigned char raw[2] = { 0, 0 };
+  int cnt = 0;
+  while (Wire.available() && cnt < 2)
+    raw[cnt++] = Wire.read();
+  dta = raw[0] * 256 + raw[1];
+  return dta;
+}
+
+unsigned int MutichannelGasSensor::get_addr_dta(unsigned char addr_reg, unsigned char __dta)
+{
+  Wire.beginTransmission(i2cAddress);
+  Wire.write(addr_reg);
+  Wire.write(__dta);
+  Wire.endTransmission();
+
+  Wire.requestFrom((int) i2cAddress, 2);
+  unsigned int dta = 0;
+  unsigned char raw[2] = { 0, 0 };
+  int cnt = 0;
+  while (Wire.available() && cnt < 2)
+    raw[cnt++] = Wire.read();
+  dta = raw[0] * 256 + raw[1];
+  return dta;
+}
+
+float MutichannelGasSensor::calcGas(int gas)
+{
+  ledOn();
+
+  float A0_0 = get_addr_dta(CMD_READ_EEPROM, ADDR_USER_ADC_HN3);
+  float A0_1 = get_addr_dta(CMD_READ_EEPROM, ADDR_USER_ADC_CO);
+  float A0_2 = get_addr_dta(CMD_READ_EEPROM, ADDR_USER_ADC_NO2);
+
+  float An_0 = get_addr_dta(CH_VALUE_NH3);
+  float An_1 = get_addr_dta(CH_VALUE_CO);
+  float An_2 = get_addr_dta(CH_VALUE_NO2);
+
+  float ratio0 = An_0 / A0_0 * (1023.0 - A0_0) / (1023.0 - An_0);
+  float ratio1 = An_1 / A0_1 * (1023.0 - A0_1) / (1023.0 - An_1);
+  float ratio2 = An_2 / A0_2 * (1023.0 - A0_2) / (1023.0 - An_2);
+
+  float c = 0;
+  switch (gas)
+  {
+    case CO: c = pow(ratio1, -1.179) * 4.385; break;
+    case NO2: c = pow(ratio2, 1.007) / 6.855; break;
+    case NH3: c = pow(ratio0, -1.67) / 1.47; break;
+    case C3H8: c = pow(ratio0, -2.518) * 570.164; break;
+    case C4H10: c = pow(ratio0, -2.138) * 398.107; break;
+    case CH4: c = pow(ratio1, -4.363) * 630.957; break;
+    case H2: c = pow(ratio1, -1.8) * 0.73; break;
+    case C2H5OH: c = pow(ratio1, -1.552) * 1.622; break;
+  }
+
+  ledOff();
+  return isnan(c) ? -3 : c;
+}
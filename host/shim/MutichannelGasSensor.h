@@ -0,0 +1,66 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - Grove Multichannel Gas (MiCS6814)      */
+/*  library stand-in                                    */
+/*                                                      */
+/*  Follows the firmware version 2 code path of the     */
+/*  Seeed library: every measure_xxx() call switches    */
+/*  the LED on, reads the three R0 calibration values   */
+/*  from EEPROM and the three channel ADCs, then        */
+/*  converts with the same curves and switches the LED  */
+/*  off again.                                          */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+#include "Wire.h"
+
+#define CH_VALUE_NH3 1
+#define CH_VALUE_CO  2
+#define CH_VALUE_NO2 3
+
+#define CMD_READ_EEPROM    6
+#define ADDR_IS_SET        0
+#define ADDR_USER_ADC_HN3  8
+#define ADDR_USER_ADC_CO   10
+#define ADDR_USER_ADC_NO2  12
+
+#define CMD_CONTROL_LED 10
+#define CMD_CONTROL_PWR 11
+
+enum { CO, NO2, NH3, C3H8, C4H10, CH4, H2, C2H5OH };
+
+class MutichannelGasSensor
+{
+  public:
+    void begin(int address = 0x04);
+    void powerOn();
+    void powerOff();
+    unsigned char getVersion();
+
+    float measure_NH3() { return calcGas(NH3); }
+    float measure_CO() { return calcGas(CO); }
+    float measure_NO2() { return calcGas(NO2); }
+    float measure_C3H8() { return calcGas(C3H8); }
+    float measure_C4H10() { return calcGas(C4H10); }
+    float measure_CH4() { return calcGas(CH4); }
+    float measure_H2() { return calcGas(H2); }
+    float measure_C2H5OH() { return calcGas(C2H5OH); }
+
+    void ledOn() { dta_test[0] = CMD_CONTROL_LED; dta_test[1] = 1; write_i2c(dta_test, 2); }
+    void ledOff() { dta_test[0] = CMD_CONTROL_LED; dta_test[1] = 0; write_i2c(dta_test, 2); }
+
+  private:
+    float calcGas(int gas);
+    unsigned int get_addr_dta(unsigned char addr_reg);
+    unsigned int get_addr_dta(unsigned char addr_reg, unsigned char __dta);
+    void write_i2c(unsigned char *dta, unsigned char dta_len);
+
+    uint8_t i2cAddress = 0x04;
+    uint8_t dta_test[20];
+    int version = 2;
+};
+
+extern MutichannelGasSensor gas;
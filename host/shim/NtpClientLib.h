@@ -0,0 +1,51 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - NtpClientLib stand-in                  */
+/*                                                      */
+/*  Synchronisation succeeds at once when online.       */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+#include "TimeLib.h"
+
+typedef enum
+{
+  timeSyncd,
+  noResponse,
+  invalidAddress
+} NTPSyncEvent_t;
+
+typedef std::function<void(NTPSyncEvent_t)> onSyncEvent_t;
+
+class NTPClient
+{
+  public:
+    bool begin(String ntpServerName = "pool.ntp.org", int timeOffset = 0, bool daylight = false);
+    bool setInterval(int interval) { (void) interval; return true; }
+    bool setInterval(int shortInterval, int longInterval) { (void) shortInterval; (void) longInterval; return true; }
+    void onNTPSyncEvent(onSyncEvent_t handler) { _onSyncEvent = handler; }
+
+    time_t getTime() { return now(); }
+    time_t getLastNTPSync() { return _lastSyncTime; }
+    time_t getFirstSync() { return _firstSync; }
+    String getTimeStr(time_t moment);
+    String getTimeStr() { return getTimeStr(now()); }
+    String getDateStr(time_t moment);
+    String getDateStr() { return getDateStr(now()); }
+    String getTimeDateString(time_t moment) { return getTimeStr(moment) + " " + getDateStr(moment); }
+    String getTimeDateString() { return getTimeDateString(now()); }
+    bool isSummerTime() { return _daylight; }
+    int getTimeZone() { return _timeZone; }
+
+  private:
+    onSyncEvent_t _onSyncEvent;
+    time_t _lastSyncTime = 0;
+    time_t _firstSync = 0;
+    int _timeZone = 0;
+    bool _daylight = false;
+};
+
+extern NTPClient NTP;
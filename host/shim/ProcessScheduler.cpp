@@ -0,0 +1,118 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - ArduinoProcessScheduler stand-in       */
+/*                                                      */
+/********************************************************/
+
+#include "ProcessScheduler.h"
+
+Process::Process(Scheduler &manager, ProcPriority priority, uint32_t period, int iterations)
+  : _scheduler(manager), _priority(priority), _period(period), _iterations(iterations) {}
+
+bool Process::add(bool enableIfNot)
+{
+  if (_added)
+    return false;
+
+  _added = true;
+  _scheduler._processes.push_back(this);
+  setup();
+
+  if (enableIfNot)
+    enable();
+  return true;
+}
+
+bool Process::remove()
+{
+  if (!_added)
+    return false;
+
+  disable();
+  cleanup();
+  auto &list = _scheduler._processes;
+  list.erase(std::find(list.begin(), list.end(), this));
+  _added = false;
+  return true;
+}
+
+bool Process::enable()
+{
+  if (!_added || _enabled)
+    return false;
+
+  _enabled = true;
+  _scheduledTS = millis();
+  onEnable();
+  return true;
+}
+
+bool Process::disable()
+{
+  if (!_enabled)
+    return false;
+
+  _enabled = false;
+  onDisable();
+  return true;
+}
+
+bool Process::restart()
+{
+  disable();
+  return enable();
+}
+
+bool Process::isDue(uint32_t now) const
+{
+  return _enabled && (_force || (int32_t)(now - _scheduledTS) >= 0);
+}
+
+int Scheduler::run()
+{
+  int serviced = 0;
+
+  for (int level = HIGH_PRIORITY; level < NUM_PRIORITY_LEVELS; level++)
+  {
+    // Round robin within the level, starting after the last serviced process
+    std::vector<Process *> members;
+    for (Process *p : _processes)
+    {
+      if (p->_priority == level)
+        members.push_back(p);
+    }
+
+    for (size_t i = 0; i < members.size(); i++)
+    {
+      size_t index = (_nextInLevel[level] + i) % members.size();
+      Process *p = members[index];
+
+      uint32_t now = millis();
+      if (!p->isDue(now))
+        continue;
+
+      // Like the library, a forced run leaves the schedule alone
+      if (!p->_force)
+        p->_scheduledTS = now + p->_period;
+      p->_force = false;
+      p->_actualTS = now;
+      p->service();
+      serviced++;
+      _serviced++;
+      _nextInLevel[level] = index + 1;
+
+      if (p->_iterations > 0 && --p->_iterations == 0)
+        p->disable();
+    }
+  }
+
+  return serviced;
+}
+
+int Scheduler::getActive() const
+{
+  int active = 0;
+  for (Process *p : _processes)
+    active += p->isEnabled();
+  return active;
+}
@@ -0,0 +1,94 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - ArduinoProcessScheduler stand-in       */
+/*                                                      */
+/*  Same public contract as the original: processes    */
+/*  are serviced by priority level, round robin within  */
+/*  a level, once their period has elapsed.             */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+
+#define RUNTIME_FOREVER -1
+#define SERVICE_CONSTANTLY 0
+
+enum ProcPriority
+{
+  HIGH_PRIORITY = 0,
+  MEDIUM_PRIORITY,
+  LOW_PRIORITY,
+  NUM_PRIORITY_LEVELS
+};
+
+class Scheduler;
+
+class Process
+{
+    friend class Scheduler;
+
+  public:
+    Process(Scheduler &manager, ProcPriority priority, uint32_t period, int iterations = RUNTIME_FOREVER);
+    virtual ~Process() {}
+
+    bool add(bool enableIfNot = false);
+    bool remove();
+    bool enable();
+    bool disable();
+    bool restart();
+    bool force() { _force = true; return true; }
+    void setPeriod(uint32_t period) { _period = period; }
+    uint32_t getPeriod() const { return _period; }
+    void setIterations(int iterations) { _iterations = iterations; }
+    int getIterations() const { return _iterations; }
+    bool isEnabled() const { return _enabled; }
+    bool isNotDestroyed() const { return _added; }
+    ProcPriority getPriority() const { return _priority; }
+    Scheduler &getScheduler() { return _scheduler; }
+    uint32_t getScheduledTS() const { return _scheduledTS; }
+    uint32_t getActualRunTS() const { return _actualTS; }
+
+  protected:
+    virtual void setup() {}
+    virtual void cleanup() {}
+    virtual void onEnable() {}
+    virtual void onDisable() {}
+    virtual void service() = 0;
+
+  private:
+    bool isDue(uint32_t now) const;
+
+    Scheduler &_scheduler;
+    ProcPriority _priority;
+    uint32_t _period;
+    int _iterations;
+    bool _added = false;
+    bool _enabled = false;
+    bool _force = false;
+    uint32_t _scheduledTS = 0;
+    uint32_t _actualTS = 0;
+};
+
+class Scheduler
+{
+    friend class Process;
+
+  public:
+    Scheduler() {}
+
+    // Services due processes; returns how many ran
+    int run();
+    uint32_t getCurrTS() const { return millis(); }
+    int getActive() const;
+    const std::vector<Process *> &getProcesses() const { return _processes; }
+
+    // Host only: total service() calls so far
+    unsigned long hostServiced() const { return _serviced; }
+
+  private:
+    std::vector<Process *> _processes;
+    size_t _nextInLevel[NUM_PRIORITY_LEVELS] = {};
+    unsigned long _serviced = 0;
+};
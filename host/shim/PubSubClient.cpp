@@ -0,0 +1,83 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - PubSubClient stand-in                  */
+/*                                                      */
+/********************************************************/
+
+#include "PubSubClient.h"
+#include "ESP8266WiFi.h"
+#include "HostSim.h"
+
+std::function<void(const char *topic, const uint8_t *payload, size_t length)> PubSubClient::hostOnPublish;
+unsigned long PubSubClient::hostPublished = 0;
+
+namespace host
+{
+  uint64_t brokerDownFrom = 0;
+  uint64_t brokerDownUntil = 0;
+}
+
+static bool brokerDown()
+{
+  uint64_t now = host::micros64();
+  return now >= host::brokerDownFrom && now < host::brokerDownUntil;
+}
+
+bool PubSubClient::connect(const char *id)
+{
+  (void) id;
+
+  if (WiFi.status() != WL_CONNECTED || !_domain || !*_domain)
+  {
+    _state = MQTT_CONNECT_FAILED;
+    return false;
+  }
+
+  // Nothing answers the TCP connection: WiFiClient::connect() waits out the client timeout
+  if (!host::online)
+  {
+    host::advance((uint64_t) _client.getTimeout() * 1000);
+    _state = MQTT_CONNECT_FAILED;
+    return false;
+  }
+
+  // Connected, the broker does not answer CONNECT: readPacket() waits out the socket timeout
+  if (brokerDown())
+  {
+    host::advance(host::networkLatency + (uint64_t) _socketTimeout * 1000000);
+    _state = MQTT_CONNECTION_TIMEOUT;
+    return false;
+  }
+
+  // CONNECT / CONNACK round trip
+  host::advance(host::networkLatency);
+
+  _state = MQTT_CONNECTED;
+  return true;
+}
+
+void PubSubClient::disconnect()
+{
+  _state = MQTT_DISCONNECTED;
+}
+
+bool PubSubClient::connected()
+{
+  if (_state == MQTT_CONNECTED && (WiFi.status() != WL_CONNECTED || brokerDown()))
+    _state = MQTT_CONNECTION_LOST;
+  return _state == MQTT_CONNECTED;
+}
+
+bool PubSubClient::publish(const char *topic, const uint8_t *payload, unsigned int plength, bool retained)
+{
+  (void) retained;
+
+  // Same limit as the library: header + topic + payload must fit the packet buffer
+  if (!connected() || 5 + 2 + strlen(topic) + plength > _bufferSize)
+    return false;
+
+  hostPublished++;
+  if (hostOnPublish)
+    hostOnPublish(topic, payload, plength);
+  return true;
+}
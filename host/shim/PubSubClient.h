@@ -0,0 +1,65 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - PubSubClient stand-in                  */
+/*                                                      */
+/*  The broker is in-process: it accepts a connection   */
+/*  whenever the station is online and records every    */
+/*  publish. connect() blocks like the library's: for   */
+/*  the client timeout when nothing answers the TCP     */
+/*  connection, for the socket timeout when the broker  */
+/*  does not answer CONNECT.                            */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+#include "WiFiClient.h"
+
+#define MQTT_MAX_PACKET_SIZE 128
+#ifndef MQTT_SOCKET_TIMEOUT
+#define MQTT_SOCKET_TIMEOUT 15
+#endif
+
+#define MQTT_CONNECTION_TIMEOUT     -4
+#define MQTT_CONNECTION_LOST        -3
+#define MQTT_CONNECT_FAILED         -2
+#define MQTT_DISCONNECTED           -1
+#define MQTT_CONNECTED               0
+
+class PubSubClient
+{
+  public:
+    PubSubClient(Client &client) : _client(client) {}
+
+    PubSubClient &setServer(const char *domain, uint16_t port) { _domain = domain; _port = port; return *this; }
+    PubSubClient &setClient(Client &client) { (void) client; return *this; }
+    bool setBufferSize(uint16_t size) { if (size == 0) return false; _bufferSize = size; return true; }
+    uint16_t getBufferSize() { return _bufferSize; }
+    PubSubClient &setKeepAlive(uint16_t keepAlive) { (void) keepAlive; return *this; }   // the link never idles out
+    PubSubClient &setSocketTimeout(uint16_t timeout) { _socketTimeout = timeout; return *this; }
+
+    bool connect(const char *id);
+    bool connect(const char *id, const char *user, const char *pass) { (void) user; (void) pass; return connect(id); }
+    void disconnect();
+    bool connected();
+    int state() { return _state; }
+    bool loop() { return connected(); }
+
+    bool publish(const char *topic, const char *payload) { return publish(topic, (const uint8_t *) payload, strlen(payload), false); }
+    bool publish(const char *topic, const char *payload, bool retained) { return publish(topic, (const uint8_t *) payload, strlen(payload), retained); }
+    bool publish(const char *topic, const uint8_t *payload, unsigned int plength) { return publish(topic, payload, plength, false); }
+    bool publish(const char *topic, const uint8_t *payload, unsigned int plength, bool retained);
+
+    // Host only: sees every message accepted by the broker
+    static std::function<void(const char *topic, const uint8_t *payload, size_t length)> hostOnPublish;
+    static unsigned long hostPublished;
+
+  private:
+    Client &_client;
+    const char *_domain = nullptr;   // kept by pointer like the library does
+    uint16_t _port = 0;
+    int _state = MQTT_DISCONNECTED;
+    uint16_t _bufferSize = MQTT_MAX_PACKET_SIZE;
+    uint16_t _socketTimeout = MQTT_SOCKET_TIMEOUT;  // (s)
+};
@@ -0,0 +1,51 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - RingBufCPP stand-in                    */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+template <typename Type, size_t MaxElements> class RingBufCPP
+{
+  public:
+    bool add(const Type &obj)
+    {
+      if (isFull())
+        return false;
+      _buf[_head] = obj;
+      _head = (_head + 1) % MaxElements;
+      _numElements++;
+      return true;
+    }
+
+    bool pull(Type *dest)
+    {
+      if (isEmpty())
+        return false;
+      *dest = _buf[_tail];
+      _tail = (_tail + 1) % MaxElements;
+      _numElements--;
+      return true;
+    }
+
+    // num = 0 is the oldest element
+    Type *peek(size_t num)
+    {
+      if (num >= _numElements)
+        return NULL;
+      return &_buf[(_tail + num) % MaxElements];
+    }
+
+    bool isFull() const { return _numElements >= MaxElements; }
+    bool isEmpty() const { return _numElements == 0; }
+    size_t numElements() const { return _numElements; }
+
+  private:
+    Type _buf[MaxElements];
+    size_t _head = 0;
+    size_t _tail = 0;
+    size_t _numElements = 0;
+};
@@ -0,0 +1,19 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - SPI stand-in                           */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+
+class SPIClass
+{
+  public:
+    void begin() {}
+    void end() {}
+    void setFrequency(uint32_t freq) { (void) freq; }
+};
+
+extern SPIClass SPI;
@@ -0,0 +1,38 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - SoftwareSerial stand-in                */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+
+class SoftwareSerial : public HostUart
+{
+  public:
+    SoftwareSerial(int receivePin, int transmitPin, bool inverseLogic = false, unsigned int buffSize = 64)
+      : _receivePin(receivePin), _transmitPin(transmitPin), _bufferSize(buffSize)
+    {
+      (void) inverseLogic;
+    }
+
+    void begin(long speed)
+    {
+      setBaud(speed);
+      if (!_peer)
+        attachPeer(hostPeer, hostPeerLatency);
+    }
+
+    bool overflow() { return false; }
+    void enableRx(bool on) { (void) on; }
+
+    // Host only: device model attached to every port when it begins
+    static Peer hostPeer;
+    static uint32_t hostPeerLatency;
+
+  private:
+    int _receivePin;
+    int _transmitPin;
+    unsigned int _bufferSize;
+};
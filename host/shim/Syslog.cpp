@@ -0,0 +1,33 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - ESP8266_Syslog stand-in                */
+/*                                                      */
+/********************************************************/
+
+#include "Syslog.h"
+#include "HostSim.h"
+
+#include <cstdarg>
+
+static const char *const severityNames[] = { "EMERG", "ALERT", "CRIT", "ERR", "WARNING", "NOTICE", "INFO", "DEBUG" };
+
+bool Syslog::logf(uint16_t pri, const char *fmt, ...)
+{
+  char buf[512];
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+  return _send(pri, buf);
+}
+
+bool Syslog::_send(uint16_t pri, const char *message)
+{
+  if (!(LOG_MASK(LOG_PRI(pri)) & _priMask))
+    return true;
+
+  _messages++;
+  if (host::verbose || LOG_PRI(pri) <= LOG_ERR)
+    fprintf(stderr, "[%10.3f] %-7s %s\n", millis() / 1000.0, severityNames[LOG_PRI(pri)], message);
+  return true;
+}
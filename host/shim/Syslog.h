@@ -0,0 +1,72 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - ESP8266_Syslog stand-in                */
+/*                                                      */
+/*  Messages go to stderr when --verbose is given.      */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+#include "WiFiUdp.h"
+
+#define SYSLOG_NILVALUE "-"
+
+#define SYSLOG_PROTO_IETF 0
+#define SYSLOG_PROTO_BSD 1
+
+#define LOG_EMERG   0
+#define LOG_ALERT   1
+#define LOG_CRIT    2
+#define LOG_ERR     3
+#define LOG_WARNING 4
+#define LOG_NOTICE  5
+#define LOG_INFO    6
+#define LOG_DEBUG   7
+
+#define LOG_PRIMASK 0x07
+#define LOG_PRI(p) ((p) & LOG_PRIMASK)
+#define LOG_MAKEPRI(fac, pri) (((fac) << 3) | (pri))
+
+#define LOG_KERN   (0 << 3)
+#define LOG_USER   (1 << 3)
+#define LOG_DAEMON (3 << 3)
+#define LOG_LOCAL0 (16 << 3)
+
+#define LOG_MASK(pri) (1 << (pri))
+#define LOG_UPTO(pri) ((1 << ((pri) + 1)) - 1)
+
+class Syslog
+{
+  public:
+    Syslog(UDP &client, uint8_t protocol = SYSLOG_PROTO_IETF) : _client(client), _protocol(protocol) {}
+
+    Syslog &server(const char *server, uint16_t port) { _server = server; _port = port; return *this; }
+    Syslog &deviceHostname(const char *deviceHostname) { _deviceHostname = deviceHostname; return *this; }
+    Syslog &appName(const char *appName) { _appName = appName; return *this; }
+    Syslog &defaultPriority(uint16_t pri = LOG_KERN) { _priDefault = pri; return *this; }
+    Syslog &logMask(uint8_t priMask) { _priMask = priMask; return *this; }
+
+    bool log(uint16_t pri, const __FlashStringHelper *message) { return _send(pri, reinterpret_cast<const char *>(message)); }
+    bool log(uint16_t pri, const String &message) { return _send(pri, message.c_str()); }
+    bool log(uint16_t pri, const char *message) { return _send(pri, message); }
+
+    bool logf(uint16_t pri, const char *fmt, ...) __attribute__ ((format (printf, 3, 4)));
+
+    // Host only
+    unsigned long messages() const { return _messages; }
+
+  private:
+    bool _send(uint16_t pri, const char *message);
+
+    UDP &_client;
+    uint8_t _protocol;
+    String _server;
+    uint16_t _port = 0;
+    String _deviceHostname = SYSLOG_NILVALUE;
+    String _appName = SYSLOG_NILVALUE;
+    uint16_t _priDefault = LOG_KERN;
+    uint8_t _priMask = 0xff;
+    unsigned long _messages = 0;
+};
@@ -0,0 +1,499 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - TFT_eSPI stand-in                      */
+/*                                                      */
+/********************************************************/
+
+#include "TFT_eSPI.h"
+#include "HostSim.h"
+
+// Numbered (non GFX) fonts are proxied by the project fonts, see HostFonts.cpp
+const GFXfont *hostNumberedFont(uint8_t font);
+
+// ILI9341 on a 40MHz SPI bus: 16 clocks per pixel, ~60 clocks to set a window
+#define PIXEL_NANOS  400
+#define WINDOW_NANOS 1500
+
+TFT_eSPI::TFT_eSPI(int16_t w, int16_t h)
+{
+  (void) w;
+  (void) h;
+  memset(_fb, 0, sizeof(_fb));
+}
+
+void TFT_eSPI::init()
+{
+  setRotation(0);
+  memset(_fb, 0, sizeof(_fb));
+}
+
+// -------------------------------------------------------
+// Geometry
+// -------------------------------------------------------
+
+// 0-3 are the usual rotations, 4-7 the same ones with the Y axis mirrored
+// (used to draw bottom-up BMP files without seeking)
+void TFT_eSPI::setRotation(uint8_t r)
+{
+  _rotation = r % 8;
+  bool landscape = _rotation & 1;
+  _width = landscape ? TFT_HEIGHT : TFT_WIDTH;
+  _height = landscape ? TFT_WIDTH : TFT_HEIGHT;
+}
+
+void TFT_eSPI::plot(int32_t x, int32_t y, uint16_t color)
+{
+  if (x < 0 || y < 0 || x >= _width || y >= _height)
+    return;
+
+  if (_rotation & 4)
+    y = _height - 1 - y;
+
+  int32_t px, py;
+  switch (_rotation & 3)
+  {
+    case 0: px = x; py = y; break;
+    case 1: px = TFT_WIDTH - 1 - y; py = x; break;
+    case 2: px = TFT_WIDTH - 1 - x; py = TFT_HEIGHT - 1 - y; break;
+    default: px = y; py = TFT_HEIGHT - 1 - x; break;
+  }
+  _fb[py * TFT_WIDTH + px] = color;
+}
+
+void TFT_eSPI::chargeBus(uint32_t pixels, uint32_t windows)
+{
+  _counters.pixels += pixels;
+  _counters.windows += windows;
+  _busNanos += (uint64_t) pixels * PIXEL_NANOS + (uint64_t) windows * WINDOW_NANOS;
+
+  uint64_t us = (_busNanos - _busNanosCharged) / 1000;
+  if (us)
+  {
+    _busNanosCharged += us * 1000;
+    host::advance(us);
+  }
+}
+
+// -------------------------------------------------------
+// Primitives
+// -------------------------------------------------------
+
+void TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color)
+{
+  if (x < 0 || y < 0 || x >= _width || y >= _height)
+    return;
+  plot(x, y, color);
+  chargeBus(1, 1);
+}
+
+void TFT_eSPI::drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color)
+{
+  int32_t dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+  int32_t dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+  int32_t err = dx + dy;
+  uint32_t pixels = 0;
+
+  while (true)
+  {
+    plot(x0, y0, color);
+    pixels++;
+    if (x0 == x1 && y0 == y1)
+      break;
+    int32_t e2 = 2 * err;
+    if (e2 >= dy) { err += dy; x0 += sx; }
+    if (e2 <= dx) { err += dx; y0 += sy; }
+  }
+
+  // The library sends straight runs as one window each, roughly one per pixel on diagonals
+  chargeBus(pixels, (dx == 0 || dy == 0) ? 1 : pixels);
+}
+
+void TFT_eSPI::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color)
+{
+  fillRect(x, y, w, 1, color);
+}
+
+void TFT_eSPI::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color)
+{
+  fillRect(x, y, 1, h, color);
+}
+
+void TFT_eSPI::drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color)
+{
+  drawFastHLine(x, y, w, color);
+  drawFastHLine(x, y + h - 1, w, color);
+  drawFastVLine(x, y, h, color);
+  drawFastVLine(x + w - 1, y, h, color);
+}
+
+void TFT_eSPI::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color)
+{
+  // Clip
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > _width) w = _width - x;
+  if (y + h > _height) h = _height - y;
+  if (w <= 0 || h <= 0)
+    return;
+
+  for (int32_t j = y; j < y + h; j++)
+    for (int32_t i = x; i < x + w; i++)
+      plot(i, j, color);
+
+  if (w == _width && h == _height)
+    _counters.fullScreens++;
+  chargeBus(w * h, 1);
+}
+
+void TFT_eSPI::drawCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color)
+{
+  int32_t x = r, y = 0, err = 1 - r;
+  uint32_t pixels = 0;
+
+  while (x >= y)
+  {
+    plot(x0 + x, y0 + y, color); plot(x0 - x, y0 + y, color);
+    plot(x0 + x, y0 - y, color); plot(x0 - x, y0 - y, color);
+    plot(x0 + y, y0 + x, color); plot(x0 - y, y0 + x, color);
+    plot(x0 + y, y0 - x, color); plot(x0 - y, y0 - x, color);
+    pixels += 8;
+
+    y++;
+    if (err < 0)
+      err += 2 * y + 1;
+    else
+    {
+      x--;
+      err += 2 * (y - x) + 1;
+    }
+  }
+  chargeBus(pixels, pixels);
+}
+
+void TFT_eSPI::fillCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color)
+{
+  for (int32_t dy = -r; dy <= r; dy++)
+  {
+    int32_t dx = (int32_t) sqrt((double) (r * r - dy * dy));
+    fillRect(x0 - dx, y0 + dy, 2 * dx + 1, 1, color);
+  }
+}
+
+// Horizontal inset of a rounded corner of radius r at row j (0 = top row of the corner)
+static int32_t cornerInset(int32_t r, int32_t j)
+{
+  int32_t dy = r - j;
+  return r - (int32_t) sqrt((double) (r * r - dy * dy));
+}
+
+void TFT_eSPI::drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color)
+{
+  drawFastHLine(x + r, y, w - 2 * r, color);
+  drawFastHLine(x + r, y + h - 1, w - 2 * r, color);
+  drawFastVLine(x, y + r, h - 2 * r, color);
+  drawFastVLine(x + w - 1, y + r, h - 2 * r, color);
+
+  for (int32_t j = 0; j < r; j++)
+  {
+    int32_t inset = cornerInset(r, j);
+    plot(x + inset, y + j, color);
+    plot(x + w - 1 - inset, y + j, color);
+    plot(x + inset, y + h - 1 - j, color);
+    plot(x + w - 1 - inset, y + h - 1 - j, color);
+  }
+  chargeBus(4 * r, 4 * r);
+}
+
+void TFT_eSPI::fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color)
+{
+  fillRect(x, y + r, w, h - 2 * r, color);
+  for (int32_t j = 0; j < r; j++)
+  {
+    int32_t inset = cornerInset(r, j);
+    fillRect(x + inset, y + j, w - 2 * inset, 1, color);
+    fillRect(x + inset, y + h - 1 - j, w - 2 * inset, 1, color);
+  }
+}
+
+void TFT_eSPI::drawTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color)
+{
+  drawLine(x0, y0, x1, y1, color);
+  drawLine(x1, y1, x2, y2, color);
+  drawLine(x2, y2, x0, y0, color);
+}
+
+void TFT_eSPI::fillTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color)
+{
+  // Sort by y
+  if (y0 > y1) { std::swap(y0, y1); std::swap(x0, x1); }
+  if (y1 > y2) { std::swap(y2, y1); std::swap(x2, x1); }
+  if (y0 > y1) { std::swap(y0, y1); std::swap(x0, x1); }
+
+  if (y0 == y2)
+  {
+    int32_t a = std::min(x0, std::min(x1, x2));
+    int32_t b = std::max(x0, std::max(x1, x2));
+    drawFastHLine(a, y0, b - a + 1, color);
+    return;
+  }
+
+  for (int32_t y = y0; y <= y2; y++)
+  {
+    // Long edge 0-2, short edges 0-1 then 1-2
+    int32_t a = x0 + (int64_t) (x2 - x0) * (y - y0) / (y2 - y0);
+    int32_t b;
+    if (y < y1 || y1 == y2)
+      b = (y1 == y0) ? x1 : x0 + (int64_t) (x1 - x0) * (y - y0) / (y1 - y0);
+    else
+      b = x1 + (int64_t) (x2 - x1) * (y - y1) / (y2 - y1);
+    if (a > b)
+      std::swap(a, b);
+    drawFastHLine(a, y, b - a + 1, color);
+  }
+}
+
+// -------------------------------------------------------
+// Address window & block writes
+// -------------------------------------------------------
+
+void TFT_eSPI::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+  _winX0 = x0;
+  _winY0 = y0;
+  _winX1 = x1;
+  _winY1 = y1;
+  _winX = x0;
+  _winY = y0;
+  chargeBus(0, 1);
+}
+
+void TFT_eSPI::pushColor(uint16_t color)
+{
+  plot(_winX, _winY, color);
+  if (++_winX > _winX1)
+  {
+    _winX = _winX0;
+    if (++_winY > _winY1)
+      _winY = _winY0;
+  }
+  chargeBus(1, 0);
+}
+
+void TFT_eSPI::pushColor(uint16_t color, uint32_t len)
+{
+  while (len--)
+    pushColor(color);
+}
+
+// Pixel values are native; swap only tells the library how to feed the SPI FIFO
+void TFT_eSPI::pushColors(uint16_t *data, uint32_t len, bool swap)
+{
+  (void) swap;
+  while (len--)
+    pushColor(*data++);
+}
+
+// Bytes go out as they are in memory, so each pixel is big endian
+void TFT_eSPI::pushColors(uint8_t *data, uint32_t len)
+{
+  for (uint32_t i = 0; i + 1 < len; i += 2)
+    pushColor((data[i] << 8) | data[i + 1]);
+}
+
+// -------------------------------------------------------
+// Text
+// -------------------------------------------------------
+
+const GFXfont *TFT_eSPI::fontFor(uint8_t font, uint8_t &yAdvance)
+{
+  const GFXfont *f = (font == 1 && _gfxFont) ? _gfxFont : hostNumberedFont(font);
+  yAdvance = f->yAdvance;
+  return f;
+}
+
+int16_t TFT_eSPI::fontHeight(int16_t font)
+{
+  uint8_t yAdvance;
+  fontFor(font, yAdvance);
+  return yAdvance * _textSize;
+}
+
+int16_t TFT_eSPI::textWidth(const String &string, uint8_t font)
+{
+  uint8_t yAdvance;
+  const GFXfont *f = fontFor(font, yAdvance);
+
+  int16_t width = 0;
+  for (const char *p = string.c_str(); *p; p++)
+  {
+    uint8_t c = *p;
+    if (c >= f->first && c <= f->last)
+      width += f->glyph[c - f->first].xAdvance;
+  }
+  return width * _textSize;
+}
+
+void TFT_eSPI::drawGlyph(const GFXfont *font, int32_t x, int32_t baseline, char ch, uint16_t color)
+{
+  uint8_t c = ch;
+  if (c < font->first || c > font->last)
+    return;
+
+  const GFXglyph &g = font->glyph[c - font->first];
+  const uint8_t *bitmap = font->bitmap + g.bitmapOffset;
+  uint32_t bit = 0, pixels = 0;
+
+  for (int32_t yy = 0; yy < g.height; yy++)
+    for (int32_t xx = 0; xx < g.width; xx++, bit++)
+    {
+      if (bitmap[bit >> 3] & (0x80 >> (bit & 7)))
+      {
+        for (int32_t sy = 0; sy < _textSize; sy++)
+          for (int32_t sx = 0; sx < _textSize; sx++)
+            plot(x + (g.xOffset + xx) * _textSize + sx, baseline + (g.yOffset + yy) * _textSize + sy, color);
+        pixels++;
+      }
+    }
+
+  // The library draws glyphs pixel by pixel
+  chargeBus(pixels * _textSize * _textSize, pixels);
+}
+
+// Same datum and padding rules as the library
+int16_t TFT_eSPI::drawString(const String &string, int32_t poX, int32_t poY, uint8_t font)
+{
+  uint8_t yAdvance;
+  const GFXfont *f = fontFor(font, yAdvance);
+
+  int32_t cwidth = textWidth(string, font);
+  int32_t cheight = yAdvance * _textSize;
+
+  // Ascent from the tallest of a few reference glyphs
+  int32_t ascent = 0;
+  for (char ref : { 'A', 'd', '0' })
+    if ((uint8_t) ref >= f->first && (uint8_t) ref <= f->last)
+      ascent = std::max<int32_t>(ascent, -f->glyph[ref - f->first].yOffset);
+  int32_t baseline = ascent * _textSize;
+
+  uint8_t padding = 0;
+  switch (_textDatum)
+  {
+    case TC_DATUM: poX -= cwidth / 2; padding = 1; break;
+    case TR_DATUM: poX -= cwidth; padding = 2; break;
+    case ML_DATUM: poY -= cheight / 2; break;
+    case MC_DATUM: poX -= cwidth / 2; poY -= cheight / 2; padding = 1; break;
+    case MR_DATUM: poX -= cwidth; poY -= cheight / 2; padding = 2; break;
+    case BL_DATUM: poY -= cheight; break;
+    case BC_DATUM: poX -= cwidth / 2; poY -= cheight; padding = 1; break;
+    case BR_DATUM: poX -= cwidth; poY -= cheight; padding = 2; break;
+    case L_BASELINE: poY -= baseline; break;
+    case C_BASELINE: poX -= cwidth / 2; poY -= baseline; padding = 1; break;
+    case R_BASELINE: poX -= cwidth; poY -= baseline; padding = 2; break;
+  }
+
+  if (poX + cwidth > _width) poX = _width - cwidth;
+  if (poY + cheight - baseline > _height) poY = _height - cheight;
+  if (poX < 0) poX = 0;
+  if (poY < 0) poY = 0;
+
+  // Background and padding only when the text colours differ
+  if (_textColor != _textBgColor)
+  {
+    fillRect(poX, poY, cwidth, cheight, _textBgColor);
+
+    if (_padX > cwidth)
+    {
+      int32_t extra = _padX - cwidth;
+      switch (padding)
+      {
+        case 0:
+          fillRect(poX + cwidth, poY, extra, cheight, _textBgColor);
+          break;
+        case 1:
+          fillRect(poX - extra / 2, poY, extra / 2, cheight, _textBgColor);
+          fillRect(poX + cwidth, poY, extra - extra / 2, cheight, _textBgColor);
+          break;
+        default:
+          fillRect(poX - extra, poY, extra, cheight, _textBgColor);
+          break;
+      }
+    }
+  }
+
+  int32_t x = poX;
+  for (const char *p = string.c_str(); *p; p++)
+  {
+    uint8_t c = *p;
+    drawGlyph(f, x, poY + baseline, c, _textColor);
+    if (c >= f->first && c <= f->last)
+      x += f->glyph[c - f->first].xAdvance * _textSize;
+  }
+
+  return cwidth;
+}
+
+int16_t TFT_eSPI::drawCentreString(const String &string, int32_t x, int32_t y, uint8_t font)
+{
+  uint8_t datum = _textDatum;
+  _textDatum = TC_DATUM;
+  int16_t w = drawString(string, x, y, font);
+  _textDatum = datum;
+  return w;
+}
+
+int16_t TFT_eSPI::drawRightString(const String &string, int32_t x, int32_t y, uint8_t font)
+{
+  uint8_t datum = _textDatum;
+  _textDatum = TR_DATUM;
+  int16_t w = drawString(string, x, y, font);
+  _textDatum = datum;
+  return w;
+}
+
+// print(): the cursor is on the baseline for GFX fonts
+size_t TFT_eSPI::write(uint8_t c)
+{
+  uint8_t yAdvance;
+  const GFXfont *f = fontFor(_textFont, yAdvance);
+
+  if (c == '\n')
+  {
+    _cursorX = 0;
+    _cursorY += yAdvance * _textSize;
+    return 1;
+  }
+  if (c == '\r' || c < f->first || c > f->last)
+    return 1;
+
+  int16_t advance = f->glyph[c - f->first].xAdvance * _textSize;
+  if (_textWrap && _cursorX + advance > _width)
+  {
+    _cursorX = 0;
+    _cursorY += yAdvance * _textSize;
+  }
+  drawGlyph(f, _cursorX, _cursorY, c, _textColor);
+  _cursorX += advance;
+  return 1;
+}
+
+// -------------------------------------------------------
+// Host only
+// -------------------------------------------------------
+
+// Written the way the panel is seen in the enclosure (rotation 2)
+bool TFT_eSPI::dumpPPM(const char *path)
+{
+  FILE *fp = fopen(path, "wb");
+  if (!fp)
+    return false;
+
+  fprintf(fp, "P6\n%d %d\n255\n", TFT_WIDTH, TFT_HEIGHT);
+  for (int32_t i = TFT_WIDTH * TFT_HEIGHT - 1; i >= 0; i--)
+  {
+    uint16_t c = _fb[i];
+    uint8_t rgb[3] = { (uint8_t) ((c >> 8) & 0xF8), (uint8_t) ((c >> 3) & 0xFC), (uint8_t) ((c << 3) & 0xF8) };
+    fwrite(rgb, 1, 3, fp);
+  }
+  fclose(fp);
+  return true;
+}
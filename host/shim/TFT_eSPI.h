@@ -0,0 +1,189 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - TFT_eSPI stand-in                      */
+/*                                                      */
+/*  Renders into a 240x320 RGB565 framebuffer. Every    */
+/*  pixel sent to the panel is counted and charged to   */
+/*  the virtual clock at the SPI rate of the real panel */
+/*  (ILI9341 at 40MHz: 16 bit per pixel plus address    */
+/*  window commands), so drawing cost shows up in the   */
+/*  host timings. Frames can be dumped as PPM files.    */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+#include "SPI.h"
+
+#define TFT_WIDTH  240
+#define TFT_HEIGHT 320
+
+// Text datums
+#define TL_DATUM 0
+#define TC_DATUM 1
+#define TR_DATUM 2
+#define ML_DATUM 3
+#define CL_DATUM 3
+#define MC_DATUM 4
+#define CC_DATUM 4
+#define MR_DATUM 5
+#define CR_DATUM 5
+#define BL_DATUM 6
+#define BC_DATUM 7
+#define BR_DATUM 8
+#define L_BASELINE 9
+#define C_BASELINE 10
+#define R_BASELINE 11
+
+// Colours (RGB565)
+#define TFT_BLACK       0x0000
+#define TFT_NAVY        0x000F
+#define TFT_DARKGREEN   0x03E0
+#define TFT_DARKCYAN    0x03EF
+#define TFT_MAROON      0x7800
+#define TFT_PURPLE      0x780F
+#define TFT_OLIVE       0x7BE0
+#define TFT_LIGHTGREY   0xC618
+#define TFT_DARKGREY    0x7BEF
+#define TFT_BLUE        0x001F
+#define TFT_GREEN       0x07E0
+#define TFT_CYAN        0x07FF
+#define TFT_RED         0xF800
+#define TFT_MAGENTA     0xF81F
+#define TFT_YELLOW      0xFFE0
+#define TFT_WHITE       0xFFFF
+#define TFT_ORANGE      0xFDA0
+#define TFT_GREENYELLOW 0xB7E0
+#define TFT_PINK        0xFC9F
+
+// Adafruit GFX font structures
+typedef struct
+{
+  uint16_t bitmapOffset;
+  uint8_t width;
+  uint8_t height;
+  uint8_t xAdvance;
+  int8_t xOffset;
+  int8_t yOffset;
+} GFXglyph;
+
+typedef struct
+{
+  uint8_t *bitmap;
+  GFXglyph *glyph;
+  uint16_t first;
+  uint16_t last;
+  uint8_t yAdvance;
+} GFXfont;
+
+// The free fonts used by the firmware ship with the library; the host build maps
+// them onto the project fonts with the original line heights (see HostFonts.cpp)
+extern const GFXfont FreeSans9pt7b;
+extern const GFXfont FreeSansBold9pt7b;
+extern const GFXfont FreeSansBold12pt7b;
+extern const GFXfont FreeMono9pt7b;
+
+class TFT_eSPI : public Print
+{
+  public:
+    TFT_eSPI(int16_t w = TFT_WIDTH, int16_t h = TFT_HEIGHT);
+
+    void init();
+    void begin() { init(); }
+
+    void setRotation(uint8_t r);
+    uint8_t getRotation() { return _rotation; }
+    int16_t width() { return _width; }
+    int16_t height() { return _height; }
+
+    // Primitives
+    void drawPixel(int32_t x, int32_t y, uint32_t color);
+    void drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color);
+    void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color);
+    void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color);
+    void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void fillScreen(uint32_t color) { fillRect(0, 0, _width, _height, color); }
+    void drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color);
+    void fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color);
+    void drawCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color);
+    void fillCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color);
+    void drawTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color);
+    void fillTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color);
+
+    // Address window & block writes
+    void setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1);
+    void setAddrWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1) { setWindow(x0, y0, x1, y1); }
+    void pushColor(uint16_t color);
+    void pushColor(uint16_t color, uint32_t len);
+    void pushColors(uint16_t *data, uint32_t len, bool swap = true);
+    void pushColors(uint8_t *data, uint32_t len);
+
+    static uint16_t color565(uint8_t r, uint8_t g, uint8_t b) { return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3); }
+
+    // Text
+    void setCursor(int16_t x, int16_t y) { _cursorX = x; _cursorY = y; }
+    void setTextColor(uint16_t color) { _textColor = _textBgColor = color; }
+    void setTextColor(uint16_t fgcolor, uint16_t bgcolor) { _textColor = fgcolor; _textBgColor = bgcolor; }
+    void setTextWrap(bool wrap) { _textWrap = wrap; }
+    void setTextDatum(uint8_t datum) { _textDatum = datum; }
+    uint8_t getTextDatum() { return _textDatum; }
+    void setTextPadding(uint16_t xWidth) { _padX = xWidth; }
+    void setTextSize(uint8_t size) { _textSize = size ? size : 1; }
+    void setFreeFont(const GFXfont *f) { _gfxFont = f; _textFont = f ? 1 : 0; }
+    void setTextFont(uint8_t font) { _gfxFont = NULL; _textFont = font; }
+
+    int16_t drawString(const String &string, int32_t x, int32_t y, uint8_t font);
+    int16_t drawString(const String &string, int32_t x, int32_t y) { return drawString(string, x, y, _textFont); }
+    int16_t drawString(const char *string, int32_t x, int32_t y, uint8_t font) { return drawString(String(string), x, y, font); }
+    int16_t drawString(const char *string, int32_t x, int32_t y) { return drawString(String(string), x, y, _textFont); }
+    int16_t drawCentreString(const String &string, int32_t x, int32_t y, uint8_t font);
+    int16_t drawRightString(const String &string, int32_t x, int32_t y, uint8_t font);
+    int16_t textWidth(const String &string, uint8_t font);
+    int16_t textWidth(const String &string) { return textWidth(string, _textFont); }
+    int16_t fontHeight(int16_t font);
+    int16_t fontHeight() { return fontHeight(_textFont); }
+
+    using Print::write;
+    size_t write(uint8_t c) override;
+
+    // Host only
+    struct Counters
+    {
+      unsigned long pixels = 0;       // pixels sent to the panel
+      unsigned long windows = 0;      // address window commands
+      unsigned long fullScreens = 0;  // fillScreen() calls
+    };
+    const Counters &counters() const { return _counters; }
+    uint64_t busMicros() const { return _busNanos / 1000; }
+    const uint16_t *framebuffer() const { return _fb; }
+    bool dumpPPM(const char *path);
+
+  private:
+    const GFXfont *fontFor(uint8_t font, uint8_t &yAdvance);
+    void drawGlyph(const GFXfont *font, int32_t x, int32_t baseline, char c, uint16_t color);
+    void plot(int32_t x, int32_t y, uint16_t color);
+    void chargeBus(uint32_t pixels, uint32_t windows);
+
+    uint16_t _fb[TFT_WIDTH * TFT_HEIGHT];
+    uint8_t _rotation = 0;
+    int16_t _width = TFT_WIDTH;
+    int16_t _height = TFT_HEIGHT;
+
+    int32_t _winX0 = 0, _winY0 = 0, _winX1 = 0, _winY1 = 0;
+    int32_t _winX = 0, _winY = 0;
+
+    int16_t _cursorX = 0, _cursorY = 0;
+    uint16_t _textColor = TFT_WHITE, _textBgColor = TFT_WHITE;
+    bool _textWrap = true;
+    uint8_t _textDatum = TL_DATUM;
+    uint16_t _padX = 0;
+    uint8_t _textSize = 1;
+    const GFXfont *_gfxFont = NULL;
+    uint8_t _textFont = 1;
+
+    Counters _counters;
+    uint64_t _busNanos = 0;
+    uint64_t _busNanosCharged = 0;
+};
@@ -0,0 +1,137 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - Time library & NtpClientLib stand-in   */
+/*                                                      */
+/********************************************************/
+
+#include "TimeLib.h"
+#include "NtpClientLib.h"
+#include "ESP8266WiFi.h"
+
+NTPClient NTP;
+
+// 2017-10-01 10:00:00 UTC
+static time_t baseTime = 1506852000;
+static unsigned long baseMillis = 0;
+static timeStatus_t status = timeNotSet;
+
+time_t now()
+{
+  return baseTime + (millis() - baseMillis) / 1000;
+}
+
+void setTime(time_t t)
+{
+  baseTime = t;
+  baseMillis = millis();
+  status = timeSet;
+}
+
+void adjustTime(long adjustment)
+{
+  baseTime += adjustment;
+}
+
+timeStatus_t timeStatus()
+{
+  return status;
+}
+
+static struct tm breakTime(time_t t)
+{
+  struct tm tm;
+  gmtime_r(&t, &tm);
+  return tm;
+}
+
+int hour(time_t t) { return breakTime(t).tm_hour; }
+int minute(time_t t) { return breakTime(t).tm_min; }
+int second(time_t t) { return breakTime(t).tm_sec; }
+int day(time_t t) { return breakTime(t).tm_mday; }
+int weekday(time_t t) { return breakTime(t).tm_wday + 1; }
+int month(time_t t) { return breakTime(t).tm_mon + 1; }
+int year(time_t t) { return breakTime(t).tm_year + 1900; }
+
+int hour() { return hour(now()); }
+int hourFormat12() { int h = hour() % 12; return h ? h : 12; }
+bool isAM() { return hour() < 12; }
+bool isPM() { return !isAM(); }
+int minute() { return minute(now()); }
+int second() { return second(now()); }
+int day() { return day(now()); }
+int weekday() { return weekday(now()); }
+int month() { return month(now()); }
+int year() { return year(now()); }
+
+static char nameBuffer[10];
+static const char *const monthNames[] = { "", "January", "February", "March", "April", "May", "June", "July", "August", "September", "October", "November", "December" };
+static const char *const dayNames[] = { "Err", "Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday" };
+
+char *monthStr(uint8_t month)
+{
+  strcpy(nameBuffer, monthNames[month <= 12 ? month : 0]);
+  return nameBuffer;
+}
+
+char *dayStr(uint8_t day)
+{
+  strcpy(nameBuffer, dayNames[day <= 7 ? day : 0]);
+  return nameBuffer;
+}
+
+char *monthShortStr(uint8_t month)
+{
+  monthStr(month);
+  nameBuffer[3] = 0;
+  return nameBuffer;
+}
+
+char *dayShortStr(uint8_t day)
+{
+  dayStr(day);
+  nameBuffer[3] = 0;
+  return nameBuffer;
+}
+
+// -------------------------------------------------------
+// NTP
+// -------------------------------------------------------
+
+bool NTPClient::begin(String ntpServerName, int timeOffset, bool daylight)
+{
+  (void) ntpServerName;
+
+  // Keep local time across zone changes
+  adjustTime((long)(timeOffset - _timeZone + (daylight - _daylight)) * 3600);
+  _timeZone = timeOffset;
+  _daylight = daylight;
+
+  if (WiFi.status() != WL_CONNECTED)
+  {
+    if (_onSyncEvent)
+      _onSyncEvent(noResponse);
+    return false;
+  }
+
+  status = timeSet;
+  _lastSyncTime = now();
+  if (!_firstSync)
+    _firstSync = _lastSyncTime;
+  if (_onSyncEvent)
+    _onSyncEvent(timeSyncd);
+  return true;
+}
+
+String NTPClient::getTimeStr(time_t moment)
+{
+  char buf[3 * 11 + 3];   // three ints at their longest, separators, terminator
+  snprintf(buf, sizeof(buf), "%02d:%02d:%02d", hour(moment), minute(moment), second(moment));
+  return String(buf);
+}
+
+String NTPClient::getDateStr(time_t moment)
+{
+  char buf[3 * 11 + 3];   // three ints at their longest, separators, terminator
+  snprintf(buf, sizeof(buf), "%02d/%02d/%4d", day(moment), month(moment), year(moment));
+  return String(buf);
+}
@@ -0,0 +1,44 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - Time library stand-in                  */
+/*                                                      */
+/*  The clock starts at a fixed epoch and follows the   */
+/*  virtual millis() clock, so runs are reproducible.   */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+
+#include <ctime>
+
+typedef enum { timeNotSet, timeNeedsSync, timeSet } timeStatus_t;
+
+time_t now();
+void setTime(time_t t);
+void adjustTime(long adjustment);
+timeStatus_t timeStatus();
+
+int hour();
+int hour(time_t t);
+int hourFormat12();
+bool isAM();
+bool isPM();
+int minute();
+int minute(time_t t);
+int second();
+int second(time_t t);
+int day();
+int day(time_t t);
+int weekday();
+int weekday(time_t t);
+int month();
+int month(time_t t);
+int year();
+int year(time_t t);
+
+char *monthStr(uint8_t month);
+char *dayStr(uint8_t day);
+char *monthShortStr(uint8_t month);
+char *dayShortStr(uint8_t day);
@@ -0,0 +1,39 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - TimeSpaceLib stand-in                  */
+/*                                                      */
+/*  Fixed location (Zurich) when online.                */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+#include "ESP8266WiFi.h"
+
+class Geolocate
+{
+  public:
+    bool acquire() { return WiFi.status() == WL_CONNECTED; }
+    double getLatitude() { return 47.376887; }
+    double getLongitude() { return 8.541694; }
+};
+
+class Timezone
+{
+  public:
+    bool acquire(double latitude, double longitude) { (void) latitude; (void) longitude; return WiFi.status() == WL_CONNECTED; }
+    int getUtcOffset() { return 7200; }
+    bool isDst() { return true; }
+    String getTimeZoneId() { return F("Europe/Zurich"); }
+    String getTimeZoneName() { return F("Central European Summer Time"); }
+};
+
+class Geocode
+{
+  public:
+    bool acquire(double latitude, double longitude) { (void) latitude; (void) longitude; return WiFi.status() == WL_CONNECTED; }
+    String getLocality() { return F("Zurich"); }
+    String getCountry() { return F("Switzerland"); }
+    String getCountryCode() { return F("CH"); }
+};
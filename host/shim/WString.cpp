@@ -0,0 +1,163 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - Arduino String stand-in                */
+/*                                                      */
+/********************************************************/
+
+#include "WString.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+
+// Format an integer in the requested base, like the core's itoa/ultoa
+static std::string toBase(unsigned long value, bool negative, unsigned char base)
+{
+  if (base < 2 || base > 36)
+    base = 10;
+
+  std::string out;
+  do
+  {
+    int digit = value % base;
+    out += (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+    value /= base;
+  }
+  while (value);
+
+  if (negative)
+    out += '-';
+
+  std::reverse(out.begin(), out.end());
+  return out;
+}
+
+String::String(unsigned char value, unsigned char base) : s(toBase(value, false, base)) {}
+String::String(int value, unsigned char base)
+  : s(base == 10 ? toBase(value < 0 ? -(long)value : value, value < 0, base) : toBase((unsigned int)value, false, base)) {}
+String::String(unsigned int value, unsigned char base) : s(toBase(value, false, base)) {}
+String::String(long value, unsigned char base)
+  : s(base == 10 ? toBase(value < 0 ? -(unsigned long)value : value, value < 0, base) : toBase((unsigned long)value, false, base)) {}
+String::String(unsigned long value, unsigned char base) : s(toBase(value, false, base)) {}
+
+String::String(float value, unsigned char decimalPlaces) : String((double) value, decimalPlaces) {}
+
+String::String(double value, unsigned char decimalPlaces)
+{
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, value);
+  s = buf;
+}
+
+bool String::equalsIgnoreCase(const String &rhs) const
+{
+  if (s.size() != rhs.s.size())
+    return false;
+
+  for (size_t i = 0; i < s.size(); i++)
+  {
+    if (tolower((unsigned char) s[i]) != tolower((unsigned char) rhs.s[i]))
+      return false;
+  }
+  return true;
+}
+
+bool String::endsWith(const String &suffix) const
+{
+  return s.size() >= suffix.s.size() && s.compare(s.size() - suffix.s.size(), suffix.s.size(), suffix.s) == 0;
+}
+
+int String::indexOf(char ch, unsigned int fromIndex) const
+{
+  size_t pos = s.find(ch, fromIndex);
+  return pos == std::string::npos ? -1 : (int) pos;
+}
+
+int String::indexOf(const String &str, unsigned int fromIndex) const
+{
+  size_t pos = s.find(str.s, fromIndex);
+  return pos == std::string::npos ? -1 : (int) pos;
+}
+
+int String::lastIndexOf(char ch) const
+{
+  size_t pos = s.rfind(ch);
+  return pos == std::string::npos ? -1 : (int) pos;
+}
+
+int String::lastIndexOf(const String &str) const
+{
+  size_t pos = s.rfind(str.s);
+  return pos == std::string::npos ? -1 : (int) pos;
+}
+
+String String::substring(unsigned int beginIndex) const
+{
+  return substring(beginIndex, s.size());
+}
+
+// Same contract as the core: indexes are swapped if reversed and clamped to the length
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const
+{
+  if (beginIndex > endIndex)
+    std::swap(beginIndex, endIndex);
+  if (beginIndex >= s.size())
+    return String();
+  if (endIndex > s.size())
+    endIndex = s.size();
+  return String(s.substr(beginIndex, endIndex - beginIndex));
+}
+
+void String::replace(const String &find, const String &replace)
+{
+  if (find.s.empty())
+    return;
+
+  size_t pos = 0;
+  while ((pos = s.find(find.s, pos)) != std::string::npos)
+  {
+    s.replace(pos, find.s.size(), replace.s);
+    pos += replace.s.size();
+  }
+}
+
+void String::remove(unsigned int index, unsigned int count)
+{
+  if (index < s.size())
+    s.erase(index, count);
+}
+
+void String::toUpperCase()
+{
+  for (auto &c : s)
+    c = toupper((unsigned char) c);
+}
+
+void String::toLowerCase()
+{
+  for (auto &c : s)
+    c = tolower((unsigned char) c);
+}
+
+void String::trim()
+{
+  size_t first = s.find_first_not_of(" \t\r\n");
+  if (first == std::string::npos)
+  {
+    s.clear();
+    return;
+  }
+  size_t last = s.find_last_not_of(" \t\r\n");
+  s = s.substr(first, last - first + 1);
+}
+
+long String::toInt() const
+{
+  return atol(s.c_str());
+}
+
+float String::toFloat() const
+{
+  return atof(s.c_str());
+}
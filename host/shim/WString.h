@@ -0,0 +1,99 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - Arduino String stand-in                */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+#define FPSTR(pstr_pointer) (reinterpret_cast<const __FlashStringHelper *>(pstr_pointer))
+
+// Subset of the ESP8266 core String, backed by std::string
+class String
+{
+  public:
+    String() {}
+    String(const char *cstr) : s(cstr ? cstr : "") {}
+    String(const std::string &str) : s(str) {}
+    String(const __FlashStringHelper *pstr) : s(reinterpret_cast<const char *>(pstr)) {}
+    explicit String(char c) : s(1, c) {}
+    explicit String(unsigned char value, unsigned char base = 10);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(float value, unsigned char decimalPlaces = 2);
+    explicit String(double value, unsigned char decimalPlaces = 2);
+
+    unsigned int length() const { return s.length(); }
+    const char *c_str() const { return s.c_str(); }
+    bool reserve(unsigned int size) { s.reserve(size); return true; }
+
+    String &operator += (const String &rhs) { s += rhs.s; return *this; }
+    String &operator += (const char *cstr) { s += cstr; return *this; }
+    String &operator += (const __FlashStringHelper *pstr) { s += reinterpret_cast<const char *>(pstr); return *this; }
+    String &operator += (char c) { s += c; return *this; }
+    String &operator += (int value) { return *this += String(value); }
+    String &operator += (unsigned int value) { return *this += String(value); }
+    String &operator += (long value) { return *this += String(value); }
+    String &operator += (unsigned long value) { return *this += String(value); }
+    String &operator += (float value) { return *this += String(value); }
+    String &operator += (double value) { return *this += String(value); }
+    bool concat(const String &rhs) { s += rhs.s; return true; }
+
+    bool equals(const String &rhs) const { return s == rhs.s; }
+    bool equalsIgnoreCase(const String &rhs) const;
+    bool startsWith(const String &prefix) const { return s.compare(0, prefix.s.size(), prefix.s) == 0; }
+    bool endsWith(const String &suffix) const;
+
+    char charAt(unsigned int index) const { return index < s.size() ? s[index] : 0; }
+    char operator [](unsigned int index) const { return charAt(index); }
+    char &operator [](unsigned int index) { return s[index]; }
+
+    int indexOf(char ch, unsigned int fromIndex = 0) const;
+    int indexOf(const String &str, unsigned int fromIndex = 0) const;
+    int lastIndexOf(char ch) const;
+    int lastIndexOf(const String &str) const;
+    String substring(unsigned int beginIndex) const;
+    String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+    void replace(const String &find, const String &replace);
+    void remove(unsigned int index, unsigned int count = (unsigned int) -1);
+    void toUpperCase();
+    void toLowerCase();
+    void trim();
+
+    long toInt() const;
+    float toFloat() const;
+
+    const std::string &str() const { return s; }
+
+  private:
+    std::string s;
+};
+
+inline String operator + (const String &lhs, const String &rhs) { String r(lhs); r += rhs; return r; }
+inline String operator + (const String &lhs, const char *rhs) { String r(lhs); r += rhs; return r; }
+inline String operator + (const char *lhs, const String &rhs) { String r(lhs); r += rhs; return r; }
+inline String operator + (const String &lhs, const __FlashStringHelper *rhs) { String r(lhs); r += rhs; return r; }
+inline String operator + (const String &lhs, char rhs) { String r(lhs); r += rhs; return r; }
+inline String operator + (const String &lhs, int rhs) { String r(lhs); r += rhs; return r; }
+inline String operator + (const String &lhs, unsigned int rhs) { String r(lhs); r += rhs; return r; }
+inline String operator + (const String &lhs, long rhs) { String r(lhs); r += rhs; return r; }
+inline String operator + (const String &lhs, unsigned long rhs) { String r(lhs); r += rhs; return r; }
+inline String operator + (const String &lhs, float rhs) { String r(lhs); r += rhs; return r; }
+inline String operator + (const String &lhs, double rhs) { String r(lhs); r += rhs; return r; }
+
+inline bool operator == (const String &lhs, const String &rhs) { return lhs.str() == rhs.str(); }
+inline bool operator == (const String &lhs, const char *rhs) { return lhs.str() == rhs; }
+inline bool operator == (const String &lhs, const __FlashStringHelper *rhs) { return lhs.str() == reinterpret_cast<const char *>(rhs); }
+inline bool operator != (const String &lhs, const String &rhs) { return !(lhs == rhs); }
+inline bool operator != (const String &lhs, const char *rhs) { return !(lhs == rhs); }
+inline bool operator != (const String &lhs, const __FlashStringHelper *rhs) { return !(lhs == rhs); }
+inline bool operator < (const String &lhs, const String &rhs) { return lhs.str() < rhs.str(); }
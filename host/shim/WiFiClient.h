@@ -0,0 +1,68 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - WiFiClient stand-in                    */
+/*                                                      */
+/*  Connections go to the canned servers of the host    */
+/*  build (host::server). A request is answered once    */
+/*  its header block is complete; the peer closes after */
+/*  the response unless keep-alive was requested.       */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+#include "IPAddress.h"
+
+class Client : public Stream
+{
+  public:
+    virtual int connect(const char *host, uint16_t port) = 0;
+    virtual uint8_t connected() = 0;
+    virtual void stop() = 0;
+    virtual operator bool() = 0;
+    virtual int read(uint8_t *buf, size_t size) = 0;
+    using Stream::read;
+};
+
+class WiFiClient : public Client
+{
+  public:
+    int connect(const char *host, uint16_t port) override;
+    int connect(const String &host, uint16_t port) { return connect(host.c_str(), port); }
+    int connect(IPAddress ip, uint16_t port) { return connect(ip.toString().c_str(), port); }
+    uint8_t connected() override;
+    void stop() override;
+    operator bool() override { return connected(); }
+
+    using Print::write;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buf, size_t size) override;
+    int available() override;
+    int read() override;
+    int read(uint8_t *buf, size_t size) override;
+    int peek() override;
+    void flush() override {}
+
+    void setNoDelay(bool nodelay) { (void) nodelay; }
+    uint8_t status() { return connected() ? 4 : 0; }
+
+    // Host only: traffic counters over all clients
+    static unsigned long connections;
+    static unsigned long requests;
+    static unsigned long bytesReceived;
+
+  private:
+    void serveRequest();
+    size_t arrived() const;
+
+    bool _open = false;
+    bool _peerClosed = false;
+    String _host;
+    uint16_t _port = 0;
+    std::string _request;
+    std::string _response;
+    size_t _responseIndex = 0;
+    size_t _streamBase = 0;       // bytes of _response delivered at _streamStart
+    uint64_t _streamStart = 0;
+};
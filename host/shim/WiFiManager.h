@@ -0,0 +1,53 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - WiFiManager stand-in                   */
+/*                                                      */
+/*  The configuration portal returns at once, keeping   */
+/*  the default parameter values.                       */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "ESP8266WiFi.h"
+
+class WiFiManagerParameter
+{
+  public:
+    WiFiManagerParameter(const char *id, const char *placeholder, const char *defaultValue, int length)
+      : _id(id), _placeholder(placeholder), _value(defaultValue ? defaultValue : ""), _length(length) {}
+
+    const char *getID() { return _id; }
+    const char *getValue() { return _value.c_str(); }
+    const char *getPlaceholder() { return _placeholder; }
+    int getValueLength() { return _length; }
+
+  private:
+    const char *_id;
+    const char *_placeholder;
+    std::string _value;
+    int _length;
+};
+
+class WiFiManager
+{
+  public:
+    void setDebugOutput(bool debug) { (void) debug; }
+    void setSaveConfigCallback(void (*func)(void)) { _saveCallback = func; }
+    void addParameter(WiFiManagerParameter *p) { (void) p; }
+    void setConfigPortalTimeout(unsigned long seconds) { (void) seconds; }
+    void setConnectTimeout(unsigned long seconds) { (void) seconds; }
+    bool autoConnect(const char *apName = NULL) { return startConfigPortal(apName); }
+
+    bool startConfigPortal(const char *apName)
+    {
+      (void) apName;
+      WiFi.begin();
+      if (WiFi.status() == WL_CONNECTED && _saveCallback)
+        _saveCallback();
+      return WiFi.status() == WL_CONNECTED;
+    }
+
+  private:
+    void (*_saveCallback)(void) = NULL;
+};
@@ -0,0 +1,38 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - WiFiUDP stand-in                       */
+/*                                                      */
+/*  Datagrams are dropped; the counters are kept.       */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+#include "IPAddress.h"
+
+class UDP : public Stream
+{
+  public:
+    virtual uint8_t begin(uint16_t port) { (void) port; return 1; }
+    virtual void stop() {}
+    virtual int beginPacket(const char *host, uint16_t port) { (void) host; (void) port; return 1; }
+    virtual int beginPacket(IPAddress ip, uint16_t port) { (void) ip; (void) port; return 1; }
+    virtual int endPacket() { packets++; return 1; }
+    virtual int parsePacket() { return 0; }
+
+    using Print::write;
+    size_t write(uint8_t c) override { (void) c; bytes++; return 1; }
+    size_t write(const uint8_t *buffer, size_t size) override { (void) buffer; bytes += size; return size; }
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int read(unsigned char *buffer, size_t len) { (void) buffer; (void) len; return 0; }
+    int peek() override { return -1; }
+
+    unsigned long packets = 0;
+    unsigned long bytes = 0;
+};
+
+class WiFiUDP : public UDP
+{
+};
@@ -0,0 +1,122 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - I2C (Wire) stand-in                    */
+/*                                                      */
+/********************************************************/
+
+#include "Wire.h"
+#include "HostSim.h"
+
+TwoWire Wire;
+
+void TwoWire::begin(int sda, int scl)
+{
+  _sda = sda;
+  _scl = scl;
+  pinMode(sda, INPUT_PULLUP);
+  pinMode(scl, INPUT_PULLUP);
+}
+
+// Address byte + data bytes, 9 clocks each, plus start/stop
+void TwoWire::chargeBus(size_t bytes)
+{
+  uint64_t us = ((bytes + 1) * 9 + 2) * 1000000ULL / _clock;
+  _busMicros += us;
+  host::advance(us);
+}
+
+HostI2CDevice *TwoWire::device(uint8_t address)
+{
+  auto dev = _devices.find(address);
+  if (dev == _devices.end() || !dev->second->present())
+    return nullptr;
+
+  auto fault = _faults.find(address);
+  uint64_t now = host::micros64();
+  if (fault != _faults.end() && now >= fault->second.first && now < fault->second.second)
+    return nullptr;
+  return dev->second;
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+  _txAddress = address;
+  _txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t data)
+{
+  if (_txLength >= sizeof(_tx))
+    return 0;
+  _tx[_txLength++] = data;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t quantity)
+{
+  size_t n = 0;
+  while (n < quantity && write(data[n]))
+    n++;
+  return n;
+}
+
+// Same return codes as the core: 0 success, 2 address NACK, 4 bus error
+uint8_t TwoWire::endTransmission(bool sendStop)
+{
+  (void) sendStop;
+
+  Counters &c = _counters[_txAddress];
+  chargeBus(_txLength);
+
+  // SDA held low: the core gives up on the start condition
+  if (_jamClocks > 0)
+  {
+    c.busErrors++;
+    _txLength = 0;
+    return 4;
+  }
+
+  HostI2CDevice *dev = device(_txAddress);
+  if (!dev)
+  {
+    c.nacks++;
+    return 2;
+  }
+
+  dev->receive(_tx, _txLength);
+  c.writes++;
+  c.bytes += _txLength;
+  _txLength = 0;
+  return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, size_t quantity, bool sendStop)
+{
+  (void) sendStop;
+
+  Counters &c = _counters[address];
+  quantity = std::min(quantity, sizeof(_rx));
+  _rxIndex = 0;
+  _rxLength = 0;
+
+  if (_jamClocks > 0)
+  {
+    chargeBus(0);
+    c.busErrors++;
+    return 0;
+  }
+
+  HostI2CDevice *dev = device(address);
+  if (!dev)
+  {
+    chargeBus(0);
+    c.nacks++;
+    return 0;
+  }
+
+  _rxLength = dev->request(_rx, quantity);
+  chargeBus(_rxLength);
+  c.reads++;
+  c.bytes += _rxLength;
+  return _rxLength;
+}
@@ -0,0 +1,102 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - I2C (Wire) stand-in                    */
+/*                                                      */
+/*  Transactions are routed to device models attached  */
+/*  by address. Bus time is charged to the virtual      */
+/*  clock at the configured SCL rate, and per-address   */
+/*  traffic is counted. Faults: a device can be made to */
+/*  NACK for a time window, and a jammed slave can hold */
+/*  SDA low until SCL is pulsed by hand.                */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+
+#include <map>
+
+// Device model seen by the master on the bus
+class HostI2CDevice
+{
+  public:
+    virtual ~HostI2CDevice() {}
+
+    // Master wrote a frame to the device
+    virtual void receive(const uint8_t *data, size_t len) = 0;
+
+    // Master requests len bytes; returns the number supplied
+    virtual size_t request(uint8_t *data, size_t len) = 0;
+
+    // False makes the device NACK its address
+    virtual bool present() { return true; }
+};
+
+class TwoWire : public Stream
+{
+  public:
+    struct Counters
+    {
+      unsigned long writes = 0;
+      unsigned long reads = 0;
+      unsigned long bytes = 0;
+      unsigned long nacks = 0;
+      unsigned long busErrors = 0;
+    };
+
+    void begin(int sda, int scl);
+    void begin() {}
+    void setClock(uint32_t frequency) { _clock = frequency; }
+    void setClockStretchLimit(uint32_t limit) { (void) limit; }
+
+    void beginTransmission(uint8_t address);
+    void beginTransmission(int address) { beginTransmission((uint8_t) address); }
+    uint8_t endTransmission(bool sendStop = true);
+
+    uint8_t requestFrom(uint8_t address, size_t quantity, bool sendStop = true);
+    uint8_t requestFrom(int address, int quantity) { return requestFrom((uint8_t) address, (size_t) quantity); }
+    uint8_t requestFrom(int address, int quantity, int sendStop) { return requestFrom((uint8_t) address, (size_t) quantity, (bool) sendStop); }
+
+    using Print::write;
+    size_t write(uint8_t data) override;
+    size_t write(const uint8_t *data, size_t quantity) override;
+    size_t write(int n) { return write((uint8_t) n); }
+    size_t write(unsigned int n) { return write((uint8_t) n); }
+    size_t write(long n) { return write((uint8_t) n); }
+    size_t write(unsigned long n) { return write((uint8_t) n); }
+    int available() override { return _rxLength - _rxIndex; }
+    int read() override { return _rxIndex < _rxLength ? _rx[_rxIndex++] : -1; }
+    int peek() override { return _rxIndex < _rxLength ? _rx[_rxIndex] : -1; }
+
+    // Host only
+    void attachDevice(uint8_t address, HostI2CDevice *device) { _devices[address] = device; }
+    void hostFault(uint8_t address, uint64_t fromMicros, uint64_t untilMicros) { _faults[address] = { fromMicros, untilMicros }; }
+    void hostJam(int clocks) { _jamClocks = clocks; }
+    bool hostHoldsLow(uint8_t pin) const { return _jamClocks > 0 && pin == _sda; }
+    void hostClock(uint8_t pin) { if (_jamClocks > 0 && pin == _scl) _jamClocks--; }
+    const std::map<uint8_t, Counters> &counters() const { return _counters; }
+    unsigned long busMicros() const { return _busMicros; }
+
+  private:
+    void chargeBus(size_t bytes);
+    HostI2CDevice *device(uint8_t address);
+
+    std::map<uint8_t, HostI2CDevice *> _devices;
+    std::map<uint8_t, std::pair<uint64_t, uint64_t>> _faults;
+    int _sda = -1;
+    int _scl = -1;
+    int _jamClocks = 0;
+    std::map<uint8_t, Counters> _counters;
+    uint32_t _clock = 100000;
+    unsigned long _busMicros = 0;
+
+    uint8_t _txAddress = 0;
+    uint8_t _tx[32];
+    size_t _txLength = 0;
+    uint8_t _rx[32];
+    size_t _rxLength = 0;
+    size_t _rxIndex = 0;
+};
+
+extern TwoWire Wire;
@@ -0,0 +1,89 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - PAJ7620U gesture sensor stand-in       */
+/*                                                      */
+/*  begin() checks the part id and writes the           */
+/*  initialisation table like the real driver; gestures */
+/*  come from the flag registers 0x43/0x44 of bank 0.   */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+#include "Wire.h"
+
+#define PAJ7620_ADDRESS 0x73
+
+#define GES_NONE          0
+#define GES_UP            1
+#define GES_DOWN          2
+#define GES_LEFT          3
+#define GES_RIGHT         4
+#define GES_FORWARD       5
+#define GES_BACKWARD      6
+#define GES_CLOCKWISE     7
+#define GES_CNTRCLOCKWISE 8
+#define GES_WAVE          9
+
+class PAJ7620U
+{
+  public:
+    // 0 on success, like the driver
+    uint8_t begin()
+    {
+      Wire.begin();
+      writeRegister(0xEF, 0x00);   // Bank 0
+      uint16_t id = readRegister(0x00) | (readRegister(0x01) << 8);
+      if (id != 0x7620)
+        return 0xFF;
+
+      // The real table has 51 entries, the values do not matter here
+      for (uint8_t i = 0; i < 51; i++)
+        writeRegister(0x32 + i, 0x00);
+      writeRegister(0xEF, 0x00);
+      return 0;
+    }
+
+    int readGesture()
+    {
+      uint8_t flags = readRegister(0x43);
+      switch (flags)
+      {
+        case 0x01: return GES_RIGHT;
+        case 0x02: return GES_LEFT;
+        case 0x04: return GES_UP;
+        case 0x08: return GES_DOWN;
+        case 0x10: return GES_FORWARD;
+        case 0x20: return GES_BACKWARD;
+        case 0x40: return GES_CLOCKWISE;
+        case 0x80: return GES_CNTRCLOCKWISE;
+      }
+      return (readRegister(0x44) & 0x01) ? GES_WAVE : GES_NONE;
+    }
+
+    void cancelGesture()
+    {
+      readRegister(0x43);
+      readRegister(0x44);
+    }
+
+  private:
+    void writeRegister(uint8_t reg, uint8_t value)
+    {
+      Wire.beginTransmission(PAJ7620_ADDRESS);
+      Wire.write(reg);
+      Wire.write(value);
+      Wire.endTransmission();
+    }
+
+    uint8_t readRegister(uint8_t reg)
+    {
+      Wire.beginTransmission(PAJ7620_ADDRESS);
+      Wire.write(reg);
+      Wire.endTransmission();
+      if (Wire.requestFrom(PAJ7620_ADDRESS, 1) != 1)
+        return 0;
+      return Wire.read();
+    }
+};
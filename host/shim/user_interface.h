@@ -0,0 +1,20 @@
+/********************************************************/
+/*                                                      */
+/*  Host build - ESP8266 SDK stand-in                   */
+/*                                                      */
+/********************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+bool system_update_cpu_freq(uint8_t freq);
+uint8_t system_get_cpu_freq(void);
+
+#ifdef __cplusplus
+}
+#endif